@@ -10,14 +10,68 @@
 #include "ObstacleDetection_Internal.h"
 #include "ObstacleDetection_Cfg.h"
 #include "Rte.h"
+#include "DistConv.h"
 #include "Logger.h"
 #include "LogTags.h"
+#include "Dem.h"
+#include "NvM.h"
 
 /* ============================================================
  *  Internal Runtime Data Definition
  * ============================================================ */
 ObstacleDetection_InternalDataType	ObstacleDetection_InternalData;
 
+// Runnable does nothing before Init
+static boolean ObstacleDetection_Initialized = FALSE;
+
+// Calibration, defaults until Init finds a valid one in NvM
+static ObstacleDetection_CalibrationType ObstacleDetection_Cal =
+{
+	.ThresholdCm		= OBSTACLE_DETECTION_DISTANCE_THRESHOLD_CM,
+	.HysteresisCm		= OBSTACLE_DETECTION_HYSTERESIS_CM,
+	.MinValidCm			= OBSTACLE_DETECTION_MIN_VALID_DISTANCE_CM,
+	.MaxValidCm			= OBSTACLE_DETECTION_MAX_VALID_DISTANCE_CM,
+	.MaxInvalidCount	= OBSTACLE_DETECTION_MAX_INVALID_ID_COUNT
+};
+
+// Calibration limits in RTE unit, refreshed on SetCalibration so the runnable never converts
+typedef struct
+{
+	ObstacleDistance_q4mmType	Threshold;
+	ObstacleDistance_q4mmType	Release;		// threshold + hysteresis
+	ObstacleDistance_q4mmType	MinValid;
+	ObstacleDistance_q4mmType	MaxValid;
+} ObstacleDetection_LimitsType;
+
+static ObstacleDetection_LimitsType ObstacleDetection_Lim =
+{
+	.Threshold	= DISTCONV_CM_TO_Q4(OBSTACLE_DETECTION_DISTANCE_THRESHOLD_CM),
+	.Release	= DISTCONV_CM_TO_Q4(OBSTACLE_DETECTION_DISTANCE_THRESHOLD_CM + OBSTACLE_DETECTION_HYSTERESIS_CM),
+	.MinValid	= DISTCONV_CM_TO_Q4(OBSTACLE_DETECTION_MIN_VALID_DISTANCE_CM),
+	.MaxValid	= DISTCONV_CM_TO_Q4(OBSTACLE_DETECTION_MAX_VALID_DISTANCE_CM)
+};
+
+// Check and take over a calibration, E_NOT_OK if values are inconsistent (nothing changed)
+static Std_ReturnType ObstacleDetection_ApplyCalibration(const ObstacleDetection_CalibrationType* Cal)
+{
+	if((Cal->MinValidCm >= Cal->MaxValidCm) ||
+	   (Cal->ThresholdCm < Cal->MinValidCm) ||
+	   ((uint32)Cal->ThresholdCm + Cal->HysteresisCm > Cal->MaxValidCm) ||
+	   (DISTCONV_CM_TO_Q4(Cal->MaxValidCm) > DISTCONV_Q4_MAX) ||
+	   (Cal->MaxInvalidCount == 0u))
+	{
+		return E_NOT_OK;
+	}
+
+	ObstacleDetection_Cal = *Cal;
+
+	ObstacleDetection_Lim.Threshold	= (ObstacleDistance_q4mmType)DISTCONV_CM_TO_Q4(Cal->ThresholdCm);
+	ObstacleDetection_Lim.Release	= (ObstacleDistance_q4mmType)DISTCONV_CM_TO_Q4((uint32)Cal->ThresholdCm + Cal->HysteresisCm);
+	ObstacleDetection_Lim.MinValid	= (ObstacleDistance_q4mmType)DISTCONV_CM_TO_Q4(Cal->MinValidCm);
+	ObstacleDetection_Lim.MaxValid	= (ObstacleDistance_q4mmType)DISTCONV_CM_TO_Q4(Cal->MaxValidCm);
+	return E_OK;
+}
+
 /* ============================================
  * API function prototypes
  * ============================================*/
@@ -25,10 +79,19 @@ ObstacleDetection_InternalDataType	ObstacleDetection_InternalData;
 // Initialize Obstacle detection software component
 void ObstacleDetection_Init(void)
 {
+	ObstacleDetection_CalibrationType Stored;
+
+	// stored calibration (NvM initialised before), a block that fails the checks keeps the current one
+	if(NvM_ReadBlock(NVM_BLOCK_OBSTACLE_CAL, &Stored) == E_OK)
+	{
+		(void)ObstacleDetection_ApplyCalibration(&Stored);
+	}
+
 	ObstacleDetection_InternalData.State						= OBSTACLE_INT_STATE_INIT;
-	ObstacleDetection_InternalData.LastDistanceCm				= 0U;
+	ObstacleDetection_InternalData.LastDistance					= 0U;
 	ObstacleDetection_InternalData.LastMeasurementStatus		= OBSTACLE_MEASUREMENT_INVALID;
 	ObstacleDetection_InternalData.InvalidMeasurementCounter	= 0U;
+	ObstacleDetection_Initialized								= TRUE;
 
 #if (OBSTACLE_DETECTION_DEBUG_ENABLE == STD_ON)
 	LOG_INFO(LOG_TAG_SWC_OBTACLE,"ObstacleDetection initialized");
@@ -40,16 +103,16 @@ void ObstacleDetection_Init(void)
 void ObstacleDetection_MainFunction(void)
 {
 	Std_ReturnType	RteStatus;
-	ObstacleDistance_cmType			DistanceCm;
+	ObstacleDistance_q4mmType		Distance;
 	ObstracleMeasurementStatusType	MeasurementStatus;
 
-	if(ObstacleDetection_InternalData.State != OBSTACLE_INT_STATE_INIT)
+	if(ObstacleDetection_Initialized == FALSE)
 	{
 		return;
 	}
 
 	// Read input signal
-	RteStatus = Rte_Read_Distance(&DistanceCm);
+	RteStatus = Rte_Read_Distance(&Distance);
 
 	if(RteStatus != E_OK)
 	{
@@ -58,7 +121,7 @@ void ObstacleDetection_MainFunction(void)
 	}
 
 	// validate measurement
-	MeasurementStatus = ObstacleDetection_ValidateDistance(DistanceCm);
+	MeasurementStatus = ObstacleDetection_ValidateDistance(Distance);
 	ObstacleDetection_InternalData.LastMeasurementStatus = MeasurementStatus;
 
 	if(MeasurementStatus != OBSTACLE_MEASUREMENT_VALID)
@@ -69,20 +132,43 @@ void ObstacleDetection_MainFunction(void)
 
 	// Reset invalid counter or valid data
 	ObstacleDetection_InternalData.InvalidMeasurementCounter	= 0U;
-	ObstacleDetection_InternalData.LastDistanceCm	= DistanceCm;
+	(void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_INVALID, DEM_EVENT_STATUS_PREPASSED);
+	ObstacleDetection_InternalData.LastDistance	= Distance;
 
 	// Update state machine
-	ObstacleDetection_UpdateState(DistanceCm);
+	ObstacleDetection_UpdateState(Distance);
+
+}
+
+// Get number of consecutive invalid measurements
+uint8 ObstacleDetection_GetInvalidMeasurementCounter(void)
+{
+	return ObstacleDetection_InternalData.InvalidMeasurementCounter;
+}
+
+// Read active calibration
+void ObstacleDetection_GetCalibration(ObstacleDetection_CalibrationType* Cal)
+{
+	if(Cal == NULL_PTR) return;
+	*Cal = ObstacleDetection_Cal;
+}
+
+// Replace active calibration, stored by NvM in the background
+Std_ReturnType ObstacleDetection_SetCalibration(const ObstacleDetection_CalibrationType* Cal)
+{
+	if((Cal == NULL_PTR) || (ObstacleDetection_ApplyCalibration(Cal) != E_OK)) return E_NOT_OK;
 
+	(void)NvM_WriteBlock(NVM_BLOCK_OBSTACLE_CAL, &ObstacleDetection_Cal);
+	return E_OK;
 }
 
 /* ============================================
  * Internal Helper Function Prototypes
  * ============================================*/
 // Validate distance measurement
-ObstracleMeasurementStatusType ObstacleDetection_ValidateDistance(ObstacleDistance_cmType DistanceCm)
+ObstracleMeasurementStatusType ObstacleDetection_ValidateDistance(ObstacleDistance_q4mmType Distance)
 {
-	if( (DistanceCm < OBSTACLE_DETECTION_MIN_VALID_DISTANCE_CM) || (DistanceCm > OBSTACLE_DETECTION_MAX_VALID_DISTANCE_CM))
+	if( (Distance < ObstacleDetection_Lim.MinValid) || (Distance > ObstacleDetection_Lim.MaxValid))
 	{
 		return OBSTACLE_MEASUREMENT_INVALID;
 	}
@@ -91,19 +177,19 @@ ObstracleMeasurementStatusType ObstacleDetection_ValidateDistance(ObstacleDistan
 }
 
 // Update obstacle state machine
-void ObstacleDetection_UpdateState(ObstacleDistance_cmType DistanceCm)
+void ObstacleDetection_UpdateState(ObstacleDistance_q4mmType Distance)
 {
 	switch (ObstacleDetection_InternalData.State)
 	{
 	case OBSTACLE_INT_STATE_CLEAR:
-		if(DistanceCm < OBSTACLE_DETECTION_DISTANCE_THRESHOLD_CM)
+		if(Distance < ObstacleDetection_Lim.Threshold)
 		{
 			ObstacleDetection_InternalData.State = OBSTACLE_INT_STATE_DETECTED;
 		}
 		break;
 
 	case OBSTACLE_INT_STATE_DETECTED:
-		if(DistanceCm > (OBSTACLE_DETECTION_DISTANCE_THRESHOLD_CM + OBSTACLE_DETECTION_HYSTERESIS_CM))
+		if(Distance > ObstacleDetection_Lim.Release)
 		{
 			ObstacleDetection_InternalData.State = OBSTACLE_INT_STATE_CLEAR;
 		}
@@ -118,8 +204,9 @@ void ObstacleDetection_UpdateState(ObstacleDistance_cmType DistanceCm)
 void ObstacleDetection_HandleInvalidMeasurement(void)
 {
 	 ObstacleDetection_InternalData.InvalidMeasurementCounter++;
+	 (void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_INVALID, DEM_EVENT_STATUS_PREFAILED);
 
-	 if(ObstacleDetection_InternalData.InvalidMeasurementCounter >= OBSTACLE_DETECTION_MAX_INVALID_ID_COUNT)
+	 if(ObstacleDetection_InternalData.InvalidMeasurementCounter >= ObstacleDetection_Cal.MaxInvalidCount)
 	 {
 #if (OBSTACLE_DETECTION_FAIL_SAFE_MODE == STD_ON)
 		 ObstacleDetection_InternalData.State = OBSTACLE_INT_STATE_DETECTED;
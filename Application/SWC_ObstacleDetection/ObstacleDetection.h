@@ -22,4 +22,13 @@ void ObstacleDetection_Init(void);
 // Periodic runnable for obstacle detection logic
 void ObstacleDetection_MainFunction(void);
 
+// Get number of consecutive invalid measurements
+uint8 ObstacleDetection_GetInvalidMeasurementCounter(void);
+
+// Read active calibration
+void ObstacleDetection_GetCalibration(ObstacleDetection_CalibrationType* Cal);
+
+// Replace active calibration and store it (NvM), E_NOT_OK if values are inconsistent (nothing changed)
+Std_ReturnType ObstacleDetection_SetCalibration(const ObstacleDetection_CalibrationType* Cal);
+
 #endif /* SWC_OBSTACLEDETECTION_OBSTACLEDETECTION_H_ */
@@ -31,7 +31,7 @@ typedef enum
 typedef struct
 {
 	ObstacleDetection_InternalStateType	State;
-	ObstacleDistance_cmType				LastDistanceCm;
+	ObstacleDistance_q4mmType			LastDistance;
 	ObstracleMeasurementStatusType		LastMeasurementStatus;
 	uint8								InvalidMeasurementCounter;
 } ObstacleDetection_InternalDataType;
@@ -46,10 +46,10 @@ extern ObstacleDetection_InternalDataType ObstacleDetection_InternalData;
  * Internal Helper Function Prototypes
  * ============================================*/
 // Validate distance measurement
-ObstracleMeasurementStatusType ObstacleDetection_ValidateDistance(ObstacleDistance_cmType DistanceCm);
+ObstracleMeasurementStatusType ObstacleDetection_ValidateDistance(ObstacleDistance_q4mmType Distance);
 
 // Update obstacle state machine
-void ObstacleDetection_UpdateState(ObstacleDistance_cmType DistanceCm);
+void ObstacleDetection_UpdateState(ObstacleDistance_q4mmType Distance);
 
 // Handle invalid measurement behavior
 void ObstacleDetection_HandleInvalidMeasurement(void);
@@ -17,6 +17,9 @@
 // Distance value measured by ultrasonic sensor
 typedef uint16 ObstacleDistance_cmType;
 
+// Distance as carried on RTE (Q4 mm = 1/16 mm, DistConv.h)
+typedef uint16 ObstacleDistance_q4mmType;
+
 // Obstacle detection status
 typedef boolean ObstacleDetectedType;
 
@@ -35,6 +38,18 @@ typedef enum
 	OBSTACLE_STATE_DETECTED
 } ObstracleStateType;
 
+/* ============================================
+ * Calibration type (RAM copy of NVM_BLOCK_OBSTACLE_CAL, defaults from ObstacleDetection_Cfg.h)
+ * ============================================*/
+typedef struct
+{
+	ObstacleDistance_cmType			ThresholdCm;		// obstacle declared below this distance
+	ObstacleDistance_cmType			HysteresisCm;		// clear again above threshold + hysteresis
+	ObstacleDistance_cmType			MinValidCm;
+	ObstacleDistance_cmType			MaxValidCm;
+	uint8							MaxInvalidCount;	// consecutive invalid measurements before fail safe
+} ObstacleDetection_CalibrationType;
+
 /* ============================================
  * Signal group type
  * ============================================*/
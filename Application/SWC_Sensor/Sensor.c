@@ -11,6 +11,8 @@
 #include "Sensor_Internal.h"
 #include "Rte.h"
 #include "SensorIf.h"
+#include "DistConv.h"
+#include "Dem.h"
 
 // Internal Data
 static Sensor_InternalDataType Sensor_InternalData;
@@ -22,42 +24,63 @@ void Sensor_Init(void)
 	Sensor_InternalData.LastDistance	= 0U;
 	Sensor_InternalData.LastMeasurement	= SENSOR_MEAS_INVALID;
 	Sensor_InternalData.TimeoutCounter	= 0U;
+	Sensor_InternalData.CycleCounter	= SENSOR_MEAS_PERIOD_CYCLES;		// first call triggers
+	Sensor_InternalData.Busy			= FALSE;
+	Sensor_InternalData.Requested		= FALSE;
+	Sensor_InternalData.Serving			= FALSE;
+	Sensor_InternalData.ResultReady		= FALSE;
 }
 
-// Periodic runnable
+// Periodic runnable: one trigger per SENSOR_MEAS_PERIOD_MS, the result is read on a later call
 void Sensor_MainFunction(void)
 {
-	Sensor_DistanceCmType	DistanceCm;
-	Std_ReturnType			Ret;
+	Sensor_MeasurementType	Meas;
 
-	// Trigger HC-SR04
-	Sensor_TriggerPulse();
+	// No sensor interface (Icu did not start): nothing to measure, nothing to report
+	if(SensorIf_IsInitialized() == FALSE) return;
 
-	// Read Echo
-	Ret = Sensor_ReadEcho(&DistanceCm);
+	// Echo of the running measurement
+	SensorIf_Mainfunction();
 
-	if(Ret != E_OK)
+	if(Sensor_InternalData.CycleCounter < SENSOR_MEAS_PERIOD_CYCLES)
 	{
-		Sensor_InternalData.Status = SENSOR_STATUS_TIMEOUT;
-		Sensor_InternalData.TimeoutCounter++;
-		return;
+		Sensor_InternalData.CycleCounter++;
 	}
 
-	// Validate distance
-	if(Sensor_ValidateDistance(DistanceCm) != SENSOR_MEAS_VALID)
+	if(Sensor_InternalData.Busy == TRUE)
 	{
-		Sensor_InternalData.Status = SENSOR_STATUS_NO_ECHO;
-		return;
+		if(Sensor_ReadEcho(&Meas) != E_OK)
+		{
+			if(Sensor_InternalData.CycleCounter < SENSOR_MEAS_PERIOD_CYCLES) return;
+
+			// still open a whole period after the trigger: the echo never ended
+			Meas.Distance	= 0U;
+			Meas.EchoUs		= 0U;
+			Meas.Status		= (uint8)SENSORIF_MEAS_TIMEOUT;
+		}
+		Sensor_InternalData.Busy = FALSE;
+
+		if(Sensor_InternalData.Serving == TRUE)
+		{
+			Sensor_InternalData.Result		= Meas;
+			Sensor_InternalData.ResultReady	= TRUE;
+			Sensor_InternalData.Serving		= FALSE;
+		}
+		Sensor_Evaluate(&Meas);
 	}
 
-	// Valid measurement
-	Sensor_InternalData.Status			= SENSOR_STATUS_OK;
-	Sensor_InternalData.LastDistance	= DistanceCm;
-	Sensor_InternalData.LastMeasurement	= SENSOR_MEAS_VALID;
-	Sensor_InternalData.TimeoutCounter	= 0U;
+	if(Sensor_InternalData.CycleCounter < SENSOR_MEAS_PERIOD_CYCLES) return;
 
-	// Send Data to RTE
-	(void)Rte_Write_Distance(DistanceCm);
+	// Trigger HC-SR04
+	Sensor_InternalData.CycleCounter = 0U;
+	if(Sensor_TriggerPulse() != E_OK)
+	{
+		Sensor_InternalData.Status = SENSOR_STATUS_HW_ERROR;
+		return;
+	}
+	Sensor_InternalData.Busy		= TRUE;
+	Sensor_InternalData.Serving		= Sensor_InternalData.Requested;
+	Sensor_InternalData.Requested	= FALSE;
 }
 
 // Get last sensor status
@@ -66,32 +89,90 @@ Sensor_StatusType Sensor_GetStatus(void)
 	return Sensor_InternalData.Status;
 }
 
-// Internal Api
-void Sensor_TriggerPulse(void)
+// Get number of consecutive echo timeouts
+uint8 Sensor_GetTimeoutCounter(void)
+{
+	return Sensor_InternalData.TimeoutCounter;
+}
+
+// One-shot request, served by the next trigger so the result is never older than the request
+Std_ReturnType Sensor_RequestMeasurement(void)
 {
-	(void)SensorIf_TriggerMeasurement();
+	if(SensorIf_IsInitialized() == FALSE) return E_NOT_OK;
+
+	// a measurement running for an earlier, given up request is too old
+	Sensor_InternalData.Serving		= FALSE;
+	Sensor_InternalData.ResultReady	= FALSE;
+	Sensor_InternalData.Requested	= TRUE;
+	return E_OK;
+}
+
+// Requested measurement, taken by the first successful call
+Std_ReturnType Sensor_GetRequestedMeasurement(Sensor_MeasurementType* Meas)
+{
+	if((Meas == NULL_PTR) || (Sensor_InternalData.ResultReady == FALSE)) return E_NOT_OK;
+
+	*Meas = Sensor_InternalData.Result;
+	Sensor_InternalData.ResultReady = FALSE;
+	return E_OK;
 }
 
-Std_ReturnType Sensor_ReadEcho(Sensor_DistanceCmType* DistanceCm)
+// Internal Api
+Std_ReturnType Sensor_TriggerPulse(void)
 {
-	SensorIf_MeasurementType		Meas;
-	SensorIf_StatusType				IfStatus;
+	return (SensorIf_TriggerMeasurement() == SENSORIF_STATUS_OK) ? E_OK : E_NOT_OK;
+}
 
-	if(DistanceCm == NULL_PTR) return E_NOT_OK;
+// E_OK once the triggered measurement is done, whatever its status
+Std_ReturnType Sensor_ReadEcho(Sensor_MeasurementType* Meas)
+{
+	SensorIf_MeasurementType		IfMeas;
 
-	IfStatus = SensorIf_ReadMeasurement(&Meas);
+	if(Meas == NULL_PTR) return E_NOT_OK;
 
-	if(IfStatus != SENSORIF_STATUS_OK) return E_NOT_OK;
-	if(Meas.Status != SENSORIF_MEAS_VALID) return E_NOT_OK;
+	if(SensorIf_ReadMeasurement(&IfMeas) != SENSORIF_STATUS_OK) return E_NOT_OK;
 
-	*DistanceCm = (Sensor_DistanceCmType)Meas.DistanceCm;
+	Meas->Distance	= (Sensor_DistanceQ4MmType)IfMeas.DistanceQ4Mm;
+	Meas->EchoUs	= IfMeas.EchoTimeUs;
+	Meas->Status	= (uint8)IfMeas.Status;
 
 	return E_OK;
 }
 
-Sensor_MeasurementStatusType Sensor_ValidateDistance(Sensor_DistanceCmType DistanceCm)
+// Status, DEM and RTE from one finished measurement
+void Sensor_Evaluate(const Sensor_MeasurementType* Meas)
+{
+	if(Meas->Status != (uint8)SENSORIF_MEAS_VALID)
+	{
+		Sensor_InternalData.Status = SENSOR_STATUS_TIMEOUT;
+		Sensor_InternalData.TimeoutCounter++;
+		(void)Dem_SetEventStatus(DEM_EVENT_SENSOR_TIMEOUT, DEM_EVENT_STATUS_PREFAILED);
+		return;
+	}
+
+	// the sensor answered, whatever the distance
+	(void)Dem_SetEventStatus(DEM_EVENT_SENSOR_TIMEOUT, DEM_EVENT_STATUS_PREPASSED);
+
+	// Validate distance
+	if(Sensor_ValidateDistance(Meas->Distance) != SENSOR_MEAS_VALID)
+	{
+		Sensor_InternalData.Status = SENSOR_STATUS_NO_ECHO;
+		return;
+	}
+
+	// Valid measurement
+	Sensor_InternalData.Status			= SENSOR_STATUS_OK;
+	Sensor_InternalData.LastDistance	= Meas->Distance;
+	Sensor_InternalData.LastMeasurement	= SENSOR_MEAS_VALID;
+	Sensor_InternalData.TimeoutCounter	= 0U;
+
+	// Send Data to RTE
+	(void)Rte_Write_Distance(Meas->Distance);
+}
+
+Sensor_MeasurementStatusType Sensor_ValidateDistance(Sensor_DistanceQ4MmType Distance)
 {
-	if( (DistanceCm > SENSORIF_MAX_DISTANCE_CM) || (DistanceCm < SENSORIF_MIN_DISTANCE_CM))
+	if( (Distance > DISTCONV_CM_TO_Q4(SENSORIF_MAX_DISTANCE_CM)) || (Distance < DISTCONV_CM_TO_Q4(SENSORIF_MIN_DISTANCE_CM)))
 	{
 		return SENSOR_MEAS_INVALID;
 	}
@@ -20,4 +20,13 @@ void Sensor_MainFunction(void);
 // Get last sensor status
 Sensor_StatusType Sensor_GetStatus(void);
 
+// Get number of consecutive echo timeouts
+uint8 Sensor_GetTimeoutCounter(void);
+
+// One-shot request: the next measurement triggered from now is kept for the requester. E_NOT_OK without a sensor
+Std_ReturnType Sensor_RequestMeasurement(void);
+
+// Requested measurement, E_OK once (then taken), E_NOT_OK while it runs
+Std_ReturnType Sensor_GetRequestedMeasurement(Sensor_MeasurementType* Meas);
+
 #endif /* SWC_SENSOR_SENSOR_H_ */
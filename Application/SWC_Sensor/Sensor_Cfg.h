@@ -23,4 +23,12 @@
 // Task period
 #define SENSOR_MAINFUNCTION_PERIOD_MS	(10U)
 
+// Trigger period (HC-SR04: at least 60 ms, the echo of the last burst dies out)
+#define SENSOR_MEAS_PERIOD_MS			(60U)
+#define SENSOR_MEAS_PERIOD_CYCLES		(SENSOR_MEAS_PERIOD_MS / SENSOR_MAINFUNCTION_PERIOD_MS)
+
+#if ((SENSOR_MEAS_PERIOD_MS * 1000U) <= SENSOR_ECHO_TIMEOUT_US)
+#error "SENSOR_MEAS_PERIOD_MS must exceed the echo timeout"
+#endif
+
 #endif /* SWC_SENSOR_SENSOR_CFG_H_ */
@@ -16,14 +16,21 @@
 typedef struct
 {
 	Sensor_StatusType				Status;
-	Sensor_DistanceCmType			LastDistance;
+	Sensor_DistanceQ4MmType			LastDistance;
 	Sensor_MeasurementStatusType	LastMeasurement;
 	uint8							TimeoutCounter;
+	uint8							CycleCounter;		// MainFunction calls since the last trigger
+	boolean							Busy;				// triggered, result not read yet
+	boolean							Requested;			// one-shot request waits for the next trigger
+	boolean							Serving;			// running measurement answers the request
+	boolean							ResultReady;		// Result not taken by the requester yet
+	Sensor_MeasurementType			Result;
 } Sensor_InternalDataType;
 
 // Internal Api
-void Sensor_TriggerPulse(void);
-Std_ReturnType Sensor_ReadEcho(Sensor_DistanceCmType* DistanceCm);
-Sensor_MeasurementStatusType Sensor_ValidateDistance(Sensor_DistanceCmType DistanceCm);
+Std_ReturnType Sensor_TriggerPulse(void);
+Std_ReturnType Sensor_ReadEcho(Sensor_MeasurementType* Meas);
+void Sensor_Evaluate(const Sensor_MeasurementType* Meas);
+Sensor_MeasurementStatusType Sensor_ValidateDistance(Sensor_DistanceQ4MmType Distance);
 
 #endif /* SWC_SENSOR_SENSOR_INTERNAL_H_ */
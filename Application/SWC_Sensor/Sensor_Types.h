@@ -12,8 +12,8 @@
 
 #include "Std_Types.h"
 
-// Distance type
-typedef uint16 Sensor_DistanceCmType;
+// Distance type (Q4 mm = 1/16 mm, see DistConv.h)
+typedef uint16 Sensor_DistanceQ4MmType;
 
 // Sensor status
 typedef enum
@@ -31,4 +31,12 @@ typedef enum
 	SENSOR_MEAS_VALID
 } Sensor_MeasurementStatusType;
 
+// One measurement as read from SensorIf
+typedef struct
+{
+	Sensor_DistanceQ4MmType		Distance;
+	uint32						EchoUs;
+	uint8						Status;		// SensorIf_MeasurementStatusType
+} Sensor_MeasurementType;
+
 #endif /* SWC_SENSOR_SENSOR_TYPES_H_ */
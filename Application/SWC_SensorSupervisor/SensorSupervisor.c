@@ -9,6 +9,8 @@
 
 #include "SensorSupervisor.h"
 #include "SensorSupervisor_Cfg.h"
+#include "DistConv.h"
+#include "Dem.h"
 
 /* ============================================
  * Static internal data
@@ -52,24 +54,28 @@ void SensorSupervisor_Runnable_10ms(void)
 	{
 		// Read failed
 		SensorSupervisor_Status = SENSOR_SUPERVISOR_SENSOR_ERROR;
+		(void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_MISSING, DEM_EVENT_STATUS_PREFAILED);
 		return;
 	}
+	(void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_MISSING, DEM_EVENT_STATUS_PREPASSED);
 
 	// Store last receiver distance
 	SensorSupervisor_LastDistance = Distance;
 
 	// Valid distance range
-	if((Distance < SENSOR_SUPERVISOR_MIN_VALID_DISTANCE_MM) || (Distance > SENSOR_SUPERVISOR_MAX_VALID_DISTANCE_MM))
+	if((Distance < DISTCONV_MM_TO_Q4(SENSOR_SUPERVISOR_MIN_VALID_DISTANCE_MM)) || (Distance > DISTCONV_MM_TO_Q4(SENSOR_SUPERVISOR_MAX_VALID_DISTANCE_MM)))
 	{
 		SensorSupervisor_Status = SENSOR_SUPERVISOR_SENSOR_INVALID;
 		SensorSupervisor_ObstacleDecition = SENSOR_SUPERVISOR_OBSTACLE_UNKNOWN;
+		(void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_RANGE, DEM_EVENT_STATUS_PREFAILED);
 		return;
 	}
 
 	SensorSupervisor_Status = SENSOR_SUPERVISOR_SENSOR_OK;
+	(void)Dem_SetEventStatus(DEM_EVENT_DISTANCE_RANGE, DEM_EVENT_STATUS_PREPASSED);
 
 	// Obstacle decision logic
-	if(Distance <= SENSOR_SUPERVISOR_OBSTACLE_THRESHOLD_MM )
+	if(Distance <= DISTCONV_MM_TO_Q4(SENSOR_SUPERVISOR_OBSTACLE_THRESHOLD_MM))
 	{
 		SensorSupervisor_ObstacleDecition = SENSOR_SUPERVISOR_OBSTACLE_DETECTED;
 
@@ -14,18 +14,34 @@
 #include "EcuM.h"
 #include "Det.h"
 #include "Rte.h"
+#include "Logger.h"
+#include "UartIf.h"
+#include "Telemetry.h"
+#include "Shell.h"
+#include "DistConv.h"
+#include "Bench.h"
+#include "StackMon.h"
+#include "Dem.h"
+#include "NvM.h"
+#include "Fls.h"
+#include "Mcu.h"
+#include "Com.h"
+#include "Can.h"
+#include "CanSM.h"
+#include "CanNm.h"
 
 /* ============================================
  * Includes - Application SWCs
  * ============================================*/
+#include "Sensor.h"
 #include "ObstacleDetection.h"
 #include "SensorSupervisor.h"
 
 /* ============================================================
  *  Local Variables
  * ============================================================ */
-// System tick counter
-static uint32 SystemApp_TickMs = 0U;
+// Tick the cyclic SWCs last ran in, the loop passes many times per millisecond
+static uint32 SystemApp_LastCycleMs = 0xFFFFFFFFU;
 
 /* ============================================================
  *  Public API Implementation
@@ -36,28 +52,95 @@ void SystemApp_Init(void)
 	// RTE Init
 	Rte_Init();
 
+	// Ambient compensation of echo -> distance (reads RTE inputs)
+	DistConv_Init();
+
 	// SWC Init
+	Sensor_Init();
 	ObstacleDetection_Init();
 	SensorSupervisor_Init();
+
+#if (BENCH_CFG_ENABLE == 1u)
+	// cycle counter only, the suite is started from the shell ("bench")
+	Bench_Init(&Bench_Config);
+#endif
 }
 
 // Periodic main function of System Application
 void SystemApp_MainFunction(void)
 {
+	// Bus asleep: nothing to measure or report. EcuM takes a latched CAN wake-up back to validation (controller on
+	// the bus again), otherwise halt the core until the next interrupt (SysTick, CAN wake-up)
+	if(EcuM_GetState() == ECUM_STATE_SLEEP)
+	{
+		Can_MainFunction_Wakeup();
+#if (ECUM_ENABLE_MAINFUNCTION == 1u)
+		EcuM_MainFunction();
+#endif
+		if(EcuM_GetState() == ECUM_STATE_SLEEP)
+		{
+			Mcu_WaitForInterrupt();
+			return;
+		}
+	}
+
+	// Background services: bounded work, never wait on the UART
+	UartIf_MainFunction();		// feeds Shell_RxIndication
+	Shell_MainFunction();
+	Logger_MainFunction();
+	StackMon_MainFunction();	// high-water mark, a few words per call
+	NvM_MainFunction();			// write-behind, starts Fls jobs
+	Fls_MainFunction();			// polls the job, never waits on BSY
+	Can_MainFunction_Tx();		// confirmation of the single mailbox
+	Can_MainFunction_Rx();		// one frame of FIFO 0 per call
+	Can_MainFunction_BusOff();	// bus-off latched by the SCE interrupt: controller stopped, CanSM recovers it
+#if (BENCH_CFG_ENABLE == 1u)
+	Bench_MainFunction();		// one case per call while a run is active
+#endif
+
+	// Cyclic SWCs once per SysTick (1 ms, started by EcuM): debounce counters and times count calls
+	uint32 tickMs = s_systickTicks;
+	if(tickMs == SystemApp_LastCycleMs)
+	{
+		return;
+	}
+	SystemApp_LastCycleMs = tickMs;
 
 	// Check if it's time to run cyclic SWCs
-	if((SystemApp_TickMs % 10U) == 0U)
+	if((tickMs % 10U) == 0U)
 	{
+		// Received signals and their deadlines before the SWCs read them
+		Com_MainFunctionRx();
+
+		// Sensor acquisition: trigger / echo result, one-shot requests of the shell
+		Sensor_MainFunction();
+
 		// Obstacle detection logic
 		ObstacleDetection_MainFunction();
 
 		// Sensor supervision & decision
 		SensorSupervisor_Runnable_10ms();
+
+		// Time-based debouncing of the events reported above
+		Dem_MainFunction();
+
+		// Binary telemetry of the values above (decimated internally)
+		Telemetry_MainFunction();
+
+		// Cyclic I-PDUs and Tx deadlines with the values written above
+		Com_MainFunctionTx();
+
+		// Network and ECU state: NM PDUs and bus sleep, controller mode and recovery, wake-up validation
+		CanNm_MainFunction();
+		CanSM_MainFunction();
+#if (ECUM_ENABLE_MAINFUNCTION == 1u)
+		EcuM_MainFunction();
+#endif
 	}
-}
 
-// Update system tick counter
-void SystemApp_Tick1ms(void)
-{
-	SystemApp_TickMs++;
+	// Slow: ambient temperature / humidity for speed of sound
+	if((tickMs % 100U) == 0U)
+	{
+		DistConv_MainFunction();
+	}
 }
@@ -30,8 +30,5 @@ void SystemApp_Init(void);
 // Periodic main function of System Application
 void SystemApp_MainFunction(void);
 
-// Update system tick counter
-void SystemApp_Tick1ms(void);
-
 
 #endif /* SYSTEMAPP_H_ */
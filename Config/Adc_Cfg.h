@@ -0,0 +1,21 @@
+/* =====================================================================================================================
+ *  File        : Adc_Cfg.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Config Adc driver
+ *  Notes       :
+ * ===================================================================================================================*/
+
+#ifndef ADC_CFG_H_
+#define ADC_CFG_H_
+
+#include "Adc_Types.h"
+
+// Internal temperature sensor, needs >= 17.1 us sampling: 239.5 clk @ 12 MHz = 20 us
+#define ADC_GROUP_TEMPSENSOR		0
+#define ADC_GROUP_COUNT				1
+
+// Busy wait bound for power up / calibration (loop iterations)
+#define ADC_CFG_CAL_TIMEOUT			(100000u)
+
+#endif /* ADC_CFG_H_ */
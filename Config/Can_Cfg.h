@@ -25,6 +25,12 @@ extern "C" {
 #define CAN_BIT_SEGMENT_2_CTL0			4
 #define CAN_PREC_SCALE_CTL0				4
 
+/* REG_POLL rounds a mode change (INAK) may take before the driver gives up. Entering / leaving init waits
+ * for 11 recessive bits (22 us at 500 kbit/s), a bus stuck dominant or a missing clock never acknowledges */
+#ifndef CAN_CFG_MODE_TIMEOUT_POLLS
+#define CAN_CFG_MODE_TIMEOUT_POLLS		(10000u)
+#endif
+
 #if __cplusplus
 }
 #endif
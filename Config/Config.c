@@ -12,6 +12,8 @@
 #include "Gpt_Cfg.h"
 #include "Can_Cfg.h"
 #include "Icu_Cfg.h"
+#include "Adc_Cfg.h"
+#include "Irq_Cfg.h"
 
 // Config for Mcu
 const Mcu_ConfigType Mcu_Config = {
@@ -36,6 +38,22 @@ const Mcu_ConfigType Mcu_Config = {
 							}
 };
 
+// Interrupt plan: every line the image may enable, levels from Mcu_Cfg.h
+static const Irq_LineCfgType Irq_Lines[] = {
+		{ .Irqn = IRQ_NUM_TIM2,				.Preempt = MCU_PRIO_TIM2_ICU_PREEMPT,	.Sub = MCU_PRIO_TIM2_ICU_SUB },
+		{ .Irqn = IRQ_NUM_USB_HP_CAN1_TX,	.Preempt = MCU_PRIO_CAN_TX_PREEMPT,		.Sub = MCU_PRIO_CAN_TX_SUB },
+		{ .Irqn = IRQ_NUM_USB_LP_CAN1_RX0,	.Preempt = MCU_PRIO_CAN_RX0_PREEMPT,	.Sub = MCU_PRIO_CAN_RX0_SUB },
+		{ .Irqn = IRQ_NUM_CAN1_SCE,			.Preempt = MCU_PRIO_CAN_SCE_PREEMPT,	.Sub = MCU_PRIO_CAN_SCE_SUB },
+		{ .Irqn = IRQ_NUM_USART1,			.Preempt = MCU_PRIO_USART1_PREEMPT,		.Sub = MCU_PRIO_USART1_SUB },
+		{ .Irqn = IRQ_NUM_SYSTICK,			.Preempt = MCU_PRIO_SYSTICK_PREEMPT,	.Sub = MCU_PRIO_SYCTICK_SUB },
+};
+
+const Irq_ConfigType Irq_Config = {
+		.Lines			= Irq_Lines,
+		.LineCount		= (uint8)(sizeof(Irq_Lines) / sizeof(Irq_LineCfgType)),
+		.PriGroup		= IRQ_CFG_PRIGROUP
+};
+
 // Config for Uart
 const Uart_ConfigType Uart_Config = {
 		.useCh1				= UART_CFG_INSTANCE_USART1,
@@ -84,7 +102,11 @@ static const Port_PinConfigType s_PortPins[] = {
 		{ .pin = PORT_PIN_CAN1_RX, .mode = PORT_MODE_INPUT_FLOATING, .initLevel = PORT_INIT_LOW},
 
 		//HSRC04
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+		{ .pin = PORT_PIN_HCSR04_TRIG, .mode = PORT_MODE_AF_PP_2M, .initLevel = PORT_INIT_LOW},		// TIM2_CH2
+#else
 		{ .pin = PORT_PIN_HCSR04_TRIG, .mode = PORT_MODE_OUTPUT_PP_2M, .initLevel = PORT_INIT_LOW},
+#endif
 		{ .pin = PORT_PIN_HCSR04_ECHO, .mode = PORT_MODE_INPUT_FLOATING, .initLevel = PORT_INIT_LOW}
 };
 
@@ -152,3 +174,17 @@ const Icu_ConfigType Icu_Config = {
 		.channels = s_IcuChannelConfigs,
 		.numsChannel = ICU_CNT_CHANNEL
 };
+
+// Config for ADC
+static const Adc_GroupConfigType s_AdcGroupConfigs[] = {
+		{
+				.GroupId	= ADC_GROUP_TEMPSENSOR,
+				.Channel	= ADC_CHANNEL_TEMPSENSOR,
+				.SampleTime	= ADC_SMP_239_5
+		}
+};
+
+const Adc_ConfigType Adc_Config = {
+		.GroupConfig	= s_AdcGroupConfigs,
+		.GroupCount		= ADC_GROUP_COUNT
+};
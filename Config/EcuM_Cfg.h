@@ -119,6 +119,22 @@ typedef uint32 EcuM_WakeupSourceType;
 #define ECU_WAKEUP_CAN_TX		((EcuM_WakeupSourceType)(1u << 0))
 #define ECU_WAKEUP_TIMER		((EcuM_WakeupSourceType)(1u << 1))
 #define ECU_WAKEUP_EXTI			((EcuM_WakeupSourceType)(1u << 2))
+#define ECU_WAKEUP_CAN_BUS		((EcuM_WakeupSourceType)(1u << 3))	//bxCAN asleep saw a frame (AWUM, WKUI)
+
+/* =========================================================
+ * Sleep / wake-up
+ * - a wake-up starts the stack receive only, it counts once a user
+ *   validates it (CanNm: NM PDU for this ECU), else back to sleep
+ * =======================================================*/
+// Call period of EcuM_MainFunction
+#ifndef ECUM_CFG_MAINFUNCTION_PERIOD_MS
+#define ECUM_CFG_MAINFUNCTION_PERIOD_MS		(10u)
+#endif
+
+// Longer than the NM message cycle: the frame that woke the controller is lost, the next one validates
+#ifndef ECUM_CFG_WAKEUP_VALIDATION_MS
+#define ECUM_CFG_WAKEUP_VALIDATION_MS		(250u)
+#endif
 
 /* =========================================================
  * Compile-time hints
@@ -129,6 +145,10 @@ typedef uint32 EcuM_WakeupSourceType;
 #endif
 #endif
 
+#if (ECUM_CFG_MAINFUNCTION_PERIOD_MS == 0u)
+#error "ECUM_CFG_MAINFUNCTION_PERIOD_MS must not be 0"
+#endif
+
 /*CAN stack define order: Mcu->Port->CAN->Canif->Pdur->Com*/
 #if defined(ECUM_ENFORCE_CAN_DEP) && (ECUM_ENFORCE_CAN_DEP == 1u)
 
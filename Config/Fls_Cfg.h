@@ -0,0 +1,36 @@
+/* =====================================================================================================================
+ *  File        : Fls_Cfg.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Config parameter for the internal flash driver.
+ *  Notes       : C6T6: 32 KB main flash, 32 pages of 1 KB
+ * ===================================================================================================================*/
+
+#ifndef FLS_CFG_H_
+#define FLS_CFG_H_
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "Fls_Types.h"
+#include "stm32f103xx_regs.h"
+
+#define FLS_CFG_BASE_ADDRESS			(FLASH_MEM_BASE)
+#define FLS_CFG_TOTAL_SIZE				(0x8000UL)
+#define FLS_CFG_PAGE_SIZE				(0x400UL)
+
+/* Pages below this address hold the image and are refused by Fls_Erase / Fls_Write */
+#ifndef FLS_CFG_WRITABLE_START
+#define FLS_CFG_WRITABLE_START			(FLS_CFG_BASE_ADDRESS + 0x7800UL)
+#endif
+
+#if ((FLS_CFG_WRITABLE_START % FLS_CFG_PAGE_SIZE) != 0u)
+#error "FLS_CFG_WRITABLE_START must be page aligned"
+#endif
+
+#if __cplusplus
+}
+#endif
+
+#endif /* FLS_CFG_H_ */
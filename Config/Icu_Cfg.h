@@ -22,6 +22,20 @@ extern "C" {
 #define ICU_CHANNEL_1			1
 #define ICU_CNT_CHANNEL			1
 
+/*
+ * HC-SR04 ranging in hardware (TIM2 @ 1 MHz shared with Gpt):
+ *  - CH2 (PA1, AF push-pull) drives TRIG: forced high, released by CCR2 compare
+ *  - CH1 (PA0) captures ECHO, armed in the CC2 interrupt (trigger falling edge)
+ *  - CH3 compare = trigger end + timeout, ends a measurement without echo
+ * 0: legacy SW trigger on Dio + free-running CH1 capture
+ */
+#ifndef ICU_CFG_HCSR04_HW_TRIGGER
+#define ICU_CFG_HCSR04_HW_TRIGGER	(1u)
+#endif
+
+// counter bit width of TIM2 on STM32F1
+#define ICU_TIMER_MASK				(0xFFFFu)
+
 #ifdef __cplusplus
 }
 #endif
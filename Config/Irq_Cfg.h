@@ -0,0 +1,29 @@
+/* =====================================================================================================================
+ *  File        : Irq_Cfg.h
+ *  Layer		: MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Configure interrupt manager (MCAL/Irq), levels come from Mcu_Cfg.h
+ *  Notes       : The line table (Irq_Config) is in Config.c
+ * ===================================================================================================================*/
+
+#ifndef IRQ_CFG_H_
+#define IRQ_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Irq_Types.h"
+#include "Mcu_Cfg.h"
+
+/* Priority grouping applied by Irq_Init */
+#define IRQ_CFG_PRIGROUP				MCU_CFG_NVIC_PRIGROUP
+
+/* First bit of the preemption field in a priority byte (4 implemented bits, 7:4) */
+#define IRQ_CFG_PREEMPT_SHIFT			((IRQ_CFG_PRIGROUP < 3u) ? 4u : ((uint32)IRQ_CFG_PRIGROUP + 1u))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_CFG_H_ */
@@ -8,13 +8,102 @@
 
 #include "CanIf.h"
 #include "Can.h"
+#include "PduR.h"
+#include "CanSM.h"
+#include "CanNm.h"
+#include "EcuM.h"
 
 static const CanIf_ConfigType* CanIf_CfgPtr = NULL_PTR;
 static boolean CanIf_Inited = FALSE;
+static boolean CanIf_RxSorted = FALSE;		// FALSE: exact table is scanned linearly
+static CanIf_PduModeType CanIf_PduMode = CANIF_ONLINE;
 
+/* =================== PRIVATE FUNCTIONS =================== */
+// Binary search needs ascending, unique IDs; a hand-edited table that breaks this still works, only slower
+static boolean prv_RxTableSorted(const CanIf_ConfigType* cfg)
+{
+	uint16 i;
+
+	for(i = 1u; i < cfg->NumRxPdu; i++)
+	{
+		if(cfg->RxPduConfig[i].CanId <= cfg->RxPduConfig[i - 1u].CanId) return FALSE;
+	}
+	return TRUE;
+}
+
+static const CanIf_RxPduConfigType* prv_FindExact(CanIf_CanIdType CanId)
+{
+	const CanIf_RxPduConfigType* tab = CanIf_CfgPtr->RxPduConfig;
+	uint16 lo = 0u;
+	uint16 hi = CanIf_CfgPtr->NumRxPdu;
+
+	if(tab == NULL_PTR) return NULL_PTR;
+
+	if(CanIf_RxSorted == FALSE)
+	{
+		for(lo = 0u; lo < hi; lo++)
+		{
+			if(tab[lo].CanId == CanId) return &tab[lo];
+		}
+		return NULL_PTR;
+	}
+
+	// [lo, hi) holds the ID if present
+	while(lo < hi)
+	{
+		uint16 mid = (uint16)((lo + hi) >> 1);
+
+		if(tab[mid].CanId < CanId)			lo = (uint16)(mid + 1u);
+		else if(tab[mid].CanId > CanId)		hi = mid;
+		else								return &tab[mid];
+	}
+	return NULL_PTR;
+}
+
+static const CanIf_RxMaskConfigType* prv_FindMask(CanIf_CanIdType CanId)
+{
+	const CanIf_RxMaskConfigType* tab = CanIf_CfgPtr->RxMaskConfig;
+	uint8 i;
+
+	if(tab == NULL_PTR) return NULL_PTR;
+
+	for(i = 0u; i < CanIf_CfgPtr->NumRxMask; i++)
+	{
+		if((CanId & tab[i].Mask) == tab[i].Code) return &tab[i];
+	}
+	return NULL_PTR;
+}
+
+// Rx PDU and its user of a CAN ID: exact table first, then the mask entries
+static Std_ReturnType prv_Lookup(Can_IdType CanId, PduIdType* RxPduIdPtr, CanIf_UserType* UserPtr)
+{
+	const CanIf_RxPduConfigType* exact;
+	const CanIf_RxMaskConfigType* masked;
+
+	exact = prv_FindExact((CanIf_CanIdType)CanId);
+	if(exact != NULL_PTR)
+	{
+		*RxPduIdPtr	= exact->RxPduId;
+		*UserPtr	= exact->User;
+		return E_OK;
+	}
+
+	masked = prv_FindMask((CanIf_CanIdType)CanId);
+	if(masked != NULL_PTR)
+	{
+		*RxPduIdPtr	= masked->RxPduId;
+		*UserPtr	= masked->User;
+		return E_OK;
+	}
+	return E_NOT_OK;
+}
+
+/* =================== API =================== */
 void CanIf_Init(const CanIf_ConfigType* ConfigPtr)
 {
 	CanIf_CfgPtr = ConfigPtr;
+	CanIf_RxSorted = (ConfigPtr != NULL_PTR) ? prv_RxTableSorted(ConfigPtr) : FALSE;
+	CanIf_PduMode = CANIF_ONLINE;
 	CanIf_Inited = TRUE;
 
 }
@@ -28,12 +117,15 @@ Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType* PduInfoPtr)
 	{
 		return E_NOT_OK;
 	}
+	if((PduInfoPtr == NULL_PTR) || (PduInfoPtr->SduLength > CAN_MAX_PDU_LENGTH)) return E_NOT_OK;
+	if((PduInfoPtr->SduDataPtr == NULL_PTR) && (PduInfoPtr->SduLength != 0u)) return E_NOT_OK;
+	if(CanIf_PduMode != CANIF_ONLINE) return E_NOT_OK;
 
 	txCfg = &CanIf_CfgPtr->TxPduConfig[TxPduId];
 
 	canPdu.Id			= txCfg->CanId;
 	canPdu.sdu			= PduInfoPtr->SduDataPtr;
-	canPdu.length		= PduInfoPtr->SduLength;
+	canPdu.length		= (uint8)PduInfoPtr->SduLength;
 	canPdu.swpduHandle	= TxPduId;
 
 	return Can_Write(txCfg->Hoh, &canPdu);
@@ -41,11 +133,106 @@ Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType* PduInfoPtr)
 
 void CanIf_TxConfirmation(PduIdType TxPduId)
 {
+	if((CanIf_CfgPtr == NULL_PTR) || (TxPduId >= CanIf_CfgPtr->NumTxPdu)) return;
 
+	if(CanIf_CfgPtr->TxPduConfig[TxPduId].User == CANIF_UL_CANNM)
+	{
+		CanNm_TxConfirmation(TxPduId);
+		return;
+	}
+	PduR_CanIfTxConfirmation(TxPduId);
+}
+
+/*
+ * Can driver Tx callback (overrides the weak one in Can.c).
+ * SwPduHandle is the swpduHandle CanIf_Transmit put into the Can_PduType, i.e. the CanIf Tx PDU id
+ */
+void Can_TxConfirmation(Can_HwHandleType SwPduHandle)
+{
+	CanIf_TxConfirmation((PduIdType)SwPduHandle);
+}
+
+Std_ReturnType CanIf_GetRxPduId(Can_IdType CanId, PduIdType* RxPduIdPtr)
+{
+	CanIf_UserType user;
+
+	if((CanIf_Inited == FALSE) || (CanIf_CfgPtr == NULL_PTR) || (RxPduIdPtr == NULL_PTR)) return E_NOT_OK;
+
+	return prv_Lookup(CanId, RxPduIdPtr, &user);
 }
 
 void CanIf_RxIndication( PduIdType RxPduId, const PduInfoType* PduInfoPtr)
 {
-	if(RxPduId >= CanIf_CfgPtr->NumRxPdu) return;
+	if((CanIf_CfgPtr == NULL_PTR) || (PduInfoPtr == NULL_PTR)) return;
+
+	PduR_CanIfRxIndication(RxPduId, PduInfoPtr);
+}
+
+/*
+ * Can driver Rx callback (overrides the weak one in Can.c).
+ * The SDU is handed up in the driver's buffer, valid until this call returns.
+ */
+void Can_RxIndication(Can_HwHandleType Hrh, const Can_PduType* PduInfo)
+{
+	PduIdType rxPduId;
+	CanIf_UserType user;
+	PduInfoType pdu;
+
+	(void)Hrh;
+	if((PduInfo == NULL_PTR) || (CanIf_Inited == FALSE) || (CanIf_CfgPtr == NULL_PTR)) return;
+	if(prv_Lookup(PduInfo->Id, &rxPduId, &user) != E_OK) return;		// software filter: not for us
+
+	pdu.SduDataPtr	= PduInfo->sdu;
+	pdu.MetaDataPtr	= NULL_PTR;
+	pdu.SduLength	= (PduLengthType)PduInfo->length;
+
+	if(user == CANIF_UL_CANNM)
+	{
+		CanNm_RxIndication(rxPduId, &pdu);
+		return;
+	}
+	CanIf_RxIndication(rxPduId, &pdu);
+}
+
+void CanIf_ControllerBusOff(uint8 ControllerId)
+{
+	CanSM_ControllerBusOff(ControllerId);
+}
+
+/*
+ * Can driver bus-off callback (overrides the weak one in Can.c), task context of Can_MainFunction_BusOff
+ */
+void Can_ControllerBusOff(uint8 Controller)
+{
+	CanIf_ControllerBusOff(Controller);
+}
+
+void CanIf_ControllerWakeup(uint8 ControllerId)
+{
+	(void)ControllerId;
+	EcuM_SetWakeupEvent(ECU_WAKEUP_CAN_BUS);
+}
+
+/*
+ * Can driver wake-up callback (overrides the weak one in Can.c), SCE interrupt
+ */
+void Can_ControllerWakeup(uint8 Controller)
+{
+	CanIf_ControllerWakeup(Controller);
+}
+
+Std_ReturnType CanIf_SetPduMode(uint8 ControllerId, CanIf_PduModeType PduModeRequest)
+{
+	if((ControllerId != 0u) || (CanIf_Inited == FALSE) || (PduModeRequest > CANIF_ONLINE)) return E_NOT_OK;
+
+	CanIf_PduMode = PduModeRequest;
+	return E_OK;
+}
+
+Std_ReturnType CanIf_GetPduMode(uint8 ControllerId, CanIf_PduModeType* PduModePtr)
+{
+	if((ControllerId != 0u) || (CanIf_Inited == FALSE) || (PduModePtr == NULL_PTR)) return E_NOT_OK;
 
+	*PduModePtr = CanIf_PduMode;
+	return E_OK;
 }
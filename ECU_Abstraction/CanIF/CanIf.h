@@ -35,6 +35,25 @@ typedef uint32 CanIf_CanIdType;
  */
 typedef uint8 CanIf_HohType;
 
+/*
+ * Upper layer of a PDU: Rx indication / Tx confirmation go to PduR (Com) or CanNm, each with its own PDU ID space
+ */
+typedef enum
+{
+	CANIF_UL_PDUR		= 0,
+	CANIF_UL_CANNM
+} CanIf_UserType;
+
+/*
+ * PDU channel mode of the controller. TX_OFFLINE: frames are still received (wake-up validation, prepare bus-sleep),
+ * CanIf_Transmit refuses every request
+ */
+typedef enum
+{
+	CANIF_TX_OFFLINE	= 0,
+	CANIF_ONLINE
+} CanIf_PduModeType;
+
 /*
  * Mapping between upper layer PDU and CAN hw
  */
@@ -44,18 +63,34 @@ typedef struct
 	PduIdType			TxPduId;
 	CanIf_CanIdType		CanId;
 	CanIf_HohType		Hoh;
+	CanIf_UserType		User;
 } CanIf_TxPduConfigType;
 
 /*
  * Mapping between received CAN ID  and upper layer PDU
+ * Table is sorted by CanId, ascending and unique (binary search). Extended IDs carry
+ * CAN_ID_EXTENDED, so they sort after all standard IDs.
  */
 
 typedef struct
 {
 	PduIdType			RxPduId;
 	CanIf_CanIdType		CanId;
+	CanIf_UserType		User;
 } CanIf_RxPduConfigType;
 
+/*
+ * Software filter for IDs not in the exact table: (CanId & Mask) == Code, first match wins.
+ * An aligned range (e.g. all J1939 source addresses of one PGN) is a single mask entry.
+ */
+typedef struct
+{
+	PduIdType			RxPduId;
+	CanIf_CanIdType		Code;
+	CanIf_CanIdType		Mask;
+	CanIf_UserType		User;
+} CanIf_RxMaskConfigType;
+
 /*
  * Global CanIf configuration
  */
@@ -63,8 +98,10 @@ typedef struct
 {
 	CanIf_TxPduConfigType*			TxPduConfig;
 	uint8							NumTxPdu;
-	CanIf_RxPduConfigType*			RxPduConfig;
-	uint8							NumRxPdu;
+	const CanIf_RxPduConfigType*	RxPduConfig;
+	uint16							NumRxPdu;
+	const CanIf_RxMaskConfigType*	RxMaskConfig;
+	uint8							NumRxMask;
 } CanIf_ConfigType;
 
 /* =====================================================================================================================
@@ -72,12 +109,50 @@ typedef struct
  * ===================================================================================================================*/
 void CanIf_Init(const CanIf_ConfigType* CanConfigPtr);
 
+/*
+ * SduLength is the DLC of the frame (0 .. CAN_MAX_PDU_LENGTH)
+ * E_NOT_OK: unknown PDU, no data, too long for the controller, CANIF_TX_OFFLINE or mailbox busy
+ */
 Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType* PduInfoPtr);
 
+// To the user of the Tx PDU (PduR or CanNm)
 void CanIf_TxConfirmation(PduIdType TxPduId);
 
+// PduR Rx PDU (CanNm PDUs go to CanNm_RxIndication from the driver callback)
 void CanIf_RxIndication( PduIdType RxPduId, const PduInfoType* PduInfoPtr);
 
+/*
+ * Rx PDU of a CAN ID: exact table first, then the mask entries
+ * E_NOT_OK: not initialised or the frame is not for this ECU
+ */
+Std_ReturnType CanIf_GetRxPduId(Can_IdType CanId, PduIdType* RxPduIdPtr);
+
+// Controller went bus-off and is stopped, forwarded to CanSM (recovery)
+void CanIf_ControllerBusOff(uint8 ControllerId);
+
+// Sleeping controller saw bus activity, EcuM wake-up event ECU_WAKEUP_CAN_BUS (interrupt context)
+void CanIf_ControllerWakeup(uint8 ControllerId);
+
+// CANIF_ONLINE after CanIf_Init
+Std_ReturnType CanIf_SetPduMode(uint8 ControllerId, CanIf_PduModeType PduModeRequest);
+Std_ReturnType CanIf_GetPduMode(uint8 ControllerId, CanIf_PduModeType* PduModePtr);
+
+/* =====================================================================================================================
+ *  Configuration
+ * ===================================================================================================================*/
+// Rx PDU IDs (index space of PduR CanIf routes)
+#define CANIF_RX_PDU_SENSOR_DISTANCE		((PduIdType)0)
+
+// Rx PDU IDs of CanNm (all NM identifiers, one PDU)
+#define CANIF_RX_PDU_NM						((PduIdType)0)
+
+// Tx PDU IDs
+#define CANIF_TX_PDU_VEHICLE				((PduIdType)0)
+#define CANIF_TX_PDU_SENSOR_STATUS			((PduIdType)1)
+#define CANIF_TX_PDU_NM						((PduIdType)2)
+
+extern const CanIf_ConfigType				CanIf_Config;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,37 @@
+/* =====================================================================================================================
+ *  File        : CanIf_PBcfg.c
+ *  Layer       : Abstraction
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Config for CanIf: Tx PDUs, Rx lookup tables
+ *  Notes       : RxPduConfig must stay sorted by CanId (standard IDs first, then CAN_ID_EXTENDED ones),
+ * 				  CanIf_Init falls back to a linear scan otherwise
+ *  Depends     : CanIf.h
+ * ===================================================================================================================*/
+
+#include "CanIf.h"
+
+// Tx PDUs, index = CanIf Tx PDU ID (PduR Tx route destination)
+static CanIf_TxPduConfigType CanIf_TxPduConfigList[] = {
+		{ .TxPduId = CANIF_TX_PDU_VEHICLE,			.CanId = 0x200u,	.Hoh = 0u },
+		{ .TxPduId = CANIF_TX_PDU_SENSOR_STATUS,	.CanId = 0x210u,	.Hoh = 0u },
+		{ .TxPduId = CANIF_TX_PDU_NM,				.CanId = 0x521u,	.Hoh = 0u,	.User = CANIF_UL_CANNM },	// 0x500 + node 0x21
+};
+
+// Rx exact IDs, ascending
+static const CanIf_RxPduConfigType CanIf_RxPduConfigList[] = {
+		{ .RxPduId = CANIF_RX_PDU_SENSOR_DISTANCE,	.CanId = 0x100u },
+};
+
+// Rx ranges: NM identifiers 0x500 .. 0x53F (0x500 + source node)
+static const CanIf_RxMaskConfigType CanIf_RxMaskConfigList[] = {
+		{ .RxPduId = CANIF_RX_PDU_NM,	.Code = 0x500u,	.Mask = CAN_ID_EXTENDED | 0x7C0u,	.User = CANIF_UL_CANNM },
+};
+
+const CanIf_ConfigType CanIf_Config = {
+		.TxPduConfig	= CanIf_TxPduConfigList,
+		.NumTxPdu		= (uint8)(sizeof(CanIf_TxPduConfigList) / sizeof(CanIf_TxPduConfigType)),
+		.RxPduConfig	= CanIf_RxPduConfigList,
+		.NumRxPdu		= (uint16)(sizeof(CanIf_RxPduConfigList) / sizeof(CanIf_RxPduConfigType)),
+		.RxMaskConfig	= CanIf_RxMaskConfigList,
+		.NumRxMask		= (uint8)(sizeof(CanIf_RxMaskConfigList) / sizeof(CanIf_RxMaskConfigType)),
+};
@@ -11,8 +11,8 @@
 #include "Gpt.h"
 #include "Gpt_Cfg.h"
 #include "Port_Cfg.h"
-
-#define SENSORIF_US_TO_CM(us)		((us)/58U)
+#include "Icu.h"
+#include "DistConv.h"
 
 /* ============================================================
  *  Local types
@@ -37,34 +37,60 @@ static SensorIf_InternalStateType	SensorIf_State = SENSORIF_STATE_UNINIT;
 static SensorIf_MeasurementType SensorIf_LastMeasurement;
 
 // Timing
+#if (ICU_CFG_HCSR04_HW_TRIGGER != 1u)
 static uint32 EchoStartTick 	= 0U;
 static uint32 EchoEndTick		= 0U;
+#endif
 static uint32 TimeoutTick		= 0U;
 
 /* ============================================================
  *	MCAL Abstraction
  * ============================================================ */
 // These functions represent MCAL access
+#if (ICU_CFG_HCSR04_HW_TRIGGER != 1u)
 static void SensorIf_Mcal_SetTriggerHigh(void)
 {
-	Dio_WriteChannel(PORT_PIN_HCSR04_TRIG, TRUE);
+	Dio_WriteChannelFast(PORT_PIN_HCSR04_TRIG, PORT_PIN_LEVEL_HIGH);
 }
 
 static void SensorIf_Mcal_SetTriggerLow(void)
 {
-	Dio_WriteChannel(PORT_PIN_HCSR04_TRIG, FALSE);
+	Dio_WriteChannelFast(PORT_PIN_HCSR04_TRIG, PORT_PIN_LEVEL_LOW);
 }
 
 static boolean SensorIf_Mcal_ReadEchoPin(void)
 {
-	return Dio_ReadChannel(PORT_PIN_HCSR04_ECHO);
+	return (Dio_ReadChannelFast(PORT_PIN_HCSR04_ECHO) == PORT_PIN_LEVEL_HIGH) ? TRUE : FALSE;
 }
+#endif
 
 static uint32 SensorIf_Mcal_GetMicroTick(void)
 {
 	return Gpt_GetTimeElapsed(GPT_CHANNEL_ID);
 }
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+// Trigger pulse, echo capture and timeout all run on TIM2 (1 tick = 1us)
+static boolean SensorIf_Mcal_StartRanging(void)
+{
+	return (Icu_StartRanging(ICU_CHANNEL_ECHO, SENSORIF_TRIG_PULSE_US, SENSORIF_ECHO_TIMOUT_US) == E_OK) ? TRUE : FALSE;
+}
+#endif
+
+/* ============================================================
+ *	Local helpers
+ * ============================================================ */
+// Only place echo time becomes distance
+static void SensorIf_StoreEcho(uint32 EchoUs, SensorIf_MeasurementStatusType Status)
+{
+	DistConv_Q4MmType Q4 = DistConv_EchoUsToQ4Mm(EchoUs);
+
+	SensorIf_LastMeasurement.EchoTimeUs		= EchoUs;
+	SensorIf_LastMeasurement.DistanceQ4Mm	= Q4;
+	SensorIf_LastMeasurement.DistanceCm		= (SensorIf_DistanceCmType) DISTCONV_Q4_TO_CM(Q4);
+	SensorIf_LastMeasurement.Status			= Status;
+}
+
 /* ============================================================
  *  Public API Prototype
  * ============================================================ */
@@ -75,6 +101,7 @@ void SensorIf_Init(void)
 	SensorIf_State	= SENSORIF_STATE_IDLE;
 
 	SensorIf_LastMeasurement.DistanceCm = 0u;
+	SensorIf_LastMeasurement.DistanceQ4Mm = 0u;
 	SensorIf_LastMeasurement.Status	= SENSORIF_MEAS_INVALID;
 }
 
@@ -93,10 +120,17 @@ SensorIf_StatusType	SensorIf_TriggerMeasurement(void)
 		return SENSORIF_STATUS_NOT_READY;
 	}
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+	if(SensorIf_Mcal_StartRanging() == FALSE)
+	{
+		return SENSORIF_STATUS_HW_ERROR;
+	}
+#else
 	// send trigger pulse
 	SensorIf_Mcal_SetTriggerHigh();
 	// delay 10us
 	SensorIf_Mcal_SetTriggerLow();
+#endif
 
 	TimeoutTick	= SensorIf_Mcal_GetMicroTick();
 	SensorIf_State = SENSORIF_STATE_TRIGGERED;
@@ -131,6 +165,7 @@ SensorIf_StatusType	SensorIf_GetDistanceCm(SensorIf_DistanceCmType* DistanceCm)
 	// Blocking wait
 	while(SensorIf_State != SENSORIF_STATE_DONE)
 	{
+		REG_POLL();
 		SensorIf_Mainfunction();
 	}
 
@@ -146,13 +181,39 @@ SensorIf_StatusType	SensorIf_GetDistanceCm(SensorIf_DistanceCmType* DistanceCm)
 // Periodic processing function
 void SensorIf_Mainfunction(void)
 {
+#if (ICU_CFG_HCSR04_HW_TRIGGER != 1u)
 	uint32 CurrentTick;
+#endif
 
 	if(SensorIf_Initialized == FALSE)
 	{
 		return;
 	}
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+	// timing is done by the timer, only collect the result
+	if(SensorIf_State == SENSORIF_STATE_TRIGGERED)
+	{
+		uint16 WidthUs = 0u;
+
+		switch(Icu_GetRanging(ICU_CHANNEL_ECHO, &WidthUs))
+		{
+		case ICU_RANGING_DONE:
+			SensorIf_StoreEcho(WidthUs, SENSORIF_MEAS_VALID);
+			SensorIf_State = SENSORIF_STATE_DONE;
+			break;
+
+		case ICU_RANGING_TIMEOUT:
+		case ICU_RANGING_IDLE:
+			SensorIf_StoreEcho(0u, SENSORIF_MEAS_TIMEOUT);
+			SensorIf_State = SENSORIF_STATE_DONE;
+			break;
+
+		default:
+			break;
+		}
+	}
+#else
 	CurrentTick = SensorIf_Mcal_GetMicroTick();
 
 	switch(SensorIf_State)
@@ -177,9 +238,7 @@ void SensorIf_Mainfunction(void)
 
 			uint32 PulseWidth = EchoEndTick - EchoStartTick;
 
-			SensorIf_LastMeasurement.DistanceCm = (SensorIf_DistanceCmType) SENSORIF_US_TO_CM(PulseWidth);
-
-			SensorIf_LastMeasurement.Status = SENSORIF_MEAS_INVALID;
+			SensorIf_StoreEcho(PulseWidth, SENSORIF_MEAS_INVALID);
 
 			SensorIf_State = SENSORIF_STATE_DONE;
 		}
@@ -193,7 +252,11 @@ void SensorIf_Mainfunction(void)
 	default:
 		break;
 	}
+#endif
 }
 
 // Check whether SensorIf is initialized
-boolean SensorIf_IsInitialized(void);
+boolean SensorIf_IsInitialized(void)
+{
+	return SensorIf_Initialized;
+}
@@ -22,6 +22,9 @@
 // Timeout echo reception
 #define SENSORIF_ECHO_TIMOUT_US			(30000U)
 
+// Trigger pulse width required by HC-SR04
+#define SENSORIF_TRIG_PULSE_US			(10U)
+
 /* ============================================================
  *  Public API Prototype
  * ============================================================ */
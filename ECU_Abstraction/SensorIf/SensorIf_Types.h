@@ -18,6 +18,9 @@
 // Distance type centimeters
 typedef uint16 SensorIf_DistanceCmType;
 
+// Distance type 1/16 mm (DistConv Q4 mm, unit carried on RTE)
+typedef uint16 SensorIf_DistanceQ4MmType;
+
 // Raw echo pulse duration in microseconds
 typedef uint32 SensorIf_EchoTimeUsType;
 
@@ -58,6 +61,7 @@ typedef struct
 {
 	SensorIf_SensorType					SensorType;
 	SensorIf_DistanceCmType				DistanceCm;
+	SensorIf_DistanceQ4MmType			DistanceQ4Mm;
 	SensorIf_EchoTimeUsType				EchoTimeUs;
 	SensorIf_MeasurementValidityType	Validity;
 	SensorIf_MeasurementStatusType		Status;
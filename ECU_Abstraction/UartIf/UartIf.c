@@ -8,15 +8,31 @@
 
 #include "UartIf.h"
 #include "Uart.h"
-#include "Mcu.h"
+#include "Irq_Queue.h"
 #include <string.h>
 
 #ifndef UARTIF_MCAL_WRITE
 #define UARTIF_MCAL_WRITE(_ch, _buf, _len)			Uart_WriteAsync((_ch), (_buf), (_len))
 #endif
 
+#ifndef UARTIF_MCAL_WRITE_PARTIAL
+#define UARTIF_MCAL_WRITE_PARTIAL(_ch, _buf, _len)	Uart_WriteAsyncPartial((_ch), (_buf), (_len))
+#endif
+
+#ifndef UARTIF_MCAL_TXFREE
+#define UARTIF_MCAL_TXFREE(_ch)						Uart_GetTxFree((_ch))
+#endif
+
+#ifndef UARTIF_MCAL_TXRESERVE
+#define UARTIF_MCAL_TXRESERVE(_ch, _len, _span)		Uart_TxReserve((_ch), (_len), (_span))
+#endif
+
+#ifndef UARTIF_MCAL_TXCOMMIT
+#define UARTIF_MCAL_TXCOMMIT(_ch, _len)				Uart_TxCommit((_ch), (_len))
+#endif
+
 #ifndef UARTIF_MCAL_REGISTER_CALLBACKS
-#define UARTIF_MCAL_REGISTER_CALLBACKS(_ch, _pcbs)	((void)(_ch), (void)(_pcbs),(void)0)
+#define UARTIF_MCAL_REGISTER_CALLBACKS(_ch, _pcbs)	((void)Uart_RegisterCallbacks((_ch), (_pcbs)))
 #endif
 
 #ifndef UARTIF_MCAL_ISTXBUSY
@@ -27,15 +43,13 @@
 #define UARTIF_RX_RING_SIZE		(256u)
 #endif
 
+#if ((UARTIF_RX_RING_SIZE & (UARTIF_RX_RING_SIZE - 1u)) != 0u)
+#error "UARTIF_RX_RING_SIZE must be a power of two (Irq_SpscType)"
+#endif
+
 /* =====================================================================================
  *     Config and State
  * ===================================================================================== */
-typedef struct {
-	volatile uint16 head;
-	volatile uint16 tail;
-	uint8			data[UARTIF_RX_RING_SIZE];
-} UartIf_RxRingType;
-
 // Config init
 static const UartIf_ConfigType* UartIf_CfgPtr = NULL_PTR;
 // Init state
@@ -45,43 +59,38 @@ static boolean UartIf_Inited = FALSE;
 static UartIf_RxIndicationType		UartIf_RxCb_Default = NULL_PTR;
 static UartIf_TxConfirmationType 	UartIf_TxCb_Default = NULL_PTR;
 
-// Ring-buffer for default channel
-static UartIf_RxRingType UartIf_RxRing_Default = {0u,0u};
+// Ring-buffer for default channel: USART ISR -> UartIf_Read / MainFunction (SPSC, a full ring drops the new byte)
+IRQ_SPSC_DEFINE(UartIf_RxRing_Default, uint8, UARTIF_RX_RING_SIZE);
 
 /* =====================================================================================
  *     RING-BUFFER HELPERS
  * ===================================================================================== */
-static inline uint8 ring_is_empty(const UartIf_RxRingType* rb)
-{
-	return (rb->head == rb->tail);
-}
-
-static inline uint8 ring_is_full(const UartIf_RxRingType* rb)
+static inline uint16 ring_pop_many(Irq_SpscType* rb, uint8* buf, uint16 maxlen)
 {
-	return ((uint16)((rb->head + 1u) % UARTIF_RX_RING_SIZE) == rb->tail);
+	uint16 cnt = 0u;
+	while((cnt < maxlen) && Irq_SpscPop(rb, &buf[cnt]))
+	{
+		cnt++;
+	}
+	return cnt;
 }
 
-static inline void ring_push(UartIf_RxRingType* rb, uint8 byte)
+/* =====================================================================================
+ *     TX HELPERS
+ * ===================================================================================== */
+static inline Uart_ChannelType prv_DefaultCh(void)
 {
-	uint16 next = (uint16)((rb->head +1u) % UARTIF_RX_RING_SIZE);
-	if(next == rb->tail)
-	{
-		//full
-		rb->tail = (uint16)((rb->tail + 1u) % UARTIF_RX_RING_SIZE);
-	}
-	rb->data[rb->head] = byte;
-	rb->head = next;
+	return UartIf_CfgPtr->Channels[UartIf_CfgPtr->DefaultChannelIndex].ChannelId;
 }
 
-static inline uint16 ring_pop_many(UartIf_RxRingType* rb, uint8* buf, uint16 maxlen)
+// queue whole buffer or nothing
+static Std_ReturnType prv_WriteAll(Uart_ChannelType ch, const uint8* DataPtr, uint16 Length)
 {
-	uint16 cnt = 0u;
-	while((cnt < maxlen) && !ring_is_empty(rb))
+	if(UARTIF_MCAL_TXFREE(ch) < Length)
 	{
-		buf[cnt++] = rb->data[rb->tail];
-		rb->tail = (uint16)((rb->tail + 1u) % UARTIF_RX_RING_SIZE);
+		return UARTIF_WOULD_BLOCK;
 	}
-	return cnt;
+	return UARTIF_MCAL_WRITE(ch, DataPtr, Length);
 }
 
 /* =====================================================================================
@@ -90,7 +99,8 @@ static inline uint16 ring_pop_many(UartIf_RxRingType* rb, uint8* buf, uint16 max
 static void UartIf_McalRxCb(Uart_ChannelType ch, uint16 data)
 {
 	(void)ch;
-	ring_push(&UartIf_RxRing_Default, (uint8)(data & 0xFFu));
+	uint8 b = (uint8)(data & 0xFFu);
+	(void)Irq_SpscPush(&UartIf_RxRing_Default, &b);
 }
 
 static void UartIf_McalTxCb(Uart_ChannelType ch)
@@ -124,8 +134,7 @@ void UartIf_Init(const UartIf_ConfigType* CfgPtr)
 	UartIf_Inited = TRUE;
 
 	//reset ring/callback runtime
-	UartIf_RxRing_Default.head 	= 0u;
-	UartIf_RxRing_Default.tail 	= 0u;
+	(void)IRQ_SPSC_INIT(UartIf_RxRing_Default);
 	UartIf_RxCb_Default		   	= NULL_PTR;
 	UartIf_TxCb_Default			= NULL_PTR;
 
@@ -179,14 +188,64 @@ Std_ReturnType UartIf_Write(const uint8* DataPtr, uint16 Length)
 		return E_NOT_OK;
 	}
 #endif
-	const Uart_ChannelType ch = UartIf_CfgPtr->Channels[UartIf_CfgPtr->DefaultChannelIndex].ChannelId;
-	if(UARTIF_MCAL_ISTXBUSY(ch)){
-#if (UARTIF_DEV_ERROR_DETECT == STD_ON)
-		UARTIF_DET_REPORT(UARTIF_API_ID_WRITE, UARTIF_E_BUSY);
+	return prv_WriteAll(prv_DefaultCh(), DataPtr, Length);
+}
+
+Std_ReturnType UartIf_WritePartial(const uint8* DataPtr, uint16 Length, uint16* AcceptedPtr)
+{
+#if(UARTIF_DEV_ERROR_DETECT == STD_ON )
+	if(UartIf_Inited == FALSE){
+		UARTIF_DET_REPORT(UARTIF_API_ID_WRITE_PARTIAL, UARTIF_E_UNINIT);
+		return E_NOT_OK;
+	}
+	if( (DataPtr == NULL_PTR) || (AcceptedPtr == NULL_PTR) ){
+		UARTIF_DET_REPORT(UARTIF_API_ID_WRITE_PARTIAL, UARTIF_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+#endif
+	*AcceptedPtr = UARTIF_MCAL_WRITE_PARTIAL(prv_DefaultCh(), DataPtr, Length);
+	return (*AcceptedPtr == Length) ? E_OK : UARTIF_WOULD_BLOCK;
+}
+
+uint16 UartIf_GetTxFree(void)
+{
+#if(UARTIF_DEV_ERROR_DETECT == STD_ON )
+	if(UartIf_Inited == FALSE){
+		UARTIF_DET_REPORT(UARTIF_API_ID_GETTXFREE, UARTIF_E_UNINIT);
+		return 0u;
+	}
 #endif
+	return UARTIF_MCAL_TXFREE(prv_DefaultCh());
+}
+
+Std_ReturnType UartIf_TxReserve(uint16 Length, Uart_TxSpanType* SpanPtr)
+{
+#if(UARTIF_DEV_ERROR_DETECT == STD_ON )
+	if(UartIf_Inited == FALSE){
+		UARTIF_DET_REPORT(UARTIF_API_ID_TXRESERVE, UARTIF_E_UNINIT);
 		return E_NOT_OK;
 	}
-	return UARTIF_MCAL_WRITE(ch, DataPtr, Length);
+	if(SpanPtr == NULL_PTR){
+		UARTIF_DET_REPORT(UARTIF_API_ID_TXRESERVE, UARTIF_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+#endif
+	if(UARTIF_MCAL_TXRESERVE(prv_DefaultCh(), Length, SpanPtr) != E_OK)
+	{
+		return UARTIF_WOULD_BLOCK;
+	}
+	return E_OK;
+}
+
+Std_ReturnType UartIf_TxCommit(uint16 Length)
+{
+#if(UARTIF_DEV_ERROR_DETECT == STD_ON )
+	if(UartIf_Inited == FALSE){
+		UARTIF_DET_REPORT(UARTIF_API_ID_TXCOMMIT, UARTIF_E_UNINIT);
+		return E_NOT_OK;
+	}
+#endif
+	return UARTIF_MCAL_TXCOMMIT(prv_DefaultCh(), Length);
 }
 
 Std_ReturnType UartIf_WriteChar(uint8 ch8)
@@ -208,18 +267,24 @@ Std_ReturnType UartIf_WriteLine(const char* CStr)
 		return E_NOT_OK;
 	}
 #endif
-	Std_ReturnType ret = UartIf_Write((const uint8*) CStr, (uint16)strlen(CStr));
-	if(ret != E_OK) return ret;
-	DelayMs(TIME_DELAY_FOR_IQR_HANDER);
 #if (UARTIF_DEFAULT_CRLF == 1)
-	static const uint8 crlf[2] = {'\r','\n'};
-	ret = UartIf_Write(crlf,2u);
+	static const uint8 eol[2] = {'\r','\n'};
 #else
-	static const uint8 lf[1] = {'\n'};
-	ret = UartIf_Write(lf,1u);
+	static const uint8 eol[1] = {'\n'};
 #endif
-	DelayMs(TIME_DELAY_FOR_IQR_HANDER);
-	return ret;
+	const Uart_ChannelType ch = prv_DefaultCh();
+	const uint16 len = (uint16)strlen(CStr);
+
+	// text and EOL go in together or not at all
+	if(UARTIF_MCAL_TXFREE(ch) < (uint16)(len + sizeof(eol)))
+	{
+		return UARTIF_WOULD_BLOCK;
+	}
+	if((len > 0u) && (UARTIF_MCAL_WRITE(ch, (const uint8*)CStr, len) != E_OK))
+	{
+		return E_NOT_OK;
+	}
+	return UARTIF_MCAL_WRITE(ch, eol, (uint16)sizeof(eol));
 }
 
 Std_ReturnType UartIf_Read(uint8* BufPtr, uint16 BufSize, uint16* OutLen)
@@ -301,8 +366,7 @@ boolean UartIf_IsTxBusy(void)
 		return E_NOT_OK;
 	}
 #endif
-	const Uart_ChannelType ch = UartIf_CfgPtr->Channels[UartIf_CfgPtr->DefaultChannelIndex].ChannelId;
-	return (boolean) UARTIF_MCAL_ISTXBUSY(ch);
+	return (boolean) UARTIF_MCAL_ISTXBUSY(prv_DefaultCh());
 }
 
 void UartIf_MainFunction(void)
@@ -342,13 +406,7 @@ Std_ReturnType UartIf_WriteCh(Uart_ChannelType Channel, const uint8* DataPtr, ui
 		return E_NOT_OK;
 	}
 #endif
-	if(UARTIF_MCAL_ISTXBUSY(Channel)){
-#if(UARTIF_DEV_ERROR_DETECT == STD_ON)
-		UARTIF_DET_REPORT(UARTIF_API_ID_WRITE,UARTIF_E_BUSY);
-#endif
-		return E_NOT_OK;
-	}
-	return UARTIF_MCAL_WRITE(Channel,DataPtr,Length);
+	return prv_WriteAll(Channel, DataPtr, Length);
 }
 
 Std_ReturnType UartIf_ReadCh(Uart_ChannelType Channel, uint8* BufPtr, uint16 BufSize, uint16* OutLen)
@@ -59,6 +59,16 @@ extern "C" {
 #define UARTIF_API_ID_MAINFUNCTION			(0x09u)
 #define UARTIF_API_ID_ISTXBUSY				(0x0Au)
 #define UARTIF_API_ID_ISINIT				(0x0Bu)
+#define UARTIF_API_ID_WRITE_PARTIAL			(0x0Cu)
+#define UARTIF_API_ID_GETTXFREE				(0x0Du)
+#define UARTIF_API_ID_TXRESERVE				(0x0Eu)
+#define UARTIF_API_ID_TXCOMMIT				(0x0Fu)
+
+/* ==============================
+ *         RETURN CODES
+ * ============================== */
+// Tx ring has no room for the request right now, nothing (or only part) was queued
+#define UARTIF_WOULD_BLOCK					((Std_ReturnType)0x02u)
 
 /* ==============================
  *         DET ERROR CODES
@@ -84,7 +94,7 @@ extern "C" {
 // Callback when has new data
 typedef void (*UartIf_RxIndicationType) (const uint8* DataPtr, uint16 Length);
 
-//Callback when complete transmitted
+//Callback when complete transmitted (Tx ring drained), called from IRQ context
 typedef void (*UartIf_TxConfirmationType) (void);
 
 // Config UART channel
@@ -109,9 +119,13 @@ typedef struct
 void UartIf_Init(const UartIf_ConfigType* CfgPtr);
 void UartIf_DeInit(void); // Clear state to uninit
 boolean UartIf_IsInitialized(void); // Check init state
-Std_ReturnType UartIf_Write(const uint8* DataPtr, uint16 Length);
+Std_ReturnType UartIf_Write(const uint8* DataPtr, uint16 Length); // queue all or nothing, UARTIF_WOULD_BLOCK if no room
+Std_ReturnType UartIf_WritePartial(const uint8* DataPtr, uint16 Length, uint16* AcceptedPtr); // queue what fits
 Std_ReturnType UartIf_WriteChar(uint8 ch); //send a char
-Std_ReturnType UartIf_WriteLine(const char* CStr); // send a string
+Std_ReturnType UartIf_WriteLine(const char* CStr); // send a string + EOL, all or nothing
+uint16 UartIf_GetTxFree(void); // bytes that can be queued now
+Std_ReturnType UartIf_TxReserve(uint16 Length, Uart_TxSpanType* SpanPtr); // borrow Tx ring space to fill in place, UARTIF_WOULD_BLOCK if no room
+Std_ReturnType UartIf_TxCommit(uint16 Length); // send bytes filled into last reserved span
 Std_ReturnType UartIf_Read(uint8* BufPtr, uint16 BufSize, uint16* OutLen); // Read data
 Std_ReturnType UartIf_ReadNonBlocking(uint8* BufPtr, uint16 BufSize, uint16* OutLen); // Read non-blocking
 Std_ReturnType UartIf_RegisterRxIndication(UartIf_RxIndicationType RxCb); //Register Callback Rx
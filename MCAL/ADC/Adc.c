@@ -0,0 +1,145 @@
+/* =====================================================================================================================
+ *  File        : Adc.c
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Write API for Adc driver (ADC1 regular group, SWSTART, polled EOC)
+ *  Notes       : One group converts at a time, no interrupt / DMA
+ * ===================================================================================================================*/
+#include "Adc.h"
+#include "Adc_Cfg.h"
+
+static const Adc_ConfigType*	Adc_ConfigPtr = NULL_PTR;
+static Adc_StatusType			Adc_GroupStatus[ADC_GROUP_COUNT];
+static Adc_ValueGroupType		Adc_GroupResult[ADC_GROUP_COUNT];
+static sint8					Adc_ActiveGroup = -1;
+
+static inline const Adc_GroupConfigType* prv_GetGroup(Adc_GroupType Group)
+{
+	if((Adc_ConfigPtr == NULL_PTR) || (Group >= Adc_ConfigPtr->GroupCount) || (Group >= ADC_GROUP_COUNT))
+	{
+		return NULL_PTR;
+	}
+	return &Adc_ConfigPtr->GroupConfig[Group];
+}
+
+static void prv_SetSampleTime(Adc_ChannelType Channel, uint8 Smp)
+{
+	uint32 pos;
+
+	if(Channel >= 10u)
+	{
+		pos = (uint32)(Channel - 10u) * ADC_SMP_BITS;
+		ADC1->SMPR1 = (ADC1->SMPR1 & ~(7UL << pos)) | ((uint32)Smp << pos);
+	} else {
+		pos = (uint32)Channel * ADC_SMP_BITS;
+		ADC1->SMPR2 = (ADC1->SMPR2 & ~(7UL << pos)) | ((uint32)Smp << pos);
+	}
+}
+
+static boolean prv_WaitClear(uint32 Mask)
+{
+	uint32 n = ADC_CFG_CAL_TIMEOUT;
+
+	while((ADC1->CR2 & Mask) != 0u)
+	{
+		REG_POLL();
+		if(--n == 0u) return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ * Adc_Init
+ * - Enable clock (ADCCLK prescaler is set by Mcu)
+ * - Power up, software trigger, internal channels on
+ * - Self calibration
+ * - Sample time of every group channel
+ */
+Std_ReturnType Adc_Init(const Adc_ConfigType* ConfigPtr)
+{
+	uint32 i;
+
+	if(ConfigPtr == NULL_PTR) return E_NOT_OK;
+	Adc_ConfigPtr = ConfigPtr;
+
+	RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
+
+	ADC1->CR1	= 0u;
+	ADC1->CR2	= ADC_CR2_ADON | ADC_CR2_EXTSEL_SWSTART | ADC_CR2_EXTTRIG | ADC_CR2_TSVREFE;
+
+	// tSTAB (1 us) before calibration
+	for(volatile uint32 d = 0u; d < 100u; d++) {}
+
+	ADC1->CR2 |= ADC_CR2_RSTCAL;
+	if(prv_WaitClear(ADC_CR2_RSTCAL) == FALSE) return E_NOT_OK;
+
+	ADC1->CR2 |= ADC_CR2_CAL;
+	if(prv_WaitClear(ADC_CR2_CAL) == FALSE) return E_NOT_OK;
+
+	for(i = 0u; i < ADC_GROUP_COUNT; i++)
+	{
+		Adc_GroupStatus[i]	= ADC_IDLE;
+		Adc_GroupResult[i]	= 0u;
+	}
+
+	for(i = 0u; i < ConfigPtr->GroupCount; i++)
+	{
+		prv_SetSampleTime(ConfigPtr->GroupConfig[i].Channel, ConfigPtr->GroupConfig[i].SampleTime);
+	}
+
+	Adc_ActiveGroup = -1;
+	return E_OK;
+}
+
+/*
+ * Adc Deinit
+ */
+void Adc_DeInit(void)
+{
+	ADC1->CR2 &= ~(ADC_CR2_ADON | ADC_CR2_TSVREFE);
+	Adc_ConfigPtr	= NULL_PTR;
+	Adc_ActiveGroup	= -1;
+}
+
+Std_ReturnType Adc_StartGroupConversion(Adc_GroupType Group)
+{
+	const Adc_GroupConfigType* grp = prv_GetGroup(Group);
+
+	if(grp == NULL_PTR)		return E_NOT_OK;
+	if(Adc_ActiveGroup >= 0)	return E_NOT_OK;
+
+	ADC1->SQR1	&= ~ADC_SQR1_L;				// one conversion
+	ADC1->SQR3	= (uint32)grp->Channel;
+	(void)ADC1->DR;							// drop stale EOC
+
+	Adc_ActiveGroup			= (sint8)Group;
+	Adc_GroupStatus[Group]	= ADC_BUSY;
+
+	ADC1->CR2 |= ADC_CR2_SWSTART;
+	return E_OK;
+}
+
+Adc_StatusType Adc_GetGroupStatus(Adc_GroupType Group)
+{
+	if(prv_GetGroup(Group) == NULL_PTR) return ADC_IDLE;
+
+	if((Adc_GroupStatus[Group] == ADC_BUSY) && ((ADC1->SR & ADC_SR_EOC) != 0u))
+	{
+		// reading DR clears EOC
+		Adc_GroupResult[Group]	= (Adc_ValueGroupType)(ADC1->DR & 0x0FFFu);
+		Adc_GroupStatus[Group]	= ADC_STREAM_COMPLETED;
+		Adc_ActiveGroup			= -1;
+	}
+
+	return Adc_GroupStatus[Group];
+}
+
+Std_ReturnType Adc_ReadGroup(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr)
+{
+	if((DataBufferPtr == NULL_PTR) || (prv_GetGroup(Group) == NULL_PTR)) return E_NOT_OK;
+	if(Adc_GroupStatus[Group] != ADC_STREAM_COMPLETED) return E_NOT_OK;
+
+	*DataBufferPtr			= Adc_GroupResult[Group];
+	Adc_GroupStatus[Group]	= ADC_IDLE;
+	return E_OK;
+}
@@ -0,0 +1,36 @@
+/* =====================================================================================================================
+ *  File        : Adc.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Define API for Adc module (software triggered, polled, one conversion per group)
+ *  Notes       :
+ * ===================================================================================================================*/
+
+
+#ifndef ADC_ADC_H_
+#define ADC_ADC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Adc_Types.h"
+
+// Clock, power up and self calibration of ADC1
+Std_ReturnType Adc_Init(const Adc_ConfigType* ConfigPtr);
+void Adc_DeInit(void);
+
+// Start one conversion of the group, result is polled with Adc_GetGroupStatus
+Std_ReturnType Adc_StartGroupConversion(Adc_GroupType Group);
+
+// ADC_BUSY until the conversion is done, then ADC_STREAM_COMPLETED
+Adc_StatusType Adc_GetGroupStatus(Adc_GroupType Group);
+
+// Copy result of a completed group, group goes back to ADC_IDLE
+Std_ReturnType Adc_ReadGroup(Adc_GroupType Group, Adc_ValueGroupType* DataBufferPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_ADC_H_ */
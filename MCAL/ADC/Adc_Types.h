@@ -0,0 +1,62 @@
+/* =====================================================================================================================
+ *  File        : Adc_Types.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Define data structure and macro for Adc driver (ADC1, single channel groups)
+ *  Notes       :
+ * ===================================================================================================================*/
+
+
+#ifndef ADC_ADC_TYPES_H_
+#define ADC_ADC_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "stm32f103xx_regs.h"
+
+// Internal channels of ADC1
+#define ADC_CHANNEL_TEMPSENSOR		(16u)
+#define ADC_CHANNEL_VREFINT			(17u)
+
+// Sample time encoding (SMPRx), in ADC clocks
+#define ADC_SMP_1_5					(0u)
+#define ADC_SMP_7_5					(1u)
+#define ADC_SMP_13_5				(2u)
+#define ADC_SMP_28_5				(3u)
+#define ADC_SMP_41_5				(4u)
+#define ADC_SMP_55_5				(5u)
+#define ADC_SMP_71_5				(6u)
+#define ADC_SMP_239_5				(7u)
+
+typedef uint8	Adc_ChannelType;
+typedef uint8	Adc_GroupType;
+typedef uint16	Adc_ValueGroupType;		// right aligned 12 bit
+
+typedef enum
+{
+	ADC_IDLE = 0,
+	ADC_BUSY,
+	ADC_STREAM_COMPLETED
+} Adc_StatusType;
+
+typedef struct
+{
+	Adc_GroupType		GroupId;
+	Adc_ChannelType		Channel;
+	uint8				SampleTime;		// ADC_SMP_x
+} Adc_GroupConfigType;
+
+typedef struct
+{
+	const Adc_GroupConfigType*	GroupConfig;
+	uint8						GroupCount;
+} Adc_ConfigType;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_ADC_TYPES_H_ */
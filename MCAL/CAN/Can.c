@@ -7,16 +7,29 @@
  *  Notes       :
  * ===================================================================================================================*/
 #include "Can.h"
+#include "Can_Cfg.h"
+#include "Irq.h"
+#include "Irq_Atomic.h"
+
+#define CAN_ESR_STATE_FLAGS		(CAN_ESR_EWGF | CAN_ESR_EPVF | CAN_ESR_BOFF)
+#define CAN_LEC_UNCHANGED		(7u)		// written by the driver, hardware overwrites it on the next error
 
 static const Can_ConfigType* Can_ConfigPtr;
 static Can_ControllerStateType Can_State;
 static Can_PduType Can_TxPduPending;
-static boolean Can_TxPending = FALSE;
-static uint8 Can_RxBuffer[8];
+// Mailbox 0 owner: set after Can_TxPduPending is complete, taken by exactly one confirmation
+static volatile uint32 Can_TxPending = FALSE;
+static uint8 Can_RxBuffer[CAN_MAX_PDU_LENGTH];
+// Counts and last error code, the live fields (state, TEC, REC) are read from ESR by Can_GetStatistics
+static Can_StatisticsType Can_Stats;
+// ESR flags of the last SCE event: a flag counts on its rising edge, Can_MainFunction_BusOff drops the ones that fell
+static volatile uint32 Can_ErrFlags;
+static volatile uint32 Can_BusOffPending = FALSE;
+static boolean Can_SceIrq = FALSE;			// FALSE: SCE line not in the interrupt plan, ERRI is polled
 
-__attribute__((weak)) void Can_TxConfirmation( Can_HwHandleType Hth)
+__attribute__((weak)) void Can_TxConfirmation( Can_HwHandleType SwPduHandle)
 {
-	(void)Hth;
+	(void)SwPduHandle;
 }
 
 __attribute__((weak)) void Can_RxIndication( Can_HwHandleType Hrh, const Can_PduType* PduInfo)
@@ -25,17 +38,61 @@ __attribute__((weak)) void Can_RxIndication( Can_HwHandleType Hrh, const Can_Pdu
 	(void)PduInfo;
 }
 
+__attribute__((weak)) void Can_ControllerBusOff(uint8 Controller)
+{
+	(void)Controller;
+}
+
+__attribute__((weak)) void Can_ControllerWakeup(uint8 Controller)
+{
+	(void)Controller;
+}
+
+// (MSR & Mask) == Value within CAN_CFG_MODE_TIMEOUT_POLLS
+static Std_ReturnType prv_WaitMsr(uint32 Mask, uint32 Value)
+{
+	uint32 n;
+
+	for(n = 0U; n < CAN_CFG_MODE_TIMEOUT_POLLS; n++)
+	{
+		if((CAN1->MSR & Mask) == Value) return E_OK;
+		REG_POLL();
+	}
+	return ((CAN1->MSR & Mask) == Value) ? E_OK : E_NOT_OK;
+}
+
+// Keep a new last error code, then mark it read so the next one is seen even when it has the same code
+static void prv_LatchLec(uint32 Esr)
+{
+	uint8 lec = (uint8)((Esr & CAN_ESR_LEC_Msk) >> CAN_ESR_LEC_Pos);
+
+	if((lec == CAN_LEC_NONE) || (lec == CAN_LEC_UNCHANGED)) return;
+
+	Can_Stats.LastErrorCode = lec;
+	CAN1->ESR = CAN_ESR_LEC_Msk;
+}
+
+static Can_ErrorStateType prv_ErrorState(uint32 Esr)
+{
+	if(Esr & CAN_ESR_BOFF) return CAN_ERRORSTATE_BUSOFF;
+	if(Esr & CAN_ESR_EPVF) return CAN_ERRORSTATE_PASSIVE;
+	return CAN_ERRORSTATE_ACTIVE;
+}
+
 
 void Can_Init(const Can_ConfigType* Config)
 {
 	Can_ConfigPtr = Config;
+	Can_State = CAN_CS_UNINIT;
 
 	// Enable Can clock
 	RCC->APB1ENR |= RCC_APB1ENR_CAN1EN;
 
-	//Enter init mode
-	CAN1->MCR |= CAN_MCR_INRQ;
-	while(!(CAN1->MSR & CAN_MSR_INAK));
+	//Enter init mode (SLEEP must be cleared too, sleep -> init is not a valid transition)
+	//ABOM off: after bus-off the controller waits for the software (CanSM) to restart it
+	//AWUM on: bus activity ends CAN_CS_SLEEP without the software
+	CAN1->MCR = (CAN1->MCR & ~(CAN_MCR_SLEEP | CAN_MCR_ABOM)) | CAN_MCR_INRQ | CAN_MCR_AWUM;
+	if(prv_WaitMsr(CAN_MSR_INAK, CAN_MSR_INAK) != E_OK) return;
 
 	// Config bit timing
 	CAN1->BTR =
@@ -43,50 +100,173 @@ void Can_Init(const Can_ConfigType* Config)
 			((Config->ControllerConfig[0].baudrate->tseg2 - 1U ) << CAN_BTR_TS2_Pos)|
 			((Config->ControllerConfig[0].baudrate->tseg1 - 1U ) << CAN_BTR_TS1_Pos)|
 			((Config->ControllerConfig[0].baudrate->precscale - 1U ));
-	/* Leave init mode */
-	CAN1->MCR &= ~CAN_MCR_INRQ;
-	while(CAN1->MSR & CAN_MSR_INAK);
 
+	// Filter bank 0: 32 bit mask, all don't care -> every frame to FIFO 0 (no active bank drops all)
+	CAN1->FMR	|= CAN_FMR_FINIT;
+	CAN1->FA1R	&= ~CAN_FILTER_BANK0;
+	CAN1->FS1R	|= CAN_FILTER_BANK0;
+	CAN1->FM1R	&= ~CAN_FILTER_BANK0;
+	CAN1->FFA1R	&= ~CAN_FILTER_BANK0;
+	CAN1->sFilterRegister[0].FR1 = 0U;
+	CAN1->sFilterRegister[0].FR2 = 0U;
+	CAN1->FA1R	|= CAN_FILTER_BANK0;
+	CAN1->FMR	&= ~CAN_FMR_FINIT;
+
+	// Error management: warning, passive and bus-off raise the SCE interrupt, LEC errors alone do not. Wake-up too
+	Can_Stats.LastErrorCode	= CAN_LEC_NONE;
+	Can_Stats.WarningCount	= 0U;
+	Can_Stats.PassiveCount	= 0U;
+	Can_Stats.BusOffCount	= 0U;
+	Can_ErrFlags			= 0U;
+	Can_TxPending			= FALSE;
+	Can_BusOffPending		= FALSE;
+	CAN1->ESR	= CAN_ESR_LEC_Msk;
+	CAN1->MSR	= CAN_MSR_ERRI | CAN_MSR_WKUI;
+	CAN1->IER	|= CAN_IER_EWGIE | CAN_IER_EPVIE | CAN_IER_BOFIE | CAN_IER_ERRIE | CAN_IER_WKUIE;
+	Can_SceIrq	= (Irq_EnableLine(IRQ_NUM_CAN1_SCE) == E_OK) ? TRUE : FALSE;
+
+	// init mode until Can_SetControllerMode(CAN_CS_STARTED)
 	Can_State = CAN_CS_STOPPED;
 }
 
 Std_ReturnType Can_SetControllerMode(uint8 Controller, Can_ControllerStateType Mode)
 {
+	if((Controller != 0U) || (Can_State == CAN_CS_UNINIT))
+	{
+		return E_NOT_OK;
+	}
+
 	if(Mode == CAN_CS_STARTED)
 	{
-		CAN1->MCR &= ~CAN_MCR_SLEEP;
+		// a controller that was bus-off sends again after 128 x 11 recessive bits
+		CAN1->MCR &= ~(CAN_MCR_SLEEP | CAN_MCR_INRQ);
+		if(prv_WaitMsr(CAN_MSR_INAK, 0U) != E_OK)
+		{
+			CAN1->MCR |= CAN_MCR_INRQ;
+			return E_NOT_OK;
+		}
 		Can_State = CAN_CS_STARTED;
 		return E_OK;
 	}
 
 	if(Mode == CAN_CS_STOPPED)
 	{
-		CAN1->MCR |= CAN_MCR_INRQ;
+		CAN1->MCR = (CAN1->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ;
+		if(prv_WaitMsr(CAN_MSR_INAK, CAN_MSR_INAK) != E_OK)
+		{
+			CAN1->MCR &= ~CAN_MCR_INRQ;
+			return E_NOT_OK;
+		}
+
+		// the frame in mailbox 0 would go out stale after a restart, it gets no confirmation
+		CAN1->TSR = CAN_TSR_ABRQ0;
+		Irq_AtomicStore32(&Can_TxPending, FALSE);
 		Can_State = CAN_CS_STOPPED;
 		return E_OK;
 	}
 
+	if(Mode == CAN_CS_SLEEP)
+	{
+		// from init mode only (the mailbox is already empty), a wake-up left over from the last sleep is dropped
+		if(Can_State != CAN_CS_STOPPED) return E_NOT_OK;
+
+		CAN1->MSR = CAN_MSR_WKUI;
+		CAN1->MCR = (CAN1->MCR & ~CAN_MCR_INRQ) | CAN_MCR_SLEEP;
+		if(prv_WaitMsr(CAN_MSR_SLAK | CAN_MSR_INAK, CAN_MSR_SLAK) != E_OK)
+		{
+			CAN1->MCR = (CAN1->MCR & ~CAN_MCR_SLEEP) | CAN_MCR_INRQ;
+			return E_NOT_OK;
+		}
+		Can_State = CAN_CS_SLEEP;
+		return E_OK;
+	}
+
 	return E_NOT_OK;
 }
 
+Std_ReturnType Can_GetControllerMode(uint8 Controller, Can_ControllerStateType* ControllerModePtr)
+{
+	if((Controller != 0U) || (ControllerModePtr == NULL_PTR))
+	{
+		return E_NOT_OK;
+	}
+
+	*ControllerModePtr = Can_State;
+	return E_OK;
+}
+
+Std_ReturnType Can_GetControllerErrorState(uint8 Controller, Can_ErrorStateType* ErrorStatePtr)
+{
+	if((Controller != 0U) || (ErrorStatePtr == NULL_PTR) || (Can_State == CAN_CS_UNINIT))
+	{
+		return E_NOT_OK;
+	}
+
+	*ErrorStatePtr = prv_ErrorState(CAN1->ESR);
+	return E_OK;
+}
+
+Std_ReturnType Can_GetStatistics(uint8 Controller, Can_StatisticsType* StatisticsPtr)
+{
+	uint32 esr;
+
+	if((Controller != 0U) || (StatisticsPtr == NULL_PTR) || (Can_State == CAN_CS_UNINIT))
+	{
+		return E_NOT_OK;
+	}
+
+	esr = CAN1->ESR;
+	prv_LatchLec(esr);
+
+	*StatisticsPtr				= Can_Stats;
+	StatisticsPtr->ErrorState	= prv_ErrorState(esr);
+	StatisticsPtr->Tec			= (uint8)(esr >> CAN_ESR_TEC_Pos);
+	StatisticsPtr->Rec			= (uint8)(esr >> CAN_ESR_REC_Pos);
+	return E_OK;
+}
+
+// Bytes [First, First + 4) of the SDU as a mailbox data word, bytes beyond Length are 0
+static uint32 prv_DataWord(const uint8* Sdu, uint8 Length, uint8 First)
+{
+	uint32 w = 0U;
+	uint8 i;
+
+	for(i = First; (i < Length) && (i < (uint8)(First + 4U)); i++)
+	{
+		w |= (uint32)Sdu[i] << ((i - First) * 8U);
+	}
+	return w;
+}
+
 Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo)
 {
-	if((CAN1->TSR & CAN_TSR_TME0) == 0U)
+	if((PduInfo == NULL_PTR) || (PduInfo->length > CAN_MAX_PDU_LENGTH) || ((PduInfo->sdu == NULL_PTR) && (PduInfo->length != 0U)))
+	{
+		return E_NOT_OK;
+	}
+
+	// stopped (bus-off until CanSM restarts) or asleep: the frame would wait in the mailbox and go out stale
+	if((Can_State == CAN_CS_STOPPED) || (Can_State == CAN_CS_SLEEP))
+	{
+		return E_NOT_OK;
+	}
+
+	// TXRQ too: a request written in the same run of the caller may not show in TME0 yet
+	if(((CAN1->TSR & CAN_TSR_TME0) == 0U) || ((CAN1->sTxMailBox[0].TIR & CAN_TI_TXRQ) != 0U))
 	{
 		return E_NOT_OK;
 	}
 
 	Can_TxPduPending = *PduInfo;
-	Can_TxPending = TRUE;
+	Irq_AtomicStore32(&Can_TxPending, TRUE);
 
-	CAN1->sTxMailBox[0].TIR = (PduInfo->Id << CAN_TI0R_STID_Pos);
-	CAN1->sTxMailBox[0].TDTR = PduInfo->length;
+	CAN1->sTxMailBox[0].TIR = (PduInfo->Id & CAN_ID_EXTENDED) ?
+			(((PduInfo->Id & ~CAN_ID_EXTENDED) << CAN_TI0R_EXID_Pos) | CAN_TI_IDE) :
+			(PduInfo->Id << CAN_TI0R_STID_Pos);
+	CAN1->sTxMailBox[0].TDTR = PduInfo->length;				// DLC, TGT off
 
-	CAN1->sTxMailBox[0].TDLR =
-			(PduInfo->sdu[3] << 24)|
-			(PduInfo->sdu[2] << 16)|
-			(PduInfo->sdu[1] << 8)|
-			(PduInfo->sdu[0]);
+	CAN1->sTxMailBox[0].TDLR = prv_DataWord(PduInfo->sdu, PduInfo->length, 0U);
+	CAN1->sTxMailBox[0].TDHR = prv_DataWord(PduInfo->sdu, PduInfo->length, 4U);
 
 	CAN1->sTxMailBox[0].TIR |= CAN_TI_TXRQ;
 
@@ -95,20 +275,21 @@ Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo)
 
 void Can_MainFunction_Tx(void)
 {
-	if(Can_TxPending == FALSE)
+	if(Irq_AtomicLoad32(&Can_TxPending) == FALSE)
 	{
 		return;
 	}
 
 	if(CAN1->TSR & CAN_TSR_RQCP0)
 	{
-		// Clear flag
-		CAN1->TSR |= CAN_TSR_RQCP0;
+		// Clear flag (rc_w1: a read-modify-write would also ack mailbox 1/2)
+		CAN1->TSR = CAN_TSR_RQCP0;
 
-		Can_TxPending = FALSE;
+		// a second caller (ISR / other task) that saw RQCP0 too must not confirm again
+		if(Irq_AtomicExchange32(&Can_TxPending, FALSE) == FALSE) return;
 
-		// Notify upper layer
-		Can_TxConfirmation(0);
+		// Notify upper layer with the handle of the request in the mailbox
+		Can_TxConfirmation(Can_TxPduPending.swpduHandle);
 	}
 }
 
@@ -122,19 +303,97 @@ void Can_MainFunction_Rx(void)
 	Can_PduType RxPdu;
 	RxPdu.Id =
 		(CAN1->sFIFOMailBox[0].RIR & CAN_RI0R_IDE) ?
-		(CAN1->sFIFOMailBox[0].RIR >> CAN_TI0R_EXID_Pos):
+		((CAN1->sFIFOMailBox[0].RIR >> CAN_TI0R_EXID_Pos) | CAN_ID_EXTENDED):
 		(CAN1->sFIFOMailBox[0].RIR >> CAN_TI0R_STID_Pos);
 
+	// DLC 9 .. 15 still carries 8 bytes on classic CAN
 	RxPdu.length = CAN1->sFIFOMailBox[0].RDTR & 0x0FU;
+	if(RxPdu.length > CAN_MAX_PDU_LENGTH) RxPdu.length = CAN_MAX_PDU_LENGTH;
 	RxPdu.sdu = Can_RxBuffer;
 
 	Can_RxBuffer[0] = (CAN1->sFIFOMailBox[0].RDLR >> 0) & 0xFF;
 	Can_RxBuffer[1] = (CAN1->sFIFOMailBox[0].RDLR >> 8) & 0xFF;
 	Can_RxBuffer[2] = (CAN1->sFIFOMailBox[0].RDLR >> 16) & 0xFF;
 	Can_RxBuffer[3] = (CAN1->sFIFOMailBox[0].RDLR >> 24) & 0xFF;
+	Can_RxBuffer[4] = (CAN1->sFIFOMailBox[0].RDHR >> 0) & 0xFF;
+	Can_RxBuffer[5] = (CAN1->sFIFOMailBox[0].RDHR >> 8) & 0xFF;
+	Can_RxBuffer[6] = (CAN1->sFIFOMailBox[0].RDHR >> 16) & 0xFF;
+	Can_RxBuffer[7] = (CAN1->sFIFOMailBox[0].RDHR >> 24) & 0xFF;
 
 	// Release FIFO
-	CAN1->RF0R = CAN_RF0R_FMP0;
+	CAN1->RF0R = CAN_RF0R_RFOM0;
 
 	Can_RxIndication(0, &RxPdu);
 }
+
+void CAN1_SCE_IRQHandler(void)
+{
+	uint32 msr	= CAN1->MSR;
+	uint32 esr;
+	uint32 rise;
+
+	// rc_w1, the other MSR bits are read only or not written with 0
+	if(msr & CAN_MSR_WKUI)
+	{
+		CAN1->MSR = CAN_MSR_WKUI;
+		Can_ControllerWakeup(0U);
+	}
+	if((msr & CAN_MSR_ERRI) == 0U)
+	{
+		return;
+	}
+
+	esr		= CAN1->ESR;
+	rise	= esr & ~Can_ErrFlags & CAN_ESR_STATE_FLAGS;
+	CAN1->MSR = CAN_MSR_ERRI;
+	Can_ErrFlags |= esr & CAN_ESR_STATE_FLAGS;
+
+	if(rise & CAN_ESR_EWGF) Can_Stats.WarningCount++;
+	if(rise & CAN_ESR_EPVF) Can_Stats.PassiveCount++;
+	if(rise & CAN_ESR_BOFF)
+	{
+		Can_Stats.BusOffCount++;
+		Irq_AtomicStore32(&Can_BusOffPending, TRUE);
+	}
+	prv_LatchLec(esr);
+}
+
+void Can_MainFunction_BusOff(void)
+{
+	uint32 old;
+	uint32 esr;
+
+	if(Can_State == CAN_CS_UNINIT)
+	{
+		return;
+	}
+
+	if((Can_SceIrq == FALSE) && (CAN1->MSR & CAN_MSR_ERRI))
+	{
+		CAN1_SCE_IRQHandler();
+	}
+
+	// flags that fell (counters back down) count again on their next rise; ESR read inside, an SCE event in between retries
+	do
+	{
+		old = Irq_AtomicLoad32(&Can_ErrFlags);
+		esr = CAN1->ESR;
+	} while(Irq_AtomicCas32(&Can_ErrFlags, old, old & esr) == FALSE);
+
+	if(Irq_AtomicExchange32(&Can_BusOffPending, FALSE) == FALSE)
+	{
+		return;
+	}
+
+	// init mode right away, the restart (and its back-off) belongs to CanSM
+	(void)Can_SetControllerMode(0U, CAN_CS_STOPPED);
+	Can_ControllerBusOff(0U);
+}
+
+void Can_MainFunction_Wakeup(void)
+{
+	if((Can_State == CAN_CS_SLEEP) && (Can_SceIrq == FALSE) && (CAN1->MSR & CAN_MSR_WKUI))
+	{
+		CAN1_SCE_IRQHandler();
+	}
+}
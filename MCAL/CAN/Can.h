@@ -16,13 +16,50 @@ extern "C" {
 
 #include "Can_Types.h"
 
+/*
+ * Controller left in init mode (CAN_CS_STOPPED), SCE interrupt on for warning / passive / bus-off.
+ * Stays CAN_CS_UNINIT when the controller does not acknowledge init mode within CAN_CFG_MODE_TIMEOUT_POLLS
+ */
 void Can_Init(const Can_ConfigType* Config);
+
+/*
+ * STARTED: leave init / sleep mode. STOPPED: enter init mode, the pending mailbox is aborted without confirmation.
+ * SLEEP: from STOPPED only, the first frame on the bus wakes the controller (AWUM) and is lost, Can_ControllerWakeup
+ * reports it; the controller is then back on the bus, the driver state stays SLEEP until the next mode request.
+ * E_NOT_OK: not initialised, other mode or no acknowledge within CAN_CFG_MODE_TIMEOUT_POLLS (mode unchanged)
+ */
 Std_ReturnType Can_SetControllerMode(uint8 Controller, Can_ControllerStateType Mode);
+Std_ReturnType Can_GetControllerMode(uint8 Controller, Can_ControllerStateType* ControllerModePtr);
+
+Std_ReturnType Can_GetControllerErrorState(uint8 Controller, Can_ErrorStateType* ErrorStatePtr);
+
+// Error counters now, last error code and state transitions since Can_Init
+Std_ReturnType Can_GetStatistics(uint8 Controller, Can_StatisticsType* StatisticsPtr);
+
+// E_NOT_OK: mailbox busy, controller stopped (bus-off, recovery not started yet) or asleep
 Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType* PduInfo);
 
 void Can_MainFunction_Tx(void);
 void Can_MainFunction_Rx(void);
 
+/*
+ * Bus-off latched by the SCE interrupt: controller to CAN_CS_STOPPED, then Can_ControllerBusOff.
+ * Recovery is left to the upper layer (CanSM): ABOM is off, the controller only returns on CAN_CS_STARTED
+ */
+void Can_MainFunction_BusOff(void);
+
+// Wake-up of a sleeping controller when the SCE line is not in the interrupt plan (polled WKUI)
+void Can_MainFunction_Wakeup(void);
+
+// SCE: error warning / passive / bus-off, counted here, bus-off handed to Can_MainFunction_BusOff. Wake-up
+void CAN1_SCE_IRQHandler(void);
+
+/* Upper layer callbacks, weak no-op defaults in Can.c (CanIf provides them) */
+void Can_TxConfirmation(Can_HwHandleType SwPduHandle);		// swpduHandle of the confirmed Can_Write
+void Can_RxIndication(Can_HwHandleType Hrh, const Can_PduType* PduInfo);
+void Can_ControllerBusOff(uint8 Controller);				// task context (Can_MainFunction_BusOff)
+void Can_ControllerWakeup(uint8 Controller);				// SCE interrupt (or Can_MainFunction_Wakeup)
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,9 +23,11 @@ typedef uint8		Std_ReturnType;
 #define E_NOT_OK	((Std_ReturnType)0x01u)
 #endif
 
-// Can ID type
+// Can ID type, MSB set: 29 bit extended identifier
 typedef uint32 Can_IdType;
 
+#define CAN_ID_EXTENDED		((Can_IdType)0x80000000UL)
+
 // HW transmit handle
 typedef uint8 Can_HwHandleType;
 
@@ -38,12 +40,44 @@ typedef enum
 	CAN_CS_SLEEP
 } Can_ControllerStateType;
 
+// Fault confinement state (ESR EPVF / BOFF)
+typedef enum
+{
+	CAN_ERRORSTATE_ACTIVE	= 0,
+	CAN_ERRORSTATE_PASSIVE,				// TEC or REC > 127
+	CAN_ERRORSTATE_BUSOFF				// TEC > 255, off the bus until the recovery
+} Can_ErrorStateType;
+
+// Last error code (ESR LEC)
+#define CAN_LEC_NONE			(0u)
+#define CAN_LEC_STUFF			(1u)
+#define CAN_LEC_FORM			(2u)
+#define CAN_LEC_ACK				(3u)
+#define CAN_LEC_BIT_RECESSIVE	(4u)
+#define CAN_LEC_BIT_DOMINANT	(5u)
+#define CAN_LEC_CRC				(6u)
+
+// Error counters and fault confinement history of a controller
+typedef struct
+{
+	Can_ErrorStateType ErrorState;
+	uint8 Tec;
+	uint8 Rec;
+	uint8 LastErrorCode;			// CAN_LEC_*, last error the controller reported since Can_Init
+	uint16 WarningCount;			// transitions into each state since Can_Init
+	uint16 PassiveCount;
+	uint16 BusOffCount;
+} Can_StatisticsType;
+
+// Longest data field: bxCAN is classic CAN (an FD controller would raise it to 64 and map lengths to DLC codes)
+#define CAN_MAX_PDU_LENGTH	(8u)
+
 // PDU definition
 typedef struct
 {
 	Can_IdType Id;
-	uint8 length;
-	uint8* sdu;
+	uint8 length;					// data bytes = DLC, 0 .. CAN_MAX_PDU_LENGTH
+	uint8* sdu;						// length bytes, may be NULL when length is 0
 	Can_HwHandleType swpduHandle;
 } Can_PduType;
 
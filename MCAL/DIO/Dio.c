@@ -71,3 +71,24 @@ void Dio_WritePort(Dio_ChannelType pinID, Dio_PortLevelType Level)
 	GPIOx->ODR = Level ;
 }
 
+/*
+ * Read adjacent pins of a port in one access
+ */
+Dio_PortLevelType Dio_ReadChannelGroup(const Dio_ChannelGroupType* Group)
+{
+	if(Group == NULL_PTR) return 0u;
+	return (Dio_PortLevelType)((Group->Port->IDR & Group->Mask) >> Group->Offset);
+}
+
+/*
+ * Write adjacent pins of a port, upper half of BSRR resets, lower half sets
+ */
+void Dio_WriteChannelGroup(const Dio_ChannelGroupType* Group, Dio_PortLevelType Level)
+{
+	if(Group == NULL_PTR) return;
+
+	uint32 set = ((uint32)Level << Group->Offset) & Group->Mask;
+	uint32 rst = (~((uint32)Level << Group->Offset)) & Group->Mask;
+	Group->Port->BSRR = (rst << 16) | set;
+}
+
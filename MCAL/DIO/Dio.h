@@ -46,7 +46,61 @@ Dio_PortLevelType Dio_ReadPort(Dio_ChannelType pinID);
 /*
  * Write all a Port
  */
-Dio_PortLevelType Dio_ReadPort(Dio_ChannelType pinID);
+void Dio_WritePort(Dio_ChannelType pinID, Dio_PortLevelType Level);
+
+/*
+ * Read adjacent pins of a port in one access, right aligned
+ */
+Dio_PortLevelType Dio_ReadChannelGroup(const Dio_ChannelGroupType* Group);
+
+/*
+ * Write adjacent pins of a port in one BSRR store (set + reset together)
+ */
+void Dio_WriteChannelGroup(const Dio_ChannelGroupType* Group, Dio_PortLevelType Level);
+
+/* =====================================================================================================================
+ *  Fast path
+ *  Pin ID from Port_Cfg.h (port << 4 | pin) resolves to GPIO base + mask in the preprocessor.
+ *  With a constant pin ID each access is one IDR load + mask, or one BSRR/BRR store.
+ *  No Port init check: only use on pins configured by Port_Init.
+ * ===================================================================================================================*/
+#define DIO_GPIO_BASE(_pinId)				(GPIOA_BASE + ((uint32)(((_pinId) >> 4) & 0x0Fu) * 0x400UL))
+#define DIO_GPIO(_pinId)					((Dio_PortType*)DIO_GPIO_BASE(_pinId))
+#define DIO_PIN_MASK(_pinId)				(1UL << ((uint32)(_pinId) & 0x0Fu))
+
+#define DIO_FAST_CHANNEL(_pinId)			{ DIO_GPIO(_pinId), DIO_PIN_MASK(_pinId) }
+#define DIO_CHANNEL_GROUP(_firstPinId, _width) \
+	{ DIO_GPIO(_firstPinId), (uint16)(((1UL << (_width)) - 1UL) << ((_firstPinId) & 0x0Fu)), (uint8)((_firstPinId) & 0x0Fu) }
+
+static inline Dio_ChannelState Dio_ReadChannelFast(Dio_ChannelType pinID)
+{
+	return ((DIO_GPIO(pinID)->IDR & DIO_PIN_MASK(pinID)) != 0u) ? PORT_PIN_LEVEL_HIGH : PORT_PIN_LEVEL_LOW;
+}
+
+static inline void Dio_WriteChannelFast(Dio_ChannelType pinID, Dio_ChannelState Level)
+{
+	if(Level == PORT_PIN_LEVEL_HIGH)
+	{
+		DIO_GPIO(pinID)->BSRR = DIO_PIN_MASK(pinID);
+	} else {
+		DIO_GPIO(pinID)->BRR = DIO_PIN_MASK(pinID);
+	}
+}
+
+static inline Dio_ChannelState Dio_ReadFastChannel(const Dio_FastChannelType* Ch)
+{
+	return ((Ch->Port->IDR & Ch->Mask) != 0u) ? PORT_PIN_LEVEL_HIGH : PORT_PIN_LEVEL_LOW;
+}
+
+static inline void Dio_WriteFastChannel(const Dio_FastChannelType* Ch, Dio_ChannelState Level)
+{
+	if(Level == PORT_PIN_LEVEL_HIGH)
+	{
+		Ch->Port->BSRR = Ch->Mask;
+	} else {
+		Ch->Port->BRR = Ch->Mask;
+	}
+}
 
 #ifdef __cplusplus
 }
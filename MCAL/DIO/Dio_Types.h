@@ -30,6 +30,23 @@ typedef struct {
 	Dio_PortType* PortID;
 } Dio_ChannelGroupLevel;
 
+/*
+ * Pre-resolved channel: GPIO base + bit mask, built by DIO_FAST_CHANNEL() at compile time
+ */
+typedef struct {
+	Dio_PortType*	Port;
+	uint32			Mask;
+} Dio_FastChannelType;
+
+/*
+ * Adjacent pins of one port, read/written with a single IDR load / BSRR store
+ */
+typedef struct {
+	Dio_PortType*	Port;
+	uint16			Mask;		// bits inside port
+	uint8			Offset;		// position of lowest bit
+} Dio_ChannelGroupType;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,204 @@
+/* =====================================================================================================================
+ *  File        : Fls.c
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Internal flash driver: page erase / half-word program jobs as a polled state machine
+ *  Notes       : The job owner is the one caller of Fls_MainFunction (NvM), no locking.
+ * 				  SR flags are rc_w1, the driver always writes the full flag mask to clear them.
+ *  Depends     : Fls.h, Fls_Cfg.h
+ * ===================================================================================================================*/
+
+#include "Fls.h"
+#include "Fls_Cfg.h"
+
+#define FLS_SR_FLAGS			(FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR)
+// via unsigned long: pointer-sized on the target and on the 64 bit host build
+#define FLS_MEM16(_a)			(*(__vo uint16*)(unsigned long)(_a))
+#define FLS_MEM8(_a)			((const __vo uint8*)(unsigned long)(_a))
+
+typedef enum
+{
+	FLS_JOB_NONE	= 0,
+	FLS_JOB_ERASE,
+	FLS_JOB_WRITE
+} Fls_JobType;
+
+static Fls_StatusType		Fls_State	= FLS_UNINIT;
+static Fls_JobResultType	Fls_Result	= FLS_JOB_OK;
+static Fls_JobType			Fls_Job		= FLS_JOB_NONE;
+static Fls_AddressType		Fls_Addr;				// page being erased / half-word being programmed
+static Fls_AddressType		Fls_End;
+static const uint8*			Fls_Src;				// source byte of Fls_Addr
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static boolean prv_InFlash(Fls_AddressType Address, Fls_LengthType Length, Fls_AddressType Start)
+{
+	Fls_AddressType end = FLS_CFG_BASE_ADDRESS + FLS_CFG_TOTAL_SIZE;
+
+	return ((Length != 0u) && (Address >= Start) && (Address < end) && (Length <= (end - Address))) ? TRUE : FALSE;
+}
+
+// Key sequence; a wrong key locks the FPEC until reset, so it is only written while LOCK is set
+static boolean prv_Unlock(void)
+{
+	if(FLASH_R->CR & FLASH_CR_LOCK)
+	{
+		FLASH_R->KEYR = FLASH_KEY1;
+		REG_SYNC();
+		FLASH_R->KEYR = FLASH_KEY2;
+		REG_SYNC();
+	}
+	return ((FLASH_R->CR & FLASH_CR_LOCK) == 0u) ? TRUE : FALSE;
+}
+
+static void prv_Finish(Fls_JobResultType Result)
+{
+	FLASH_R->CR	= FLASH_CR_LOCK;
+	Fls_Job		= FLS_JOB_NONE;
+	Fls_Result	= Result;
+	Fls_State	= FLS_IDLE;
+}
+
+static void prv_StartErase(void)
+{
+	FLASH_R->CR	= FLASH_CR_PER;
+	FLASH_R->AR	= Fls_Addr;
+	FLASH_R->CR	= FLASH_CR_PER | FLASH_CR_STRT;
+	REG_SYNC();		// BSY from here on, before the next SR read
+}
+
+static uint16 prv_SrcHalfWord(void)
+{
+	return (uint16)((uint16)Fls_Src[0] | ((uint16)Fls_Src[1] << 8));
+}
+
+static void prv_StartProgram(void)
+{
+	FLASH_R->CR				= FLASH_CR_PG;
+	FLS_MEM16(Fls_Addr)		= prv_SrcHalfWord();
+	REG_SYNC();
+}
+
+static Std_ReturnType prv_Start(Fls_JobType Job, Fls_AddressType Address, Fls_LengthType Length, const uint8* Src)
+{
+	if((Fls_State != FLS_IDLE) || (prv_InFlash(Address, Length, FLS_CFG_WRITABLE_START) == FALSE)) return E_NOT_OK;
+
+	if(prv_Unlock() == FALSE)
+	{
+		Fls_Result = FLS_JOB_FAILED;
+		return E_NOT_OK;
+	}
+	FLASH_R->SR	= FLS_SR_FLAGS;
+
+	Fls_Job		= Job;
+	Fls_Addr	= Address;
+	Fls_End		= Address + Length;
+	Fls_Src		= Src;
+	Fls_Result	= FLS_JOB_PENDING;
+	Fls_State	= FLS_BUSY;
+
+	if(Job == FLS_JOB_ERASE)	prv_StartErase();
+	else						prv_StartProgram();
+	return E_OK;
+}
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void Fls_Init(void)
+{
+	FLASH_R->CR	= FLASH_CR_LOCK;
+	FLASH_R->SR	= FLS_SR_FLAGS;
+	Fls_Job		= FLS_JOB_NONE;
+	Fls_Result	= FLS_JOB_OK;
+	Fls_State	= FLS_IDLE;
+}
+
+Std_ReturnType Fls_Erase(Fls_AddressType Address, Fls_LengthType Length)
+{
+	if(((Address % FLS_CFG_PAGE_SIZE) != 0u) || ((Length % FLS_CFG_PAGE_SIZE) != 0u)) return E_NOT_OK;
+	return prv_Start(FLS_JOB_ERASE, Address, Length, NULL_PTR);
+}
+
+Std_ReturnType Fls_Write(Fls_AddressType Address, const uint8* SourceAddressPtr, Fls_LengthType Length)
+{
+	if((SourceAddressPtr == NULL_PTR) || ((Address & 1u) != 0u) || ((Length & 1u) != 0u)) return E_NOT_OK;
+	return prv_Start(FLS_JOB_WRITE, Address, Length, SourceAddressPtr);
+}
+
+Std_ReturnType Fls_Read(Fls_AddressType Address, uint8* TargetAddressPtr, Fls_LengthType Length)
+{
+	const __vo uint8* p = FLS_MEM8(Address);
+	Fls_LengthType i;
+
+	if((TargetAddressPtr == NULL_PTR) || (prv_InFlash(Address, Length, FLS_CFG_BASE_ADDRESS) == FALSE)) return E_NOT_OK;
+
+	for(i = 0u; i < Length; i++) TargetAddressPtr[i] = p[i];
+	return E_OK;
+}
+
+Std_ReturnType Fls_BlankCheck(Fls_AddressType Address, Fls_LengthType Length)
+{
+	const __vo uint8* p = FLS_MEM8(Address);
+	Fls_LengthType i;
+
+	if(prv_InFlash(Address, Length, FLS_CFG_BASE_ADDRESS) == FALSE) return E_NOT_OK;
+
+	for(i = 0u; i < Length; i++)
+	{
+		if(p[i] != 0xFFu) return E_NOT_OK;
+	}
+	return E_OK;
+}
+
+Fls_StatusType Fls_GetStatus(void)
+{
+	return Fls_State;
+}
+
+Fls_JobResultType Fls_GetJobResult(void)
+{
+	return Fls_Result;
+}
+
+void Fls_MainFunction(void)
+{
+	uint32 sr;
+
+	if(Fls_State != FLS_BUSY) return;
+
+	sr = FLASH_R->SR;
+	if(sr & FLASH_SR_BSY) return;
+
+	FLASH_R->SR = FLS_SR_FLAGS;
+	if(sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR))
+	{
+		prv_Finish(FLS_JOB_FAILED);
+		return;
+	}
+
+	if(Fls_Job == FLS_JOB_ERASE)
+	{
+		if(Fls_BlankCheck(Fls_Addr, FLS_CFG_PAGE_SIZE) != E_OK)
+		{
+			prv_Finish(FLS_JOB_FAILED);
+			return;
+		}
+		Fls_Addr += FLS_CFG_PAGE_SIZE;
+		if(Fls_Addr >= Fls_End)	prv_Finish(FLS_JOB_OK);
+		else					prv_StartErase();
+		return;
+	}
+
+	if(FLS_MEM16(Fls_Addr) != prv_SrcHalfWord())
+	{
+		prv_Finish(FLS_JOB_FAILED);
+		return;
+	}
+	Fls_Addr	+= 2u;
+	Fls_Src		+= 2u;
+	if(Fls_Addr >= Fls_End)	prv_Finish(FLS_JOB_OK);
+	else					prv_StartProgram();
+}
@@ -0,0 +1,52 @@
+/* =====================================================================================================================
+ *  File        : Fls.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Declare API for the internal flash driver (FPEC page erase, half-word programming)
+ *  Notes       : Fls_Erase / Fls_Write only start a job, Fls_MainFunction advances it by at most one page erase or
+ * 				  one half-word per call and never waits on BSY. The FPEC is unlocked for the job only.
+ * 				  Single bank: a fetch from flash stalls while BSY (about 20 ms per page erase, 52 us per half-word),
+ * 				  the driver keeps the software from spinning, the bus stall itself stays.
+ * ===================================================================================================================*/
+
+#ifndef FLS_FLS_H_
+#define FLS_FLS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Fls_Types.h"
+
+// FPEC locked, flags cleared, no job
+void Fls_Init(void);
+
+/*
+ * Erase the pages of [Address, Address + Length), both page aligned, at or above FLS_CFG_WRITABLE_START.
+ * E_NOT_OK: not initialised, a job is running or the range is not allowed
+ */
+Std_ReturnType Fls_Erase(Fls_AddressType Address, Fls_LengthType Length);
+
+/*
+ * Program Length bytes (even, half-word aligned Address) from SourceAddressPtr, which must stay valid until the
+ * job ends. Each half-word is read back. E_NOT_OK: as Fls_Erase
+ */
+Std_ReturnType Fls_Write(Fls_AddressType Address, const uint8* SourceAddressPtr, Fls_LengthType Length);
+
+// Copy from the memory mapped flash, synchronous. E_NOT_OK: range outside the flash
+Std_ReturnType Fls_Read(Fls_AddressType Address, uint8* TargetAddressPtr, Fls_LengthType Length);
+
+// E_OK: every byte of the range reads 0xFF (erased), synchronous
+Std_ReturnType Fls_BlankCheck(Fls_AddressType Address, Fls_LengthType Length);
+
+Fls_StatusType Fls_GetStatus(void);
+Fls_JobResultType Fls_GetJobResult(void);
+
+// Job progress, call every main loop pass
+void Fls_MainFunction(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLS_FLS_H_ */
@@ -0,0 +1,41 @@
+/* =====================================================================================================================
+ *  File        : Fls_Types.h
+ *  Layer       : MCAL
+ *  ECU         : STM32F103C6T6
+ *  Purpose     : Define data structure for the internal flash driver
+ *  Notes       :
+ * ===================================================================================================================*/
+
+#ifndef FLS_FLS_TYPES_H_
+#define FLS_FLS_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+// Absolute address in the memory map (0x08000000 ..)
+typedef uint32 Fls_AddressType;
+typedef uint32 Fls_LengthType;
+
+typedef enum
+{
+	FLS_UNINIT	= 0,
+	FLS_IDLE,
+	FLS_BUSY
+} Fls_StatusType;
+
+// Result of the last Fls_Erase / Fls_Write job
+typedef enum
+{
+	FLS_JOB_OK		= 0,
+	FLS_JOB_PENDING,
+	FLS_JOB_FAILED						// PGERR / WRPRTERR, read back mismatch or the FPEC stayed locked
+} Fls_JobResultType;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLS_FLS_TYPES_H_ */
@@ -7,6 +7,8 @@
  * ===================================================================================================================*/
 
 #include "Icu.h"
+#include "Irq.h"
+#include "Irq_Atomic.h"
 
 // Private Macro
 #define ICU_NOT_INITIALIZED		0U
@@ -20,12 +22,21 @@ static uint32 Icu_RiseTime[ICU_MAX_CHANNELS];
 static uint32 Icu_FallTime[ICU_MAX_CHANNELS];
 static uint32 Icu_PulseWidth[ICU_MAX_CHANNELS];
 
-// Measurement state
-static uint8 Icu_MeasurementDone[ICU_MAX_CHANNELS];
+// Measurement state, published by the ISR after Icu_PulseWidth (Irq_AtomicStore32)
+static volatile uint32 Icu_MeasurementDone[ICU_MAX_CHANNELS];
 
 // Store config pointer
 static const Icu_ConfigType* Icu_ConfigPtr = NULL_PTR;
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+// Ranging state, shared with TIM2 ISR
+static volatile Icu_RangingStateType	Icu_RngState	= ICU_RANGING_IDLE;
+static volatile uint16					Icu_RngRise		= 0u;
+static volatile uint16					Icu_RngWidth	= 0u;
+static volatile uint8					Icu_RngEdge		= 0u;
+static uint16							Icu_RngTimeout	= 0u;
+#endif
+
 /* =================== PRIVATE FUNCTIONS =================== */
 /*
  * Get TIM instance from channel config
@@ -36,31 +47,52 @@ static TIM_TypeDef* Icu_GetTimer(Icu_ChannelType Channel)
 	return TIM2;
 }
 
-/* enable/disable NVIC IRQ for channel */
-static void prv_EnableIrq(IRQn_Type irqn, boolean enable)
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+static void Icu_HwInit(Icu_ChannelType Channel)
 {
-	irqn = TIM2_IRQn;
-
-	volatile uint32* ISER = (uint32*)0xE000E100UL;
-	volatile uint32* ICER = (uint32*)0xE000E180UL;
-	volatile uint32* ICPR = (uint32*)0xE000E280UL;
-
-	if(irqn < 0) return;
-	uint32 n   = (uint32)irqn;
-	uint32 idx = n >> 5;           // /32
-	uint32 bit = n & 0x1FU;        // %32
-	uint32 mask = (1UL << bit);
-
-	if (enable) {
-		ICPR[idx] = mask;            // clear pending before enable
-		ISER[idx] = mask;            // enable
-	} else {
-		ICER[idx] = mask;            // disable
-		ICPR[idx] = mask;            // clear pending
-	}
-}
+	TIM_TypeDef* TIMx = Icu_GetTimer(Channel);
+
+	// Enable TIM2 clock
+	RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+
+	// 72MHz / 72 = 1MHz, same timebase as Gpt
+	TIMx->PSC = 72-1;
+	TIMx->ARR = ICU_TIMER_MASK;
+
+	// CH1: input capture on TI1 (echo), disabled until armed
+	// CH2: output compare (trigger), held low
+	TIMx->CCER	&= ~(TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC2P);
+	TIMx->CCMR1	 = (TIMx->CCMR1 & ~(TIM_CCMR1_CC1S | TIM_CCMR1_CC2S | TIM_CCMR1_OC2M | TIM_CCMR1_OC2PE))
+				 | TIM_CCMR1_CC1S_1 | TIM_CCMR1_OC2M_FORCE_LO;
+	TIMx->CCER	|= TIM_CCER_CC2E;
+
+	// CH3: compare only, timeout of echo window
+	TIMx->CCMR2 &= ~(TIM_CCMR2_CC3S | TIM_CCMR2_OC3M);
+
+	TIMx->DIER &= ~(TIM_DIER_CC1IE | TIM_DIER_CC2IE | TIM_DIER_CC3IE);
 
+	// PSC is buffered: without an update event the counter runs undivided until the first wrap,
+	// a trigger in that window would be a 10 tick (<1us) pulse
+	TIMx->EGR	= TIM_EGR_UG;
+	REG_SYNC();
+	TIMx->SR	= 0u;
 
+	// Enable counter
+	TIMx->CR1 |= TIM_CR1_CEN;
+
+	// Enable NVIC for TIM2 (level from the Irq table)
+	(void)Irq_EnableLine(IRQ_NUM_TIM2);
+
+	Icu_RngState = ICU_RANGING_IDLE;
+}
+
+static void prv_RangingStop(TIM_TypeDef* TIMx, Icu_RangingStateType result)
+{
+	TIMx->DIER	&= ~(TIM_DIER_CC1IE | TIM_DIER_CC3IE);
+	TIMx->CCER	&= ~(TIM_CCER_CC1E | TIM_CCER_CC1P);
+	Icu_RngState = result;
+}
+#else
 static void Icu_HwInit(Icu_ChannelType Channel)
 {
 	TIM_TypeDef* TIMx = Icu_GetTimer(Channel);
@@ -90,9 +122,10 @@ static void Icu_HwInit(Icu_ChannelType Channel)
 	// Enable counter
 	TIMx->CR1 |= TIM_CR1_CEN;
 
-	// Enable NVIC for TIM2
-	prv_EnableIrq(TIM2_IRQn, TRUE);
+	// Enable NVIC for TIM2 (level from the Irq table)
+	(void)Irq_EnableLine(IRQ_NUM_TIM2);
 }
+#endif
 
 /* =================== ICU API FUNCTION =================== */
 
@@ -115,13 +148,14 @@ Std_ReturnType Icu_Init(const Icu_ConfigType* ConfigPtr)
 
 	Icu_InitState = ICU_INITIALIZED;
 
+	return E_OK;
 }
 
 Std_ReturnType Icu_StartSignalMeasurement(Icu_ChannelType Channel)
 {
 	if(Icu_InitState != ICU_INITIALIZED)	return E_NOT_OK;
 
-	Icu_MeasurementDone[Channel] = 0;
+	Irq_AtomicStore32(&Icu_MeasurementDone[Channel], 0u);
 
 	// Reset timer counter
 	Icu_GetTimer(Channel)->CNT = 0;
@@ -129,11 +163,12 @@ Std_ReturnType Icu_StartSignalMeasurement(Icu_ChannelType Channel)
 	// Capture rising edge first
 	Icu_GetTimer(Channel)->CCER &= ~(TIM_CCER_CC1P);
 
+	return E_OK;
 }
 
 uint32 Icu_GetTimeElapsed(Icu_ChannelType Channel)
 {
-	if( Icu_MeasurementDone[Channel] == 1U)
+	if(Irq_AtomicLoad32(&Icu_MeasurementDone[Channel]) == 1U)
 	{
 		return Icu_PulseWidth[Channel];
 	}
@@ -149,8 +184,96 @@ void Icu_StopSignalMeasurement(Icu_ChannelType Channel)
 	Icu_GetTimer(Channel)->DIER &= TIM_DIER_CC1IE;
 }
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+Std_ReturnType Icu_StartRanging(Icu_ChannelType Channel, uint16 PulseTicks, uint16 TimeoutTicks)
+{
+	TIM_TypeDef* TIMx = Icu_GetTimer(Channel);
+	uint32 sv;
+
+	if(Icu_InitState != ICU_INITIALIZED)	return E_NOT_OK;
+	if(Icu_RngState == ICU_RANGING_BUSY)	return E_NOT_OK;
+
+	prv_RangingStop(TIMx, ICU_RANGING_BUSY);
+	Icu_RngEdge		= 0u;
+	Icu_RngTimeout	= TimeoutTicks;
+
+	/*
+	 * CCR2 is loaded before the output is forced high, so the compare falls at
+	 * least PulseTicks after the rising edge (+1 covers a tick between read and force).
+	 * Falling edge is produced by hardware, only the mode switch must beat it.
+	 */
+	IRQ_ENTER_CRITICAL_ALL(sv);
+	TIMx->CCR2	= (TIMx->CNT + PulseTicks + 1u) & ICU_TIMER_MASK;
+	TIMx->SR	= ~(uint32)TIM_SR_CC2IF;
+	TIMx->CCMR1	= (TIMx->CCMR1 & ~TIM_CCMR1_OC2M) | TIM_CCMR1_OC2M_FORCE_HI;
+	REG_SYNC();
+	TIMx->CCMR1	= (TIMx->CCMR1 & ~TIM_CCMR1_OC2M) | TIM_CCMR1_OC2M_INACTIVE;
+	TIMx->DIER	|= TIM_DIER_CC2IE;
+	IRQ_EXIT_CRITICAL_ALL(sv);
+
+	return E_OK;
+}
+
+Icu_RangingStateType Icu_GetRanging(Icu_ChannelType Channel, uint16* WidthTicks)
+{
+	(void)Channel;
+	Icu_RangingStateType st = Icu_RngState;
+
+	if(st == ICU_RANGING_DONE)
+	{
+		if(WidthTicks != NULL_PTR) *WidthTicks = Icu_RngWidth;
+		Icu_RngState = ICU_RANGING_IDLE;
+	} else if(st == ICU_RANGING_TIMEOUT) {
+		Icu_RngState = ICU_RANGING_IDLE;
+	}
+
+	return st;
+}
+#endif
+
 /* =================== ICU INTERRUPT SERVICE =================== */
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+void TIM2_IRQHandler(void)
+{
+	TIM_TypeDef* TIMx = TIM2;
+	uint32 sr = TIMx->SR;
+
+	// trigger falling edge: arm echo capture (rising) and timeout window
+	if((sr & TIM_SR_CC2IF) && (TIMx->DIER & TIM_DIER_CC2IE))
+	{
+		TIMx->DIER	&= ~TIM_DIER_CC2IE;
+		TIMx->CCR3	= (TIMx->CCR2 + Icu_RngTimeout) & ICU_TIMER_MASK;
+		TIMx->SR	= ~(uint32)(TIM_SR_CC2IF | TIM_SR_CC1IF | TIM_SR_CC3IF | TIM_SR_CC1OF);
+		TIMx->CCER	= (TIMx->CCER & ~TIM_CCER_CC1P) | TIM_CCER_CC1E;
+		TIMx->DIER	|= (TIM_DIER_CC1IE | TIM_DIER_CC3IE);
+		sr			&= ~(TIM_SR_CC1IF | TIM_SR_CC3IF);		// stale flags were just cleared
+	}
+
+	// echo edges, reading CCR1 clears CC1IF
+	if((sr & TIM_SR_CC1IF) && (TIMx->DIER & TIM_DIER_CC1IE))
+	{
+		uint16 cap = (uint16)(TIMx->CCR1 & ICU_TIMER_MASK);
+
+		if(Icu_RngEdge == 0u)
+		{
+			Icu_RngRise	= cap;
+			Icu_RngEdge	= 1u;
+			TIMx->CCER	|= TIM_CCER_CC1P;
+		} else {
+			Icu_RngWidth = (uint16)((cap - Icu_RngRise) & ICU_TIMER_MASK);
+			prv_RangingStop(TIMx, ICU_RANGING_DONE);
+		}
+	}
+
+	// no (complete) echo inside window
+	if((sr & TIM_SR_CC3IF) && (TIMx->DIER & TIM_DIER_CC3IE))
+	{
+		TIMx->SR = ~(uint32)TIM_SR_CC3IF;
+		prv_RangingStop(TIMx, ICU_RANGING_TIMEOUT);
+	}
+}
+#else
 void TIM2_IRQHandler(void)
 {
 	if(TIM2->SR & TIM_SR_CC1IF)
@@ -176,7 +299,7 @@ void TIM2_IRQHandler(void)
 				Icu_PulseWidth[0] = (0xFFFFFFFF - Icu_RiseTime[0]) + Icu_FallTime[0];
 			}
 
-			Icu_MeasurementDone[0] = 1;
+			Irq_AtomicStore32(&Icu_MeasurementDone[0], 1u);
 
 			// prepare for next measurement
 			TIM2->CCER &= ~(TIM_CCER_CC1P);
@@ -187,3 +310,4 @@ void TIM2_IRQHandler(void)
 		TIM2->SR &= ~TIM_SR_CC1IF;
 	}
 }
+#endif
@@ -14,6 +14,7 @@ extern "C" {
 
 #include "stm32f103xx_regs.h"
 #include "Icu_Types.h"
+#include "Icu_Cfg.h"
 
 // we only use TIMER2
 #define ICU_GET_TIMER(ch)		(TIM2)
@@ -25,6 +26,24 @@ Std_ReturnType Icu_StartSignalMeasurement(Icu_ChannelType Channel);
 uint32 Icu_GetTimeElapsed(Icu_ChannelType Channel);
 void Icu_StopSignalMeasurement(Icu_ChannelType Channel);
 
+#if (ICU_CFG_HCSR04_HW_TRIGGER == 1u)
+/*
+ * Emit a PulseTicks wide trigger on CH2 (exact, done by compare hardware),
+ * arm echo capture on its falling edge and a TimeoutTicks window after it.
+ * E_NOT_OK if not initialized or a measurement is still running.
+ */
+Std_ReturnType Icu_StartRanging(Icu_ChannelType Channel, uint16 PulseTicks, uint16 TimeoutTicks);
+
+/*
+ * Poll ranging result. DONE: *WidthTicks = echo high time. DONE/TIMEOUT are
+ * reported once, then the channel returns to IDLE.
+ */
+Icu_RangingStateType Icu_GetRanging(Icu_ChannelType Channel, uint16* WidthTicks);
+#endif
+
+// Vector table entry, exported for the benchmark suite
+void TIM2_IRQHandler(void);
+
 #if __cplusplus
 }
 #endif
@@ -44,6 +44,14 @@ typedef struct
 	Icu_ActivationType DefaultEdge;
 } Icu_ChannelConfigType;
 
+// Hardware triggered ranging (trigger pulse + echo capture + timeout on one timer)
+typedef enum {
+	ICU_RANGING_IDLE = 0u,
+	ICU_RANGING_BUSY,
+	ICU_RANGING_DONE,
+	ICU_RANGING_TIMEOUT
+} Icu_RangingStateType;
+
 typedef struct
 {
 	uint8 numsChannel;
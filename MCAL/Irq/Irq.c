@@ -0,0 +1,80 @@
+/* =====================================================================================================================
+ *  File        : Irq.c
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Apply the interrupt priority plan and own NVIC enable / disable
+ *  Depends     : Irq.h, Mcu.h (grouping, priority encoding), stm32f103xx_regs.h
+ * ===================================================================================================================*/
+
+#include "Irq.h"
+#include "Mcu.h"
+#include "stm32f103xx_regs.h"
+
+#define IRQ_NVIC_WORDS				((IRQ_NUM_LINES + 31) / 32)
+
+/* Driver state */
+static const Irq_ConfigType* s_cfg = NULL_PTR;
+
+static const Irq_LineCfgType* prv_Find(Irq_NumberType Irqn)
+{
+	uint8 i;
+
+	for(i = 0u; i < s_cfg->LineCount; i++)
+	{
+		if(s_cfg->Lines[i].Irqn == Irqn) return &s_cfg->Lines[i];
+	}
+	return NULL_PTR;
+}
+
+Std_ReturnType Irq_Init(const Irq_ConfigType* ConfigPtr)
+{
+	uint8 i;
+
+	if((ConfigPtr == NULL_PTR) || (ConfigPtr->Lines == NULL_PTR)) return E_NOT_OK;
+	s_cfg = NULL_PTR;
+
+	/* nothing enabled before the levels are in place */
+	for(i = 0u; i < IRQ_NVIC_WORDS; i++)
+	{
+		NVIC_ICER[i] = 0xFFFFFFFFUL;
+		NVIC_ICPR[i] = 0xFFFFFFFFUL;
+	}
+	REG_SYNC();
+
+	(void)Mcu_SetNvicPriorityGrouping((uint32)ConfigPtr->PriGroup);
+
+	for(i = 0u; i < ConfigPtr->LineCount; i++)
+	{
+		const Irq_LineCfgType* l = &ConfigPtr->Lines[i];
+
+		if(Mcu_SetIrqPriority((sint32)l->Irqn, l->Preempt, l->Sub) != E_OK) return E_NOT_OK;
+	}
+
+	s_cfg = ConfigPtr;
+	return E_OK;
+}
+
+Std_ReturnType Irq_EnableLine(Irq_NumberType Irqn)
+{
+	if((s_cfg == NULL_PTR) || (Irqn < 0) || (Irqn >= IRQ_NUM_LINES)) return E_NOT_OK;
+	if(prv_Find(Irqn) == NULL_PTR) return E_NOT_OK;
+
+	uint32 idx	= (uint32)Irqn >> 5;
+	uint32 mask	= 1UL << ((uint32)Irqn & 0x1FUL);
+
+	NVIC_ICPR[idx] = mask;		// clear pending before enable
+	NVIC_ISER[idx] = mask;
+	return E_OK;
+}
+
+Std_ReturnType Irq_DisableLine(Irq_NumberType Irqn)
+{
+	if((Irqn < 0) || (Irqn >= IRQ_NUM_LINES)) return E_NOT_OK;
+
+	uint32 idx	= (uint32)Irqn >> 5;
+	uint32 mask	= 1UL << ((uint32)Irqn & 0x1FUL);
+
+	NVIC_ICER[idx] = mask;
+	NVIC_ICPR[idx] = mask;
+	return E_OK;
+}
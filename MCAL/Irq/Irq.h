@@ -0,0 +1,96 @@
+/* =====================================================================================================================
+ *  File        : Irq.h
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Interrupt manager: single owner of NVIC enable / priority
+ * 					- Irq_Init applies the grouping and the level of every line in Irq_Config, all lines start off
+ * 					- drivers enable their line through Irq_EnableLine, a line missing from the table is refused,
+ * 					  so nothing runs at the default (highest) level by accident
+ * 					- IRQ_ENTER_CRITICAL masks by BASEPRI: only lines at the given preemption level and below
+ * 					  are held off, higher ones (echo capture) keep running
+ * 					- IRQ_ENTER_CRITICAL_ALL masks by PRIMASK: every line, for short sections shared with ISRs of
+ * 					  any level or timed to the microsecond
+ *  Depends     : Irq_Types.h, Irq_Cfg.h
+ * ===================================================================================================================*/
+
+#ifndef IRQ_IRQ_H_
+#define IRQ_IRQ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Irq_Types.h"
+#include "Irq_Cfg.h"
+
+/* =========================================================
+ *  Version
+ * =======================================================*/
+#define IRQ_SW_MAJOR_VERSION			(1u)
+#define IRQ_SW_MINOR_VERSION			(0u)
+#define IRQ_SW_PATCH_VERSION			(0u)
+
+/* =========================================================
+ *  Critical sections (BASEPRI)
+ * =======================================================*/
+/* BASEPRI value holding off every line with preemption level >= _preempt (0: masks nothing) */
+#define IRQ_BASEPRI(_preempt)			(((uint32)(_preempt) << IRQ_CFG_PREEMPT_SHIFT) & 0xFFu)
+
+/*
+ * _sv: uint32 saved BASEPRI. basepri_max only raises the mask, so sections nest and
+ * a section inside an ISR never unmasks its own level. Use the level of the highest
+ * ISR that shares the data (e.g. MCU_PRIO_USART1_PREEMPT).
+ */
+#if defined(__GNUC__) && defined(__arm__)
+#define IRQ_ENTER_CRITICAL(_sv, _preempt)	__asm volatile ("mrs %0, basepri\n\tmsr basepri_max, %1" : "=&r"(_sv) : "r"(IRQ_BASEPRI(_preempt)) : "memory")
+#define IRQ_EXIT_CRITICAL(_sv)				__asm volatile ("msr basepri, %0" :: "r"(_sv) : "memory")
+#else
+#define IRQ_ENTER_CRITICAL(_sv, _preempt)	((_sv) = 0u)
+#define IRQ_EXIT_CRITICAL(_sv)				((void)(_sv))
+#endif
+
+/* =========================================================
+ *  Critical sections (PRIMASK)
+ * =======================================================*/
+/*
+ * _sv: uint32 saved PRIMASK. Holds off every maskable line, the caller's mask is restored
+ * on exit, so sections nest. Keep them to a handful of instructions.
+ */
+#if defined(__GNUC__) && defined(__arm__)
+#define IRQ_ENTER_CRITICAL_ALL(_sv)			__asm volatile ("mrs %0, primask\n\tcpsid i" : "=r"(_sv) :: "memory")
+#define IRQ_EXIT_CRITICAL_ALL(_sv)			__asm volatile ("msr primask, %0" :: "r"(_sv) : "memory")
+#else
+#define IRQ_ENTER_CRITICAL_ALL(_sv)			((_sv) = 0u)
+#define IRQ_EXIT_CRITICAL_ALL(_sv)			((void)(_sv))
+#endif
+
+/* =========================================================
+ *  API
+ * =======================================================*/
+/**
+ * @brief  Grouping + level of every configured line, all NVIC lines disabled and not pending
+ * @return E_NOT_OK: null config or a level that does not fit the grouping
+ */
+Std_ReturnType Irq_Init(const Irq_ConfigType* ConfigPtr);
+
+/**
+ * @brief  Clear pending, then enable (NVIC lines only)
+ * @return E_NOT_OK: not initialised or line not in the table
+ */
+Std_ReturnType Irq_EnableLine(Irq_NumberType Irqn);
+
+/**
+ * @brief  Disable, then clear pending
+ */
+Std_ReturnType Irq_DisableLine(Irq_NumberType Irqn);
+
+/* =========================================================
+ * 	 Global configuration
+ * =======================================================*/
+extern const Irq_ConfigType Irq_Config;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_IRQ_H_ */
@@ -0,0 +1,154 @@
+/* =====================================================================================================================
+ *  File        : Irq_Atomic.h
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Barriers and word atomics for state shared between ISRs and the main loop
+ * 					- Cortex-M3: LDREX/STREX loops, DMB for acquire/release. Exception entry and return clear
+ * 					  the exclusive monitor, so a preempted loop simply retries
+ * 					- host: GCC __atomic builtins (the same calls hold against real threads)
+ * 					- plain aligned loads/stores of <= 32 bit are single-copy atomic, the Load/Store calls only
+ * 					  add the ordering: a Store publishes the data written before it (release), a Load makes
+ * 					  that data visible to the code after it (acquire)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef IRQ_IRQ_ATOMIC_H_
+#define IRQ_IRQ_ATOMIC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* =========================================================
+ *  Barriers
+ * =======================================================*/
+#define IRQ_COMPILER_BARRIER()			__asm volatile ("" ::: "memory")
+
+#if defined(__GNUC__) && defined(__arm__)
+#define IRQ_DMB()						__asm volatile ("dmb" ::: "memory")
+#define IRQ_DSB()						__asm volatile ("dsb" ::: "memory")
+#define IRQ_ISB()						__asm volatile ("isb" ::: "memory")
+#else
+#define IRQ_DMB()						__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define IRQ_DSB()						__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define IRQ_ISB()						IRQ_COMPILER_BARRIER()
+#endif
+
+/* =========================================================
+ *  Ordered loads / stores
+ * =======================================================*/
+static inline uint32 Irq_AtomicLoad32(const volatile uint32* Ptr)
+{
+	uint32 v = *Ptr;
+	IRQ_DMB();
+	return v;
+}
+
+static inline void Irq_AtomicStore32(volatile uint32* Ptr, uint32 Value)
+{
+	IRQ_DMB();
+	*Ptr = Value;
+}
+
+static inline uint16 Irq_AtomicLoad16(const volatile uint16* Ptr)
+{
+	uint16 v = *Ptr;
+	IRQ_DMB();
+	return v;
+}
+
+static inline void Irq_AtomicStore16(volatile uint16* Ptr, uint16 Value)
+{
+	IRQ_DMB();
+	*Ptr = Value;
+}
+
+/* =========================================================
+ *  Read-modify-write (full barrier on both sides)
+ * =======================================================*/
+#if defined(__GNUC__) && defined(__arm__)
+/* returns the previous value */
+static inline uint32 Irq_AtomicAdd32(volatile uint32* Ptr, uint32 Value)
+{
+	uint32 old;
+	uint32 tmp;
+	uint32 fail;
+
+	IRQ_DMB();
+	__asm volatile (
+		"1:	ldrex	%0, [%3]\n\t"
+		"	add		%1, %0, %4\n\t"
+		"	strex	%2, %1, [%3]\n\t"
+		"	cmp		%2, #0\n\t"
+		"	bne		1b"
+		: "=&r"(old), "=&r"(tmp), "=&r"(fail)
+		: "r"(Ptr), "r"(Value)
+		: "cc", "memory");
+	IRQ_DMB();
+	return old;
+}
+
+/* returns the previous value */
+static inline uint32 Irq_AtomicExchange32(volatile uint32* Ptr, uint32 Value)
+{
+	uint32 old;
+	uint32 fail;
+
+	IRQ_DMB();
+	__asm volatile (
+		"1:	ldrex	%0, [%2]\n\t"
+		"	strex	%1, %3, [%2]\n\t"
+		"	cmp		%1, #0\n\t"
+		"	bne		1b"
+		: "=&r"(old), "=&r"(fail)
+		: "r"(Ptr), "r"(Value)
+		: "cc", "memory");
+	IRQ_DMB();
+	return old;
+}
+
+/* *Ptr = Desired if *Ptr == Expected, TRUE when stored */
+static inline boolean Irq_AtomicCas32(volatile uint32* Ptr, uint32 Expected, uint32 Desired)
+{
+	uint32 old;
+	uint32 fail;
+
+	IRQ_DMB();
+	__asm volatile (
+		"1:	ldrex	%0, [%2]\n\t"
+		"	cmp		%0, %3\n\t"
+		"	bne		2f\n\t"
+		"	strex	%1, %4, [%2]\n\t"
+		"	cmp		%1, #0\n\t"
+		"	bne		1b\n\t"
+		"2:	clrex"
+		: "=&r"(old), "=&r"(fail)
+		: "r"(Ptr), "r"(Expected), "r"(Desired)
+		: "cc", "memory");
+	IRQ_DMB();
+	return (old == Expected) ? TRUE : FALSE;
+}
+#else
+static inline uint32 Irq_AtomicAdd32(volatile uint32* Ptr, uint32 Value)
+{
+	return __atomic_fetch_add(Ptr, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline uint32 Irq_AtomicExchange32(volatile uint32* Ptr, uint32 Value)
+{
+	return __atomic_exchange_n(Ptr, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline boolean Irq_AtomicCas32(volatile uint32* Ptr, uint32 Expected, uint32 Desired)
+{
+	return __atomic_compare_exchange_n(Ptr, &Expected, Desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_IRQ_ATOMIC_H_ */
@@ -0,0 +1,115 @@
+/* =====================================================================================================================
+ *  File        : Irq_Queue.c
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : SPSC / MPSC bounded queues (see Irq_Queue.h)
+ *  Depends     : Irq_Queue.h
+ * ===================================================================================================================*/
+
+#include "Irq_Queue.h"
+#include <string.h>
+
+static boolean prv_PowerOfTwo(uint16 n)
+{
+	return ((n != 0u) && ((n & (uint16)(n - 1u)) == 0u)) ? TRUE : FALSE;
+}
+
+// Byte queues (UART) skip the library call
+static inline void prv_Copy(uint8* Dst, const uint8* Src, uint16 Size)
+{
+	if(Size == 1u)	*Dst = *Src;
+	else			memcpy(Dst, Src, Size);
+}
+
+/* =========================================================
+ *  SPSC
+ * =======================================================*/
+Std_ReturnType Irq_SpscInit(Irq_SpscType* Q, uint8* Buf, uint16 ElemSize, uint16 Count)
+{
+	if((Q == NULL_PTR) || (Buf == NULL_PTR) || (ElemSize == 0u) || (prv_PowerOfTwo(Count) == FALSE)) return E_NOT_OK;
+
+	Q->Buf		= Buf;
+	Q->ElemSize	= ElemSize;
+	Q->Mask		= (uint16)(Count - 1u);
+	Q->Head		= 0u;
+	Q->Tail		= 0u;
+	return E_OK;
+}
+
+boolean Irq_SpscPush(Irq_SpscType* Q, const void* Elem)
+{
+	uint32 h = Q->Head;
+
+	// tail only moves forward under us, a stale value only under-reports the room
+	if((h - Irq_AtomicLoad32(&Q->Tail)) > Q->Mask) return FALSE;
+
+	prv_Copy(&Q->Buf[(h & Q->Mask) * Q->ElemSize], (const uint8*)Elem, Q->ElemSize);
+	Irq_AtomicStore32(&Q->Head, h + 1u);		// element before index
+	return TRUE;
+}
+
+boolean Irq_SpscPop(Irq_SpscType* Q, void* Elem)
+{
+	uint32 t = Q->Tail;
+
+	if(Irq_AtomicLoad32(&Q->Head) == t) return FALSE;
+
+	prv_Copy((uint8*)Elem, &Q->Buf[(t & Q->Mask) * Q->ElemSize], Q->ElemSize);
+	Irq_AtomicStore32(&Q->Tail, t + 1u);		// slot free only after the copy
+	return TRUE;
+}
+
+/* =========================================================
+ *  MPSC
+ * =======================================================*/
+Std_ReturnType Irq_MpscInit(Irq_MpscType* Q, uint8* Buf, volatile uint32* Seq, uint16 ElemSize, uint16 Count)
+{
+	uint32 i;
+
+	if((Q == NULL_PTR) || (Buf == NULL_PTR) || (Seq == NULL_PTR) || (ElemSize == 0u) || (prv_PowerOfTwo(Count) == FALSE))
+	{
+		return E_NOT_OK;
+	}
+
+	for(i = 0u; i < Count; i++) Seq[i] = i;
+
+	Q->Buf		= Buf;
+	Q->Seq		= Seq;
+	Q->ElemSize	= ElemSize;
+	Q->Mask		= (uint16)(Count - 1u);
+	Q->Head		= 0u;
+	Q->Tail		= 0u;
+	IRQ_DMB();
+	return E_OK;
+}
+
+boolean Irq_MpscPush(Irq_MpscType* Q, const void* Elem)
+{
+	uint32 pos;
+
+	for(;;)
+	{
+		pos = Irq_AtomicLoad32(&Q->Head);
+		sint32 diff = (sint32)(Irq_AtomicLoad32(&Q->Seq[pos & Q->Mask]) - pos);
+
+		if(diff < 0) return FALSE;												// slot still holds pos - count
+		if((diff == 0) && (Irq_AtomicCas32(&Q->Head, pos, pos + 1u) == TRUE)) break;
+		// another producer took pos first, retry on the new head
+	}
+
+	prv_Copy(&Q->Buf[(pos & Q->Mask) * Q->ElemSize], (const uint8*)Elem, Q->ElemSize);
+	Irq_AtomicStore32(&Q->Seq[pos & Q->Mask], pos + 1u);
+	return TRUE;
+}
+
+boolean Irq_MpscPop(Irq_MpscType* Q, void* Elem)
+{
+	uint32 t = Q->Tail;
+
+	if(Irq_AtomicLoad32(&Q->Seq[t & Q->Mask]) != (t + 1u)) return FALSE;
+
+	prv_Copy((uint8*)Elem, &Q->Buf[(t & Q->Mask) * Q->ElemSize], Q->ElemSize);
+	Irq_AtomicStore32(&Q->Seq[t & Q->Mask], t + (uint32)Q->Mask + 1u);			// free for pos + count
+	Q->Tail = t + 1u;
+	return TRUE;
+}
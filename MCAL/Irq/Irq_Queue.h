@@ -0,0 +1,106 @@
+/* =====================================================================================================================
+ *  File        : Irq_Queue.h
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Lock-free bounded queues between ISRs and the main loop, fixed element size, caller storage
+ * 					- SPSC: one producer and one consumer context (ISR -> task or task -> ISR)
+ * 					- MPSC: producers in any context (several ISR levels + task), one consumer. A producer
+ * 					  reserves a slot by CAS, then publishes it through the slot sequence, so a producer preempted
+ * 					  mid-copy only holds back the consumer, never another producer
+ * 					- indices run free, element count must be a power of two
+ * 					- IRQ_SPSC_DEFINE / IRQ_MPSC_DEFINE lay out typed storage for a queue of _type
+ *  Depends     : Irq_Atomic.h
+ * ===================================================================================================================*/
+
+#ifndef IRQ_IRQ_QUEUE_H_
+#define IRQ_IRQ_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Irq_Atomic.h"
+
+/* =========================================================
+ *  Types
+ * =======================================================*/
+typedef struct
+{
+	uint8*				Buf;
+	uint16				ElemSize;
+	uint16				Mask;				// element count - 1
+	volatile uint32		Head;				// written by the producer only
+	volatile uint32		Tail;				// written by the consumer only
+} Irq_SpscType;
+
+typedef struct
+{
+	uint8*				Buf;
+	volatile uint32*	Seq;				// per slot: == pos free for pos, == pos + 1 filled for pos
+	uint16				ElemSize;
+	uint16				Mask;
+	volatile uint32		Head;				// next slot to reserve (CAS)
+	uint32				Tail;				// consumer only
+} Irq_MpscType;
+
+/* =========================================================
+ *  Storage
+ * =======================================================*/
+#define IRQ_SPSC_DEFINE(_name, _type, _count)										\
+	static _type			_name##_Buf[(_count)];									\
+	static Irq_SpscType		_name
+
+#define IRQ_SPSC_INIT(_name)	Irq_SpscInit(&(_name), (uint8*)(_name##_Buf), (uint16)sizeof((_name##_Buf)[0]),	\
+										(uint16)(sizeof(_name##_Buf) / sizeof((_name##_Buf)[0])))
+
+#define IRQ_MPSC_DEFINE(_name, _type, _count)										\
+	static _type			_name##_Buf[(_count)];									\
+	static volatile uint32	_name##_Seq[(_count)];									\
+	static Irq_MpscType		_name
+
+#define IRQ_MPSC_INIT(_name)	Irq_MpscInit(&(_name), (uint8*)(_name##_Buf), _name##_Seq,							\
+										(uint16)sizeof((_name##_Buf)[0]),											\
+										(uint16)(sizeof(_name##_Buf) / sizeof((_name##_Buf)[0])))
+
+/* =========================================================
+ *  SPSC
+ * =======================================================*/
+/**
+ * @brief  Empty the queue (no context may use it meanwhile)
+ * @return E_NOT_OK: null storage, ElemSize 0 or Count not a power of two
+ */
+Std_ReturnType Irq_SpscInit(Irq_SpscType* Q, uint8* Buf, uint16 ElemSize, uint16 Count);
+
+// Producer side, FALSE when full (nothing stored)
+boolean Irq_SpscPush(Irq_SpscType* Q, const void* Elem);
+
+// Consumer side, FALSE when empty
+boolean Irq_SpscPop(Irq_SpscType* Q, void* Elem);
+
+// Either side, exact for the calling side (the other one only makes it smaller / larger)
+static inline uint32 Irq_SpscUsed(const Irq_SpscType* Q)
+{
+	return Q->Head - Q->Tail;
+}
+
+/* =========================================================
+ *  MPSC
+ * =======================================================*/
+/**
+ * @brief  Empty the queue (no context may use it meanwhile), Seq holds Count words
+ * @return E_NOT_OK: null storage, ElemSize 0 or Count not a power of two
+ */
+Std_ReturnType Irq_MpscInit(Irq_MpscType* Q, uint8* Buf, volatile uint32* Seq, uint16 ElemSize, uint16 Count);
+
+// Any context, FALSE when full
+boolean Irq_MpscPush(Irq_MpscType* Q, const void* Elem);
+
+// Consumer only, FALSE when empty or the oldest slot is still being written
+boolean Irq_MpscPop(Irq_MpscType* Q, void* Elem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_IRQ_QUEUE_H_ */
@@ -0,0 +1,62 @@
+/* =====================================================================================================================
+ *  File        : Irq_Types.h
+ *  Layer       : MCAL
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Types and line numbers of the interrupt manager (MCAL/Irq)
+ *  Depends     : Std_Types.h, Mcu_Types.h
+ * ===================================================================================================================*/
+
+#ifndef IRQ_IRQ_TYPES_H_
+#define IRQ_IRQ_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Mcu_Types.h"
+
+/* =========================================================
+ *  Line numbers (STM32F103 low/medium density vector table)
+ * =======================================================*/
+#define IRQ_NUM_SYSTICK					MCU_IRQN_SYSTICK	// exception, priority only
+#define IRQ_NUM_ADC1_2					(18)
+#define IRQ_NUM_USB_HP_CAN1_TX			(19)
+#define IRQ_NUM_USB_LP_CAN1_RX0			(20)
+#define IRQ_NUM_CAN1_RX1				(21)
+#define IRQ_NUM_CAN1_SCE				(22)
+#define IRQ_NUM_TIM1_CC					(27)
+#define IRQ_NUM_TIM2					(28)
+#define IRQ_NUM_TIM3					(29)
+#define IRQ_NUM_TIM4					(30)
+#define IRQ_NUM_USART1					(37)
+#define IRQ_NUM_USART2					(38)
+#define IRQ_NUM_USART3					(39)
+
+#define IRQ_NUM_LINES					(60)				// NVIC lines 0..59
+
+typedef sint8 Irq_NumberType;
+
+/* =========================================================
+ *  Config
+ * =======================================================*/
+/* One entry per interrupt the image may enable */
+typedef struct
+{
+	Irq_NumberType	Irqn;
+	uint8			Preempt;		// 0 = highest, never masked by IRQ_ENTER_CRITICAL
+	uint8			Sub;
+} Irq_LineCfgType;
+
+typedef struct
+{
+	const Irq_LineCfgType*	Lines;
+	uint8					LineCount;
+	Mcu_NvicPrigroupType	PriGroup;
+} Irq_ConfigType;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_IRQ_TYPES_H_ */
@@ -46,6 +46,7 @@ static inline boolean prv_WaitFlagSet(__vo const uint32* reg, uint32 mask, uint3
 {
 	while(((*reg) & mask) == 0)
 	{
+		REG_POLL();
 		if(loops-- == 0U) return FALSE;
 	}
 	return TRUE;
@@ -150,6 +151,7 @@ Std_ReturnType Mcu_DistributePllClock(void)
 			s_mcuStatus = MCU_INIT;
 			return E_OK;
 		}
+		REG_POLL();
 	}
 
 	return E_NOT_OK;
@@ -163,16 +165,25 @@ Mcu_PllStatusType Mcu_GetPllStatus(void)
 Std_ReturnType Mcu_SetNvicPriorityGrouping(uint32 prigroup_value)
 {
 	/*Write AIRCR with VECTKEY*/
-	SCB_AIRCR = SCB_AIRCR_VECTKEY | (prigroup_value << SCB_AIRCR_PRIGROUP_Pos) | (SCB_AIRCR & (0x700));
+	SCB_AIRCR = SCB_AIRCR_VECTKEY | ((prigroup_value & 0x7UL) << SCB_AIRCR_PRIGROUP_Pos);
 	return E_OK;
 }
 
-Std_ReturnType Mcu_SetIrqPriority(uint32 irqn, uint8 preemptPrio, uint8 subPrio)
+Std_ReturnType Mcu_SetIrqPriority(sint32 irqn, uint8 preemptPrio, uint8 subPrio)
 {
-	(void)subPrio;
-	if(irqn < 0){ return E_NOT_OK;} //Do not configure system exceptions here.
+	/* 4 implemented bits (7:4), preemption field starts at bit PRIGROUP + 1 */
+	uint32 grp		= (SCB_AIRCR >> SCB_AIRCR_PRIGROUP_Pos) & 0x7UL;
+	uint32 shift	= (grp < 3UL) ? 4UL : (grp + 1UL);
 
-	NVIC_IPR_BASE[(uint32)irqn] = (uint8)(preemptPrio << 4); // 4 MSB
+	if((uint32)preemptPrio >= (1UL << (8UL - shift)))	return E_NOT_OK;
+	if((uint32)subPrio >= (1UL << (shift - 4UL)))		return E_NOT_OK;
+
+	uint8 prio = (uint8)(((uint32)preemptPrio << shift) | ((uint32)subPrio << 4));
+
+	if(irqn == MCU_IRQN_SYSTICK)	{ SCB_SHPR3_SYSTICK = prio; return E_OK; }
+	if((irqn < 0) || (irqn > 59))	return E_NOT_OK; //Other system exceptions are not configured here.
+
+	NVIC_IPR_BASE[(uint32)irqn] = prio;
 	return E_OK;
 }
 
@@ -205,7 +216,7 @@ void SysTick_Handler(void)
 void Mcu_DelayMs(uint32 ms)
 {
 	uint32 start = s_systickTicks;
-	while ((s_systickTicks - start) < ms){}
+	while ((s_systickTicks - start) < ms){ REG_POLL(); }
 }
 
 Std_ReturnType Mcu_GetClockInfo(Mcu_ClockInfoType* out)
@@ -273,7 +284,17 @@ void MCu_PerformReset(void)
 {
 	/*write AIRCR with VECTKEY and SYSRESETREQ = 1*/
 	SCB_AIRCR = SCB_AIRCR_VECTKEY | (SCB_AIRCR &  (0x7UL << SCB_AIRCR_PRIGROUP_Pos)) | (1UL << SCB_AIRCR_SYSRESETREQ_Pos);
-	while(1){}; //wait reset
+	while(1){ REG_POLL(); }; //wait reset
+}
+
+/* Sleep mode until the next interrupt */
+void Mcu_WaitForInterrupt(void)
+{
+#if defined(__GNUC__) && defined(__arm__)
+	__asm volatile ("wfi" ::: "memory");
+#else
+	REG_POLL();		// host: one poll step stands in for the halted core
+#endif
 }
 
 Mcu_StatusType Mcu_GetStatus(void)
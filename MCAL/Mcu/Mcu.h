@@ -91,14 +91,13 @@ Std_ReturnType Mcu_DistributePllClock(void);
 Std_ReturnType Mcu_SetNvicPriorityGrouping(uint32 prigroup_value);
 
 /**
- * @brief  set priority for some IRQ
- * @param  irqn           IRQ number
+ * @brief  set priority for some IRQ, encoded for the active priority grouping
+ * @param  irqn           IRQ number (0..59), MCU_IRQN_SYSTICK for the SysTick exception
  * @param  preemptPrio    preemption level (0 = high)
  * @param  subPrio        subpriority lelvel
- * @return E_OK/E_NOT_OK
+ * @return E_OK/E_NOT_OK (level does not fit the group)
  */
-
-Std_ReturnType Mcu_SetIrqPriority(uint32 irqn, uint8 PreemptPrio, uint8 subPrio);
+Std_ReturnType Mcu_SetIrqPriority(sint32 irqn, uint8 PreemptPrio, uint8 subPrio);
 
 /**
  * @brief  Enable SysTick to create ticks at the desired frequency (e.g. 1000 Hz).
@@ -129,6 +128,11 @@ void Mcu_KickIwdg(void);
  */
 void MCu_PerformReset(void);
 
+/**
+ * @brief  sleep mode (WFI, SLEEPDEEP clear): the core halts until the next interrupt, clocks and peripherals run on
+ */
+void Mcu_WaitForInterrupt(void);
+
 /* =========================================================
  *  Status query
  * =======================================================*/
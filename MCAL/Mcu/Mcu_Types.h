@@ -154,6 +154,9 @@ typedef struct
 	uint8 subPrio;
 }Mcu_IrqPriorityType;
 
+/* Mcu_SetIrqPriority: SysTick exception (SHPR3) instead of an NVIC line */
+#define MCU_IRQN_SYSTICK		(-1)
+
 /* =====================================================================================================================
  * Reset source
  * ===================================================================================================================*/
@@ -17,6 +17,19 @@ extern "C" {
 
 #define __vo 							volatile
 
+/* =========================================================
+ *  Host simulation seam (Sim/)
+ *  REG_POLL: inside busy waits, lets the register models advance
+ *  REG_SYNC: after a write whose intermediate value has a hardware effect
+ *  Both are empty on target
+ * =======================================================*/
+#if defined(SIM_HOST)
+#include "Sim_Hooks.h"
+#else
+#define REG_POLL()						((void)0)
+#define REG_SYNC()						((void)0)
+#endif
+
 /* =========================================================
  *  Bus base addresses
  * =======================================================*/
@@ -107,6 +120,7 @@ typedef struct
 #define RCC_APB2ENR_IOPCEN			(1UL << 4)
 #define RCC_APB2ENR_USART1EN		(1UL << 14)
 #define RCC_APB2ENR_TIM1EN			(1UL << 11)
+#define RCC_APB2ENR_ADC1EN			(1UL << 9)
 
 
 #define RCC_APB1ENR_TIM2EN			(1UL << 0)
@@ -119,6 +133,22 @@ typedef struct
 #define FLASH_ACR_LATENCY_Pos		0U
 #define FLASH_ACR_PRFTBE_Pos		4U
 
+/* ---- FLASH program / erase (FPEC) ---- */
+#define FLASH_MEM_BASE				(0x08000000UL)
+#define FLASH_KEY1					(0x45670123UL)
+#define FLASH_KEY2					(0xCDEF89ABUL)
+
+#define FLASH_SR_BSY				(1UL << 0)
+#define FLASH_SR_PGERR				(1UL << 2)		// rc_w1: programmed location was not erased
+#define FLASH_SR_WRPRTERR			(1UL << 4)		// rc_w1: write protected page
+#define FLASH_SR_EOP				(1UL << 5)		// rc_w1: operation completed
+
+#define FLASH_CR_PG					(1UL << 0)
+#define FLASH_CR_PER				(1UL << 1)
+#define FLASH_CR_MER				(1UL << 2)
+#define FLASH_CR_STRT				(1UL << 6)
+#define FLASH_CR_LOCK				(1UL << 7)
+
 /* IWDG registers */
 #define IWDG_KR						(*(__vo uint32*)(0x40003000UL))
 #define IWDG_PR						(*(__vo uint32*)(0x40003004UL))
@@ -237,8 +267,12 @@ typedef struct
 
 #define TIM_CR1_CEN			(1UL << 0)
 #define TIM_DIER_CC1IE		(1UL << 1)
+#define TIM_DIER_CC2IE		(1UL << 2)
+#define TIM_DIER_CC3IE		(1UL << 3)
 #define TIM_CCER_CC1E		(1UL << 0)
 #define TIM_CCER_CC1P		(1UL << 1)
+#define TIM_CCER_CC2E		(1UL << 4)
+#define TIM_CCER_CC2P		(1UL << 5)
 
 /* CCMR1 */
 #define TIM_CCMR1_CC1S_Pos		0U	//01:IC1 mapped on TI1
@@ -247,11 +281,68 @@ typedef struct
 #define TIM_CCMR1_CC1S			(3UL << 0 )
 #define TIM_CCMR1_CC1S_0		(0U << 0)
 #define TIM_CCMR1_CC1S_1		(1U << 0)
-#define TIM_CCMR1_CC1S_2		(2U << )
+#define TIM_CCMR1_CC1S_2		(2U << 0)
 #define TIM_CCMR1_CC1S_3		(3U << 0)
+#define TIM_CCMR1_CC2S			(3UL << 8)	// 00: CC2 output
+#define TIM_CCMR1_OC2PE			(1UL << 11)
+#define TIM_CCMR1_OC2M			(7UL << 12)
+#define TIM_CCMR1_OC2M_INACTIVE	(2UL << 12)	// OC2REF low on CCR2 match
+#define TIM_CCMR1_OC2M_FORCE_LO	(4UL << 12)
+#define TIM_CCMR1_OC2M_FORCE_HI	(5UL << 12)
+
+/* CCMR2 */
+#define TIM_CCMR2_CC3S			(3UL << 0)	// 00: CC3 output (compare only, used as timeout)
+#define TIM_CCMR2_OC3M			(7UL << 4)	// 000: frozen
 
 /* SR */
 #define TIM_SR_CC1IF			(1UL << 1)
+#define TIM_SR_CC2IF			(1UL << 2)
+#define TIM_SR_CC3IF			(1UL << 3)
+#define TIM_SR_CC1OF			(1UL << 9)
+
+/* EGR: software update / capture / compare events */
+#define TIM_EGR_UG				(1UL << 0)
+#define TIM_EGR_CC1G			(1UL << 1)
+#define TIM_EGR_CC2G			(1UL << 2)
+#define TIM_EGR_CC3G			(1UL << 3)
+
+/* =========================================================
+ *  ADC (ADC1, internal temperature sensor on channel 16)
+ * =======================================================*/
+#define ADC1_BASE				(APB2PERIPH_BASE + 0x2400UL)
+
+typedef struct
+{
+	__vo uint32 SR;			//0x00
+	__vo uint32 CR1;		//0x04
+	__vo uint32 CR2;		//0x08
+	__vo uint32 SMPR1;		//0x0C
+	__vo uint32 SMPR2;		//0x10
+	__vo uint32 JOFR[4];	//0x14
+	__vo uint32 HTR;		//0x24
+	__vo uint32 LTR;		//0x28
+	__vo uint32 SQR1;		//0x2C
+	__vo uint32 SQR2;		//0x30
+	__vo uint32 SQR3;		//0x34
+	__vo uint32 JSQR;		//0x38
+	__vo uint32 JDR[4];		//0x3C
+	__vo uint32 DR;			//0x4C
+} ADC_TypeDef;
+
+#define ADC1					((ADC_TypeDef*)ADC1_BASE)
+
+#define ADC_SR_EOC				(1UL << 1)
+#define ADC_CR2_ADON			(1UL << 0)
+#define ADC_CR2_CAL				(1UL << 2)
+#define ADC_CR2_RSTCAL			(1UL << 3)
+#define ADC_CR2_ALIGN			(1UL << 11)
+#define ADC_CR2_EXTSEL			(7UL << 17)
+#define ADC_CR2_EXTSEL_SWSTART	(7UL << 17)	// regular group started by SWSTART
+#define ADC_CR2_EXTTRIG			(1UL << 20)
+#define ADC_CR2_SWSTART			(1UL << 22)
+#define ADC_CR2_TSVREFE			(1UL << 23)	// temperature sensor + VREFINT enable
+#define ADC_SQR1_L				(0xFUL << 20)
+#define ADC_SMP_BITS			(3U)		// per channel sample time field width
 
 /* =========================================================
  *  USART (USART1 for log)
@@ -400,7 +491,11 @@ typedef struct {
 #define CAN_TI0R_STID_Pos		(21UL)
 #define CAN_TI0R_EXID_Pos		(3UL)
 #define CAN_TSR_RQCP0			(1UL << 0) // bit mailbox 0
+#define CAN_TSR_ABRQ0			(1UL << 7)	// abort request mailbox 0
 #define CAN_RF0R_FMP0			(1UL << 0)
+#define CAN_RF0R_RFOM0			(1UL << 5)	// release FIFO 0 output mailbox
+#define CAN_FMR_FINIT			(1UL << 0)	// filter init mode
+#define CAN_FILTER_BANK0		(1UL << 0)	// bank 0 in FA1R/FS1R/FM1R/FFA1R
 #define CAN_RI0R_IDE			(1UL << 2)
 
 /* Tx mailbox TIR: IDE/RTR/ID */
@@ -417,6 +512,30 @@ typedef struct {
 #define CAN_BTR_TS2_Pos				(20U)
 #define CAN_BTR_TS1_Pos				(16U)
 
+/* error management: bus-off handling, ERRI (rc_w1), error interrupt enables */
+#define CAN_MCR_ABOM				(1UL << 6)	// automatic bus-off recovery
+#define CAN_MSR_ERRI				(1UL << 2)
+#define CAN_IER_EWGIE				(1UL << 8)
+#define CAN_IER_EPVIE				(1UL << 9)
+#define CAN_IER_BOFIE				(1UL << 10)
+#define CAN_IER_LECIE				(1UL << 11)
+#define CAN_IER_ERRIE				(1UL << 15)
+
+/* CAN ESR: flags read only, LEC writable (7 = no error since the software wrote it) */
+#define CAN_ESR_EWGF				(1UL << 0)	// TEC or REC >= 96
+#define CAN_ESR_EPVF				(1UL << 1)	// TEC or REC > 127
+#define CAN_ESR_BOFF				(1UL << 2)	// TEC > 255
+#define CAN_ESR_LEC_Pos				(4U)
+#define CAN_ESR_LEC_Msk				(7UL << CAN_ESR_LEC_Pos)
+#define CAN_ESR_TEC_Pos				(16U)
+#define CAN_ESR_REC_Pos				(24U)
+
+/* sleep mode: AWUM leaves it on the first SOF seen on the bus, WKUI (rc_w1) raises the SCE interrupt */
+#define CAN_MCR_AWUM				(1UL << 5)	// automatic wake-up
+#define CAN_MSR_SLAK				(1UL << 1)
+#define CAN_MSR_WKUI				(1UL << 3)
+#define CAN_IER_WKUIE				(1UL << 16)
+
 /* =========================================================
  *  Core (SysTick/SCB/NVIC)
  * =======================================================*/
@@ -425,7 +544,18 @@ typedef struct {
 #define SYST_CVR				(*(__vo uint32*)0xE000E018UL)
 #define SYST_CALIB				(*(__vo uint32*)0xE000E01CUL)
 #define SCB_AIRCR				(*(__vo uint32*)0xE000ED0CUL)
+#define SCB_SHPR3_SYSTICK		(*(__vo uint8*)0xE000ED23UL)
 #define NVIC_IPR_BASE			((__vo uint8*)0xE000E400UL)
+#define NVIC_ISER				((__vo uint32*)0xE000E100UL)
+#define NVIC_ICER				((__vo uint32*)0xE000E180UL)
+#define NVIC_ICPR				((__vo uint32*)0xE000E280UL)
+
+/* DWT cycle counter, needs DEMCR.TRCENA */
+#define DEMCR					(*(__vo uint32*)0xE000EDFCUL)
+#define DEMCR_TRCENA			(1UL << 24)
+#define DWT_CTRL				(*(__vo uint32*)0xE0001000UL)
+#define DWT_CTRL_CYCCNTENA		(1UL << 0)
+#define DWT_CYCCNT				(*(__vo uint32*)0xE0001004UL)
 
 
 #ifdef __cplusplus
@@ -3,7 +3,7 @@
  *  Layer       : MCAL (UART)
  *  ECU         : Sensor_ECU (STM32F103C6T6)
  *  Purpose     : Apply UART driver for STM32F1
- *  Depends     : Uart_Types.h, Uart_Cfg.h/.c
+ *  Depends     : Uart_Types.h, Uart_Cfg.h/.c, Irq.h, Irq_Atomic.h
  * ===================================================================================================================*/
 
 
@@ -11,6 +11,9 @@
 #include "Uart_Types.h"
 #include "Uart_Cfg.h"
 #include "Mcu.h"
+#include "Mcu_Cfg.h"
+#include "Irq.h"
+#include "Irq_Atomic.h"
 #include "stm32f103xx_regs.h"
 
 /* Version */
@@ -107,26 +110,32 @@ static inline uint16 prv_RbFree(const Uart_RingBufferType* rb)
 	return (uint16)((rb->size - 1U) - prv_RbUsed(rb));
 }
 
+/*
+ * SPSC: head is only written by the producer (TX: thread, RX: ISR), tail only by the consumer.
+ * The index store is ordered after the byte it covers, so the other side never reads a slot early.
+ */
 static inline boolean prv_RbPush(Uart_RingBufferType* rb, uint8 b )
 {
-	uint16 next = rb->head+1U;
+	uint16 h = rb->head;
+	uint16 next = h+1U;
 	if(next == rb->size) next = 0U;
 
-	if( next == rb->tail ) return FALSE;
+	if( next == Irq_AtomicLoad16(&rb->tail) ) return FALSE;
 
-	rb->buf[rb->head] = b;
-	rb->head = next;
+	rb->buf[h] = b;
+	Irq_AtomicStore16(&rb->head, next);
 
 	return TRUE;
 }
 
 static inline boolean prv_RbPop(Uart_RingBufferType* rb, uint8* out)
 {
-	if( rb->tail == rb->head) return FALSE;
+	uint16 t = rb->tail;
+	if( t == Irq_AtomicLoad16(&rb->head)) return FALSE;
 
-	*out = rb->buf[rb->tail];
-	uint16 next = (uint16)(rb->tail + 1U);
-	rb->tail =  (next == rb->size) ? 0U : next;
+	*out = rb->buf[t];
+	uint16 next = (uint16)(t + 1U);
+	Irq_AtomicStore16(&rb->tail, (next == rb->size) ? 0U : next);
 
 	return TRUE;
 }
@@ -147,6 +156,7 @@ static inline boolean prv_WaitUntil(boolean (*cond)(void*), void* arg, uint32 ti
 
 	while(1)
 	{
+		REG_POLL();
 		if(cond(arg))
 		{
 			return TRUE;
@@ -183,33 +193,22 @@ static void prv_EnableClock(Uart_ChannelType ch)
 	}
 }
 
-/* enable/disable NVIC IRQ for channel */
-static void prv_EnableIrq(Uart_ChannelType ch, boolean enable)
+/* enable/disable NVIC IRQ for channel, the level comes from the Irq table */
+static Std_ReturnType prv_EnableIrq(Uart_ChannelType ch, boolean enable)
 {
 	sint32 irqn = prv_GetIrqNum(ch);
 
-	volatile uint32* ISER = (uint32*)0xE000E100UL;
-	volatile uint32* ICER = (uint32*)0xE000E180UL;
-	volatile uint32* ICPR = (uint32*)0xE000E280UL;
-
-	if(irqn < 0) return;
-	uint32 n   = (uint32)irqn;
-	uint32 idx = n >> 5;           // /32
-	uint32 bit = n & 0x1FU;        // %32
-	uint32 mask = (1UL << bit);
-
-	if (enable) {
-		ICPR[idx] = mask;            // clear pending before enable
-		ISER[idx] = mask;            // enable
-	} else {
-		ICER[idx] = mask;            // disable
-		ICPR[idx] = mask;            // clear pending
-	}
+	if(irqn < 0) return E_NOT_OK;
+	return (enable) ? Irq_EnableLine((Irq_NumberType)irqn) : Irq_DisableLine((Irq_NumberType)irqn);
 }
 
 /*Start Tx if idle */
 static inline void prv_KickTxIfIdle(Uart_ChannelType ch, USART_TypeDef* regs)
 {
+	uint32 sv;
+
+	/* CR1 read-modify-write races the ISR (TXEIE -> TCIE); hold off USART1 and below only */
+	IRQ_ENTER_CRITICAL(sv, MCU_PRIO_USART1_PREEMPT);
 	if((regs->CR1 & (1U << USART_CR1_TXEIE)) == 0u)
 	{
 		if(prv_RbUsed(&s_handle[ch].txRb) > 0)
@@ -217,6 +216,7 @@ static inline void prv_KickTxIfIdle(Uart_ChannelType ch, USART_TypeDef* regs)
 			regs -> CR1 |= (1<< USART_CR1_TXEIE);
 		}
 	}
+	IRQ_EXIT_CRITICAL(sv);
 }
 
 /* ---------------------------------------------------------
@@ -237,7 +237,9 @@ Std_ReturnType Uart_Init(const Uart_ConfigType* cfg)
 		s_handle[i].rxRb = (Uart_RingBufferType){0};
 		s_handle[i].parityEnable = 0;
 		s_handle[i].wordLen9b = 0;
+		s_handle[i].cbs = (Uart_CallbacksType){0};
 	}
+	s_handle[UART_CH1].cbs = cfg->usart1.cbs;
 
 	Mcu_ClockInfoType clk; (void) clk;
 	(void) Mcu_GetClockInfo(&clk);
@@ -312,7 +314,7 @@ Std_ReturnType Uart_Init(const Uart_ConfigType* cfg)
 			regs->CR1 |= (1<<USART_CR1_RXNEIE);
 
 			/*enable NVIC*/
-			prv_EnableIrq(UART_CH1, TRUE);
+			if(prv_EnableIrq(UART_CH1, TRUE) != E_OK) return E_NOT_OK;
 		}
 #endif
 		/* clear pending error*/
@@ -334,7 +336,7 @@ void Uart_Deinit(void)
 		{
 #if (UART_CFG_ENABLE_ASYNC_APIS == 1u)
 			/*Diable IRQ NVIC*/
-			prv_EnableIrq(UART_CH1, FALSE);
+			(void)prv_EnableIrq(UART_CH1, FALSE);
 
 			/*Disable RXNEIE/TXEIE/TCIE/PEIE*/
 			regs->CR1 &= ~((1 << USART_CR1_RXNEIE) | (1 << USART_CR1_TXEIE) | ( 1 << USART_CR1_TCIE));
@@ -362,10 +364,12 @@ Std_ReturnType Uart_Write(Uart_ChannelType ch, const uint8* data, uint16 len, ui
 		// wait TXE
 		while( ((regs -> SR) & (1 << USART_SR_TXE)) == 0u)
 		{
+			REG_POLL();
 			if (prv_GetTickMs() - t0 >= timeoutMs) return E_NOT_OK;
 		}
 
 		regs->DR = (uint8)data[i];
+		REG_SYNC();
 #if (UART_CFG_ENABLE_STATS == 1)
 		s_handle[ch].stats.txBytes++;
 #endif
@@ -375,6 +379,7 @@ Std_ReturnType Uart_Write(Uart_ChannelType ch, const uint8* data, uint16 len, ui
 	t0 = prv_GetTickMs();
 	while( ((regs->SR) & (1 << USART_SR_TC)) == 0u )
 	{
+		REG_POLL();
 		if(prv_GetTickMs() - t0 >= timeoutMs) return E_NOT_OK;
 	}
 
@@ -393,6 +398,7 @@ Std_ReturnType Uart_Read(Uart_ChannelType ch, uint8* data, uint16 len, uint32 ti
 		//wait RXNE
 		while( ((regs -> SR) & ( 1 << USART_SR_RXNE)) == 0)
 		{
+			REG_POLL();
 			uint32 sr = regs -> SR;
 			if( sr & ((1 << USART_SR_ORE) | (1 << USART_SR_FE )| (1<<USART_SR_PE) ) )
 			{
@@ -431,15 +437,73 @@ Std_ReturnType Uart_WriteAsync(Uart_ChannelType ch, const uint8* data, uint16 le
 	if( !regs || s_handle[ch].status != UART_INIT || data == NULL_PTR) return E_NOT_OK;
 	const Uart_ChannelConfigType* temp = (ch == UART_CH1)?(&s_cfg->usart1):NULL_PTR;
 	if(!temp || temp->transMode != UART_XFER_INTERRUPT) return E_NOT_OK;
+	/* all or nothing: never leave half a message in the ring */
+	if(prv_RbFree(&s_handle[ch].txRb) < len) return E_NOT_OK;
+
 	/* Push to Tx buffer*/
-	for(int i = 0; i < len; i++)
+	for(uint16 i = 0; i < len; i++)
 	{
-		if(!prv_RbPush(&s_handle[ch].txRb, data[i]))
-		{
-			return E_NOT_OK;
-		}
+		(void)prv_RbPush(&s_handle[ch].txRb, data[i]);
+	}
+
+	prv_KickTxIfIdle(ch, regs);
+	return E_OK;
+}
+
+uint16 Uart_WriteAsyncPartial(Uart_ChannelType ch, const uint8* data, uint16 len)
+{
+	USART_TypeDef* regs = prv_GetRegs(ch);
+	if( !regs || s_handle[ch].status != UART_INIT || data == NULL_PTR) return 0u;
+	const Uart_ChannelConfigType* temp = (ch == UART_CH1)?(&s_cfg->usart1):NULL_PTR;
+	if(!temp || temp->transMode != UART_XFER_INTERRUPT) return 0u;
+
+	uint16 cnt = 0u;
+	while((cnt < len) && prv_RbPush(&s_handle[ch].txRb, data[cnt]))
+	{
+		cnt++;
 	}
 
+	if(cnt > 0u) prv_KickTxIfIdle(ch, regs);
+	return cnt;
+}
+
+uint16 Uart_GetTxFree(Uart_ChannelType ch)
+{
+	if((ch >= UART_CH_COUNT) || (s_handle[ch].status != UART_INIT)) return 0u;
+	return prv_RbFree(&s_handle[ch].txRb);
+}
+
+Std_ReturnType Uart_TxReserve(Uart_ChannelType ch, uint16 len, Uart_TxSpanType* span)
+{
+	if((ch >= UART_CH_COUNT) || (span == NULL_PTR) || (s_handle[ch].status != UART_INIT)) return E_NOT_OK;
+
+	Uart_RingBufferType* rb = &s_handle[ch].txRb;
+	if((len == 0u) || (prv_RbFree(rb) < len)) return E_NOT_OK;
+
+	/* head only moves in thread context, tail may move under us but only frees more room */
+	uint16 h = rb->head;
+	uint16 first = (uint16)(rb->size - h);
+	if(first > len) first = len;
+
+	span->ptr[0] = &rb->buf[h];
+	span->len[0] = first;
+	span->ptr[1] = rb->buf;
+	span->len[1] = (uint16)(len - first);
+	return E_OK;
+}
+
+Std_ReturnType Uart_TxCommit(Uart_ChannelType ch, uint16 len)
+{
+	USART_TypeDef* regs = prv_GetRegs(ch);
+	if( !regs || s_handle[ch].status != UART_INIT ) return E_NOT_OK;
+
+	Uart_RingBufferType* rb = &s_handle[ch].txRb;
+	if(prv_RbFree(rb) < len) return E_NOT_OK;
+
+	uint16 next = (uint16)(rb->head + len);
+	if(next >= rb->size) next = (uint16)(next - rb->size);
+	Irq_AtomicStore16(&rb->head, next);			// bytes written through the span first
+
 	prv_KickTxIfIdle(ch, regs);
 	return E_OK;
 }
@@ -467,6 +531,7 @@ Std_ReturnType Uart_FlushTx(Uart_ChannelType ch, uint32 timeoutMs)
 	uint32 t0 = prv_GetTickMs();
 	while((prv_RbUsed(&s_handle[ch].txRb) != 0u) || (((regs->SR)&(1 << USART_SR_TC)) == 0u))
 	{
+		REG_POLL();
 		if((prv_GetTickMs() - t0) >= timeoutMs) return E_NOT_OK;
 	}
 	return E_OK;
@@ -520,7 +585,7 @@ Std_ReturnType Uart_RegisterCallbacks(Uart_ChannelType ch, const Uart_CallbacksT
 
 	if(ch == UART_CH1)
 	{
-		(void)cbs;
+		s_handle[ch].cbs = *cbs;
 		return E_OK;
 	}
 	return E_NOT_OK;
@@ -573,11 +638,11 @@ void Uart_IrqHandler(Uart_ChannelType ch)
 		s_handle[ch].stats.rxBytes++;
 		s_handle[ch].stats.rxIrqCount++;
 #endif
-		if(ch == UART_CH1 && s_cfg->usart1.cbs.onRxChar) s_cfg->usart1.cbs.onRxChar(ch,b);
+		if(s_handle[ch].cbs.onRxChar) s_handle[ch].cbs.onRxChar(ch,b);
 	}
 
 	//TXE
-	if((regs->SR & (1 << USART_SR_TXE)) /*&& (regs -> CR1 & (1 << USART_CR1_TXEIE))*/ )
+	if((regs->SR & (1 << USART_SR_TXE)) && (regs -> CR1 & (1 << USART_CR1_TXEIE)))
 	{
 		uint8 b;
 		if(prv_RbPop(&s_handle[ch].txRb, &b))
@@ -602,9 +667,9 @@ void Uart_IrqHandler(Uart_ChannelType ch)
 		(void)tmp;
 //		regs->SR &= ~(1 << USART_SR_TC);
 		regs -> CR1 &= ~(1 << USART_CR1_TCIE);
-		if(ch == UART_CH1 && s_cfg->usart1.cbs.onTxEmptyOrCplt)
+		if(s_handle[ch].cbs.onTxEmptyOrCplt)
 		{
-			s_cfg->usart1.cbs.onTxEmptyOrCplt(ch);
+			s_handle[ch].cbs.onTxEmptyOrCplt(ch);
 		}
 	}
 
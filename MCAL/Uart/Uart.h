@@ -134,11 +134,35 @@ Std_ReturnType Uart_GetChar(Uart_ChannelType ch, uint8* outByte, uint32 timeoutM
 #if( UART_CFG_ENABLE_ASYNC_APIS == 1u)
 
 /**
- * @brief  Put data to TX ring buffer.
- * @return E_OK if all are filled; E_NOT_OK if buffer is out of space.
+ * @brief  Put data to TX ring buffer (all or nothing).
+ * @return E_OK if all are filled; E_NOT_OK if buffer is out of space (nothing queued).
  */
 Std_ReturnType Uart_WriteAsync(Uart_ChannelType ch, const uint8* data, uint16 len);
 
+/**
+ * @brief  Put as many bytes as fit into TX ring buffer, never waits.
+ * @return number of bytes accepted (0..len).
+ */
+uint16 Uart_WriteAsyncPartial(Uart_ChannelType ch, const uint8* data, uint16 len);
+
+/**
+ * @brief  Free space in TX ring buffer.
+ * @return number of bytes that can be queued now.
+ */
+uint16 Uart_GetTxFree(Uart_ChannelType ch);
+
+/**
+ * @brief  Reserve len bytes of TX ring for in-place fill (zero copy), never waits.
+ *         Data is not sent until Uart_TxCommit. Single producer only.
+ * @return E_OK and span filled; E_NOT_OK if ring has less than len bytes free.
+ */
+Std_ReturnType Uart_TxReserve(Uart_ChannelType ch, uint16 len, Uart_TxSpanType* span);
+
+/**
+ * @brief  Publish len bytes written into the last reserved span and start TX.
+ */
+Std_ReturnType Uart_TxCommit(Uart_ChannelType ch, uint16 len);
+
 /**
  * @brief  get data from TX ring buffer.
  * @return number of bits.
@@ -162,7 +186,7 @@ Std_ReturnType Uart_SetBaudrate(Uart_ChannelType ch, uint32 baud);
 Std_ReturnType Uart_SetDirection(Uart_ChannelType ch, Uart_DirectionCfgType dir);
 
 /**
- * @brief  Register callback
+ * @brief  Register callback, called from IRQ context.
  */
 Std_ReturnType Uart_RegisterCallbacks(Uart_ChannelType ch, const Uart_CallbacksType* cbs);
 
@@ -188,6 +188,13 @@ typedef struct
 	uint8*			buf;
 } Uart_RingBufferType;
 
+/* Writable window of TX ring returned by Uart_TxReserve (second part is used when the window wraps) */
+typedef struct
+{
+	uint8*	ptr[2];
+	uint16	len[2];
+} Uart_TxSpanType;
+
 typedef struct
 {
 	Uart_DriverStatusType	status;
@@ -196,6 +203,8 @@ typedef struct
 	Uart_RingBufferType		txRb;
 	Uart_RingBufferType		rxRb;
 
+	Uart_CallbacksType		cbs;
+
 	uint8					parityEnable;
 	uint8					wordLen9b;
 } Uart_ChannelHandleType;
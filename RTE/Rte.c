@@ -7,20 +7,27 @@
  * ===================================================================================================================*/
 
 #include "Rte.h"
+#include "Sensor.h"
+#include "DistConv.h"
+#include "Irq_Atomic.h"
 
 /*===================== Local Types ============================*/
 // Internal RTE signal buffer
+// Data is one word, so a reader never sees half a value; UpDated is set after Data (release) and
+// taken by exchange before Data is read, so an update landing during a read is not lost
 typedef struct
 {
-	uint8						UpDated;
-	Rte_SignalStatusType		Status;
-	uint32						Data;
+	volatile uint32				UpDated;
+	volatile Rte_SignalStatusType	Status;
+	volatile uint32				Data;
 } Rte_InternalSignalType;
 
 /*===================== Local Variable ============================*/
 // Internal Buffer for signals
 static Rte_InternalSignalType	Rte_Signal_Distance;
 static Rte_InternalSignalType	Rte_Signal_Obstacle;
+static Rte_InternalSignalType	Rte_Signal_AmbientTemp;
+static Rte_InternalSignalType	Rte_Signal_AmbientHum;
 
 // System mode
 static Rte_SystemModeType		Rte_SystemMode	= RTE_MODE_INIT;
@@ -35,6 +42,17 @@ static void Rte_ClearSignal(Rte_InternalSignalType* sig) {
 	sig -> Data	   = 0u;
 }
 
+static void Rte_PublishSignal(Rte_InternalSignalType* sig, uint32 data) {
+	sig -> Data	   = data;
+	sig -> Status  = RTE_SIGNAL_VALID;
+	Irq_AtomicStore32(&sig->UpDated, 1u);
+}
+
+static uint32 Rte_TakeSignal(Rte_InternalSignalType* sig) {
+	(void)Irq_AtomicExchange32(&sig->UpDated, 0u);
+	return sig -> Data;
+}
+
 /* =====================================================================================================================
  *  RTE Init/DeInit
  * ===================================================================================================================*/
@@ -44,6 +62,8 @@ void Rte_Init(void)
 {
 	Rte_ClearSignal(&Rte_Signal_Distance);
 	Rte_ClearSignal(&Rte_Signal_Obstacle);
+	Rte_ClearSignal(&Rte_Signal_AmbientTemp);
+	Rte_ClearSignal(&Rte_Signal_AmbientHum);
 
 	Rte_SystemMode = RTE_MODE_NORMAL;
 }
@@ -62,34 +82,65 @@ void Rte_Deinit(void)
 // Write distance value from sensor
 Std_ReturnType	Rte_Write_Distance(Rte_DistanceType Distance)
 {
-	Std_ReturnType Ret;
+	// local receivers get the value whether Com takes it or not (Com not initialised), the return value reports Com
+	Rte_PublishSignal(&Rte_Signal_Distance, Distance);
+
+	return Com_SendSignal(RTE_SIGNAL_DISTANCE, &Distance);
+}
+
+// Write obstacle state
+Std_ReturnType	Rte_Write_ObstacleState(Rte_ObstacleStateType State)
+{
+	uint8 comState = (uint8)State;			// enum width is the compiler's, the Com signal is UINT8
+
+	Rte_PublishSignal(&Rte_Signal_Obstacle, State);
+
+	return Com_SendSignal(RTE_SIGNAL_OBSTACLE, &comState);
+}
+
+/* Ambient conditions (local receivers, on the bus in the ambient layout of the sensor status I-PDU) */
+// Write ambient temperature
+Std_ReturnType	Rte_Write_AmbientTemperature(Rte_TemperatureType Temperature)
+{
+	Rte_PublishSignal(&Rte_Signal_AmbientTemp, (uint32)(uint16)Temperature);
 
-	Ret = Com_SendSignal(RTE_SIGNAL_DISTANCE, &Distance);
+	return Com_SendSignal(RTE_SIGNAL_AMBIENT_TEMP, &Temperature);
+}
 
-	if(Ret == E_OK)
+// Write ambient humidity
+Std_ReturnType	Rte_Write_AmbientHumidity(Rte_HumidityType Humidity)
+{
+	if(Humidity > 100u) return RTE_E_INVALID;
+
+	Rte_PublishSignal(&Rte_Signal_AmbientHum, Humidity);
+
+	return Com_SendSignal(RTE_SIGNAL_AMBIENT_HUM, &Humidity);
+}
+
+// Read ambient temperature
+Std_ReturnType	Rte_Read_AmbientTemperature(Rte_TemperatureType* Temperature)
+{
+	if((Temperature == NULL_PTR) || (Rte_Signal_AmbientTemp.Status != RTE_SIGNAL_VALID))
 	{
-		Rte_Signal_Distance.Data	= Distance;
-		Rte_Signal_Distance.Status	= RTE_SIGNAL_VALID;
-		Rte_Signal_Distance.UpDated	= 1u;
+		return RTE_E_NO_DATA;
 	}
 
-	return Ret;
+	*Temperature = (Rte_TemperatureType)(uint16)Rte_TakeSignal(&Rte_Signal_AmbientTemp);
+
+	return RTE_E_OK;
 }
 
-// Write obstacle state
-Std_ReturnType	Rte_Write_ObstacleState(Rte_ObstacleStateType State)
+// Read ambient humidity
+Std_ReturnType	Rte_Read_AmbientHumidity(Rte_HumidityType* Humidity)
 {
-	Std_ReturnType Ret;
-
-	Ret = Com_SendSignal(RTE_SIGNAL_OBSTACLE, &State);
-	if(Ret == E_OK)
+	if((Humidity == NULL_PTR) || (Rte_Signal_AmbientHum.Status != RTE_SIGNAL_VALID))
 	{
-		Rte_Signal_Obstacle.Data	= State;
-		Rte_Signal_Obstacle.Status	= RTE_SIGNAL_VALID;
-		Rte_Signal_Obstacle.UpDated	= 1u;
+		return RTE_E_NO_DATA;
 	}
 
-	return Ret;
+	*Humidity = (Rte_HumidityType)Rte_TakeSignal(&Rte_Signal_AmbientHum);
+
+	return RTE_E_OK;
 }
 
 /* Motor Node APIs */
@@ -101,8 +152,7 @@ Std_ReturnType	Rte_Read_Distance(Rte_DistanceType* Distance )
 		return RTE_E_NO_DATA;
 	}
 
-	*Distance	= (Rte_DistanceType) Rte_Signal_Distance.Data;
-	Rte_Signal_Distance.UpDated	= 0u;
+	*Distance	= (Rte_DistanceType) Rte_TakeSignal(&Rte_Signal_Distance);
 
 	return RTE_E_OK;
 }
@@ -115,12 +165,22 @@ Std_ReturnType	Rte_Read_ObstacleState(Rte_ObstacleStateType* State)
 		return RTE_E_NO_DATA;
 	}
 
-	*State = (Rte_ObstacleStateType) Rte_Signal_Obstacle.Data;
-	Rte_Signal_Obstacle.UpDated = 0u;
+	*State = (Rte_ObstacleStateType) Rte_TakeSignal(&Rte_Signal_Obstacle);
 
 	return RTE_E_OK;
 }
 
+// Distance of the remote sensor node (Com shadow value)
+Std_ReturnType	Rte_Read_BusDistance(Rte_DistanceType* Distance)
+{
+	Com_RxSignalStatusType status = Com_GetRxSignalStatus(RTE_SIGNAL_BUS_DISTANCE);
+
+	if((Distance == NULL_PTR) || (status == COM_RX_NOT_RECEIVED)) return RTE_E_NO_DATA;
+	if(Com_ReceiveSignal(RTE_SIGNAL_BUS_DISTANCE, Distance) != E_OK) return RTE_E_NO_DATA;
+
+	return (status == COM_RX_TIMEOUT) ? RTE_E_MAX_AGE_EXCEEDED : RTE_E_OK;
+}
+
 /* =====================================================================================================================
  *  Client/Server APIs
  * ===================================================================================================================*/
@@ -139,6 +199,37 @@ Std_ReturnType	Rte_Call_StartMotor(void)
 	return Com_SendSignal(RTE_SIGNAL_SPEED, &speed);
 }
 
+// One-shot measurement by the Sensor SWC
+Std_ReturnType	Rte_Call_RequestMeasurement(void)
+{
+	return (Sensor_RequestMeasurement() == E_OK) ? RTE_E_OK : RTE_E_NOT_OK;
+}
+
+// Result of the one-shot measurement
+Std_ReturnType	Rte_Read_Measurement(Rte_MeasurementType* Measurement)
+{
+	Sensor_MeasurementType meas;
+
+	if(Measurement == NULL_PTR) return RTE_E_INVALID;
+	if(Sensor_GetRequestedMeasurement(&meas) != E_OK) return RTE_E_NO_DATA;
+
+	Measurement->Distance	= (Rte_DistanceType)meas.Distance;
+	Measurement->EchoUs		= meas.EchoUs;
+	Measurement->Status		= (Rte_MeasurementStatusType)meas.Status;
+	return RTE_E_OK;
+}
+
+/* =====================================================================================================================
+ *  Com callbacks
+ * ===================================================================================================================*/
+
+// Motor command I-PDU not confirmed after all retries
+void Rte_COMCbkTxTOut_Vehicle(Com_IpduIdType IpduId)
+{
+	(void)IpduId;
+	Rte_SystemMode = RTE_MODE_ERROR;
+}
+
 /* =====================================================================================================================
  *  Runnable Entity Prototypes
  * ===================================================================================================================*/
@@ -148,11 +239,11 @@ void Rte_Runnable_Sensor(void)
 {
 	Rte_DistanceType	Distance;
 
-	Distance = 250u; // Test
+	Distance = (Rte_DistanceType)DISTCONV_MM_TO_Q4(250u); // Test
 
 	(void)Rte_Write_Distance(Distance);
 
-	if(Distance < 300u)
+	if(Distance < DISTCONV_MM_TO_Q4(300u))
 	{
 		(void)Rte_Write_ObstacleState(RTE_OBSTACLE_DETECT);
 	} else {
@@ -167,7 +258,7 @@ void Rte_Runnable_MotorControl(void)
 
 	if(Rte_Read_Distance(&Distance) == RTE_E_OK)
 	{
-		if(Distance < 300u)
+		if(Distance < DISTCONV_MM_TO_Q4(300u))
 		{
 			(void) Rte_Call_StopMotor();
 		} else {
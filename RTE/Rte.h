@@ -35,6 +35,19 @@ Std_ReturnType	Rte_Write_Distance(Rte_DistanceType Distance);
 // Write obstacle state
 Std_ReturnType	Rte_Write_ObstacleState(Rte_ObstacleStateType State);
 
+/* Ambient conditions (local receivers, on the bus in the ambient layout of the sensor status I-PDU) */
+// Write ambient temperature
+Std_ReturnType	Rte_Write_AmbientTemperature(Rte_TemperatureType Temperature);
+
+// Write ambient humidity
+Std_ReturnType	Rte_Write_AmbientHumidity(Rte_HumidityType Humidity);
+
+// Read ambient temperature
+Std_ReturnType	Rte_Read_AmbientTemperature(Rte_TemperatureType* Temperature);
+
+// Read ambient humidity
+Std_ReturnType	Rte_Read_AmbientHumidity(Rte_HumidityType* Humidity);
+
 /* Motor Node APIs */
 // Distance value in Motor Control
 Std_ReturnType	Rte_Read_Distance(Rte_DistanceType* Distance );
@@ -42,6 +55,10 @@ Std_ReturnType	Rte_Read_Distance(Rte_DistanceType* Distance );
 // Read obstacle state
 Std_ReturnType	Rte_Read_ObstacleState(Rte_ObstacleStateType* State);
 
+// Distance of the remote sensor node from Com: RTE_E_NO_DATA before the first frame,
+// RTE_E_MAX_AGE_EXCEEDED when the sender fell silent (value per the Com timeout action)
+Std_ReturnType	Rte_Read_BusDistance(Rte_DistanceType* Distance);
+
 /* =====================================================================================================================
  *  Client/Server APIs
  * ===================================================================================================================*/
@@ -52,6 +69,19 @@ Std_ReturnType	Rte_Call_StopMotor(void);
 // Start motor
 Std_ReturnType	Rte_Call_StartMotor(void);
 
+// One-shot measurement by the Sensor SWC: the next one it triggers. RTE_E_NOT_OK without a sensor
+Std_ReturnType	Rte_Call_RequestMeasurement(void);
+
+// Result of the one-shot measurement, RTE_E_NO_DATA until it is done
+Std_ReturnType	Rte_Read_Measurement(Rte_MeasurementType* Measurement);
+
+/* =====================================================================================================================
+ *  Com callbacks
+ * ===================================================================================================================*/
+
+// Motor command I-PDU not confirmed after all retries: the ECU no longer controls the motor
+void Rte_COMCbkTxTOut_Vehicle(Com_IpduIdType IpduId);
+
 /* =====================================================================================================================
  *  Runnable Entity Prototypes
  * ===================================================================================================================*/
@@ -28,20 +28,34 @@
 #define RTE_E_NO_DATA	((Std_ReturnType)0x04u)
 #endif
 
+// Value delivered, but its reception deadline was missed (substitute or last value)
+#ifndef RTE_E_MAX_AGE_EXCEEDED
+#define RTE_E_MAX_AGE_EXCEEDED	((Std_ReturnType)0x40u)
+#endif
+
 #define RTE_SIGNAL_DISTANCE	COM_SIGNAL_ID_DISTANCE
 #define RTE_SIGNAL_OBSTACLE	COM_SIGNAL_ID_OBSTACLE
 #define RTE_SIGNAL_SPEED	COM_SIGNAL_ID_SPEED
+#define RTE_SIGNAL_BUS_DISTANCE	COM_SIGNAL_ID_BUS_DISTANCE
+#define RTE_SIGNAL_AMBIENT_TEMP	COM_SIGNAL_ID_AMBIENT_TEMP
+#define RTE_SIGNAL_AMBIENT_HUM	COM_SIGNAL_ID_AMBIENT_HUM
 
 /* ============================================
  * Application Data types
  * ============================================*/
 
-// Distance measured by ultrasonic sensor
+// Distance measured by ultrasonic sensor, Q4 mm (1/16 mm, DistConv.h)
 typedef uint16 Rte_DistanceType;
 
 // Vehicle speed command or feedback
 typedef uint16 Rte_SpeedType;
 
+// Ambient air temperature, 0.1 degC
+typedef sint16 Rte_TemperatureType;
+
+// Ambient relative humidity, %RH (0..100)
+typedef uint8 Rte_HumidityType;
+
 // Motor control command
 typedef enum
 {
@@ -49,6 +63,22 @@ typedef enum
 	RTE_MOTOR_RUN
 } Rte_MotorCommandType;
 
+// Status of a one-shot measurement (values of SensorIf_MeasurementStatusType)
+typedef enum
+{
+	RTE_MEAS_INVALID	= 0u,
+	RTE_MEAS_VALID,
+	RTE_MEAS_TIMEOUT
+} Rte_MeasurementStatusType;
+
+// One-shot measurement of the ultrasonic sensor
+typedef struct
+{
+	Rte_DistanceType			Distance;
+	uint32						EchoUs;
+	Rte_MeasurementStatusType	Status;
+} Rte_MeasurementType;
+
 // Obstacle detection state
 typedef enum
 {
@@ -0,0 +1,271 @@
+/* =====================================================================================================================
+ *  File        : Bench.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Run the benchmark cases, subtract the counter read overhead and emit JSON lines
+ *  Notes       : Every iteration (Setup, Run, Teardown) runs with interrupts masked, so an ISR cannot land
+ * 				  inside the timed window and Setup cannot be undone by one before Run.
+ * 				  Names are emitted without JSON escaping, keep them to identifier characters.
+ *  Depends     : Bench.h, Bench_Cfg.h, UartIf.h, Irq.h
+ * ===================================================================================================================*/
+
+#include "Bench.h"
+#include "Bench_Cfg.h"
+
+#if (BENCH_CFG_ENABLE == 1u)
+#include "stm32f103xx_regs.h"
+#include "UartIf.h"
+#include "Irq.h"
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static uint32 prv_DwtRead(void);
+
+static const Bench_ConfigType*	s_cfg		= NULL_PTR;
+static Bench_CounterFnType		s_counter	= prv_DwtRead;
+static const char*				s_unit		= "cycles";
+static uint32					s_overhead	= 0u;
+static boolean					s_running	= FALSE;
+static uint16					s_next		= 0u;		// 0: header, n: case n - 1
+static boolean					s_pending	= FALSE;	// s_line not accepted by the backend yet
+static char						s_line[BENCH_CFG_LINE_SIZE];
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static uint32 prv_DwtRead(void)
+{
+	return DWT_CYCCNT;
+}
+
+static uint16 prv_PutStr(char* Buf, uint16 Pos, uint16 Size, const char* Str)
+{
+	while((*Str != '\0') && ((uint16)(Pos + 1u) < Size)) Buf[Pos++] = *Str++;
+	Buf[Pos] = '\0';
+	return Pos;
+}
+
+static uint16 prv_PutU32(char* Buf, uint16 Pos, uint16 Size, uint32 Val)
+{
+	char tmp[11];
+	uint8 n = 0u;
+
+	do {
+		tmp[n++]	= (char)('0' + (Val % 10u));
+		Val			/= 10u;
+	} while(Val != 0u);
+
+	while((n > 0u) && ((uint16)(Pos + 1u) < Size)) Buf[Pos++] = tmp[--n];
+	Buf[Pos] = '\0';
+	return Pos;
+}
+
+// "key":"value"
+static uint16 prv_PutKeyStr(char* Buf, uint16 Pos, uint16 Size, const char* Key, const char* Val)
+{
+	Pos = prv_PutStr(Buf, Pos, Size, "\"");
+	Pos = prv_PutStr(Buf, Pos, Size, Key);
+	Pos = prv_PutStr(Buf, Pos, Size, "\":\"");
+	Pos = prv_PutStr(Buf, Pos, Size, Val);
+	return prv_PutStr(Buf, Pos, Size, "\"");
+}
+
+// ,"key":value
+static uint16 prv_PutKeyU32(char* Buf, uint16 Pos, uint16 Size, const char* Key, uint32 Val)
+{
+	Pos = prv_PutStr(Buf, Pos, Size, ",\"");
+	Pos = prv_PutStr(Buf, Pos, Size, Key);
+	Pos = prv_PutStr(Buf, Pos, Size, "\":");
+	return prv_PutU32(Buf, Pos, Size, Val);
+}
+
+// Smallest back-to-back read delta, the fixed cost inside every measurement
+static uint32 prv_Calibrate(void)
+{
+	uint32 best = 0xFFFFFFFFu;
+	uint32 sv;
+
+	for(uint16 i = 0u; i < BENCH_CFG_ITERATIONS; i++)
+	{
+		IRQ_ENTER_CRITICAL_ALL(sv);
+		uint32 t0 = s_counter();
+		uint32 t1 = s_counter();
+		IRQ_EXIT_CRITICAL_ALL(sv);
+
+		if((t1 - t0) < best) best = t1 - t0;
+	}
+	return best;
+}
+
+static void prv_Prepare(void)
+{
+	if((s_cfg != NULL_PTR) && (s_cfg->Prepare != NULL_PTR)) s_cfg->Prepare();
+}
+
+/* ==============================
+ *             API
+ * ============================== */
+void Bench_SetCounter(Bench_CounterFnType CounterFn, const char* Unit)
+{
+	if((CounterFn == NULL_PTR) || (Unit == NULL_PTR)) return;
+
+	s_counter	= CounterFn;
+	s_unit		= Unit;
+}
+
+void Bench_Init(const Bench_ConfigType* CfgPtr)
+{
+	s_cfg		= CfgPtr;
+	s_running	= FALSE;
+	s_pending	= FALSE;
+
+	// harmless when another counter is installed
+	DEMCR		|= DEMCR_TRCENA;
+	DWT_CYCCNT	= 0u;
+	DWT_CTRL	|= DWT_CTRL_CYCCNTENA;
+
+	s_overhead	= prv_Calibrate();
+}
+
+uint16 Bench_GetCaseCount(void)
+{
+	return (s_cfg != NULL_PTR) ? s_cfg->CaseCount : 0u;
+}
+
+Std_ReturnType Bench_RunCase(uint16 Index, Bench_ResultType* ResPtr)
+{
+	const Bench_CaseType* c;
+	uint32 sv;
+
+	if((ResPtr == NULL_PTR) || (Index >= Bench_GetCaseCount())) return E_NOT_OK;
+
+	c				= &s_cfg->Cases[Index];
+	ResPtr->Min		= 0xFFFFFFFFu;
+	ResPtr->Max		= 0u;
+	ResPtr->Sum		= 0u;
+	ResPtr->N		= 0u;
+	ResPtr->Skipped	= FALSE;
+	ResPtr->Checked	= FALSE;
+	ResPtr->Err		= 0u;
+
+	for(uint16 i = 0u; i < BENCH_CFG_ITERATIONS; i++)
+	{
+		uint32 t0, t1, d;
+
+		IRQ_ENTER_CRITICAL_ALL(sv);
+		if((c->Setup != NULL_PTR) && (c->Setup(c->Arg) != E_OK))
+		{
+			IRQ_EXIT_CRITICAL_ALL(sv);
+			ResPtr->Skipped = TRUE;
+			return E_OK;
+		}
+		t0 = s_counter();
+		c->Run(c->Arg);
+		t1 = s_counter();
+		if(c->Teardown != NULL_PTR) c->Teardown(c->Arg);
+		IRQ_EXIT_CRITICAL_ALL(sv);
+
+		d = t1 - t0;
+		d = (d > s_overhead) ? (d - s_overhead) : 0u;
+
+		if(d < ResPtr->Min) ResPtr->Min = d;
+		if(d > ResPtr->Max) ResPtr->Max = d;
+		ResPtr->Sum	+= d;
+		ResPtr->N++;
+	}
+
+	// interrupts stay on, a sweep takes longer than a timed window should be masked
+	if(c->Check != NULL_PTR)
+	{
+		ResPtr->Err		= c->Check(c->Arg);
+		ResPtr->Checked	= TRUE;
+	}
+	return E_OK;
+}
+
+uint16 Bench_FormatHeader(char* Buf, uint16 Size)
+{
+	uint16 pos;
+
+	if((Buf == NULL_PTR) || (Size == 0u)) return 0u;
+
+	pos = prv_PutStr(Buf, 0u, Size, "{");
+	pos = prv_PutKeyStr(Buf, pos, Size, "bench", (s_cfg != NULL_PTR) ? s_cfg->Name : "");
+	pos = prv_PutStr(Buf, pos, Size, ",");
+	pos = prv_PutKeyStr(Buf, pos, Size, "unit", s_unit);
+	pos = prv_PutKeyU32(Buf, pos, Size, "overhead", s_overhead);
+	pos = prv_PutKeyU32(Buf, pos, Size, "iter", BENCH_CFG_ITERATIONS);
+	pos = prv_PutKeyU32(Buf, pos, Size, "cases", Bench_GetCaseCount());
+	return prv_PutStr(Buf, pos, Size, "}");
+}
+
+uint16 Bench_FormatResult(uint16 Index, const Bench_ResultType* ResPtr, char* Buf, uint16 Size)
+{
+	const Bench_CaseType* c;
+	uint16 pos;
+
+	if((Buf == NULL_PTR) || (Size == 0u) || (ResPtr == NULL_PTR) || (Index >= Bench_GetCaseCount())) return 0u;
+
+	c	= &s_cfg->Cases[Index];
+	pos	= prv_PutStr(Buf, 0u, Size, "{");
+	pos	= prv_PutKeyStr(Buf, pos, Size, "fn", c->Fn);
+	pos	= prv_PutStr(Buf, pos, Size, ",");
+	pos	= prv_PutKeyStr(Buf, pos, Size, "in", c->Input);
+
+	if((ResPtr->Skipped == TRUE) || (ResPtr->N == 0u))
+	{
+		pos = prv_PutStr(Buf, pos, Size, ",\"skip\":true");
+	} else {
+		pos = prv_PutKeyU32(Buf, pos, Size, "n", ResPtr->N);
+		pos = prv_PutKeyU32(Buf, pos, Size, "min", ResPtr->Min);
+		pos = prv_PutKeyU32(Buf, pos, Size, "max", ResPtr->Max);
+		pos = prv_PutKeyU32(Buf, pos, Size, "avg", ResPtr->Sum / ResPtr->N);
+		if(ResPtr->Checked == TRUE) pos = prv_PutKeyU32(Buf, pos, Size, "err", ResPtr->Err);
+	}
+	return prv_PutStr(Buf, pos, Size, "}");
+}
+
+Std_ReturnType Bench_Start(void)
+{
+	if((s_cfg == NULL_PTR) || (s_running == TRUE)) return E_NOT_OK;
+
+	// modules under test were running since Init, bring them back to the known state
+	prv_Prepare();
+	s_next		= 0u;
+	s_pending	= FALSE;
+	s_running	= TRUE;
+	return E_OK;
+}
+
+boolean Bench_IsRunning(void)
+{
+	return s_running;
+}
+
+void Bench_MainFunction(void)
+{
+	if(s_running == FALSE) return;
+
+	// one case per call, a refused line is retried before the next case runs
+	if(s_pending == FALSE)
+	{
+		if(s_next == 0u)
+		{
+			(void)Bench_FormatHeader(s_line, BENCH_CFG_LINE_SIZE);
+		} else {
+			Bench_ResultType res;
+
+			(void)Bench_RunCase((uint16)(s_next - 1u), &res);
+			(void)Bench_FormatResult((uint16)(s_next - 1u), &res, s_line, BENCH_CFG_LINE_SIZE);
+		}
+		s_pending = TRUE;
+	}
+
+	if(BENCH_CFG_WRITE_LINE(s_line) != E_OK) return;
+
+	s_pending = FALSE;
+	s_next++;
+	if(s_next > Bench_GetCaseCount()) s_running = FALSE;
+}
+#endif
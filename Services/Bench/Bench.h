@@ -0,0 +1,116 @@
+/* =====================================================================================================================
+ *  File        : Bench.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Cycle-budget benchmark suite for MainFunctions and ISRs
+ * 					- each case = untimed Setup, timed Run, untimed Teardown, repeated BENCH_CFG_ITERATIONS times
+ * 					  with interrupts masked, so every iteration takes the same path
+ * 					- counter is pluggable: DWT_CYCCNT on target, the host harness installs its own
+ * 					- results are JSON lines, one object per line:
+ * 					  {"bench":"Sensor_ECU","unit":"cycles","overhead":4,"iter":16,"cases":22}
+ * 					  {"fn":"ObstacleDetection_MainFunction","in":"near","n":16,"min":61,"max":61,"avg":61}
+ * 					  {"fn":"DistConv_EchoUsToQ4Mm","in":"dry20C","n":16,"min":12,"max":12,"avg":12,"err":38}
+ * 					  {"fn":"Uart_IrqHandler","in":"rxne","skip":true}
+ *  Depends     : Std_Types.h, Bench_Cfg.h
+ * ===================================================================================================================*/
+
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Bench_Cfg.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define BENCH_VENDOR_ID						(0x00u)
+#define BENCH_MODULE_ID						(0xCAu)
+
+#define BENCH_SW_MAJOR_VERSION				(1u)
+#define BENCH_SW_MINOR_VERSION				(0u)
+#define BENCH_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+// Free running counter, wraps at 32 bit
+typedef uint32 (*Bench_CounterFnType)(void);
+
+// E_NOT_OK: input set cannot be produced on this build, case is reported as skipped
+typedef Std_ReturnType (*Bench_SetupFnType)(uint32 Arg);
+typedef void (*Bench_FnType)(uint32 Arg);
+
+// Worst deviation of the function from a reference over its input range, in a unit the case defines
+typedef uint32 (*Bench_CheckFnType)(uint32 Arg);
+
+typedef struct
+{
+	const char*			Fn;			// function under test ("fn")
+	const char*			Input;		// input set ("in")
+	Bench_SetupFnType	Setup;		// untimed, NULL: none
+	Bench_FnType		Run;		// timed
+	Bench_FnType		Teardown;	// untimed, NULL: none
+	Bench_CheckFnType	Check;		// untimed, once after the iterations ("err"), NULL: none
+	uint32				Arg;
+} Bench_CaseType;
+
+typedef struct
+{
+	const char*				Name;			// "bench" field of the header line
+	const Bench_CaseType*	Cases;
+	uint16					CaseCount;
+	void					(*Prepare)(void);	// brings the modules under test into a known state, NULL: none
+} Bench_ConfigType;
+
+typedef struct
+{
+	uint32	Min;
+	uint32	Max;
+	uint32	Sum;
+	uint16	N;
+	boolean	Skipped;
+	boolean	Checked;
+	uint32	Err;		// Check result, valid when Checked
+} Bench_ResultType;
+
+#if (BENCH_CFG_ENABLE == 1u)
+/* ==============================
+ *             API
+ * ============================== */
+// Replace the counter (before Bench_Init), Unit is copied to the header line
+void Bench_SetCounter(Bench_CounterFnType CounterFn, const char* Unit);
+
+// Start the counter and calibrate its read overhead, Prepare is left to the caller / Bench_Start
+void Bench_Init(const Bench_ConfigType* CfgPtr);
+
+uint16 Bench_GetCaseCount(void);
+
+// Run one case, counts are net of the counter read overhead
+Std_ReturnType Bench_RunCase(uint16 Index, Bench_ResultType* ResPtr);
+
+// Format the header / one result as a NUL terminated JSON line, return length
+uint16 Bench_FormatHeader(char* Buf, uint16 Size);
+uint16 Bench_FormatResult(uint16 Index, const Bench_ResultType* ResPtr, char* Buf, uint16 Size);
+
+// Run Prepare, then the whole suite from Bench_MainFunction, one case per call, output through BENCH_CFG_WRITE_LINE
+Std_ReturnType Bench_Start(void);
+boolean Bench_IsRunning(void);
+
+// Call every main loop, does nothing unless started
+void Bench_MainFunction(void);
+
+/* =========================================================
+ * 	 Global configuration
+ * =======================================================*/
+extern const Bench_ConfigType Bench_Config;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_BENCH_H_ */
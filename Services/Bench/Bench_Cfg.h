@@ -0,0 +1,42 @@
+/* =====================================================================================================================
+ *  File        : Bench_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of cycle-budget benchmark suite
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef BENCH_BENCH_CFG_H_
+#define BENCH_BENCH_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Build the suite and the "bench" shell command (off in production images, ~2 KB flash) */
+#ifndef BENCH_CFG_ENABLE
+#define BENCH_CFG_ENABLE					(0u)
+#endif
+
+/* Timed calls per case, min / max / avg are reported */
+#ifndef BENCH_CFG_ITERATIONS
+#define BENCH_CFG_ITERATIONS				(16u)
+#endif
+
+/* One JSON result line incl. terminator */
+#ifndef BENCH_CFG_LINE_SIZE
+#define BENCH_CFG_LINE_SIZE					(128u)
+#endif
+
+/* Output backend for Bench_MainFunction, must be non-blocking and all-or-nothing */
+#ifndef BENCH_CFG_WRITE_LINE
+#define BENCH_CFG_WRITE_LINE(_str)			UartIf_WriteLine((_str))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_BENCH_CFG_H_ */
@@ -0,0 +1,684 @@
+/* =====================================================================================================================
+ *  File        : Bench_PBcfg.c
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Case table of benchmark suite: MainFunctions, distance conversion, Dio API vs fast path, Com path, signal codec and timer wheel, E2E and CRC, CanIf Rx lookup and ISRs with their input sets
+ * 					- ISR inputs are staged with TIMx_EGR / USART SR so the handler is called with real flags
+ * 					- every Teardown leaves the module in the state the next Setup expects
+ *  Notes       : Running the suite resets Rte, SensorIf, DistConv and the SWCs, restores Logger_Config (drops queued log
+ * 				  text and runtime level / tag changes) and aborts CAN mailbox 0
+ *  Depends     : Bench.h, Rte.h, DistConv.h, Com.h, Com_Timer.h, Com_Codec.h, E2E.h, Crc.h, PduR.h, CanIf.h, Logger.h, Uart.h, Icu.h, SensorIf.h, Dio.h, SWC headers
+ * ===================================================================================================================*/
+
+#include "Bench.h"
+#include "Bench_Cfg.h"
+
+#if (BENCH_CFG_ENABLE == 1u)
+#include "stm32f103xx_regs.h"
+#include "Rte.h"
+#include "DistConv.h"
+#include "Com.h"
+#include "Com_Timer.h"
+#include "Com_Codec.h"
+#include "E2E.h"
+#include "Crc.h"
+#include "PduR.h"
+#include "CanIf.h"
+#include "Logger.h"
+#include "LogTags.h"
+#include "Uart.h"
+#include "Icu.h"
+#include "SensorIf.h"
+#include "Dio.h"
+#include "Port_Cfg.h"
+#include "ObstacleDetection.h"
+#include "SensorSupervisor.h"
+#include <string.h>
+#if defined(SIM_HOST)
+#include "Sim.h"
+#endif
+
+#define BENCH_WAIT_POLLS					(100000u)	// bound of the busy waits in Setup / Teardown
+#define BENCH_UART_CH						(UART_CH1)
+#define BENCH_UART_REGS						(USART1)
+
+// TIM2 ISR phases
+#define BENCH_TIM_ARM						(0u)
+#define BENCH_TIM_RISE						(1u)
+#define BENCH_TIM_FALL						(2u)
+#define BENCH_TIM_TIMEOUT					(3u)
+
+// SensorIf main function inputs
+#define BENCH_SIF_IDLE						(0u)
+#define BENCH_SIF_WAITING					(1u)
+#define BENCH_SIF_DONE						(2u)
+
+// Dio: HC-SR04 trigger pin. TIM2_CH2 alternate function in HW trigger builds, ODR does not reach the pin there;
+// a GPIO trigger build sees flip pulses of a few cycles, far below the 10 us the sensor needs
+#define BENCH_DIO_PIN						(PORT_PIN_HCSR04_TRIG)
+
+// Logger inputs
+#define BENCH_LOG_TEXT						(0u)
+#define BENCH_LOG_FMT3						(1u)
+#define BENCH_LOG_FILTERED					(2u)
+
+// Distance inputs [mm], 0: no data
+#define BENCH_DIST_NODATA					(0u)
+#define BENCH_DIST_INVALID					(5000u)
+#define BENCH_DIST_CLEAR					(1000u)
+#define BENCH_DIST_NEAR						(150u)
+
+// Distance conversion: dry air at these temperatures [0.1 degC], the echo of the timed call [us]
+#define BENCH_DISTCONV_COLD					(-200)
+#define BENCH_DISTCONV_ROOM					(200)
+#define BENCH_DISTCONV_HOT					(600)
+#define BENCH_DISTCONV_ECHO_US				(5828u)		// 1000 mm at 20 degC
+#define BENCH_DISTCONV_UM_PER_Q4			(62.5f)
+
+// Com timer wheel: what the tick has to do with COM_CFG_TIMER_MAX timers (or none)
+#define BENCH_WHEEL_IDLE					(0u)		// nothing armed
+#define BENCH_WHEEL_CASCADE					(1u)		// new window, all timers move down from level 1
+#define BENCH_WHEEL_EXPIRE					(2u)		// all timers due
+
+// Com signal codec: index into Bench_CodecSignals
+#define BENCH_CODEC_INTEL16					(0u)		// byte aligned
+#define BENCH_CODEC_INTEL12S				(1u)		// across a byte border, sign extended
+#define BENCH_CODEC_MOTOROLA12S				(2u)
+#define BENCH_CODEC_MOTOROLA32				(3u)		// over 5 bytes
+
+// E2E: index into Bench_E2EConfigs
+#define BENCH_E2E_CRC8						(0u)
+#define BENCH_E2E_CRC16						(1u)
+
+// CRC: bytes per call
+#define BENCH_CRC_BYTES						(64u)
+
+// Com Rx path: frame of the sensor I-PDU
+#define BENCH_COMRX_FRESH					(0u)		// new counter every run, all signals unpacked
+#define BENCH_COMRX_REPLAYED				(1u)		// same frame every run, dropped after the CRC
+
+// CanIf Rx lookup: table sizes up to the RAM this build can spare
+#if defined(SIM_HOST)
+#define BENCH_CANIF_IDS_MAX					(512u)
+#else
+#define BENCH_CANIF_IDS_MAX					(32u)
+#endif
+#define BENCH_CANIF_ID_BASE					(0x100u)
+#define BENCH_CANIF_ID_STEP					(3u)
+#define BENCH_CANIF_PDU_UNROUTED			((PduIdType)0x7Fu)	// PduR drops it, only CanIf is measured
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static CanIf_RxPduConfigType	Bench_CanIfRx[BENCH_CANIF_IDS_MAX];
+static CanIf_ConfigType			Bench_CanIfRxConfig;
+static uint8					Bench_CanSdu[8];
+static volatile DistConv_Q4MmType	Bench_DistQ4;
+static Com_TimerWheelType		Bench_Wheel;
+static Com_CodecType			Bench_Codec;
+static Com_CodecFrameType		Bench_CodecFrame;
+static uint8					Bench_CodecTx[COM_CODEC_FRAME_BYTES];
+static volatile uint32			Bench_CodecValue;
+static uint8					Bench_E2EFrame[COM_CODEC_FRAME_BYTES];
+static E2E_ProtectStateType		Bench_E2EProtect;
+static E2E_CheckStateType		Bench_E2ECheck;
+static uint8					Bench_CrcData[BENCH_CRC_BYTES];
+static volatile uint16			Bench_CrcValue;
+static volatile Dio_ChannelState	Bench_DioLevel;
+static uint8					Bench_ComRxSdu[COM_CODEC_FRAME_BYTES];
+
+// Placement only, the rest of the signal config does not reach the codec
+static const Com_SignalConfigType Bench_CodecSignals[] = {
+	[BENCH_CODEC_INTEL16]		= { .SignalType = COM_SIGNAL_UINT16,	.BitPosition = 16u,	.BitSize = 16u,	.Endianness = COM_LITTLE_ENDIAN },
+	[BENCH_CODEC_INTEL12S]		= { .SignalType = COM_SIGNAL_SINT16,	.BitPosition = 20u,	.BitSize = 12u,	.Endianness = COM_LITTLE_ENDIAN },
+	[BENCH_CODEC_MOTOROLA12S]	= { .SignalType = COM_SIGNAL_SINT16,	.BitPosition = 20u,	.BitSize = 12u,	.Endianness = COM_BIG_ENDIAN },
+	[BENCH_CODEC_MOTOROLA32]	= { .SignalType = COM_SIGNAL_UINT32,	.BitPosition = 36u,	.BitSize = 32u,	.Endianness = COM_BIG_ENDIAN },
+};
+
+// Full 8 byte frames, CRC and counter in front
+static const E2E_ConfigType Bench_E2EConfigs[] = {
+	[BENCH_E2E_CRC8]			= { .Profile = E2E_PROFILE_CRC8,	.DataId = 0x0123u,	.CrcOffset = 0u,	.CounterOffset = 8u,	.MaxDeltaCounter = 1u },
+	[BENCH_E2E_CRC16]			= { .Profile = E2E_PROFILE_CRC16,	.DataId = 0x0123u,	.CrcOffset = 0u,	.CounterOffset = 16u,	.MaxDeltaCounter = 1u },
+};
+
+// J1939 PGN 0xFF00, any source address
+static const CanIf_RxMaskConfigType Bench_CanIfRxMask[] = {
+	{ .RxPduId = BENCH_CANIF_PDU_UNROUTED,	.Code = CAN_ID_EXTENDED | 0x18FF0000u,	.Mask = CAN_ID_EXTENDED | 0x1FFFFF00u },
+};
+
+static uint32 Bench_UartCr1;
+
+/* ==============================
+ *       STAGING HELPERS
+ * ============================== */
+// Raise TIM2 CCxIF by software and serve it like the NVIC would
+static void prv_TimEvent(uint32 Egr)
+{
+	TIM2->EGR = Egr;
+	REG_SYNC();
+	TIM2_IRQHandler();
+}
+
+// Finish whatever ranging is running (timeout) and consume the result
+static void prv_IcuIdle(void)
+{
+	if(Icu_GetRanging(ICU_CHANNEL_ECHO, NULL_PTR) == ICU_RANGING_BUSY)
+	{
+		prv_TimEvent(TIM_EGR_CC2G);
+		prv_TimEvent(TIM_EGR_CC3G);
+		(void)Icu_GetRanging(ICU_CHANNEL_ECHO, NULL_PTR);
+	}
+}
+
+// Mailbox 0 free for the next Can_Write (the frame is aborted, the controller may still be asleep)
+static Std_ReturnType prv_CanFree(void)
+{
+	if((CAN1->TSR & CAN_TSR_TME0) == 0u)
+	{
+		CAN1->TSR = CAN_TSR_ABRQ0;
+		for(uint32 n = 0u; (n < BENCH_WAIT_POLLS) && ((CAN1->TSR & CAN_TSR_TME0) == 0u); n++) REG_POLL();
+	}
+	return (CAN1->TSR & CAN_TSR_TME0) ? E_OK : E_NOT_OK;
+}
+
+static Std_ReturnType prv_SetupCan(uint32 Arg)		{ (void)Arg; return prv_CanFree(); }
+static void prv_TeardownCan(uint32 Arg)				{ (void)Arg; (void)prv_CanFree(); }
+
+/* ==============================
+ *       SWC RUNNABLES
+ * ============================== */
+static Std_ReturnType prv_SetupDistance(uint32 Mm)
+{
+	if(Mm == BENCH_DIST_NODATA)
+	{
+		Rte_Init();
+	} else {
+		(void)Rte_Write_Distance((Rte_DistanceType)DISTCONV_MM_TO_Q4(Mm));
+	}
+	return E_OK;
+}
+
+static void prv_RunObstacle(uint32 Arg)				{ (void)Arg; ObstacleDetection_MainFunction(); }
+static void prv_RunSupervisor(uint32 Arg)			{ (void)Arg; SensorSupervisor_Runnable_10ms(); }
+
+/* ==============================
+ *       DISTANCE CONVERSION
+ * ============================== */
+// Newton iterations from 1.0, the argument stays within 0.85 .. 1.33
+static float prv_Sqrtf(float X)
+{
+	float r = 1.0f;
+
+	for(uint8 i = 0u; i < 6u; i++) r = 0.5f * (r + (X / r));
+	return r;
+}
+
+static Std_ReturnType prv_SetupDistConv(uint32 TempDc)
+{
+	DistConv_SetTemperature((DistConv_TempDeciCType)(sint32)TempDc);
+	DistConv_SetHumidity(0u);
+	return E_OK;
+}
+
+static void prv_RunDistConv(uint32 Arg)				{ (void)Arg; Bench_DistQ4 = DistConv_EchoUsToQ4Mm(BENCH_DISTCONV_ECHO_US); }
+static void prv_RunDistConvReload(uint32 TempDc)	{ DistConv_SetTemperature((DistConv_TempDeciCType)(sint32)TempDc); }
+static void prv_TeardownDistConv(uint32 Arg)		{ (void)Arg; DistConv_Init(); }
+
+// Worst error [um] against c = 331.3 m/s * sqrt(1 + T / 273.15) in float, every echo time up to saturation
+static uint32 prv_CheckDistConv(uint32 TempDc)
+{
+	float c		= 331300.0f * prv_Sqrtf(1.0f + ((float)(sint32)TempDc / 2731.5f));	// mm/s
+	float worst	= 0.0f;
+
+	(void)prv_SetupDistConv(TempDc);
+	for(uint32 us = 0u; ; us++)
+	{
+		DistConv_Q4MmType q4 = DistConv_EchoUsToQ4Mm(us);
+		float err;
+
+		if(q4 == DISTCONV_Q4_MAX) break;
+		err = (float)q4 - (((float)us * c * 16.0f) / 2000000.0f);
+		if(err < 0.0f)		err = -err;
+		if(err > worst)		worst = err;
+	}
+	prv_TeardownDistConv(0u);
+	return (uint32)((worst * BENCH_DISTCONV_UM_PER_Q4) + 0.5f);
+}
+
+/* ==============================
+ *       SENSORIF
+ * ============================== */
+static Std_ReturnType prv_SetupSensorIf(uint32 Arg)
+{
+	prv_IcuIdle();
+	SensorIf_Init();
+	DistConv_Init();
+	if(Arg == BENCH_SIF_IDLE) return E_OK;
+
+	if(SensorIf_TriggerMeasurement() != SENSORIF_STATUS_OK) return E_NOT_OK;
+
+	if(Arg == BENCH_SIF_DONE)
+	{
+		prv_TimEvent(TIM_EGR_CC2G);		// trigger end, echo armed
+		prv_TimEvent(TIM_EGR_CC1G);		// echo rise
+		prv_TimEvent(TIM_EGR_CC1G);		// echo fall
+	}
+	return E_OK;
+}
+
+static void prv_RunSensorIf(uint32 Arg)				{ (void)Arg; SensorIf_Mainfunction(); }
+
+static void prv_TeardownSensorIf(uint32 Arg)
+{
+	(void)Arg;
+	prv_IcuIdle();
+	SensorIf_Init();
+}
+
+/* ==============================
+ *       DIO
+ * ============================== */
+// Pin low before and after every run: flip always goes low -> high
+static Std_ReturnType prv_SetupDio(uint32 Arg)		{ (void)Arg; Dio_WriteChannelFast(BENCH_DIO_PIN, PORT_PIN_LEVEL_LOW); return E_OK; }
+static void prv_TeardownDio(uint32 Arg)				{ (void)Arg; Dio_WriteChannelFast(BENCH_DIO_PIN, PORT_PIN_LEVEL_LOW); }
+
+static void prv_RunDioWrite(uint32 Arg)				{ (void)Arg; Dio_WriteChannel(BENCH_DIO_PIN, PORT_PIN_LEVEL_LOW); }
+static void prv_RunDioWriteFast(uint32 Arg)			{ (void)Arg; Dio_WriteChannelFast(BENCH_DIO_PIN, PORT_PIN_LEVEL_LOW); }
+static void prv_RunDioRead(uint32 Arg)				{ (void)Arg; Bench_DioLevel = Dio_ReadChannel(BENCH_DIO_PIN); }
+static void prv_RunDioReadFast(uint32 Arg)			{ (void)Arg; Bench_DioLevel = Dio_ReadChannelFast(BENCH_DIO_PIN); }
+static void prv_RunDioFlip(uint32 Arg)				{ (void)Arg; Bench_DioLevel = Dio_FlipChannel(BENCH_DIO_PIN); }
+
+/* ==============================
+ *       COM / PDUR
+ * ============================== */
+static void prv_RunComSend(uint32 SignalId)
+{
+	Rte_DistanceType d = (Rte_DistanceType)DISTCONV_MM_TO_Q4(BENCH_DIST_CLEAR);
+
+	(void)Com_SendSignal((Com_SignalIdType)SignalId, &d);
+}
+
+static void prv_RunPduR(uint32 PduId)
+{
+	uint8 sdu[8] = { 0x11u, 0x22u, 0x33u, 0x44u, 0x55u, 0x66u, 0x77u, 0x88u };
+	PduInfoType pdu;
+
+	pdu.SduDataPtr	= sdu;
+	pdu.MetaDataPtr	= NULL_PTR;
+	pdu.SduLength	= (PduLengthType)sizeof(sdu);
+	(void)PduR_ComTransmit((PduIdType)PduId, &pdu);
+}
+
+/* ==============================
+ *       COM TIMER WHEEL
+ * ============================== */
+static void prv_WheelExpired(Com_TimerIdType Id)	{ (void)Id; }
+
+static Std_ReturnType prv_SetupWheel(uint32 Slot)
+{
+	Com_TimerIdType id;
+
+	Com_TimerInit(&Bench_Wheel, prv_WheelExpired);
+	if(Slot == BENCH_WHEEL_IDLE) return E_OK;
+
+	for(id = 0u; id < COM_CFG_TIMER_MAX; id++)
+	{
+		(void)Com_TimerStart(&Bench_Wheel, id, (Slot == BENCH_WHEEL_CASCADE) ? (COM_TIMER_L0_SLOTS + 1u) : 1u);
+	}
+
+	// up to the last tick of the first window, the timed one starts the next
+	if(Slot == BENCH_WHEEL_CASCADE)
+	{
+		for(id = 0u; id < (COM_TIMER_L0_SLOTS - 1u); id++) Com_TimerTick(&Bench_Wheel);
+	}
+	return E_OK;
+}
+
+static void prv_RunWheel(uint32 Slot)				{ (void)Slot; Com_TimerTick(&Bench_Wheel); }
+
+/* ==============================
+ *       COM SIGNAL CODEC
+ * ============================== */
+static Std_ReturnType prv_SetupCodec(uint32 Signal)
+{
+	static const uint8 sdu[COM_CODEC_FRAME_BYTES] = { 0x11u, 0x22u, 0x33u, 0xC4u, 0x55u, 0x66u, 0x77u, 0x88u };
+
+	if(Com_CodecInit(&Bench_Codec, &Bench_CodecSignals[Signal]) != E_OK) return E_NOT_OK;
+	Com_CodecLoad(&Bench_CodecFrame, sdu, (PduLengthType)sizeof(sdu));
+	memcpy(Bench_CodecTx, sdu, sizeof(sdu));
+	return E_OK;
+}
+
+static void prv_RunUnpack(uint32 Arg)				{ (void)Arg; Bench_CodecValue = Com_CodecUnpack(&Bench_Codec, &Bench_CodecFrame); }
+static void prv_RunPack(uint32 Arg)					{ (void)Arg; Com_CodecPack(&Bench_Codec, Bench_CodecTx, 0xFFFFF9C0u); }
+
+static Std_ReturnType prv_SetupComRx(uint32 Arg)
+{
+	static const uint8 sdu[COM_CODEC_FRAME_BYTES] = { 0x34u, 0x12u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u };
+
+	(void)Arg;
+	memcpy(Bench_ComRxSdu, sdu, sizeof(sdu));
+	E2E_ProtectInit(&Bench_E2EProtect);
+	return E2E_Protect(Com_Config.RxIpduConfig[COM_IPDU_ID_RX_SENSOR].E2E, &Bench_E2EProtect, Bench_ComRxSdu, (PduLengthType)sizeof(sdu));
+}
+
+// Whole Rx path of the sensor I-PDU: E2E check, frame load, update bit, one signal, deadline restart.
+// A fresh frame includes the sender side E2E_Protect
+static void prv_RunComRx(uint32 Arg)
+{
+	PduInfoType pdu;
+
+	if(Arg == BENCH_COMRX_FRESH)
+	{
+		(void)E2E_Protect(Com_Config.RxIpduConfig[COM_IPDU_ID_RX_SENSOR].E2E, &Bench_E2EProtect, Bench_ComRxSdu, (PduLengthType)sizeof(Bench_ComRxSdu));
+	}
+	pdu.SduDataPtr	= Bench_ComRxSdu;
+	pdu.MetaDataPtr	= NULL_PTR;
+	pdu.SduLength	= (PduLengthType)sizeof(Bench_ComRxSdu);
+	Com_RxIndication((PduIdType)COM_IPDU_ID_RX_SENSOR, &pdu);
+}
+
+/* ==============================
+ *       E2E / CRC
+ * ============================== */
+static Std_ReturnType prv_SetupE2E(uint32 Cfg)
+{
+	static const uint8 sdu[COM_CODEC_FRAME_BYTES] = { 0x00u, 0x00u, 0x00u, 0x44u, 0x55u, 0x66u, 0x77u, 0x88u };
+
+	memcpy(Bench_E2EFrame, sdu, sizeof(sdu));
+	E2E_ProtectInit(&Bench_E2EProtect);
+	E2E_CheckInit(&Bench_E2ECheck);
+	return E2E_Protect(&Bench_E2EConfigs[Cfg], &Bench_E2EProtect, Bench_E2EFrame, (PduLengthType)sizeof(sdu));
+}
+
+static void prv_RunProtect(uint32 Cfg)
+{
+	(void)E2E_Protect(&Bench_E2EConfigs[Cfg], &Bench_E2EProtect, Bench_E2EFrame, (PduLengthType)sizeof(Bench_E2EFrame));
+}
+
+// same frame every run: E2E_P_REPEATED after the first, the CRC is computed all the same
+static void prv_RunCheck(uint32 Cfg)
+{
+	(void)E2E_Check(&Bench_E2EConfigs[Cfg], &Bench_E2ECheck, Bench_E2EFrame, (PduLengthType)sizeof(Bench_E2EFrame));
+}
+
+static Std_ReturnType prv_SetupCrc(uint32 Arg)
+{
+	(void)Arg;
+	for(uint32 i = 0u; i < BENCH_CRC_BYTES; i++) Bench_CrcData[i] = (uint8)(i * 37u);
+	return E_OK;
+}
+
+static void prv_RunCrc8(uint32 Arg)				{ (void)Arg; Bench_CrcValue = Crc_CalculateCRC8(Bench_CrcData, BENCH_CRC_BYTES, 0u, TRUE); }
+static void prv_RunCrc16(uint32 Arg)			{ (void)Arg; Bench_CrcValue = Crc_CalculateCRC16(Bench_CrcData, BENCH_CRC_BYTES, 0u, TRUE); }
+
+/* ==============================
+ *       CANIF RX LOOKUP
+ * ============================== */
+// Count sorted IDs, all unrouted, plus the J1939 mask entry
+static Std_ReturnType prv_SetupCanIfRx(uint32 Count)
+{
+	if((Count == 0u) || (Count > BENCH_CANIF_IDS_MAX)) return E_NOT_OK;
+
+	for(uint32 i = 0u; i < Count; i++)
+	{
+		Bench_CanIfRx[i].RxPduId	= BENCH_CANIF_PDU_UNROUTED;
+		Bench_CanIfRx[i].CanId		= BENCH_CANIF_ID_BASE + (i * BENCH_CANIF_ID_STEP);
+	}
+
+	Bench_CanIfRxConfig					= CanIf_Config;
+	Bench_CanIfRxConfig.RxPduConfig		= Bench_CanIfRx;
+	Bench_CanIfRxConfig.NumRxPdu		= (uint16)Count;
+	Bench_CanIfRxConfig.RxMaskConfig	= Bench_CanIfRxMask;
+	Bench_CanIfRxConfig.NumRxMask		= (uint8)(sizeof(Bench_CanIfRxMask) / sizeof(CanIf_RxMaskConfigType));
+	CanIf_Init(&Bench_CanIfRxConfig);
+	return E_OK;
+}
+
+static void prv_TeardownCanIfRx(uint32 Arg)			{ (void)Arg; CanIf_Init(&CanIf_Config); }
+
+static void prv_CanIfRx(Can_IdType Id)
+{
+	Can_PduType pdu;
+
+	pdu.Id			= Id;
+	pdu.length		= (uint8)sizeof(Bench_CanSdu);
+	pdu.sdu			= Bench_CanSdu;
+	pdu.swpduHandle	= 0u;
+	Can_RxIndication(0u, &pdu);
+}
+
+// last ID of the table, the deepest probe
+static void prv_RunCanIfHit(uint32 Count)	{ prv_CanIfRx(BENCH_CANIF_ID_BASE + ((Count - 1u) * BENCH_CANIF_ID_STEP)); }
+// not in the table, caught by the mask entry
+static void prv_RunCanIfMask(uint32 Count)	{ (void)Count; prv_CanIfRx(CAN_ID_EXTENDED | 0x18FF0021u); }
+// not for this ECU: exact miss + mask miss
+static void prv_RunCanIfMiss(uint32 Count)	{ (void)Count; prv_CanIfRx(BENCH_CANIF_ID_BASE + 1u); }
+
+/* ==============================
+ *       LOGGER
+ * ============================== */
+#if (LOGGER_CFG_ENABLE == 1)
+// Sink takes everything, only the formatting and queueing are measured
+static Std_ReturnType prv_LogSink(const uint8* data, uint16 len)
+{
+	(void)data; (void)len;
+	return E_OK;
+}
+
+static Std_ReturnType prv_LogSinkPartial(const uint8* data, uint16 len, uint16* accepted)
+{
+	(void)data;
+	*accepted = len;
+	return E_OK;
+}
+
+#if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
+static uint32 prv_LogTime(void)						{ return 0u; }
+#endif
+
+static const Logger_ConfigType Bench_LoggerConfig = {
+	.defaultLevel		= LOG_LEVEL_INFO,
+	.enableTagsMask		= LOG_TAG_ALL,
+	.outWrite			= prv_LogSink,
+	.outWriteLine		= NULL_PTR,
+	.outWritePartial	= prv_LogSinkPartial,
+#if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
+	.getTimeMs			= prv_LogTime
+#endif
+};
+
+static Std_ReturnType prv_SetupLogger(uint32 Arg)	{ (void)Arg; Logger_Init(&Bench_LoggerConfig); return E_OK; }
+static void prv_TeardownLogger(uint32 Arg)			{ (void)Arg; Logger_Init(&Logger_Config); }
+
+static void prv_RunLogger(uint32 Arg)
+{
+	switch(Arg)
+	{
+	case BENCH_LOG_TEXT:
+		(void)Logger_Logf(LOG_LEVEL_INFO, LOG_TAG_SYSTEM, "bench");
+		break;
+
+	case BENCH_LOG_FMT3:
+		(void)Logger_Logf(LOG_LEVEL_INFO, LOG_TAG_SYSTEM, "d=%u st=%u t=%d", 1000u, 1u, -5);
+		break;
+
+	default:
+		(void)Logger_Logf(LOG_LEVEL_DEBUG, LOG_TAG_SYSTEM, "d=%u", 1000u);
+		break;
+	}
+}
+#endif
+
+/* ==============================
+ *       UART ISR
+ * ============================== */
+// no source: TXE without TXEIE, nothing received
+static Std_ReturnType prv_SetupUartIdle(uint32 Arg)
+{
+	(void)Arg;
+	Bench_UartCr1			= BENCH_UART_REGS->CR1;
+	BENCH_UART_REGS->CR1	= Bench_UartCr1 & ~((1UL << USART_CR1_TXEIE) | (1UL << USART_CR1_TCIE));
+	return E_OK;
+}
+
+static void prv_TeardownUartIdle(uint32 Arg)
+{
+	(void)Arg;
+	BENCH_UART_REGS->CR1 = Bench_UartCr1;
+}
+
+// TDR empty and a byte queued: the handler refills TDR (a space, harmless between JSON tokens)
+static Std_ReturnType prv_SetupUartTxe(uint32 Arg)
+{
+	static const uint8 pad = (uint8)' ';
+	(void)Arg;
+
+	for(uint32 n = 0u; (n < BENCH_WAIT_POLLS) && ((BENCH_UART_REGS->SR & (1UL << USART_SR_TXE)) == 0u); n++) REG_POLL();
+	if((BENCH_UART_REGS->SR & (1UL << USART_SR_TXE)) == 0u) return E_NOT_OK;
+
+	return Uart_WriteAsync(BENCH_UART_CH, &pad, 1u);
+}
+
+// RXNE cannot be raised by software on the target, the host feeds the RX line instead
+static Std_ReturnType prv_SetupUartRx(uint32 Arg)
+{
+#if defined(SIM_HOST)
+	static const uint8 ch = (uint8)' ';
+
+	(void)prv_SetupUartIdle(Arg);
+	BENCH_UART_REGS->CR1 &= ~(1UL << USART_CR1_RXNEIE);
+	Sim_Uart_Inject(0u, &ch, 1u);
+	Sim_Advance(200u);
+	return (BENCH_UART_REGS->SR & (1UL << USART_SR_RXNE)) ? E_OK : E_NOT_OK;
+#else
+	(void)Arg;
+	return E_NOT_OK;
+#endif
+}
+
+static void prv_TeardownUartRx(uint32 Arg)
+{
+	BENCH_UART_REGS->SR = ~(uint32)(1UL << USART_SR_RXNE);
+	REG_SYNC();
+	prv_TeardownUartIdle(Arg);
+}
+
+static void prv_RunUartIrq(uint32 Arg)				{ (void)Arg; Uart_IrqHandler(BENCH_UART_CH); }
+
+/* ==============================
+ *       TIM2 ISR
+ * ============================== */
+// Ranging started and advanced to the phase before Arg, the flag of Arg is raised for the timed call
+static Std_ReturnType prv_SetupTim(uint32 Phase)
+{
+	prv_IcuIdle();
+	if(Icu_StartRanging(ICU_CHANNEL_ECHO, SENSORIF_TRIG_PULSE_US, SENSORIF_ECHO_TIMOUT_US) != E_OK) return E_NOT_OK;
+
+	if(Phase != BENCH_TIM_ARM)		prv_TimEvent(TIM_EGR_CC2G);
+	if(Phase == BENCH_TIM_FALL)		prv_TimEvent(TIM_EGR_CC1G);
+
+	switch(Phase)
+	{
+	case BENCH_TIM_ARM:		TIM2->EGR = TIM_EGR_CC2G;	break;
+	case BENCH_TIM_TIMEOUT:	TIM2->EGR = TIM_EGR_CC3G;	break;
+	default:				TIM2->EGR = TIM_EGR_CC1G;	break;
+	}
+	REG_SYNC();
+	return E_OK;
+}
+
+static void prv_RunTim(uint32 Arg)					{ (void)Arg; TIM2_IRQHandler(); }
+static void prv_TeardownTim(uint32 Arg)				{ (void)Arg; prv_IcuIdle(); }
+
+/* ==============================
+ *       PREPARE
+ * ============================== */
+static void Bench_Prepare(void)
+{
+	// bxCAN leaves reset asleep with empty mailboxes, a clock is enough for Can_Write / abort
+	RCC->APB1ENR |= RCC_APB1ENR_CAN1EN;
+
+	Com_Init(&Com_Config);
+	PduR_Init((PduR_ConfigTypes*)&PduR_Config);
+	CanIf_Init(&CanIf_Config);
+	(void)prv_CanFree();
+
+	prv_IcuIdle();
+	SensorIf_Init();
+	Rte_Init();
+	ObstacleDetection_Init();
+	SensorSupervisor_Init();
+}
+
+/* ==============================
+ *       CONFIG
+ * ============================== */
+static const Bench_CaseType Bench_Cases[] = {
+	{ .Fn = "ObstacleDetection_MainFunction",	.Input = "nodata",		.Setup = prv_SetupDistance,	.Run = prv_RunObstacle,		.Teardown = NULL_PTR,				.Arg = BENCH_DIST_NODATA },
+	{ .Fn = "ObstacleDetection_MainFunction",	.Input = "invalid",		.Setup = prv_SetupDistance,	.Run = prv_RunObstacle,		.Teardown = NULL_PTR,				.Arg = BENCH_DIST_INVALID },
+	{ .Fn = "ObstacleDetection_MainFunction",	.Input = "clear",		.Setup = prv_SetupDistance,	.Run = prv_RunObstacle,		.Teardown = NULL_PTR,				.Arg = BENCH_DIST_CLEAR },
+	{ .Fn = "ObstacleDetection_MainFunction",	.Input = "near",		.Setup = prv_SetupDistance,	.Run = prv_RunObstacle,		.Teardown = NULL_PTR,				.Arg = BENCH_DIST_NEAR },
+	{ .Fn = "SensorSupervisor_Runnable_10ms",	.Input = "nodata",		.Setup = prv_SetupDistance,	.Run = prv_RunSupervisor,	.Teardown = NULL_PTR,				.Arg = BENCH_DIST_NODATA },
+	{ .Fn = "SensorSupervisor_Runnable_10ms",	.Input = "invalid",		.Setup = prv_SetupDistance,	.Run = prv_RunSupervisor,	.Teardown = NULL_PTR,				.Arg = BENCH_DIST_INVALID },
+	{ .Fn = "SensorSupervisor_Runnable_10ms",	.Input = "clear",		.Setup = prv_SetupDistance,	.Run = prv_RunSupervisor,	.Teardown = NULL_PTR,				.Arg = BENCH_DIST_CLEAR },
+	{ .Fn = "SensorSupervisor_Runnable_10ms",	.Input = "near",		.Setup = prv_SetupDistance,	.Run = prv_RunSupervisor,	.Teardown = NULL_PTR,				.Arg = BENCH_DIST_NEAR },
+	{ .Fn = "DistConv_EchoUsToQ4Mm",			.Input = "dry-20C",		.Setup = prv_SetupDistConv,	.Run = prv_RunDistConv,		.Teardown = prv_TeardownDistConv,	.Check = prv_CheckDistConv,	.Arg = (uint32)BENCH_DISTCONV_COLD },
+	{ .Fn = "DistConv_EchoUsToQ4Mm",			.Input = "dry20C",		.Setup = prv_SetupDistConv,	.Run = prv_RunDistConv,		.Teardown = prv_TeardownDistConv,	.Check = prv_CheckDistConv,	.Arg = (uint32)BENCH_DISTCONV_ROOM },
+	{ .Fn = "DistConv_EchoUsToQ4Mm",			.Input = "dry60C",		.Setup = prv_SetupDistConv,	.Run = prv_RunDistConv,		.Teardown = prv_TeardownDistConv,	.Check = prv_CheckDistConv,	.Arg = (uint32)BENCH_DISTCONV_HOT },
+	{ .Fn = "DistConv_SetTemperature",			.Input = "reload",		.Setup = NULL_PTR,			.Run = prv_RunDistConvReload,	.Teardown = prv_TeardownDistConv,	.Arg = (uint32)BENCH_DISTCONV_HOT },
+	{ .Fn = "SensorIf_Mainfunction",			.Input = "idle",		.Setup = prv_SetupSensorIf,	.Run = prv_RunSensorIf,		.Teardown = prv_TeardownSensorIf,	.Arg = BENCH_SIF_IDLE },
+	{ .Fn = "SensorIf_Mainfunction",			.Input = "waiting",		.Setup = prv_SetupSensorIf,	.Run = prv_RunSensorIf,		.Teardown = prv_TeardownSensorIf,	.Arg = BENCH_SIF_WAITING },
+	{ .Fn = "SensorIf_Mainfunction",			.Input = "done",		.Setup = prv_SetupSensorIf,	.Run = prv_RunSensorIf,		.Teardown = prv_TeardownSensorIf,	.Arg = BENCH_SIF_DONE },
+	{ .Fn = "Dio_WriteChannel",					.Input = "low",			.Setup = prv_SetupDio,		.Run = prv_RunDioWrite,		.Teardown = prv_TeardownDio,		.Arg = 0u },
+	{ .Fn = "Dio_WriteChannelFast",				.Input = "low",			.Setup = prv_SetupDio,		.Run = prv_RunDioWriteFast,	.Teardown = prv_TeardownDio,		.Arg = 0u },
+	{ .Fn = "Dio_ReadChannel",					.Input = "pin",			.Setup = prv_SetupDio,		.Run = prv_RunDioRead,		.Teardown = prv_TeardownDio,		.Arg = 0u },
+	{ .Fn = "Dio_ReadChannelFast",				.Input = "pin",			.Setup = prv_SetupDio,		.Run = prv_RunDioReadFast,	.Teardown = prv_TeardownDio,		.Arg = 0u },
+	{ .Fn = "Dio_FlipChannel",					.Input = "low",			.Setup = prv_SetupDio,		.Run = prv_RunDioFlip,		.Teardown = prv_TeardownDio,		.Arg = 0u },
+	{ .Fn = "Com_SendSignal",					.Input = "distance",	.Setup = prv_SetupCan,		.Run = prv_RunComSend,		.Teardown = prv_TeardownCan,		.Arg = COM_SIGNAL_ID_DISTANCE },
+	{ .Fn = "Com_SendSignal",					.Input = "speed",		.Setup = prv_SetupCan,		.Run = prv_RunComSend,		.Teardown = prv_TeardownCan,		.Arg = COM_SIGNAL_ID_SPEED },
+	{ .Fn = "Com_SendSignal",					.Input = "unknown",		.Setup = NULL_PTR,			.Run = prv_RunComSend,		.Teardown = NULL_PTR,				.Arg = 0x7Fu },
+	{ .Fn = "Com_TimerTick",					.Input = "idle",		.Setup = prv_SetupWheel,	.Run = prv_RunWheel,		.Teardown = NULL_PTR,				.Arg = BENCH_WHEEL_IDLE },
+	{ .Fn = "Com_TimerTick",					.Input = "cascade",	.Setup = prv_SetupWheel,	.Run = prv_RunWheel,		.Teardown = NULL_PTR,				.Arg = BENCH_WHEEL_CASCADE },
+	{ .Fn = "Com_TimerTick",					.Input = "expire",		.Setup = prv_SetupWheel,	.Run = prv_RunWheel,		.Teardown = NULL_PTR,				.Arg = BENCH_WHEEL_EXPIRE },
+	{ .Fn = "Com_CodecUnpack",					.Input = "intel16",		.Setup = prv_SetupCodec,	.Run = prv_RunUnpack,		.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_INTEL16 },
+	{ .Fn = "Com_CodecUnpack",					.Input = "intel12s",	.Setup = prv_SetupCodec,	.Run = prv_RunUnpack,		.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_INTEL12S },
+	{ .Fn = "Com_CodecUnpack",					.Input = "motorola12s",	.Setup = prv_SetupCodec,	.Run = prv_RunUnpack,		.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_MOTOROLA12S },
+	{ .Fn = "Com_CodecUnpack",					.Input = "motorola32",	.Setup = prv_SetupCodec,	.Run = prv_RunUnpack,		.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_MOTOROLA32 },
+	{ .Fn = "Com_CodecPack",					.Input = "intel12s",	.Setup = prv_SetupCodec,	.Run = prv_RunPack,			.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_INTEL12S },
+	{ .Fn = "Com_CodecPack",					.Input = "motorola12s",	.Setup = prv_SetupCodec,	.Run = prv_RunPack,			.Teardown = NULL_PTR,				.Arg = BENCH_CODEC_MOTOROLA12S },
+	{ .Fn = "Com_RxIndication",					.Input = "sensor",		.Setup = prv_SetupComRx,	.Run = prv_RunComRx,		.Teardown = NULL_PTR,				.Arg = BENCH_COMRX_FRESH },
+	{ .Fn = "Com_RxIndication",					.Input = "replayed",	.Setup = prv_SetupComRx,	.Run = prv_RunComRx,		.Teardown = NULL_PTR,				.Arg = BENCH_COMRX_REPLAYED },
+	{ .Fn = "E2E_Protect",						.Input = "crc8",		.Setup = prv_SetupE2E,		.Run = prv_RunProtect,		.Teardown = NULL_PTR,				.Arg = BENCH_E2E_CRC8 },
+	{ .Fn = "E2E_Protect",						.Input = "crc16",		.Setup = prv_SetupE2E,		.Run = prv_RunProtect,		.Teardown = NULL_PTR,				.Arg = BENCH_E2E_CRC16 },
+	{ .Fn = "E2E_Check",						.Input = "crc8",		.Setup = prv_SetupE2E,		.Run = prv_RunCheck,		.Teardown = NULL_PTR,				.Arg = BENCH_E2E_CRC8 },
+	{ .Fn = "E2E_Check",						.Input = "crc16",		.Setup = prv_SetupE2E,		.Run = prv_RunCheck,		.Teardown = NULL_PTR,				.Arg = BENCH_E2E_CRC16 },
+	{ .Fn = "Crc_CalculateCRC8",				.Input = "64B",			.Setup = prv_SetupCrc,		.Run = prv_RunCrc8,			.Teardown = NULL_PTR,				.Arg = 0u },
+	{ .Fn = "Crc_CalculateCRC16",				.Input = "64B",			.Setup = prv_SetupCrc,		.Run = prv_RunCrc16,		.Teardown = NULL_PTR,				.Arg = 0u },
+	{ .Fn = "PduR_ComTransmit",					.Input = "routed",		.Setup = prv_SetupCan,		.Run = prv_RunPduR,			.Teardown = prv_TeardownCan,		.Arg = PDUR_APP_TX_PDU_STOP_MOTOR },
+	{ .Fn = "Can_RxIndication",					.Input = "hit4",		.Setup = prv_SetupCanIfRx,	.Run = prv_RunCanIfHit,		.Teardown = prv_TeardownCanIfRx,	.Arg = 4u },
+	{ .Fn = "Can_RxIndication",					.Input = "hit32",		.Setup = prv_SetupCanIfRx,	.Run = prv_RunCanIfHit,		.Teardown = prv_TeardownCanIfRx,	.Arg = 32u },
+	{ .Fn = "Can_RxIndication",					.Input = "hit512",		.Setup = prv_SetupCanIfRx,	.Run = prv_RunCanIfHit,		.Teardown = prv_TeardownCanIfRx,	.Arg = 512u },
+	{ .Fn = "Can_RxIndication",					.Input = "mask32",		.Setup = prv_SetupCanIfRx,	.Run = prv_RunCanIfMask,	.Teardown = prv_TeardownCanIfRx,	.Arg = 32u },
+	{ .Fn = "Can_RxIndication",					.Input = "miss32",		.Setup = prv_SetupCanIfRx,	.Run = prv_RunCanIfMiss,	.Teardown = prv_TeardownCanIfRx,	.Arg = 32u },
+#if (LOGGER_CFG_ENABLE == 1)
+	{ .Fn = "Logger_Logf",						.Input = "text",		.Setup = prv_SetupLogger,	.Run = prv_RunLogger,		.Teardown = prv_TeardownLogger,		.Arg = BENCH_LOG_TEXT },
+	{ .Fn = "Logger_Logf",						.Input = "fmt3",		.Setup = prv_SetupLogger,	.Run = prv_RunLogger,		.Teardown = prv_TeardownLogger,		.Arg = BENCH_LOG_FMT3 },
+	{ .Fn = "Logger_Logf",						.Input = "filtered",	.Setup = prv_SetupLogger,	.Run = prv_RunLogger,		.Teardown = prv_TeardownLogger,		.Arg = BENCH_LOG_FILTERED },
+#endif
+	{ .Fn = "Uart_IrqHandler",					.Input = "idle",		.Setup = prv_SetupUartIdle,	.Run = prv_RunUartIrq,		.Teardown = prv_TeardownUartIdle,	.Arg = 0u },
+	{ .Fn = "Uart_IrqHandler",					.Input = "txe",			.Setup = prv_SetupUartTxe,	.Run = prv_RunUartIrq,		.Teardown = NULL_PTR,				.Arg = 0u },
+	{ .Fn = "Uart_IrqHandler",					.Input = "rxne",		.Setup = prv_SetupUartRx,	.Run = prv_RunUartIrq,		.Teardown = prv_TeardownUartRx,		.Arg = 0u },
+	{ .Fn = "TIM2_IRQHandler",					.Input = "arm",			.Setup = prv_SetupTim,		.Run = prv_RunTim,			.Teardown = prv_TeardownTim,		.Arg = BENCH_TIM_ARM },
+	{ .Fn = "TIM2_IRQHandler",					.Input = "rise",		.Setup = prv_SetupTim,		.Run = prv_RunTim,			.Teardown = prv_TeardownTim,		.Arg = BENCH_TIM_RISE },
+	{ .Fn = "TIM2_IRQHandler",					.Input = "fall",		.Setup = prv_SetupTim,		.Run = prv_RunTim,			.Teardown = prv_TeardownTim,		.Arg = BENCH_TIM_FALL },
+	{ .Fn = "TIM2_IRQHandler",					.Input = "timeout",		.Setup = prv_SetupTim,		.Run = prv_RunTim,			.Teardown = prv_TeardownTim,		.Arg = BENCH_TIM_TIMEOUT },
+};
+
+const Bench_ConfigType Bench_Config = {
+	.Name		= "Sensor_ECU",
+	.Cases		= Bench_Cases,
+	.CaseCount	= (uint16)(sizeof(Bench_Cases) / sizeof(Bench_CaseType)),
+	.Prepare	= Bench_Prepare,
+};
+#endif
@@ -0,0 +1,301 @@
+/* =====================================================================================================================
+ *  File        : CanNm.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : CAN network management: NM PDU transmission / reception, NM timeout, ready sleep, bus sleep
+ *  Notes       : Times are counted in CanNm_MainFunction calls like in CanSM. CanNm_RxIndication and
+ * 				  CanNm_TxConfirmation run in the tasks of Can_MainFunction_Rx / _Tx, all share the main loop,
+ * 				  no locking.
+ *  Depends     : CanNm.h, CanNm_Cfg.h, CanIf.h, EcuM.h, Det.h
+ * ===================================================================================================================*/
+
+#include "CanNm.h"
+#include "CanNm_Cfg.h"
+#include "CanIf.h"
+#include "EcuM.h"
+#include <string.h>
+
+#define CANNM_TICKS(_ms)					((uint16)(((_ms) + CANNM_CFG_MAINFUNCTION_PERIOD_MS - 1u) / CANNM_CFG_MAINFUNCTION_PERIOD_MS))
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static boolean				s_init			= FALSE;
+static uint16				s_nmTimer		= 0u;	// network mode: calls left until the NM timeout
+static uint16				s_stateTimer	= 0u;	// REPEAT_MESSAGE / PREPARE_BUS_SLEEP: calls left in the state
+static uint16				s_msgTimer		= 0u;	// calls left until the next NM PDU, 0: not sending
+static uint8				s_cbv			= 0u;	// control bit vector of the own NM PDU
+static CanNm_StatusType		s_status;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static uint16 prv_Ticks(uint16 Ticks)
+{
+	return (Ticks == 0u) ? 1u : Ticks;
+}
+
+static boolean prv_NetworkMode(void)
+{
+	return ((s_status.State == CANNM_STATE_REPEAT_MESSAGE) || (s_status.State == CANNM_STATE_NORMAL_OPERATION) ||
+			(s_status.State == CANNM_STATE_READY_SLEEP)) ? TRUE : FALSE;
+}
+
+// Own NM PDU: node, CBV, the partial networks this ECU needs, unused bytes recessive
+static void prv_Transmit(void)
+{
+	uint8 sdu[CANNM_CFG_PDU_LENGTH];
+	PduInfoType pdu;
+
+	memset(sdu, 0xFF, sizeof(sdu));
+	sdu[CANNM_PDU_NID_POS]			= CANNM_CFG_NODE_ID;
+	sdu[CANNM_PDU_CBV_POS]			= s_cbv | CANNM_CBV_PNI;
+	sdu[CANNM_CFG_PN_INFO_OFFSET]	= CANNM_CFG_PN_FILTER_MASK;
+
+	pdu.SduDataPtr	= sdu;
+	pdu.MetaDataPtr	= NULL_PTR;
+	pdu.SduLength	= CANNM_CFG_PDU_LENGTH;
+
+	// mailbox busy: next call, not a whole cycle later
+	s_msgTimer = (CanIf_Transmit(CANIF_TX_PDU_NM, &pdu) == E_OK) ? prv_Ticks(CANNM_TICKS(CANNM_CFG_MSG_CYCLE_MS)) : 1u;
+}
+
+static void prv_EnterRepeatMessage(void)
+{
+	s_status.State	= CANNM_STATE_REPEAT_MESSAGE;
+	s_stateTimer	= prv_Ticks(CANNM_TICKS(CANNM_CFG_REPEAT_MESSAGE_MS));
+}
+
+// Bus sleep / prepare bus sleep -> network mode
+static void prv_Join(CanNm_StartReasonType Reason, uint8 Node)
+{
+	(void)CanIf_SetPduMode(0u, CANIF_ONLINE);
+
+	s_status.StartReason	= Reason;
+	s_status.StartNode		= Node;
+	s_nmTimer				= prv_Ticks(CANNM_TICKS(CANNM_CFG_TIMEOUT_MS));
+	prv_EnterRepeatMessage();
+
+	if(Reason == CANNM_REASON_LOCAL)
+	{
+		s_cbv = CANNM_CBV_ACTIVE_WAKEUP;
+		prv_Transmit();
+	} else {
+		s_cbv		= 0u;
+		s_msgTimer	= prv_Ticks(CANNM_TICKS(CANNM_CFG_MSG_CYCLE_OFFSET_MS));
+	}
+}
+
+static void prv_EnterReadySleep(void)
+{
+	s_status.State	= CANNM_STATE_READY_SLEEP;
+	s_msgTimer		= 0u;
+}
+
+static void prv_EnterPrepareBusSleep(void)
+{
+	(void)CanIf_SetPduMode(0u, CANIF_TX_OFFLINE);
+
+	s_status.State	= CANNM_STATE_PREPARE_BUS_SLEEP;
+	s_stateTimer	= prv_Ticks(CANNM_TICKS(CANNM_CFG_WAIT_BUS_SLEEP_MS));
+	s_msgTimer		= 0u;
+	s_nmTimer		= 0u;
+	s_cbv			= 0u;
+}
+
+static void prv_NmTimeout(void)
+{
+	if(s_status.State == CANNM_STATE_READY_SLEEP)
+	{
+		prv_EnterPrepareBusSleep();
+		return;
+	}
+
+	// requested but nobody heard, not even our own confirmation (bus-off, no partner): keep trying
+	if(s_status.Timeouts < 0xFFFFu) s_status.Timeouts++;
+	CANNM_DET_REPORT(CANNM_API_ID_MAINFUNCTION, CANNM_E_NETWORK_TIMEOUT);
+	s_nmTimer = prv_Ticks(CANNM_TICKS(CANNM_CFG_TIMEOUT_MS));
+}
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void CanNm_Init(void)
+{
+	memset(&s_status, 0, sizeof(s_status));
+	s_status.State	= CANNM_STATE_BUS_SLEEP;
+	s_nmTimer		= 0u;
+	s_stateTimer	= 0u;
+	s_msgTimer		= 0u;
+	s_cbv			= 0u;
+	s_init			= TRUE;
+}
+
+Std_ReturnType CanNm_NetworkRequest(void)
+{
+	if(s_init == FALSE)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_NETWORKREQUEST, CANNM_E_UNINIT);
+		return E_NOT_OK;
+	}
+
+	s_status.Requested = TRUE;
+
+	switch(s_status.State)
+	{
+	case CANNM_STATE_BUS_SLEEP:
+	case CANNM_STATE_PREPARE_BUS_SLEEP:
+		prv_Join(CANNM_REASON_LOCAL, CANNM_CFG_NODE_ID);
+		break;
+
+	case CANNM_STATE_READY_SLEEP:
+		s_status.State	= CANNM_STATE_NORMAL_OPERATION;
+		s_msgTimer		= 1u;
+		break;
+
+	default:
+		break;
+	}
+	return E_OK;
+}
+
+Std_ReturnType CanNm_NetworkRelease(void)
+{
+	if(s_init == FALSE)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_NETWORKRELEASE, CANNM_E_UNINIT);
+		return E_NOT_OK;
+	}
+
+	s_status.Requested = FALSE;
+
+	// REPEAT_MESSAGE ends in READY_SLEEP by itself now
+	if(s_status.State == CANNM_STATE_NORMAL_OPERATION) prv_EnterReadySleep();
+	return E_OK;
+}
+
+Std_ReturnType CanNm_StartUp(void)
+{
+	if(s_init == FALSE)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_STARTUP, CANNM_E_UNINIT);
+		return E_NOT_OK;
+	}
+	if(prv_NetworkMode() == TRUE) return E_NOT_OK;
+
+	// listen only: nobody was asked to wake up, so no repeat message phase and no NM PDU of our own
+	(void)CanIf_SetPduMode(0u, CANIF_ONLINE);
+
+	s_status.StartReason	= CANNM_REASON_STARTUP;
+	s_status.StartNode		= CANNM_CFG_NODE_ID;
+	s_nmTimer				= prv_Ticks(CANNM_TICKS(CANNM_CFG_TIMEOUT_MS));
+	s_cbv					= 0u;
+	prv_EnterReadySleep();
+	return E_OK;
+}
+
+Std_ReturnType CanNm_GetStatus(CanNm_StatusType* StatusPtr)
+{
+	if(StatusPtr == NULL_PTR)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_GETSTATUS, CANNM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+
+	*StatusPtr = s_status;
+	return E_OK;
+}
+
+void CanNm_MainFunction(void)
+{
+	if((s_init == FALSE) || (s_status.State == CANNM_STATE_BUS_SLEEP)) return;
+
+	if(s_status.State == CANNM_STATE_PREPARE_BUS_SLEEP)
+	{
+		if(--s_stateTimer != 0u) return;
+
+		s_status.State = CANNM_STATE_BUS_SLEEP;
+		(void)EcuM_GoToSleep();
+		return;
+	}
+
+	if(--s_nmTimer == 0u)
+	{
+		prv_NmTimeout();
+		if(prv_NetworkMode() == FALSE) return;
+	}
+
+	if((s_status.State == CANNM_STATE_REPEAT_MESSAGE) && (--s_stateTimer == 0u))
+	{
+		if(s_status.Requested == TRUE)	s_status.State = CANNM_STATE_NORMAL_OPERATION;
+		else							prv_EnterReadySleep();
+	}
+
+	if((s_msgTimer != 0u) && (--s_msgTimer == 0u)) prv_Transmit();
+}
+
+void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr)
+{
+	uint8 cbv;
+
+	if(s_init == FALSE)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_RXINDICATION, CANNM_E_UNINIT);
+		return;
+	}
+	if(RxPduId != CANIF_RX_PDU_NM)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_RXINDICATION, CANNM_E_INVALID_PDUID);
+		return;
+	}
+	if((PduInfoPtr == NULL_PTR) || (PduInfoPtr->SduDataPtr == NULL_PTR))
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_RXINDICATION, CANNM_E_PARAM_POINTER);
+		return;
+	}
+	if(PduInfoPtr->SduLength <= CANNM_CFG_PN_INFO_OFFSET) return;
+
+	// partial network of other ECUs only: not for us, neither keeps us awake nor wakes us
+	cbv = PduInfoPtr->SduDataPtr[CANNM_PDU_CBV_POS];
+	if(((cbv & CANNM_CBV_PNI) != 0u) &&
+	   ((PduInfoPtr->SduDataPtr[CANNM_CFG_PN_INFO_OFFSET] & CANNM_CFG_PN_FILTER_MASK) == 0u))
+	{
+		if(s_status.PnFiltered < 0xFFFFu) s_status.PnFiltered++;
+		return;
+	}
+
+	s_status.LastRxNode = PduInfoPtr->SduDataPtr[CANNM_PDU_NID_POS];
+
+	if(prv_NetworkMode() == FALSE)
+	{
+		// passive start, and the reason a CAN wake-up was for this ECU
+		EcuM_ValidateWakeupEvent(ECU_WAKEUP_CAN_BUS);
+		prv_Join(CANNM_REASON_REMOTE, s_status.LastRxNode);
+		return;
+	}
+
+	s_nmTimer = prv_Ticks(CANNM_TICKS(CANNM_CFG_TIMEOUT_MS));
+
+	if(((cbv & CANNM_CBV_REPEAT_MESSAGE) != 0u) && (s_status.State != CANNM_STATE_REPEAT_MESSAGE))
+	{
+		prv_EnterRepeatMessage();
+		if(s_msgTimer == 0u) s_msgTimer = prv_Ticks(CANNM_TICKS(CANNM_CFG_MSG_CYCLE_OFFSET_MS));
+	}
+}
+
+void CanNm_TxConfirmation(PduIdType TxPduId)
+{
+	if(s_init == FALSE)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_TXCONFIRMATION, CANNM_E_UNINIT);
+		return;
+	}
+	if(TxPduId != CANIF_TX_PDU_NM)
+	{
+		CANNM_DET_REPORT(CANNM_API_ID_TXCONFIRMATION, CANNM_E_INVALID_PDUID);
+		return;
+	}
+
+	// our own PDU made it onto the bus: the network is up even without partners
+	if(prv_NetworkMode() == TRUE) s_nmTimer = prv_Ticks(CANNM_TICKS(CANNM_CFG_TIMEOUT_MS));
+}
@@ -0,0 +1,152 @@
+/* =====================================================================================================================
+ *  File        : CanNm.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : CAN network management: decides with the other nodes when the bus may sleep
+ * 					- CanNm_NetworkRequest joins the network (REPEAT_MESSAGE, NM PDU every CANNM_CFG_MSG_CYCLE_MS),
+ * 					  CanNm_NetworkRelease lets it go (READY_SLEEP, no more NM PDUs)
+ * 					- CanNm_StartUp at power-on: network mode without a request (READY_SLEEP, NM timeout running),
+ * 					  so a silent bus nobody requests ends in bus sleep
+ * 					- a relevant NM PDU of another node keeps the network up, in BUS_SLEEP it is a passive start
+ * 					  and validates a CAN wake-up with EcuM
+ * 					- no NM PDU for CANNM_CFG_TIMEOUT_MS in READY_SLEEP: PREPARE_BUS_SLEEP (CanIf TX offline),
+ * 					  CANNM_CFG_WAIT_BUS_SLEEP_MS later BUS_SLEEP and EcuM_GoToSleep
+ * 					- partial networking: an NM PDU with the PNI bit only counts when it requests one of
+ * 					  CANNM_CFG_PN_FILTER_MASK
+ *  Depends     : Std_Types.h, ComStack_Types.h, CanNm_Cfg.h, Det.h
+ * ===================================================================================================================*/
+
+#ifndef CANNM_CANNM_H_
+#define CANNM_CANNM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "CanNm_Cfg.h"
+#include "Det.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define CANNM_VENDOR_ID						(0x00u)
+#define CANNM_MODULE_ID						(0x1Fu)
+#define CANNM_INSTANCE_ID					(0x00u)
+
+#define CANNM_SW_MAJOR_VERSION				(1u)
+#define CANNM_SW_MINOR_VERSION				(0u)
+#define CANNM_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       BUILD-TIME SWITCHES
+ * ============================== */
+#ifndef CANNM_DEV_ERROR_DETECT
+#define CANNM_DEV_ERROR_DETECT				STD_ON
+#endif
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define CANNM_API_ID_INIT					(0x00u)
+#define CANNM_API_ID_NETWORKREQUEST			(0x02u)
+#define CANNM_API_ID_NETWORKRELEASE			(0x03u)
+#define CANNM_API_ID_STARTUP				(0x01u)
+#define CANNM_API_ID_GETSTATUS				(0x0Bu)
+#define CANNM_API_ID_MAINFUNCTION			(0x13u)
+#define CANNM_API_ID_TXCONFIRMATION			(0x40u)
+#define CANNM_API_ID_RXINDICATION			(0x42u)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define CANNM_E_UNINIT						(0x01u)
+#define CANNM_E_INVALID_PDUID				(0x03u)
+#define CANNM_E_NETWORK_TIMEOUT				(0x11u)		// network mode, no NM PDU for CANNM_CFG_TIMEOUT_MS
+#define CANNM_E_PARAM_POINTER				(0x12u)
+
+#if (CANNM_DEV_ERROR_DETECT == STD_ON)
+#define CANNM_DET_REPORT(_api, _err)\
+	Det_ReportError(CANNM_MODULE_ID, CANNM_INSTANCE_ID, (_api), (_err))
+#else
+#define CANNM_DET_REPORT(_api, _err) ((void)0)
+#endif
+
+/* ==============================
+ *       NM PDU
+ * ============================== */
+#define CANNM_PDU_NID_POS					(0u)
+#define CANNM_PDU_CBV_POS					(1u)
+
+#define CANNM_CBV_REPEAT_MESSAGE			(0x01u)		// sender asks every node into REPEAT_MESSAGE
+#define CANNM_CBV_ACTIVE_WAKEUP				(0x10u)		// sender woke the network itself
+#define CANNM_CBV_PNI						(0x40u)		// partial network request bits are valid
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+typedef enum
+{
+	CANNM_STATE_BUS_SLEEP			= 0,	// controller asleep or stopped, no NM PDU
+	CANNM_STATE_PREPARE_BUS_SLEEP,			// network released everywhere, transmitters quiet
+	CANNM_STATE_REPEAT_MESSAGE,				// joined: NM PDUs, for CANNM_CFG_REPEAT_MESSAGE_MS
+	CANNM_STATE_NORMAL_OPERATION,			// requested: NM PDUs
+	CANNM_STATE_READY_SLEEP					// released here, other nodes still keep the network up
+} CanNm_StateType;
+
+typedef enum
+{
+	CANNM_REASON_NONE				= 0,
+	CANNM_REASON_LOCAL,						// CanNm_NetworkRequest
+	CANNM_REASON_REMOTE,					// NM PDU of StartNode
+	CANNM_REASON_STARTUP					// CanNm_StartUp
+} CanNm_StartReasonType;
+
+typedef struct
+{
+	CanNm_StateType			State;
+	boolean					Requested;		// CanNm_NetworkRequest without a release since
+	CanNm_StartReasonType	StartReason;	// of the last change from bus sleep to network mode
+	uint8					StartNode;		// remote start: source node of that NM PDU
+	uint8					LastRxNode;
+	uint16					PnFiltered;		// NM PDUs for partial networks of other ECUs only
+	uint16					Timeouts;		// CANNM_E_NETWORK_TIMEOUT
+} CanNm_StatusType;
+
+/* ==============================
+ *             API
+ * ============================== */
+// State BUS_SLEEP, CanIf PDU mode untouched
+void CanNm_Init(void);
+
+/**
+ * @brief  Keep the network awake: from bus sleep the first NM PDU goes out right away (active wake-up bit set)
+ * @return E_NOT_OK: not initialised
+ */
+Std_ReturnType CanNm_NetworkRequest(void);
+
+// Release the network, this node stops sending NM PDUs. E_NOT_OK: not initialised
+Std_ReturnType CanNm_NetworkRelease(void);
+
+/**
+ * @brief  Power-on with the controller on the bus: CanIf online, READY_SLEEP without NM PDUs. NM PDUs of other
+ *         nodes or a network request keep the network up, otherwise the NM timeout leads to bus sleep
+ * @return E_NOT_OK: not initialised or already in network mode
+ */
+Std_ReturnType CanNm_StartUp(void);
+
+Std_ReturnType CanNm_GetStatus(CanNm_StatusType* StatusPtr);
+
+// Timers, NM PDU transmission. Period CANNM_CFG_MAINFUNCTION_PERIOD_MS
+void CanNm_MainFunction(void);
+
+// CanIf callbacks for the NM PDUs (CANIF_UL_CANNM)
+void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr);
+void CanNm_TxConfirmation(PduIdType TxPduId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANNM_CANNM_H_ */
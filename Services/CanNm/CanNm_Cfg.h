@@ -0,0 +1,82 @@
+/* =====================================================================================================================
+ *  File        : CanNm_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of CAN network management (node, timing, NM PDU layout, partial network)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef CANNM_CANNM_CFG_H_
+#define CANNM_CANNM_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Source node of this ECU, byte 0 of its NM PDU (CAN ID 0x500 + node, see CanIf_PBcfg.c) */
+#ifndef CANNM_CFG_NODE_ID
+#define CANNM_CFG_NODE_ID					(0x21u)
+#endif
+
+/* Call period of CanNm_MainFunction, the times below are rounded up to it */
+#ifndef CANNM_CFG_MAINFUNCTION_PERIOD_MS
+#define CANNM_CFG_MAINFUNCTION_PERIOD_MS	(10u)
+#endif
+
+/* NM PDU period while this ECU keeps the network awake */
+#ifndef CANNM_CFG_MSG_CYCLE_MS
+#define CANNM_CFG_MSG_CYCLE_MS				(100u)
+#endif
+
+/* Delay of the first NM PDU after a passive start (a remote node woke the network). Spread per node so the
+ * nodes woken by the same frame do not all answer in the same bit time */
+#ifndef CANNM_CFG_MSG_CYCLE_OFFSET_MS
+#define CANNM_CFG_MSG_CYCLE_OFFSET_MS		(20u)
+#endif
+
+/* No NM PDU on the bus (received or sent) for this long: the network is released by everybody */
+#ifndef CANNM_CFG_TIMEOUT_MS
+#define CANNM_CFG_TIMEOUT_MS				(500u)
+#endif
+
+/* Time in REPEAT_MESSAGE after joining, long enough for every node to see this one */
+#ifndef CANNM_CFG_REPEAT_MESSAGE_MS
+#define CANNM_CFG_REPEAT_MESSAGE_MS			(300u)
+#endif
+
+/* PREPARE_BUS_SLEEP: transmitters are quiet, pending frames drain before the controller goes to sleep */
+#ifndef CANNM_CFG_WAIT_BUS_SLEEP_MS
+#define CANNM_CFG_WAIT_BUS_SLEEP_MS			(200u)
+#endif
+
+/* NM PDU: byte 0 source node, byte 1 control bit vector, partial network request bits from PN_INFO_OFFSET on */
+#define CANNM_CFG_PDU_LENGTH				(8u)
+
+#ifndef CANNM_CFG_PN_INFO_OFFSET
+#define CANNM_CFG_PN_INFO_OFFSET			(2u)
+#endif
+
+/* Partial networks this ECU belongs to: PN 0, the distance sensing cluster */
+#ifndef CANNM_CFG_PN_FILTER_MASK
+#define CANNM_CFG_PN_FILTER_MASK			(0x01u)
+#endif
+
+#if (CANNM_CFG_MAINFUNCTION_PERIOD_MS == 0u)
+#error "CANNM_CFG_MAINFUNCTION_PERIOD_MS must not be 0"
+#endif
+
+#if (CANNM_CFG_TIMEOUT_MS <= CANNM_CFG_MSG_CYCLE_MS)
+#error "CANNM_CFG_TIMEOUT_MS must be longer than CANNM_CFG_MSG_CYCLE_MS"
+#endif
+
+#if (CANNM_CFG_PN_INFO_OFFSET < 2u) || (CANNM_CFG_PN_INFO_OFFSET >= CANNM_CFG_PDU_LENGTH)
+#error "CANNM_CFG_PN_INFO_OFFSET must point behind the control bit vector, inside the NM PDU"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANNM_CANNM_CFG_H_ */
@@ -0,0 +1,177 @@
+/* =====================================================================================================================
+ *  File        : CanSM.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : CAN state manager: controller mode requests, bus-off recovery with quick / slow back-off
+ *  Notes       : Times are counted in CanSM_MainFunction calls, a wait of t ms ends in the call that completes
+ * 				  ceil(t / period) periods after it was armed. CanSM_ControllerBusOff runs in the task of
+ * 				  Can_MainFunction_BusOff, both share the main loop, no locking.
+ *  Depends     : CanSM.h, CanSM_Cfg.h, Can.h, Det.h
+ * ===================================================================================================================*/
+
+#include "CanSM.h"
+#include "CanSM_Cfg.h"
+#include "Can.h"
+
+#define CANSM_TICKS(_ms)					((uint16)(((_ms) + CANSM_CFG_MAINFUNCTION_PERIOD_MS - 1u) / CANSM_CFG_MAINFUNCTION_PERIOD_MS))
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static boolean				s_init		= FALSE;
+static boolean				s_wantFull	= FALSE;	// FULL requested, a refused start is retried
+static uint16				s_timer		= 0u;		// main function calls left, 0: not running
+static CanSM_StatusType		s_status;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static void prv_Arm(uint16 Ticks)
+{
+	s_timer = (Ticks == 0u) ? 1u : Ticks;
+}
+
+static Std_ReturnType prv_SetMode(Can_ControllerStateType Mode)
+{
+	if(Can_SetControllerMode(CANSM_CFG_CONTROLLER, Mode) == E_OK) return E_OK;
+
+	if(s_status.ModeFailures < 0xFFFFu) s_status.ModeFailures++;
+	return E_NOT_OK;
+}
+
+// Start the controller; refused: NOCOM, retried after the slow back-off
+static Std_ReturnType prv_Start(CanSM_BsmStateType Next, uint16 Ticks)
+{
+	if(prv_SetMode(CAN_CS_STARTED) != E_OK)
+	{
+		prv_Arm(CANSM_TICKS(CANSM_CFG_BOR_TIME_L2_MS));
+		return E_NOT_OK;
+	}
+
+	s_status.State = Next;
+	s_timer = 0u;
+	if(Ticks != 0u) prv_Arm(Ticks);
+	return E_OK;
+}
+
+static void prv_Expired(void)
+{
+	switch(s_status.State)
+	{
+	case CANSM_BSM_BUSOFF_WAIT:
+		if(prv_Start(CANSM_BSM_BUSOFF_CHECK, CANSM_TICKS(CANSM_CFG_BOR_TIME_TX_ENSURED_MS)) == E_OK)
+		{
+			if(s_status.Restarts < 0xFFFFu) s_status.Restarts++;
+		}
+		break;
+
+	case CANSM_BSM_BUSOFF_CHECK:
+		// no bus-off since the restart: the fault is gone, the next one starts with quick retries again
+		s_status.State			= CANSM_BSM_FULLCOM;
+		s_status.BusOffStreak	= 0u;
+		break;
+
+	case CANSM_BSM_NOCOM:
+		if(s_wantFull == TRUE) (void)prv_Start(CANSM_BSM_FULLCOM, 0u);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void CanSM_Init(void)
+{
+	s_status.State			= CANSM_BSM_NOCOM;
+	s_status.BusOffStreak	= 0u;
+	s_status.Restarts		= 0u;
+	s_status.ModeFailures	= 0u;
+	s_wantFull				= FALSE;
+	s_timer					= 0u;
+	s_init					= TRUE;
+}
+
+Std_ReturnType CanSM_RequestComMode(CanSM_ComModeType ComMode)
+{
+	if(s_init == FALSE)
+	{
+		CANSM_DET_REPORT(CANSM_API_ID_REQUESTCOMMODE, CANSM_E_UNINIT);
+		return E_NOT_OK;
+	}
+
+	if(ComMode == CANSM_NO_COMMUNICATION)
+	{
+		s_wantFull = FALSE;
+		if(prv_SetMode(CAN_CS_STOPPED) != E_OK)
+		{
+			CANSM_DET_REPORT(CANSM_API_ID_REQUESTCOMMODE, CANSM_E_MODE_REQUEST_TIMEOUT);
+			return E_NOT_OK;
+		}
+		s_status.State			= CANSM_BSM_NOCOM;
+		s_status.BusOffStreak	= 0u;
+		s_timer					= 0u;
+		return E_OK;
+	}
+
+	s_wantFull = TRUE;
+
+	// a bus-off recovery in progress already leads back to FULLCOM
+	if(s_status.State != CANSM_BSM_NOCOM) return E_OK;
+
+	if(prv_Start(CANSM_BSM_FULLCOM, 0u) != E_OK)
+	{
+		CANSM_DET_REPORT(CANSM_API_ID_REQUESTCOMMODE, CANSM_E_MODE_REQUEST_TIMEOUT);
+		return E_NOT_OK;
+	}
+	return E_OK;
+}
+
+CanSM_ComModeType CanSM_GetCurrentComMode(void)
+{
+	if((s_status.State == CANSM_BSM_FULLCOM) || (s_status.State == CANSM_BSM_BUSOFF_CHECK)) return CANSM_FULL_COMMUNICATION;
+	return CANSM_NO_COMMUNICATION;
+}
+
+Std_ReturnType CanSM_GetStatus(CanSM_StatusType* StatusPtr)
+{
+	if(StatusPtr == NULL_PTR)
+	{
+		CANSM_DET_REPORT(CANSM_API_ID_GETCURRENTCOMMODE, CANSM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+
+	*StatusPtr = s_status;
+	return E_OK;
+}
+
+void CanSM_MainFunction(void)
+{
+	if(s_init == FALSE) return;
+
+	if((s_timer > 0u) && (--s_timer == 0u)) prv_Expired();
+}
+
+void CanSM_ControllerBusOff(uint8 ControllerId)
+{
+	if(s_init == FALSE)
+	{
+		CANSM_DET_REPORT(CANSM_API_ID_CONTROLLERBUSOFF, CANSM_E_UNINIT);
+		return;
+	}
+	if(ControllerId != CANSM_CFG_CONTROLLER)
+	{
+		CANSM_DET_REPORT(CANSM_API_ID_CONTROLLERBUSOFF, CANSM_E_PARAM_CONTROLLER);
+		return;
+	}
+
+	// stopped on request, or the last bus-off is still being waited out
+	if((s_status.State != CANSM_BSM_FULLCOM) && (s_status.State != CANSM_BSM_BUSOFF_CHECK)) return;
+
+	prv_Arm((s_status.BusOffStreak < CANSM_CFG_BOR_COUNTER_L1_TO_L2) ?
+			CANSM_TICKS(CANSM_CFG_BOR_TIME_L1_MS) : CANSM_TICKS(CANSM_CFG_BOR_TIME_L2_MS));
+	if(s_status.BusOffStreak < 0xFFu) s_status.BusOffStreak++;
+	s_status.State = CANSM_BSM_BUSOFF_WAIT;
+}
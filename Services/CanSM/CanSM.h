@@ -0,0 +1,122 @@
+/* =====================================================================================================================
+ *  File        : CanSM.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : CAN state manager: controller mode of the network and bus-off recovery
+ * 					- CanSM_RequestComMode starts / stops the controller, a refused start is retried every
+ * 					  CANSM_CFG_BOR_TIME_L2_MS
+ * 					- bus-off (Can -> CanIf -> CanSM_ControllerBusOff, controller already stopped): restart after
+ * 					  CANSM_CFG_BOR_TIME_L1_MS for the first CANSM_CFG_BOR_COUNTER_L1_TO_L2 bus-offs in a row, after
+ * 					  CANSM_CFG_BOR_TIME_L2_MS from then on
+ * 					- a restart that sees no bus-off for CANSM_CFG_BOR_TIME_TX_ENSURED_MS ends the streak
+ * 					- one network on controller CANSM_CFG_CONTROLLER
+ *  Depends     : Std_Types.h, CanSM_Cfg.h, Det.h
+ * ===================================================================================================================*/
+
+#ifndef CANSM_CANSM_H_
+#define CANSM_CANSM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "CanSM_Cfg.h"
+#include "Det.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define CANSM_VENDOR_ID						(0x00u)
+#define CANSM_MODULE_ID						(0x8Cu)
+#define CANSM_INSTANCE_ID					(0x00u)
+
+#define CANSM_SW_MAJOR_VERSION				(1u)
+#define CANSM_SW_MINOR_VERSION				(0u)
+#define CANSM_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       BUILD-TIME SWITCHES
+ * ============================== */
+#ifndef CANSM_DEV_ERROR_DETECT
+#define CANSM_DEV_ERROR_DETECT				STD_ON
+#endif
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define CANSM_API_ID_INIT					(0x00u)
+#define CANSM_API_ID_REQUESTCOMMODE			(0x02u)
+#define CANSM_API_ID_GETCURRENTCOMMODE		(0x03u)
+#define CANSM_API_ID_CONTROLLERBUSOFF		(0x04u)
+#define CANSM_API_ID_MAINFUNCTION			(0x05u)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define CANSM_E_UNINIT						(0x01u)
+#define CANSM_E_PARAM_POINTER				(0x02u)
+#define CANSM_E_PARAM_CONTROLLER			(0x04u)
+#define CANSM_E_MODE_REQUEST_TIMEOUT		(0x0Au)		// the driver did not reach the requested mode
+
+#if (CANSM_DEV_ERROR_DETECT == STD_ON)
+#define CANSM_DET_REPORT(_api, _err)\
+	Det_ReportError(CANSM_MODULE_ID, CANSM_INSTANCE_ID, (_api), (_err))
+#else
+#define CANSM_DET_REPORT(_api, _err) ((void)0)
+#endif
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+typedef enum
+{
+	CANSM_NO_COMMUNICATION		= 0,
+	CANSM_FULL_COMMUNICATION
+} CanSM_ComModeType;
+
+// Network state
+typedef enum
+{
+	CANSM_BSM_NOCOM				= 0,	// stopped: not requested, or the start was refused (retried)
+	CANSM_BSM_FULLCOM,					// started, no bus-off streak
+	CANSM_BSM_BUSOFF_WAIT,				// bus-off, controller stopped until the back-off time is over
+	CANSM_BSM_BUSOFF_CHECK				// restarted, FULLCOM once no bus-off for CANSM_CFG_BOR_TIME_TX_ENSURED_MS
+} CanSM_BsmStateType;
+
+typedef struct
+{
+	CanSM_BsmStateType	State;
+	uint8				BusOffStreak;		// bus-offs since the last FULLCOM, >= CANSM_CFG_BOR_COUNTER_L1_TO_L2: slow
+	uint16				Restarts;			// restarts after a bus-off
+	uint16				ModeFailures;		// mode changes the driver did not acknowledge
+} CanSM_StatusType;
+
+/* ==============================
+ *             API
+ * ============================== */
+// State NOCOM, the controller is left as Can_Init put it (stopped)
+void CanSM_Init(void);
+
+/**
+ * @brief  FULL: start the controller (refused: retried in CanSM_MainFunction), NO: stop it
+ * @return E_NOT_OK: not initialised or the driver did not reach the mode (Det CANSM_E_MODE_REQUEST_TIMEOUT)
+ */
+Std_ReturnType CanSM_RequestComMode(CanSM_ComModeType ComMode);
+
+// FULL while started or restarted after a bus-off, NO while stopped or waiting out a bus-off
+CanSM_ComModeType CanSM_GetCurrentComMode(void);
+
+Std_ReturnType CanSM_GetStatus(CanSM_StatusType* StatusPtr);
+
+// Back-off timers, restarts. Period CANSM_CFG_MAINFUNCTION_PERIOD_MS
+void CanSM_MainFunction(void);
+
+// CanIf callback: the controller went bus-off and the driver stopped it
+void CanSM_ControllerBusOff(uint8 ControllerId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANSM_CANSM_H_ */
@@ -0,0 +1,61 @@
+/* =====================================================================================================================
+ *  File        : CanSM_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of the CAN state manager (controller, main function period, bus-off back-off)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef CANSM_CANSM_CFG_H_
+#define CANSM_CANSM_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Controller of the one network CanSM manages */
+#ifndef CANSM_CFG_CONTROLLER
+#define CANSM_CFG_CONTROLLER				(0u)
+#endif
+
+/* Call period of CanSM_MainFunction, the times below are rounded up to it */
+#ifndef CANSM_CFG_MAINFUNCTION_PERIOD_MS
+#define CANSM_CFG_MAINFUNCTION_PERIOD_MS	(10u)
+#endif
+
+/* Quick retry: wait after each of the first COUNTER_L1_TO_L2 bus-offs before the restart.
+ * A short glitch (connector, EMC burst) costs one L1 wait */
+#ifndef CANSM_CFG_BOR_TIME_L1_MS
+#define CANSM_CFG_BOR_TIME_L1_MS			(20u)
+#endif
+
+/* Slow retry: wait after every further bus-off, also the retry period of a restart the controller refused.
+ * A lasting fault (bad transceiver, broken TX line) then costs the bus one burst of 32 error frames per L2 period */
+#ifndef CANSM_CFG_BOR_TIME_L2_MS
+#define CANSM_CFG_BOR_TIME_L2_MS			(200u)
+#endif
+
+#ifndef CANSM_CFG_BOR_COUNTER_L1_TO_L2
+#define CANSM_CFG_BOR_COUNTER_L1_TO_L2		(3u)
+#endif
+
+/* Time without a new bus-off after a restart before the network counts as recovered (back to quick retries) */
+#ifndef CANSM_CFG_BOR_TIME_TX_ENSURED_MS
+#define CANSM_CFG_BOR_TIME_TX_ENSURED_MS	(100u)
+#endif
+
+#if (CANSM_CFG_MAINFUNCTION_PERIOD_MS == 0u)
+#error "CANSM_CFG_MAINFUNCTION_PERIOD_MS must not be 0"
+#endif
+
+#if (CANSM_CFG_BOR_COUNTER_L1_TO_L2 > 254u)
+#error "CANSM_CFG_BOR_COUNTER_L1_TO_L2 must fit the uint8 bus-off streak"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANSM_CANSM_CFG_H_ */
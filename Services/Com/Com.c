@@ -7,17 +7,204 @@
  * ===================================================================================================================*/
 
 #include "Com.h"
+#include "Com_Timer.h"
+#include "Com_Codec.h"
 #include "PduR.h"
 #include <string.h>
 
+// Signal index of no signal (I-PDU without selector)
+#define COM_NO_SIGNAL				((uint8)0xFFu)
+
+// Per Tx I-PDU state, indexed by IpduId
+typedef struct
+{
+	Com_TxStatusType	Status;
+	uint8				RetriesLeft;
+	uint8				Selector;		// signal index, COM_NO_SIGNAL: not multiplexed
+	uint8				Layout;			// selector value in the buffer
+	uint8				Length;			// bytes of the current layout
+	uint16				Countdown;		// Com_MainFunctionTx calls to the next cycle, 0: not cyclic (yet)
+} Com_TxStateType;
+
 static const Com_ConfigType* Com_ConfigPtr = NULL_PTR;
 
-static uint8 Com_TxBuffer[8];
+// kept per I-PDU: a retry re-sends the same bytes
+static uint8 Com_TxBuffer[COM_CFG_MAX_TX_IPDU][COM_CODEC_FRAME_BYTES];
+
+static Com_TxStateType		Com_TxState[COM_CFG_MAX_TX_IPDU];
+
+// Placement of every signal in its frame, indexed like SignalConfig
+static Com_CodecType			Com_SignalCodec[COM_CFG_MAX_SIGNALS];
+
+// Selector signal index of each Rx I-PDU, COM_NO_SIGNAL: not multiplexed
+static uint8					Com_RxSelector[COM_CFG_MAX_RX_IPDU];
+
+// E2E sequence of the protected I-PDUs, indexed by IpduId
+static E2E_ProtectStateType		Com_TxE2E[COM_CFG_MAX_TX_IPDU];
+static E2E_CheckStateType		Com_RxE2E[COM_CFG_MAX_RX_IPDU];
+
+// Rx shadow values and their state, indexed like SignalConfig
+static uint32					Com_RxShadow[COM_CFG_MAX_SIGNALS];
+static uint8					Com_RxStatus[COM_CFG_MAX_SIGNALS];		// Com_RxSignalStatusType
+
+// Tx deadlines, timer id = I-PDU id
+static Com_TimerWheelType	Com_TxDeadline;
+
+// Reception deadlines, timer id = signal index
+static Com_TimerWheelType	Com_RxDeadline;
+
+static void prv_TxDeadlineExpired(Com_TimerIdType Id);
+static void prv_RxDeadlineExpired(Com_TimerIdType Id);
+
+static const Com_TxIpduConfigType* prv_TxCfg(Com_IpduIdType Ipduid)
+{
+	if((Com_ConfigPtr == NULL_PTR) || (Ipduid >= Com_ConfigPtr->NumTxIpdu)) return NULL_PTR;
+	return &Com_ConfigPtr->TxIpduConfig[Ipduid];
+}
+
+// Index of a signal in SignalConfig, NumSignals when unknown
+static uint16 prv_SignalIndex(Com_SignalIdType SignalId)
+{
+	uint16 i;
+
+	for(i = 0; i < Com_ConfigPtr->NumSignals; i++)
+	{
+		if(Com_ConfigPtr->SignalConfig[i].SignalId == SignalId) break;
+	}
+	return i;
+}
+
+static uint32 prv_MsToTicks(uint16 Ms, uint16 PeriodMs)
+{
+	return ((uint32)Ms + PeriodMs - 1u) / PeriodMs;
+}
+
+// Bytes a Tx I-PDU needs for Layout: the configured length, or for a dynamic one up to the last signal byte
+static uint8 prv_LayoutLength(const Com_ConfigType* Cfg, Com_IpduIdType Ipduid, uint8 Layout)
+{
+	const Com_TxIpduConfigType* txCfg = &Cfg->TxIpduConfig[Ipduid];
+	uint8 len = 0u;
+	uint16 i;
+
+	if(txCfg->LengthMode == COM_PDU_FIXED) return (uint8)txCfg->PduLength;
+	if(txCfg->E2E != NULL_PTR) len = E2E_HeaderLength(txCfg->E2E);
+
+	for(i = 0; i < Cfg->NumSignals; i++)
+	{
+		const Com_SignalConfigType* sigCfg = &Cfg->SignalConfig[i];
+
+		if((sigCfg->Direction != COM_SEND) || (sigCfg->Ipduid != Ipduid)) continue;
+		if((sigCfg->MuxValue < COM_MUX_SELECTOR) && (sigCfg->MuxValue != Layout)) continue;
+		if(Com_SignalCodec[i].MinLength > len) len = Com_SignalCodec[i].MinLength;
+	}
+	return len;
+}
+
+// Signal placement against its I-PDU, registers selectors. FALSE: config refused
+static boolean prv_CheckSignal(const Com_ConfigType* Cfg, uint16 Index)
+{
+	const Com_SignalConfigType* sigCfg = &Cfg->SignalConfig[Index];
+	uint16 pduLength;
+	uint8* selector;
+
+	if(Com_CodecInit(&Com_SignalCodec[Index], sigCfg) != E_OK) return FALSE;
+	if((sigCfg->UpdateBitPosition != COM_NO_UPDATE_BIT) && (sigCfg->UpdateBitPosition >= (COM_CODEC_FRAME_BYTES * 8u))) return FALSE;
+
+	if(sigCfg->Direction == COM_SEND)
+	{
+		if(sigCfg->Ipduid >= Cfg->NumTxIpdu) return FALSE;
+		pduLength	= Cfg->TxIpduConfig[sigCfg->Ipduid].PduLength;
+		selector	= &Com_TxState[sigCfg->Ipduid].Selector;
+	} else {
+		if(sigCfg->Ipduid >= Cfg->NumRxIpdu) return FALSE;
+		pduLength	= Cfg->RxIpduConfig[sigCfg->Ipduid].PduLength;
+		selector	= &Com_RxSelector[sigCfg->Ipduid];
+	}
+	if(Com_SignalCodec[Index].MinLength > pduLength) return FALSE;
+
+	if(sigCfg->MuxValue == COM_MUX_SELECTOR)
+	{
+		if(*selector != COM_NO_SIGNAL) return FALSE;
+		*selector = (uint8)Index;
+	}
+	return TRUE;
+}
+
+// Layout signals need a selector in their I-PDU
+static boolean prv_CheckLayout(const Com_ConfigType* Cfg, uint16 Index)
+{
+	const Com_SignalConfigType* sigCfg = &Cfg->SignalConfig[Index];
+	uint8 selector;
+
+	if(sigCfg->MuxValue >= COM_MUX_SELECTOR) return TRUE;
 
+	selector = (sigCfg->Direction == COM_SEND) ? Com_TxState[sigCfg->Ipduid].Selector : Com_RxSelector[sigCfg->Ipduid];
+	return (selector != COM_NO_SIGNAL) ? TRUE : FALSE;
+}
 
 // Initialize Com module
 void Com_Init(const Com_ConfigType* ConfigPtr)
 {
+	uint16 i;
+
+	Com_ConfigPtr = NULL_PTR;
+	if(ConfigPtr == NULL_PTR) return;
+	if((ConfigPtr->NumTxIpdu > COM_CFG_MAX_TX_IPDU) || (ConfigPtr->NumRxIpdu > COM_CFG_MAX_RX_IPDU) ||
+	   (ConfigPtr->NumSignals > COM_CFG_MAX_SIGNALS))
+	{
+		return;
+	}
+	for(i = 0; i < ConfigPtr->NumTxIpdu; i++)
+	{
+		const Com_TxIpduConfigType* txCfg = &ConfigPtr->TxIpduConfig[i];
+
+		if((txCfg->IpduId != i) || (txCfg->PduLength == 0u) || (txCfg->PduLength > COM_CODEC_FRAME_BYTES)) return;
+		if((txCfg->E2E != NULL_PTR) && ((E2E_HeaderLength(txCfg->E2E) == 0u) || (E2E_HeaderLength(txCfg->E2E) > txCfg->PduLength))) return;
+	}
+	for(i = 0; i < ConfigPtr->NumRxIpdu; i++)
+	{
+		const Com_RxIpduConfigType* rxCfg = &ConfigPtr->RxIpduConfig[i];
+
+		if((rxCfg->IpduId != i) || (rxCfg->PduLength == 0u) || (rxCfg->PduLength > COM_CODEC_FRAME_BYTES)) return;
+		if((rxCfg->E2E != NULL_PTR) && ((E2E_HeaderLength(rxCfg->E2E) == 0u) || (E2E_HeaderLength(rxCfg->E2E) > rxCfg->PduLength))) return;
+	}
+
+	memset(Com_TxState, 0, sizeof(Com_TxState));
+	for(i = 0; i < COM_CFG_MAX_TX_IPDU; i++) Com_TxState[i].Selector = COM_NO_SIGNAL;
+	for(i = 0; i < COM_CFG_MAX_RX_IPDU; i++) Com_RxSelector[i] = COM_NO_SIGNAL;
+	for(i = 0; i < COM_CFG_MAX_TX_IPDU; i++) E2E_ProtectInit(&Com_TxE2E[i]);
+	for(i = 0; i < COM_CFG_MAX_RX_IPDU; i++) E2E_CheckInit(&Com_RxE2E[i]);
+
+	for(i = 0; i < ConfigPtr->NumSignals; i++)
+	{
+		if(prv_CheckSignal(ConfigPtr, i) == FALSE) return;
+	}
+	for(i = 0; i < ConfigPtr->NumSignals; i++)
+	{
+		if(prv_CheckLayout(ConfigPtr, i) == FALSE) return;
+	}
+
+	// buffers start with layout 0 (selector field 0)
+	memset(Com_TxBuffer, 0, sizeof(Com_TxBuffer));
+	for(i = 0; i < ConfigPtr->NumTxIpdu; i++) Com_TxState[i].Length = prv_LayoutLength(ConfigPtr, (Com_IpduIdType)i, 0u);
+	Com_TimerInit(&Com_TxDeadline, prv_TxDeadlineExpired);
+	Com_TimerInit(&Com_RxDeadline, prv_RxDeadlineExpired);
+
+	// Rx signals start at their substitute value, the first timeout runs from here
+	for(i = 0; i < ConfigPtr->NumSignals; i++)
+	{
+		const Com_SignalConfigType* sigCfg = &ConfigPtr->SignalConfig[i];
+
+		Com_RxShadow[i] = sigCfg->SubstituteValue;
+		Com_RxStatus[i] = (uint8)COM_RX_NOT_RECEIVED;
+
+		if((sigCfg->Direction == COM_RECEIVE) && (sigCfg->TimeoutMs != 0u) && (sigCfg->FirstTimeoutMs != 0u))
+		{
+			(void)Com_TimerStart(&Com_RxDeadline, (Com_TimerIdType)i,
+					prv_MsToTicks(sigCfg->FirstTimeoutMs, COM_CFG_MAINFUNCTION_RX_PERIOD_MS));
+		}
+	}
+
 	Com_ConfigPtr	= ConfigPtr;
 }
 
@@ -33,40 +220,165 @@ void Com_RxIndication(
 {
 	uint16 i;
 	const Com_SignalConfigType* sigCfg;
+	Com_CodecFrameType frame;
+	const E2E_ConfigType* e2e;
+	uint8 selector;
+	uint8 layout = 0u;
 
-	if(Com_ConfigPtr == NULL_PTR || PduInfoPtr == NULL_PTR) return;
+	if(Com_ConfigPtr == NULL_PTR || PduInfoPtr == NULL_PTR || PduInfoPtr->SduDataPtr == NULL_PTR) return;
+	if(RxPduId >= Com_ConfigPtr->NumRxIpdu) return;
+
+	// corrupted, repeated or out of sequence: none of the signals is touched
+	e2e = Com_ConfigPtr->RxIpduConfig[RxPduId].E2E;
+	if(e2e != NULL_PTR)
+	{
+		E2E_PCheckStatusType status = E2E_Check(e2e, &Com_RxE2E[RxPduId], PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+
+		if((status != E2E_P_OK) && (status != E2E_P_OKSOMELOST)) return;
+	}
+
+	// one read of the frame serves all of its signals
+	Com_CodecLoad(&frame, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+
+	// multiplexed: only the static part and the layout in the selector. A frame too short for the selector has none
+	selector = Com_RxSelector[RxPduId];
+	if(selector != COM_NO_SIGNAL)
+	{
+		if(Com_SignalCodec[selector].MinLength <= PduInfoPtr->SduLength)	layout = (uint8)Com_CodecUnpack(&Com_SignalCodec[selector], &frame);
+		else																layout = COM_MUX_SELECTOR;
+	}
 
 	// Unpack signal from PDU
 	for(i = 0; i < Com_ConfigPtr->NumSignals; i++)
 	{
 		sigCfg = &Com_ConfigPtr->SignalConfig[i];
 
-		if(sigCfg->Ipduid == (Com_IpduIdType)RxPduId)
+		if((sigCfg->Direction != COM_RECEIVE) || (sigCfg->Ipduid != (Com_IpduIdType)RxPduId)) continue;
+		if((sigCfg->MuxValue < COM_MUX_SELECTOR) && (sigCfg->MuxValue != layout)) continue;
+
+		// sender did not touch the signal (an update bit beyond the frame reads as 0): no new value, the deadline keeps running
+		if((sigCfg->UpdateBitPosition != COM_NO_UPDATE_BIT) && (Com_CodecBit(&frame, sigCfg->UpdateBitPosition) == FALSE)) continue;
+		if(Com_SignalCodec[i].MinLength > PduInfoPtr->SduLength) continue;
+
+		Com_RxShadow[i] = Com_CodecUnpack(&Com_SignalCodec[i], &frame);
+		Com_RxStatus[i] = (uint8)COM_RX_VALID;
+
+		if(sigCfg->TimeoutMs != 0u)
 		{
-			if(sigCfg->SignalType == COM_SIGNAL_UINT16)
-			{
-				uint16 value;
-				if(sigCfg->Endianness == COM_LITTLE_ENDIAN)
-				{
-					value = PduInfoPtr->SduDataPtr[(sigCfg->BitPosition)/8];
-					value |= (uint16)(PduInfoPtr->SduDataPtr[(sigCfg->BitPosition)/8+1] << 8);
-				} else {
-					value = (uint16)(PduInfoPtr->SduDataPtr[(sigCfg->BitPosition)/8] << 8);
-					value |= PduInfoPtr->SduDataPtr[(sigCfg->BitPosition)/8+1];
-				}
-				// Call back
-//				App_SignalIndication(sigCfg->SignalId,&value);
-			}
+			(void)Com_TimerStart(&Com_RxDeadline, (Com_TimerIdType)i,
+					prv_MsToTicks(sigCfg->TimeoutMs, COM_CFG_MAINFUNCTION_RX_PERIOD_MS));
 		}
 	}
 }
 
+// Missed reception deadline: substitute or hold, monitoring resumes with the next reception
+static void prv_RxDeadlineExpired(Com_TimerIdType Id)
+{
+	const Com_SignalConfigType* sigCfg = &Com_ConfigPtr->SignalConfig[Id];
+
+	if(sigCfg->TimeoutAction == COM_TIMEOUT_SUBSTITUTE) Com_RxShadow[Id] = sigCfg->SubstituteValue;
+	Com_RxStatus[Id] = (uint8)COM_RX_TIMEOUT;
+}
+
+Std_ReturnType Com_ReceiveSignal(
+		Com_SignalIdType	SignalId,
+		void* SignalDataPtr
+)
+{
+	uint16 i;
+	uint32 value;
+
+	if((Com_ConfigPtr == NULL_PTR) || (SignalDataPtr == NULL_PTR)) return E_NOT_OK;
+
+	i = prv_SignalIndex(SignalId);
+	if((i >= Com_ConfigPtr->NumSignals) || (Com_ConfigPtr->SignalConfig[i].Direction != COM_RECEIVE)) return E_NOT_OK;
+
+	value = Com_RxShadow[i];
+	switch(Com_ConfigPtr->SignalConfig[i].SignalType)
+	{
+	case COM_SIGNAL_UINT8:
+	case COM_SIGNAL_SINT8:		*(uint8*)SignalDataPtr	= (uint8)value;		break;
+	case COM_SIGNAL_UINT16:
+	case COM_SIGNAL_SINT16:		*(uint16*)SignalDataPtr	= (uint16)value;	break;
+	default:					*(uint32*)SignalDataPtr	= value;			break;
+	}
+	return E_OK;
+}
+
+Com_RxSignalStatusType Com_GetRxSignalStatus(Com_SignalIdType SignalId)
+{
+	uint16 i;
+
+	if(Com_ConfigPtr == NULL_PTR) return COM_RX_NOT_RECEIVED;
+
+	i = prv_SignalIndex(SignalId);
+	if(i >= Com_ConfigPtr->NumSignals) return COM_RX_NOT_RECEIVED;
+	return (Com_RxSignalStatusType)Com_RxStatus[i];
+}
+
 /*
  * Transmission confirmation
  */
 void Com_TxConfirmation(PduIdType TxPduId)
 {
-	(void)TxPduId;
+	const Com_TxIpduConfigType* txCfg = prv_TxCfg((Com_IpduIdType)TxPduId);
+
+	if(txCfg == NULL_PTR) return;
+
+	// a late one (after the timeout) still means the frame is on the bus
+	Com_TimerStop(&Com_TxDeadline, (Com_TimerIdType)TxPduId);
+	Com_TxState[TxPduId].Status = COM_TX_CONFIRMED;
+
+	if(txCfg->TxNotification != NULL_PTR) txCfg->TxNotification(txCfg->IpduId);
+}
+
+Com_TxStatusType Com_GetTxStatus(Com_IpduIdType IpduId)
+{
+	if(prv_TxCfg(IpduId) == NULL_PTR) return COM_TX_IDLE;
+	return Com_TxState[IpduId].Status;
+}
+
+E2E_PCheckStatusType Com_GetRxE2EStatus(Com_IpduIdType IpduId)
+{
+	if((Com_ConfigPtr == NULL_PTR) || (IpduId >= Com_ConfigPtr->NumRxIpdu)) return E2E_P_NONEWDATA;
+	return Com_RxE2E[IpduId].Status;
+}
+
+// Value of the signal type at SignalDataPtr, signed types sign extended
+static uint32 prv_ReadValue(Com_SignalTypeEnum Type, const void* SignalDataPtr)
+{
+	switch(Type)
+	{
+	case COM_SIGNAL_UINT8:	return (uint32)*(const uint8*)SignalDataPtr;
+	case COM_SIGNAL_SINT8:	return (uint32)(sint32)*(const sint8*)SignalDataPtr;
+	case COM_SIGNAL_UINT16:	return (uint32)*(const uint16*)SignalDataPtr;
+	case COM_SIGNAL_SINT16:	return (uint32)(sint32)*(const sint16*)SignalDataPtr;
+	default:				return *(const uint32*)SignalDataPtr;
+	}
+}
+
+// Selector to Layout: the signals of the old layout are cleared, a dynamic I-PDU changes its length
+static void prv_SwitchLayout(Com_IpduIdType Ipduid, uint8 Layout)
+{
+	Com_TxStateType* state = &Com_TxState[Ipduid];
+	uint8* buf = Com_TxBuffer[Ipduid];
+	uint16 i;
+
+	if(state->Layout == Layout) return;
+
+	for(i = 0; i < Com_ConfigPtr->NumSignals; i++)
+	{
+		const Com_SignalConfigType* sigCfg = &Com_ConfigPtr->SignalConfig[i];
+
+		if((sigCfg->Direction == COM_SEND) && (sigCfg->Ipduid == Ipduid) && (sigCfg->MuxValue == state->Layout))
+		{
+			Com_CodecPack(&Com_SignalCodec[i], buf, 0u);
+		}
+	}
+	Com_CodecPack(&Com_SignalCodec[state->Selector], buf, Layout);
+
+	state->Layout	= Layout;
+	state->Length	= prv_LayoutLength(Com_ConfigPtr, Ipduid, Layout);
 }
 
 /*
@@ -89,36 +401,105 @@ Std_ReturnType Com_SendSignal(
 
 		if(sigCfg->SignalId == SignalId)
 		{
-			// clear buffer
-			memset(Com_TxBuffer, 0,sizeof(Com_TxBuffer));
-
-			//Pack signal
-			if(sigCfg->SignalType == COM_SIGNAL_SINT8)
-			{
-				Com_TxBuffer[sigCfg->BitPosition / 8] = *(const uint8*)SignalDataPtr;
-			} else if (sigCfg->SignalType == COM_SIGNAL_SINT16)
-			{
-				uint16 value = *(const uint16*)SignalDataPtr;
-
-				Com_TxBuffer[sigCfg->BitPosition/8]		= (uint8)(value&0xFF);
-				Com_TxBuffer[sigCfg->BitPosition/8 + 1]	= (uint8)(value >> 8);
-			}
-
-			// trigger transmit
+			const Com_TxIpduConfigType* txCfg = prv_TxCfg(sigCfg->Ipduid);
+
+			if((sigCfg->Direction != COM_SEND) || (sigCfg->MuxValue == COM_MUX_SELECTOR) || (txCfg == NULL_PTR)) return E_NOT_OK;
+
+			if(sigCfg->MuxValue != COM_MUX_STATIC) prv_SwitchLayout(sigCfg->Ipduid, sigCfg->MuxValue);
+
+			// Pack signal, the other signals of the I-PDU keep their last value
+			Com_CodecPack(&Com_SignalCodec[i], Com_TxBuffer[sigCfg->Ipduid], prv_ReadValue(sigCfg->SignalType, SignalDataPtr));
+
+			// first value of a cyclic I-PDU: its cycle starts with the next Com_MainFunctionTx
+			if((txCfg->PeriodMs != 0u) && (Com_TxState[sigCfg->Ipduid].Countdown == 0u)) Com_TxState[sigCfg->Ipduid].Countdown = 1u;
+
+			if(sigCfg->TransferProperty == COM_PENDING) return E_OK;
 			return Com_TriggerTransmit(sigCfg->Ipduid);
 		}
 	}
 	return E_NOT_OK;
 }
 
+// Hand the I-PDU buffer to PduR and (re)arm its deadline. The deadline runs even when the
+// lower layer refused the request (mailbox busy): the retry then doubles as the resend
+static Std_ReturnType prv_Transmit(const Com_TxIpduConfigType* txCfg)
+{
+	PduInfoType		pduInfo;
+	Std_ReturnType	ret;
+
+	pduInfo.SduDataPtr		= Com_TxBuffer[txCfg->IpduId];
+	pduInfo.MetaDataPtr		= NULL_PTR;
+	pduInfo.SduLength		= (PduLengthType)Com_TxState[txCfg->IpduId].Length;
+
+	// fits: Com_Init checked the protection against the I-PDU length
+	if(txCfg->E2E != NULL_PTR) (void)E2E_Protect(txCfg->E2E, &Com_TxE2E[txCfg->IpduId], pduInfo.SduDataPtr, pduInfo.SduLength);
+
+	ret = PduR_ComTransmit((PduIdType)txCfg->IpduId, &pduInfo);
+
+	if(txCfg->DeadlineMs != 0u)
+	{
+		Com_TxState[txCfg->IpduId].Status = COM_TX_PENDING;
+		(void)Com_TimerStart(&Com_TxDeadline, (Com_TimerIdType)txCfg->IpduId,
+				prv_MsToTicks(txCfg->DeadlineMs, COM_CFG_MAINFUNCTION_TX_PERIOD_MS));
+	}
+	return ret;
+}
+
+// Missed deadline: resend while retries are left, then report
+static void prv_TxDeadlineExpired(Com_TimerIdType Id)
+{
+	const Com_TxIpduConfigType* txCfg = prv_TxCfg((Com_IpduIdType)Id);
+
+	if(txCfg == NULL_PTR) return;
+
+	if(Com_TxState[Id].RetriesLeft != 0u)
+	{
+		Com_TxState[Id].RetriesLeft--;
+		(void)prv_Transmit(txCfg);
+		return;
+	}
+
+	Com_TxState[Id].Status = COM_TX_TIMEOUT;
+	if(txCfg->TimeoutNotification != NULL_PTR) txCfg->TimeoutNotification(txCfg->IpduId);
+}
+
 // trigger transmit
 
 Std_ReturnType Com_TriggerTransmit(Com_IpduIdType Ipduid)
 {
-	PduInfoType		pduInfo;
+	const Com_TxIpduConfigType* txCfg = prv_TxCfg(Ipduid);
 
-	pduInfo.SduDataPtr		= Com_TxBuffer;
-	pduInfo.SduLength		= 8u;
+	if(txCfg == NULL_PTR) return E_NOT_OK;
+
+	// a new request gets the full retry budget, a cyclic I-PDU starts a new period
+	Com_TxState[Ipduid].RetriesLeft = txCfg->RetryMax;
+	if(txCfg->PeriodMs != 0u) Com_TxState[Ipduid].Countdown = (uint16)prv_MsToTicks(txCfg->PeriodMs, COM_CFG_MAINFUNCTION_TX_PERIOD_MS);
+	return prv_Transmit(txCfg);
+}
+
+void Com_MainFunctionTx(void)
+{
+	uint16 i;
+
+	if(Com_ConfigPtr == NULL_PTR) return;
+
+	// resends of missed deadlines first, a cycle due in the same call can wait for the next one
+	Com_TimerTick(&Com_TxDeadline);
+
+	for(i = 0; i < Com_ConfigPtr->NumTxIpdu; i++)
+	{
+		Com_TxStateType* state = &Com_TxState[i];
+
+		if((state->Countdown == 0u) || (--state->Countdown != 0u)) continue;
+
+		// lower layer busy: try again with the next call instead of losing the cycle
+		if(Com_TriggerTransmit((Com_IpduIdType)i) != E_OK) state->Countdown = 1u;
+	}
+}
+
+void Com_MainFunctionRx(void)
+{
+	if(Com_ConfigPtr == NULL_PTR) return;
 
-	return PduR_ComTransmit((PduIdType)Ipduid, &pduInfo);
+	Com_TimerTick(&Com_RxDeadline);
 }
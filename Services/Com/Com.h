@@ -12,6 +12,8 @@
 
 #include <Std_Types.h>
 #include <ComStack_Types.h>
+#include "Com_Cfg.h"
+#include "E2E.h"
 
 /* -------------------------- Signal Config ------------------------- */
 // Signal ID type
@@ -25,8 +27,8 @@ typedef uint16 Com_IpduIdType;
  */
 typedef enum
 {
-	COM_BIG_ENDIAN = 0,
-	COM_LITTLE_ENDIAN
+	COM_BIG_ENDIAN = 0,			// Motorola
+	COM_LITTLE_ENDIAN			// Intel
 } Com_SignalEndianessTypes;
 
 /*
@@ -42,8 +44,59 @@ typedef enum
 	COM_SIGNAL_SINT32
 } Com_SignalTypeEnum;
 
+/*
+ * Signal direction
+ */
+typedef enum
+{
+	COM_SEND	= 0,
+	COM_RECEIVE
+} Com_SignalDirectionType;
+
+/*
+ * Rx signal: value after a missed reception deadline
+ */
+typedef enum
+{
+	COM_TIMEOUT_HOLD		= 0,	// keep the last received value
+	COM_TIMEOUT_SUBSTITUTE			// SubstituteValue
+} Com_RxTimeoutActionType;
+
+/*
+ * Rx signal state
+ */
+typedef enum
+{
+	COM_RX_NOT_RECEIVED	= 0,		// value is SubstituteValue, no deadline missed yet
+	COM_RX_VALID		,			// received within its deadline
+	COM_RX_TIMEOUT					// deadline missed, value per TimeoutAction
+} Com_RxSignalStatusType;
+
+/*
+ * Tx signal: what a Com_SendSignal does besides updating the I-PDU buffer
+ */
+typedef enum
+{
+	COM_TRIGGERED	= 0,			// transmit the I-PDU now
+	COM_PENDING						// wait for the next triggered signal or cycle of the I-PDU
+} Com_TransferPropertyType;
+
+// No update bit: every reception of the I-PDU updates the signal
+#define COM_NO_UPDATE_BIT			((uint8)0xFFu)
+
+// MuxValue: part of every layout of the I-PDU
+#define COM_MUX_STATIC				((uint8)0xFFu)
+// MuxValue: selector field of the I-PDU (one at most), its value picks the layout. Written by Com only
+#define COM_MUX_SELECTOR			((uint8)0xFEu)
+
 /*
  *  Signal configuration structure
+ *  BitPosition is the least significant bit of the signal (byte * 8 + bit) in both byte orders, see Com_Codec.h.
+ *  Com_Init refuses a signal that is wider than its type or does not fit an 8 byte frame
+ *  Rx only: UpdateBitPosition, deadlines, TimeoutAction. SubstituteValue is also the value before the first reception
+ *  Tx only: TransferProperty
+ *  MuxValue other than COM_MUX_STATIC / COM_MUX_SELECTOR: the signal exists only while the selector holds that value.
+ *  Sending it switches the Tx layout (the signals of the previous one are cleared), on Rx it is skipped in other layouts
  */
 typedef struct
 {
@@ -51,27 +104,74 @@ typedef struct
 	Com_IpduIdType				Ipduid;
 	Com_SignalTypeEnum			SignalType;
 	uint8						BitPosition;
-	uint8						BitSize;
+	uint8						BitSize;				// 1 .. width of SignalType
 	Com_SignalEndianessTypes	Endianness;
+	Com_SignalDirectionType		Direction;
+	uint8						UpdateBitPosition;		// COM_NO_UPDATE_BIT: none
+	uint16						FirstTimeoutMs;			// from Com_Init to the first reception, 0: not monitored
+	uint16						TimeoutMs;				// between two receptions, 0: not monitored
+	Com_RxTimeoutActionType		TimeoutAction;
+	uint32						SubstituteValue;
+	uint8						MuxValue;				// COM_MUX_STATIC, COM_MUX_SELECTOR or the layout (0 .. 0xFD)
+	Com_TransferPropertyType	TransferProperty;
 } Com_SignalConfigType;
 
 /* ------------------------ I-PDU Configuration --------------------*/
+/*
+ * I-PDU length on the bus
+ */
+typedef enum
+{
+	COM_PDU_FIXED	= 0,			// always PduLength bytes
+	COM_PDU_DYNAMIC					// up to the last byte used by the current layout (static signals included)
+} Com_PduLengthModeType;
+
 /*
  * Rx I-PDU configuration
+ * IpduId equals the index in the list. A received frame may be shorter than PduLength, signals it does not carry
+ * keep their value. A protected I-PDU is dropped before its signals are read unless the check gives E2E_P_OK or
+ * E2E_P_OKSOMELOST: values stay, reception deadlines keep running
  */
 typedef struct
 {
 	Com_IpduIdType				IpduId;
 	uint16						PduLength;
+	const E2E_ConfigType*		E2E;					// NULL: not protected
 } Com_RxIpduConfigType;
 
+/*
+ * Tx I-PDU delivery state
+ */
+typedef enum
+{
+	COM_TX_IDLE		= 0,			// nothing sent since Com_Init
+	COM_TX_PENDING	,				// handed to PduR, confirmation outstanding
+	COM_TX_CONFIRMED,				// last request confirmed by the driver
+	COM_TX_TIMEOUT					// deadline missed on every attempt
+} Com_TxStatusType;
+
+// Tx confirmation / timeout notification
+typedef void (*Com_TxNotificationType)(Com_IpduIdType IpduId);
+
 /*
  * Tx I-PDU configuration
+ * IpduId equals the index in the list (state and deadline timer are indexed by it)
+ * A cyclic I-PDU starts with the first Com_SendSignal to it and is then sent every PeriodMs,
+ * triggered signals still go out at once
+ * A protected I-PDU gets a new counter and CRC on every transmission, retries included. The E2E fields count as
+ * static part of a dynamic length I-PDU
  */
 typedef struct
 {
 	Com_IpduIdType				IpduId;
-	uint16						PduLength;
+	uint16						PduLength;				// 1 .. 8 (classic CAN frame), the longest layout for COM_PDU_DYNAMIC
+	Com_PduLengthModeType		LengthMode;
+	uint16						PeriodMs;				// cyclic transmission, 0: only on triggered signals
+	uint16						DeadlineMs;				// confirmation expected within, 0: not monitored
+	uint8						RetryMax;				// re-sends after a missed deadline before the timeout
+	Com_TxNotificationType		TxNotification;			// NULL: none
+	Com_TxNotificationType		TimeoutNotification;	// NULL: none
+	const E2E_ConfigType*		E2E;					// NULL: not protected
 } Com_TxIpduConfigType;
 
 /* --- COM global configuration --------*/
@@ -87,9 +187,23 @@ typedef struct
 	uint16								NumTxIpdu;
 } Com_ConfigType;
 
-// Initialize Com module
+// Initialize Com module. Refused: I-PDU lists longer than COM_CFG_MAX_TX_IPDU / COM_CFG_MAX_RX_IPDU or out of id order,
+// signals that do not fit their I-PDU, more than one selector per I-PDU, layout signals in an I-PDU without selector,
+// E2E protection that is invalid or does not fit PduLength
 void Com_Init(const Com_ConfigType* ConfigPtr);
 
+/*
+ * Cyclic transmission and Tx deadline monitoring, every COM_CFG_MAINFUNCTION_TX_PERIOD_MS.
+ * Same context as the Can_MainFunction_Tx that delivers the confirmations
+ */
+void Com_MainFunctionTx(void);
+
+/*
+ * Reception deadline monitoring, every COM_CFG_MAINFUNCTION_RX_PERIOD_MS.
+ * Same context as the Can_MainFunction_Rx that delivers the I-PDUs and as the Com_ReceiveSignal callers
+ */
+void Com_MainFunctionRx(void);
+
 /*
  * Indication of a received I-PDU from PduR
  */
@@ -99,12 +213,39 @@ void Com_RxIndication(
 );
 
 /*
- * Transmission confirmation
+ * Transmission confirmation from PduR, stops the deadline of the I-PDU
  */
 void Com_TxConfirmation(PduIdType TxPduId);
 
 /*
- * Send a signal
+ * Delivery state of the last request on a Tx I-PDU
+ */
+Com_TxStatusType Com_GetTxStatus(Com_IpduIdType IpduId);
+
+/*
+ * E2E check result of the last frame of an Rx I-PDU, E2E_P_NONEWDATA before the first one and for unprotected
+ * or unknown I-PDUs
+ */
+E2E_PCheckStatusType Com_GetRxE2EStatus(Com_IpduIdType IpduId);
+
+/*
+ * Read the shadow value of an Rx signal, written as the signal type (uint8 / uint16 / uint32, signed ones sign extended
+ * from BitSize).
+ * The value is valid in every state, Com_GetRxSignalStatus tells how fresh it is
+ */
+Std_ReturnType Com_ReceiveSignal(
+		Com_SignalIdType	SignalId,
+		void* SignalDataPtr
+);
+
+/*
+ * Freshness of an Rx signal, COM_RX_NOT_RECEIVED for unknown ids
+ */
+Com_RxSignalStatusType Com_GetRxSignalStatus(Com_SignalIdType SignalId);
+
+/*
+ * Send a signal: SignalDataPtr points to a value of the signal type, it is cut to BitSize and packed into the
+ * I-PDU buffer. A triggered signal transmits the I-PDU, a pending one returns E_OK. Selector signals are refused
  */
 Std_ReturnType Com_SendSignal(
 		Com_SignalIdType	SignalId,
@@ -117,9 +258,18 @@ Std_ReturnType Com_SendSignal(
 #define COM_SIGNAL_ID_SPEED			((Com_SignalIdType)0U)
 #define COM_SIGNAL_ID_DISTANCE		((Com_SignalIdType)1U)
 #define COM_SIGNAL_ID_OBSTACLE		((Com_SignalIdType)2u)
+#define COM_SIGNAL_ID_BUS_DISTANCE	((Com_SignalIdType)3u)
+#define COM_SIGNAL_ID_SENSOR_MUX	((Com_SignalIdType)4u)
+#define COM_SIGNAL_ID_AMBIENT_TEMP	((Com_SignalIdType)5u)
+#define COM_SIGNAL_ID_AMBIENT_HUM	((Com_SignalIdType)6u)
+
+// Layouts of the sensor status I-PDU
+#define COM_SENSOR_MUX_RANGING		((uint8)0u)
+#define COM_SENSOR_MUX_AMBIENT		((uint8)1u)
 
 // IPDU IDs
 #define COM_IPDU_ID_TX_VEHICLE		((Com_IpduIdType)0U)
+#define COM_IPDU_ID_TX_SENSOR		((Com_IpduIdType)1U)
 #define COM_IPDU_ID_RX_SENSOR		((Com_IpduIdType)0U)
 
 extern const Com_ConfigType			Com_Config;
@@ -0,0 +1,70 @@
+/* =====================================================================================================================
+ *  File        : Com_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of the Com module (main function periods, state sizes, timer wheel)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef COM_COM_CFG_H_
+#define COM_COM_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Call period of Com_MainFunctionTx, Tx deadlines in the config are rounded up to it */
+#ifndef COM_CFG_MAINFUNCTION_TX_PERIOD_MS
+#define COM_CFG_MAINFUNCTION_TX_PERIOD_MS	(10u)
+#endif
+
+/* Call period of Com_MainFunctionRx, reception deadlines in the config are rounded up to it */
+#ifndef COM_CFG_MAINFUNCTION_RX_PERIOD_MS
+#define COM_CFG_MAINFUNCTION_RX_PERIOD_MS	(10u)
+#endif
+
+/* Tx I-PDUs with state in Com (buffer, deadline timer), the config may use fewer */
+#ifndef COM_CFG_MAX_TX_IPDU
+#define COM_CFG_MAX_TX_IPDU					(4u)
+#endif
+
+/* Rx I-PDUs with state in Com (layout selector), the config may use fewer */
+#ifndef COM_CFG_MAX_RX_IPDU
+#define COM_CFG_MAX_RX_IPDU					(4u)
+#endif
+
+/* Signals with state in Com (Rx shadow value, reception deadline timer), the config may use fewer */
+#ifndef COM_CFG_MAX_SIGNALS
+#define COM_CFG_MAX_SIGNALS					(8u)
+#endif
+
+/* Timer wheel levels: 2^L0_BITS one-tick slots, 2^L1_BITS slots of one level 0 window each.
+ * 5 + 4 at 10 ms: 320 ms on level 0, 5.12 s before a timer needs a second level 1 turn */
+#ifndef COM_CFG_TIMER_L0_BITS
+#define COM_CFG_TIMER_L0_BITS				(5u)
+#endif
+
+#ifndef COM_CFG_TIMER_L1_BITS
+#define COM_CFG_TIMER_L1_BITS				(4u)
+#endif
+
+/* Timers per wheel, ids 0 .. MAX - 1 (uint8 links, 0xFF is the end mark). Tx wheel: I-PDU ids, Rx wheel: signals */
+#ifndef COM_CFG_TIMER_MAX
+#define COM_CFG_TIMER_MAX					((COM_CFG_MAX_SIGNALS > COM_CFG_MAX_TX_IPDU) ? COM_CFG_MAX_SIGNALS : COM_CFG_MAX_TX_IPDU)
+#endif
+
+#if (((1u << COM_CFG_TIMER_L0_BITS) + (1u << COM_CFG_TIMER_L1_BITS)) > 255u)
+#error "COM_CFG_TIMER_L0_BITS / L1_BITS: more slots than the uint8 slot index holds"
+#endif
+
+#if (COM_CFG_TIMER_MAX > 255u) || (COM_CFG_MAX_SIGNALS > COM_CFG_TIMER_MAX) || (COM_CFG_MAX_TX_IPDU > COM_CFG_TIMER_MAX)
+#error "COM_CFG_TIMER_MAX must cover the Tx I-PDUs and signals and fit the uint8 links"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COM_COM_CFG_H_ */
@@ -0,0 +1,107 @@
+/* =====================================================================================================================
+ *  File        : Com_Codec.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Signal pack / unpack on whole 64-bit frame words (see Com_Codec.h)
+ *  Depends     : Com_Codec.h
+ * ===================================================================================================================*/
+
+#include "Com_Codec.h"
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "Com_Codec: frame words are read with a little endian CPU"
+#endif
+
+// REV on Cortex-M3 (twice), BSWAP on the host
+static inline uint64 prv_Swap64(uint64 w)
+{
+#if defined(__GNUC__)
+	return __builtin_bswap64(w);
+#else
+	w = ((w & 0x00FF00FF00FF00FFull) << 8)	| ((w >> 8) & 0x00FF00FF00FF00FFull);
+	w = ((w & 0x0000FFFF0000FFFFull) << 16)	| ((w >> 16) & 0x0000FFFF0000FFFFull);
+	return (w << 32) | (w >> 32);
+#endif
+}
+
+static uint8 prv_TypeBits(Com_SignalTypeEnum Type)
+{
+	switch(Type)
+	{
+	case COM_SIGNAL_UINT8:
+	case COM_SIGNAL_SINT8:	return 8u;
+	case COM_SIGNAL_UINT16:
+	case COM_SIGNAL_SINT16:	return 16u;
+	default:				return 32u;
+	}
+}
+
+Std_ReturnType Com_CodecInit(Com_CodecType* Codec, const Com_SignalConfigType* Signal)
+{
+	uint8 pos	= Signal->BitPosition;
+	uint8 size	= Signal->BitSize;
+	uint8 shift;
+
+	if((size == 0u) || (size > prv_TypeBits(Signal->SignalType)) || (pos >= (COM_CODEC_FRAME_BYTES * 8u))) return E_NOT_OK;
+
+	if(Signal->Endianness == COM_BIG_ENDIAN)
+	{
+		shift				= (uint8)(pos ^ 56u);
+		Codec->Flags		= COM_CODEC_MOTOROLA;
+		Codec->MinLength	= (uint8)((pos / 8u) + 1u);				// the LSB byte is the last one
+	} else {
+		shift				= pos;
+		Codec->Flags		= 0u;
+		Codec->MinLength	= (uint8)(((pos + size - 1u) / 8u) + 1u);
+	}
+	if(((uint16)shift + size) > 64u) return E_NOT_OK;
+
+	if((Signal->SignalType == COM_SIGNAL_SINT8) || (Signal->SignalType == COM_SIGNAL_SINT16) || (Signal->SignalType == COM_SIGNAL_SINT32))
+	{
+		Codec->Flags |= COM_CODEC_SIGNED;
+	}
+	Codec->Mask		= 0xFFFFFFFFu >> (32u - size);
+	Codec->Shift	= shift;
+	return E_OK;
+}
+
+void Com_CodecLoad(Com_CodecFrameType* Frame, const uint8* Data, PduLengthType Length)
+{
+	uint64 w = 0u;
+
+	// a full frame is two word loads, no library call
+	if(Length >= COM_CODEC_FRAME_BYTES)	memcpy(&w, Data, COM_CODEC_FRAME_BYTES);
+	else								memcpy(&w, Data, Length);
+
+	Frame->Intel	= w;
+	Frame->Motorola	= prv_Swap64(w);
+}
+
+uint32 Com_CodecUnpack(const Com_CodecType* Codec, const Com_CodecFrameType* Frame)
+{
+	uint64 w	= ((Codec->Flags & COM_CODEC_MOTOROLA) != 0u) ? Frame->Motorola : Frame->Intel;
+	uint32 v	= (uint32)(w >> Codec->Shift) & Codec->Mask;
+
+	if((Codec->Flags & COM_CODEC_SIGNED) != 0u)
+	{
+		uint32 sign = (Codec->Mask >> 1) + 1u;
+
+		v = (v ^ sign) - sign;
+	}
+	return v;
+}
+
+void Com_CodecPack(const Com_CodecType* Codec, uint8* Data, uint32 Value)
+{
+	uint64 w;
+	uint64 mask = (uint64)Codec->Mask << Codec->Shift;
+
+	memcpy(&w, Data, COM_CODEC_FRAME_BYTES);
+	if((Codec->Flags & COM_CODEC_MOTOROLA) != 0u) w = prv_Swap64(w);
+
+	w = (w & ~mask) | (((uint64)(Value & Codec->Mask)) << Codec->Shift);
+
+	if((Codec->Flags & COM_CODEC_MOTOROLA) != 0u) w = prv_Swap64(w);
+	memcpy(Data, &w, COM_CODEC_FRAME_BYTES);
+}
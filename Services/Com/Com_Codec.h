@@ -0,0 +1,81 @@
+/* =====================================================================================================================
+ *  File        : Com_Codec.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Signal pack / unpack on whole 64-bit frame words
+ * 					- BitPosition is the least significant bit of the signal, bits numbered byte * 8 + bit (LSB 0)
+ * 					- Intel (COM_LITTLE_ENDIAN): the signal grows towards higher bytes, one shift of the frame read
+ * 					  as a little endian word
+ * 					- Motorola (COM_BIG_ENDIAN): the signal grows towards lower bytes, one shift of the frame read
+ * 					  as a big endian word. Bit b of byte B is bit (7 - B) * 8 + b there, so the shift is
+ * 					  BitPosition ^ 56
+ * 					- shift, mask and sign bit come from Com_CodecInit, the per frame work is a load, a shift,
+ * 					  a mask and for signed types a sign extension, no loop over bytes or bits
+ * 					- little endian CPU (Cortex-M3, the host sim)
+ *  Depends     : Std_Types.h, ComStack_Types.h, Com.h
+ * ===================================================================================================================*/
+
+#ifndef COM_COM_CODEC_H_
+#define COM_COM_CODEC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+#include "Com.h"
+
+/* =========================================================
+ *  Types
+ * =======================================================*/
+#define COM_CODEC_FRAME_BYTES			(8u)
+
+#define COM_CODEC_MOTOROLA				(0x01u)
+#define COM_CODEC_SIGNED				(0x02u)
+
+// Placement of one signal in the frame word
+typedef struct
+{
+	uint32	Mask;			// BitSize ones from bit 0
+	uint8	Shift;			// least significant bit in the frame word
+	uint8	Flags;			// COM_CODEC_MOTOROLA, COM_CODEC_SIGNED
+	uint8	MinLength;		// bytes a received frame needs to carry the signal
+} Com_CodecType;
+
+// A received frame, read once for all of its signals. Bytes beyond the received length are 0
+typedef struct
+{
+	uint64	Intel;
+	uint64	Motorola;
+} Com_CodecFrameType;
+
+/* =========================================================
+ *  API
+ * =======================================================*/
+/**
+ * @brief  Descriptor of a signal
+ * @return E_NOT_OK: BitSize 0 or wider than the signal type, or the signal does not fit an 8 byte frame
+ */
+Std_ReturnType Com_CodecInit(Com_CodecType* Codec, const Com_SignalConfigType* Signal);
+
+// Read the first min(Length, 8) bytes of Data
+void Com_CodecLoad(Com_CodecFrameType* Frame, const uint8* Data, PduLengthType Length);
+
+// Signal value, signed types sign extended to 32 bit
+uint32 Com_CodecUnpack(const Com_CodecType* Codec, const Com_CodecFrameType* Frame);
+
+// Replace the signal bits in an 8 byte frame buffer, the other signals stay as they are. Value is cut to BitSize
+void Com_CodecPack(const Com_CodecType* Codec, uint8* Data, uint32 Value);
+
+// Bit Pos (0 .. 63) of the frame, 0 when the frame is shorter
+static inline boolean Com_CodecBit(const Com_CodecFrameType* Frame, uint8 Pos)
+{
+	return (((Frame->Intel >> (Pos & 63u)) & 1u) != 0u) ? TRUE : FALSE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COM_COM_CODEC_H_ */
@@ -7,27 +7,166 @@
  * ===================================================================================================================*/
 
 #include "Com.h"
+#include "Rte.h"
+
+// E2E protection, the DataIds are the CAN ids of the frames
+static const E2E_ConfigType Com_E2EVehicle =
+{
+		E2E_PROFILE_CRC16,
+		0x0200U,
+		0U,								// bytes 0-1 CRC16
+		16U,							// byte 2 counter
+		1U
+};
+
+static const E2E_ConfigType Com_E2ESensor =
+{
+		E2E_PROFILE_CRC8,
+		0x0210U,
+		0U,								// byte 0 CRC8
+		12U,							// byte 1 bits 4-7 counter
+		1U
+};
+
+static const E2E_ConfigType Com_E2ERemoteSensor =
+{
+		E2E_PROFILE_CRC8,
+		0x0100U,
+		3U,								// byte 3 CRC8
+		20U,							// byte 2 bits 4-7 counter
+		3U								// up to 2 frames lost in a row
+};
 
 // IPDU Buffer
 
 const Com_SignalConfigType	Com_SignalConfigList[] =
 {
+		/* Vehicle I-PDU, every write goes out at once:
+		 *   bytes 0-1 CRC16, byte 2 counter, bytes 3-4 motor command */
 		{
 			COM_SIGNAL_ID_SPEED,
 			COM_IPDU_ID_TX_VEHICLE,
 			COM_SIGNAL_UINT16,
-			0U,
+			24U,
 			16U,
-			COM_LITTLE_ENDIAN
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_MUX_STATIC,
+			COM_TRIGGERED
+		},
+
+		/* Sensor status I-PDU, cyclic, one frame for all of its signals:
+		 *   byte 0	CRC8
+		 *   byte 1	bits 0-1 layout, bits 2-3 obstacle state, bits 4-7 counter
+		 *   ranging	bytes 2-3 distance (Q4 mm)					-> DLC 4
+		 *   ambient	bytes 2-3 temperature (0.1 degC), byte 4 humidity	-> DLC 5 */
+		{
+			COM_SIGNAL_ID_SENSOR_MUX,
+			COM_IPDU_ID_TX_SENSOR,
+			COM_SIGNAL_UINT8,
+			8U,
+			2U,
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_MUX_SELECTOR,
+			COM_PENDING
+		},
+
+		{
+			COM_SIGNAL_ID_OBSTACLE,
+			COM_IPDU_ID_TX_SENSOR,
+			COM_SIGNAL_UINT8,
+			10U,
+			2U,
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_MUX_STATIC,
+			COM_PENDING
 		},
 
 		{
 			COM_SIGNAL_ID_DISTANCE,
+			COM_IPDU_ID_TX_SENSOR,
+			COM_SIGNAL_UINT16,
+			16U,
+			16U,
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_SENSOR_MUX_RANGING,
+			COM_PENDING
+		},
+
+		{
+			COM_SIGNAL_ID_AMBIENT_TEMP,
+			COM_IPDU_ID_TX_SENSOR,
+			COM_SIGNAL_SINT16,
+			16U,
+			16U,
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_SENSOR_MUX_AMBIENT,
+			COM_PENDING
+		},
+
+		{
+			COM_SIGNAL_ID_AMBIENT_HUM,
+			COM_IPDU_ID_TX_SENSOR,
+			COM_SIGNAL_UINT8,
+			32U,
+			8U,
+			COM_LITTLE_ENDIAN,
+			COM_SEND,
+			COM_NO_UPDATE_BIT,
+			0U,
+			0U,
+			COM_TIMEOUT_HOLD,
+			0U,
+			COM_SENSOR_MUX_AMBIENT,
+			COM_PENDING
+		},
+
+		/* Remote sensor node, 0xFFFF (no data) once it falls silent or its frames fail the E2E check:
+		 *   bytes 0-1 distance, byte 2 bit 0 update bit, bits 4-7 counter, byte 3 CRC8 */
+		{
+			COM_SIGNAL_ID_BUS_DISTANCE,
 			COM_IPDU_ID_RX_SENSOR,
 			COM_SIGNAL_UINT16,
 			0U,
 			16U,
-			COM_LITTLE_ENDIAN
+			COM_LITTLE_ENDIAN,
+			COM_RECEIVE,
+			16U,							// update bit: byte 2, bit 0
+			100U,
+			100U,							// sender cycle 20 ms, 5 frames lost in a row
+			COM_TIMEOUT_SUBSTITUTE,
+			0xFFFFU,
+			COM_MUX_STATIC,
+			COM_TRIGGERED
 		}
 };
 
@@ -36,7 +175,8 @@ const Com_RxIpduConfigType Com_RxIpduConfigList[] =
 {
 		{
 			COM_IPDU_ID_RX_SENSOR,
-			8U
+			8U,
+			&Com_E2ERemoteSensor
 		}
 };
 
@@ -45,7 +185,26 @@ const Com_TxIpduConfigType Com_TxIpduConfigList[] =
 {
 		{
 			COM_IPDU_ID_TX_VEHICLE,
-			8U
+			5U,
+			COM_PDU_FIXED,
+			0U,
+			50U,							// a frame takes well under 1 ms, the deadline only trips when it cannot get out
+			2U,								// 3 attempts, 150 ms to the timeout
+			NULL_PTR,
+			Rte_COMCbkTxTOut_Vehicle,
+			&Com_E2EVehicle
+		},
+
+		{
+			COM_IPDU_ID_TX_SENSOR,
+			5U,
+			COM_PDU_DYNAMIC,
+			50U,							// replaces one frame per signal write
+			0U,
+			0U,
+			NULL_PTR,
+			NULL_PTR,
+			&Com_E2ESensor
 		}
 };
 
@@ -59,6 +218,6 @@ const Com_ConfigType Com_Config =
 		.NumRxIpdu		= (uint16)(sizeof(Com_RxIpduConfigList) / sizeof(Com_RxIpduConfigType)),
 
 		.TxIpduConfig	= Com_TxIpduConfigList,
-		.NumTxIpdu		= (uint16)(sizeof(Com_RxIpduConfigList) / sizeof(Com_TxIpduConfigType)),
+		.NumTxIpdu		= (uint16)(sizeof(Com_TxIpduConfigList) / sizeof(Com_TxIpduConfigType)),
 };
 
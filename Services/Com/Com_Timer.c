@@ -0,0 +1,137 @@
+/* =====================================================================================================================
+ *  File        : Com_Timer.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Hierarchical timer wheel for Com deadline monitoring (see Com_Timer.h)
+ *  Depends     : Com_Timer.h
+ * ===================================================================================================================*/
+
+#include "Com_Timer.h"
+
+#define COM_TIMER_L0_MASK				(COM_TIMER_L0_SLOTS - 1u)
+#define COM_TIMER_L1_MASK				(COM_TIMER_L1_SLOTS - 1u)
+
+#define COM_TIMER_IDLE					(0u)
+#define COM_TIMER_RUNNING				(1u)
+#define COM_TIMER_EXPIRING				(2u)		// taken off the wheel, callback still to come
+
+static void prv_Unlink(Com_TimerWheelType* W, Com_TimerIdType Id)
+{
+	Com_TimerIdType n = W->Next[Id];
+	Com_TimerIdType p = W->Prev[Id];
+
+	if(p != COM_TIMER_NONE)	W->Next[p] = n;
+	else					W->SlotHead[W->Slot[Id]] = n;
+	if(n != COM_TIMER_NONE)	W->Prev[n] = p;
+}
+
+// Level 0 when the expiry is in the current window (always later than Now), else the level 1 slot of its window
+static void prv_Place(Com_TimerWheelType* W, Com_TimerIdType Id)
+{
+	uint32 e = W->Expiry[Id];
+	uint8 slot;
+
+	if(((e ^ W->Now) >> COM_CFG_TIMER_L0_BITS) == 0u)	slot = (uint8)(e & COM_TIMER_L0_MASK);
+	else												slot = (uint8)(COM_TIMER_L0_SLOTS + ((e >> COM_CFG_TIMER_L0_BITS) & COM_TIMER_L1_MASK));
+
+	// push front
+	W->Slot[Id]	= slot;
+	W->Prev[Id]	= COM_TIMER_NONE;
+	W->Next[Id]	= W->SlotHead[slot];
+	if(W->SlotHead[slot] != COM_TIMER_NONE) W->Prev[W->SlotHead[slot]] = Id;
+	W->SlotHead[slot] = Id;
+}
+
+void Com_TimerInit(Com_TimerWheelType* Wheel, Com_TimerExpiredType Expired)
+{
+	uint16 i;
+
+	for(i = 0u; i < (COM_TIMER_L0_SLOTS + COM_TIMER_L1_SLOTS); i++) Wheel->SlotHead[i] = COM_TIMER_NONE;
+	for(i = 0u; i < COM_CFG_TIMER_MAX; i++)
+	{
+		Wheel->Next[i]		= COM_TIMER_NONE;
+		Wheel->Prev[i]		= COM_TIMER_NONE;
+		Wheel->ExpNext[i]	= COM_TIMER_NONE;
+		Wheel->State[i]		= COM_TIMER_IDLE;
+		Wheel->Expiry[i]	= 0u;
+	}
+	Wheel->Now		= 0u;
+	Wheel->Expired	= Expired;
+}
+
+Std_ReturnType Com_TimerStart(Com_TimerWheelType* Wheel, Com_TimerIdType Id, uint32 Ticks)
+{
+	if(Id >= COM_CFG_TIMER_MAX) return E_NOT_OK;
+	if(Wheel->State[Id] == COM_TIMER_RUNNING) prv_Unlink(Wheel, Id);
+	if(Ticks == 0u) Ticks = 1u;
+
+	Wheel->Expiry[Id]	= Wheel->Now + Ticks;
+	Wheel->State[Id]	= COM_TIMER_RUNNING;
+	prv_Place(Wheel, Id);
+	return E_OK;
+}
+
+void Com_TimerStop(Com_TimerWheelType* Wheel, Com_TimerIdType Id)
+{
+	if(Id >= COM_CFG_TIMER_MAX) return;
+
+	if(Wheel->State[Id] == COM_TIMER_RUNNING) prv_Unlink(Wheel, Id);
+	Wheel->State[Id] = COM_TIMER_IDLE;			// an EXPIRING one loses its pending callback
+}
+
+boolean Com_TimerIsRunning(const Com_TimerWheelType* Wheel, Com_TimerIdType Id)
+{
+	if(Id >= COM_CFG_TIMER_MAX) return FALSE;
+	return (Wheel->State[Id] == COM_TIMER_RUNNING) ? TRUE : FALSE;
+}
+
+void Com_TimerTick(Com_TimerWheelType* Wheel)
+{
+	Com_TimerIdType id;
+	Com_TimerIdType next;
+	Com_TimerIdType expHead = COM_TIMER_NONE;
+	Com_TimerIdType expTail = COM_TIMER_NONE;
+	uint8 slot;
+
+	Wheel->Now++;
+
+	// 1. new window: its level 1 slot moves down (entries a whole level 1 turn away go back up)
+	if((Wheel->Now & COM_TIMER_L0_MASK) == 0u)
+	{
+		slot					= (uint8)(COM_TIMER_L0_SLOTS + ((Wheel->Now >> COM_CFG_TIMER_L0_BITS) & COM_TIMER_L1_MASK));
+		id						= Wheel->SlotHead[slot];
+		Wheel->SlotHead[slot]	= COM_TIMER_NONE;
+
+		for(; id != COM_TIMER_NONE; id = next)
+		{
+			next = Wheel->Next[id];
+			prv_Place(Wheel, id);
+		}
+	}
+
+	// 2. collect the level 0 slot, all of it is due now. The callbacks may relink the wheel, so none runs yet
+	slot					= (uint8)(Wheel->Now & COM_TIMER_L0_MASK);
+	id						= Wheel->SlotHead[slot];
+	Wheel->SlotHead[slot]	= COM_TIMER_NONE;
+
+	for(; id != COM_TIMER_NONE; id = next)
+	{
+		next = Wheel->Next[id];
+
+		Wheel->State[id]	= COM_TIMER_EXPIRING;
+		Wheel->ExpNext[id]	= COM_TIMER_NONE;
+		if(expTail != COM_TIMER_NONE)	Wheel->ExpNext[expTail]	= id;
+		else							expHead					= id;
+		expTail = id;
+	}
+
+	// 3. fire: skip the ones a previous callback stopped or restarted
+	for(id = expHead; id != COM_TIMER_NONE; id = next)
+	{
+		next = Wheel->ExpNext[id];
+
+		if(Wheel->State[id] != COM_TIMER_EXPIRING) continue;
+		Wheel->State[id] = COM_TIMER_IDLE;
+		if(Wheel->Expired != NULL_PTR) Wheel->Expired(id);
+	}
+}
@@ -0,0 +1,75 @@
+/* =====================================================================================================================
+ *  File        : Com_Timer.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Hierarchical timer wheel for Com deadline monitoring
+ * 					- level 0: one slot per tick for the current window of 2^L0_BITS ticks
+ * 					- level 1: one slot per window, a slot is moved down to level 0 when its window starts
+ * 					- timers are doubly linked by id, start / stop O(1); a tick touches only the timers due in it
+ * 					  plus, once per window, the ones moving down. Neither grows with the number armed
+ * 					- deadlines beyond both levels stay on level 1 and are looked at once per level 1 turn
+ * 					- the expiry callback may start or stop any timer, including the one that expired
+ * 					- not reentrant: start / stop / tick from the same context
+ *  Depends     : Std_Types.h, Com_Cfg.h
+ * ===================================================================================================================*/
+
+#ifndef COM_COM_TIMER_H_
+#define COM_COM_TIMER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Com_Cfg.h"
+
+/* =========================================================
+ *  Types
+ * =======================================================*/
+typedef uint8 Com_TimerIdType;
+
+#define COM_TIMER_NONE					((Com_TimerIdType)0xFFu)
+
+#define COM_TIMER_L0_SLOTS				(1u << COM_CFG_TIMER_L0_BITS)
+#define COM_TIMER_L1_SLOTS				(1u << COM_CFG_TIMER_L1_BITS)
+
+typedef void (*Com_TimerExpiredType)(Com_TimerIdType Id);
+
+typedef struct
+{
+	Com_TimerIdType			SlotHead[COM_TIMER_L0_SLOTS + COM_TIMER_L1_SLOTS];	// level 0, then level 1
+	Com_TimerIdType			Next[COM_CFG_TIMER_MAX];
+	Com_TimerIdType			Prev[COM_CFG_TIMER_MAX];
+	Com_TimerIdType			ExpNext[COM_CFG_TIMER_MAX];		// expired list of the running tick
+	uint8					Slot[COM_CFG_TIMER_MAX];
+	uint8					State[COM_CFG_TIMER_MAX];
+	uint32					Expiry[COM_CFG_TIMER_MAX];		// absolute tick
+	uint32					Now;
+	Com_TimerExpiredType	Expired;
+} Com_TimerWheelType;
+
+/* =========================================================
+ *  API
+ * =======================================================*/
+// All timers stopped, Expired is called from Com_TimerTick
+void Com_TimerInit(Com_TimerWheelType* Wheel, Com_TimerExpiredType Expired);
+
+/**
+ * @brief  (Re)start: expires on the Ticks-th call of Com_TimerTick from now (0 counts as 1)
+ * @return E_NOT_OK: id out of range
+ */
+Std_ReturnType Com_TimerStart(Com_TimerWheelType* Wheel, Com_TimerIdType Id, uint32 Ticks);
+
+// No-op when not running
+void Com_TimerStop(Com_TimerWheelType* Wheel, Com_TimerIdType Id);
+
+boolean Com_TimerIsRunning(const Com_TimerWheelType* Wheel, Com_TimerIdType Id);
+
+// Advance one tick, expired timers are stopped before their callback
+void Com_TimerTick(Com_TimerWheelType* Wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COM_COM_TIMER_H_ */
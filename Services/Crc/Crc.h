@@ -0,0 +1,52 @@
+/* =====================================================================================================================
+ *  File        : Crc.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : CRC library (table driven)
+ * 					- CRC8 SAE J1850: poly 0x1D, init 0xFF, no reflection, final xor 0xFF
+ * 					- CRC16 CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection, no final xor
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef CRC_CRC_H_
+#define CRC_CRC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define CRC_VENDOR_ID						(0x00u)
+#define CRC_MODULE_ID						(0xC9u)
+
+#define CRC_SW_MAJOR_VERSION				(1u)
+#define CRC_SW_MINOR_VERSION				(1u)
+#define CRC_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       CONSTANTS
+ * ============================== */
+#define CRC_INITIAL_VALUE8					(0xFFu)
+#define CRC_XOR_VALUE8						(0xFFu)
+#define CRC_INITIAL_VALUE16					(0xFFFFu)
+
+/* ==============================
+ *       API
+ * ============================== */
+// CRC8 over Crc_Length bytes. IsFirstCall = TRUE starts from CRC_INITIAL_VALUE8,
+// FALSE continues from Crc_StartValue8 (result of previous call, final xor included)
+uint8 Crc_CalculateCRC8(const uint8* Crc_DataPtr, uint32 Crc_Length, uint8 Crc_StartValue8, boolean Crc_IsFirstCall);
+
+// CRC16 over Crc_Length bytes. IsFirstCall = TRUE starts from CRC_INITIAL_VALUE16,
+// FALSE continues from Crc_StartValue16 (result of previous call) so a record can be fed in pieces
+uint16 Crc_CalculateCRC16(const uint8* Crc_DataPtr, uint32 Crc_Length, uint16 Crc_StartValue16, boolean Crc_IsFirstCall);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_CRC_H_ */
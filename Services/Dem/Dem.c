@@ -0,0 +1,371 @@
+/* =====================================================================================================================
+ *  File        : Dem.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Diagnostic event manager: debouncing, UDS status byte, occurrence counter, event memory
+ *  Notes       : Dem_SetEventStatus and Dem_MainFunction run in the 10 ms block of the main loop, no locking.
+ * 				  Per event 4 bytes of state, per event memory entry 8 bytes.
+ *  Depends     : Dem.h, Dem_Cfg.h, Det.h, NvM.h
+ * ===================================================================================================================*/
+
+#include "Dem.h"
+#include "Dem_Cfg.h"
+#include "NvM.h"
+#include <string.h>
+
+#define DEM_TICKS(_ms)						((uint16)(((_ms) + DEM_CFG_MAINFUNCTION_PERIOD_MS - 1u) / DEM_CFG_MAINFUNCTION_PERIOD_MS))
+#define DEM_TIMER_MAX						(0x1FFFu)	// 13 bit timer of Dem_EventStateType
+
+#define DEM_STATUS_INIT						(DEM_UDS_STATUS_TNCSLC | DEM_UDS_STATUS_TNCTOC)
+#define DEM_STATUS_NV						(DEM_UDS_STATUS_PDTC | DEM_UDS_STATUS_CDTC | DEM_UDS_STATUS_TNCSLC | DEM_UDS_STATUS_TFSLC)
+
+// Time-based debounce direction, kept in Counter
+#define DEM_DIR_NONE						(0)
+#define DEM_DIR_FAILING						(1)
+#define DEM_DIR_PASSING						(-1)
+
+typedef struct
+{
+	uint8	Status;							// DEM_UDS_STATUS_*
+	sint8	Counter;						// counter based: debounce counter, time based: DEM_DIR_*
+	uint16	Timer	: 13;					// time based: main function calls left, 0: not running
+	uint16	Slot	: 3;					// event memory entry + 1, 0: not stored
+} Dem_EventStateType;
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static const Dem_ConfigType*	s_cfg		= NULL_PTR;
+static Dem_EventStateType		s_events[DEM_CFG_EVENT_COUNT];
+static Dem_MemoryEntryType		s_memory[DEM_CFG_MEMORY_SIZE];
+static uint16					s_overflow	= 0u;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static void prv_ResetDebounce(Dem_EventStateType* Ev)
+{
+	Ev->Counter	= 0;
+	Ev->Timer	= 0u;
+}
+
+// Free entry, else the oldest one of an event that is not failed any more. NULL_PTR: full of failed events
+static Dem_MemoryEntryType* prv_AllocEntry(void)
+{
+	Dem_MemoryEntryType* oldest = NULL_PTR;
+	uint8 i;
+
+	for(i = 0u; i < DEM_CFG_MEMORY_SIZE; i++)
+	{
+		Dem_MemoryEntryType* m = &s_memory[i];
+
+		if(m->Used == 0u) return m;
+		if((s_events[m->EventId].Status & DEM_UDS_STATUS_TF) != 0u) continue;
+		if((oldest == NULL_PTR) || ((sint32)(m->TimestampMs - oldest->TimestampMs) < 0)) oldest = m;
+	}
+
+	if(oldest != NULL_PTR) s_events[oldest->EventId].Slot = 0u;
+	return oldest;
+}
+
+static void prv_Store(Dem_EventIdType EventId, Dem_EventStateType* Ev)
+{
+	Dem_MemoryEntryType* m;
+
+	if(Ev->Slot != 0u)
+	{
+		m = &s_memory[Ev->Slot - 1u];
+		if(m->Occurrence < 0xFFu) m->Occurrence++;
+		return;
+	}
+
+	m = prv_AllocEntry();
+	if(m == NULL_PTR)
+	{
+		if(s_overflow < 0xFFFFu) s_overflow++;
+		return;
+	}
+
+	m->TimestampMs	= (s_cfg->GetTimeMs != NULL_PTR) ? s_cfg->GetTimeMs() : 0u;
+	m->Distance		= (s_cfg->GetDistance != NULL_PTR) ? s_cfg->GetDistance() : 0xFFFFu;
+	m->SensorStatus	= (s_cfg->GetSensorStatus != NULL_PTR) ? (uint8)(s_cfg->GetSensorStatus() & 0x7u) : 0u;
+	m->EventId		= (uint8)(EventId & 0xFu);
+	m->Used			= 1u;
+	m->Occurrence	= 1u;
+	Ev->Slot		= (uint16)((m - s_memory) + 1);
+}
+
+static void prv_Failed(Dem_EventIdType EventId, Dem_EventStateType* Ev)
+{
+	boolean wasFailed = ((Ev->Status & DEM_UDS_STATUS_TF) != 0u) ? TRUE : FALSE;
+
+	Ev->Status |= (uint8)(DEM_UDS_STATUS_TF | DEM_UDS_STATUS_TFTOC | DEM_UDS_STATUS_PDTC |
+						  DEM_UDS_STATUS_CDTC | DEM_UDS_STATUS_TFSLC);
+	Ev->Status &= (uint8)~(DEM_UDS_STATUS_TNCSLC | DEM_UDS_STATUS_TNCTOC);
+
+	// an occurrence is the change to failed, a monitor repeating FAILED is one
+	if(wasFailed == FALSE) prv_Store(EventId, Ev);
+}
+
+static void prv_Passed(Dem_EventStateType* Ev)
+{
+	Ev->Status &= (uint8)~(DEM_UDS_STATUS_TF | DEM_UDS_STATUS_TNCSLC | DEM_UDS_STATUS_TNCTOC);
+}
+
+static void prv_Counter(const Dem_EventCfgType* Cfg, Dem_EventIdType EventId, Dem_EventStateType* Ev, Dem_EventStatusType Status)
+{
+	sint16 c = Ev->Counter;
+
+	switch(Status)
+	{
+	case DEM_EVENT_STATUS_PREFAILED:	c += Cfg->IncStep;			break;
+	case DEM_EVENT_STATUS_PREPASSED:	c -= Cfg->DecStep;			break;
+	case DEM_EVENT_STATUS_FAILED:		c = Cfg->FailThreshold;		break;
+	default:							c = Cfg->PassThreshold;		break;
+	}
+
+	if(c >= Cfg->FailThreshold)
+	{
+		Ev->Counter = Cfg->FailThreshold;
+		prv_Failed(EventId, Ev);
+	} else if(c <= Cfg->PassThreshold) {
+		Ev->Counter = Cfg->PassThreshold;
+		prv_Passed(Ev);
+	} else {
+		Ev->Counter = (sint8)c;
+	}
+}
+
+static void prv_Time(const Dem_EventCfgType* Cfg, Dem_EventIdType EventId, Dem_EventStateType* Ev, Dem_EventStatusType Status)
+{
+	switch(Status)
+	{
+	case DEM_EVENT_STATUS_PREFAILED:
+		// a running fail timer keeps running, a result in the other direction restarts it
+		if(Ev->Counter != DEM_DIR_FAILING)
+		{
+			Ev->Counter	= DEM_DIR_FAILING;
+			Ev->Timer	= DEM_TICKS(Cfg->FailTimeMs);
+			if(Ev->Timer == 0u) prv_Failed(EventId, Ev);
+		}
+		break;
+
+	case DEM_EVENT_STATUS_PREPASSED:
+		if(Ev->Counter != DEM_DIR_PASSING)
+		{
+			Ev->Counter	= DEM_DIR_PASSING;
+			Ev->Timer	= DEM_TICKS(Cfg->PassTimeMs);
+			if(Ev->Timer == 0u) prv_Passed(Ev);
+		}
+		break;
+
+	case DEM_EVENT_STATUS_FAILED:
+		Ev->Counter	= DEM_DIR_FAILING;
+		Ev->Timer	= 0u;
+		prv_Failed(EventId, Ev);
+		break;
+
+	default:
+		Ev->Counter	= DEM_DIR_PASSING;
+		Ev->Timer	= 0u;
+		prv_Passed(Ev);
+		break;
+	}
+}
+
+// Stored status and event memory over the cleared state, the operation cycle starts untested
+static void prv_Restore(void)
+{
+	Dem_NvDataType nv;
+	uint8 i;
+
+	if(NvM_ReadBlock(NVM_BLOCK_DEM, &nv) != E_OK) return;
+
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++)
+	{
+		s_events[i].Status = (uint8)((nv.Status[i] & DEM_STATUS_NV) | DEM_UDS_STATUS_TNCTOC);
+	}
+	for(i = 0u; i < DEM_CFG_MEMORY_SIZE; i++)
+	{
+		if((nv.Memory[i].Used == 0u) || (nv.Memory[i].EventId >= DEM_CFG_EVENT_COUNT)) continue;
+
+		s_memory[i]							= nv.Memory[i];
+		s_events[s_memory[i].EventId].Slot	= (uint16)(i + 1u);
+	}
+	s_overflow = nv.Overflow;
+}
+
+// NvM copies the image only when it differs from the stored one
+static void prv_Persist(void)
+{
+	Dem_NvDataType nv;
+	uint8 i;
+
+	memset(&nv, 0, sizeof(nv));
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++) nv.Status[i] = (uint8)(s_events[i].Status & DEM_STATUS_NV);
+	memcpy(nv.Memory, s_memory, sizeof(nv.Memory));
+	nv.Overflow = s_overflow;
+	(void)NvM_WriteBlock(NVM_BLOCK_DEM, &nv);
+}
+
+static boolean prv_ConfigValid(const Dem_ConfigType* ConfigPtr)
+{
+	uint8 i;
+
+	if((ConfigPtr->Events == NULL_PTR) || (ConfigPtr->EventCount != DEM_CFG_EVENT_COUNT)) return FALSE;
+
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++)
+	{
+		const Dem_EventCfgType* e = &ConfigPtr->Events[i];
+
+		if(e->Debounce == DEM_DEBOUNCE_COUNTER)
+		{
+			if((e->FailThreshold <= 0) || (e->PassThreshold > 0) || (e->IncStep == 0u) || (e->DecStep == 0u)) return FALSE;
+		} else if((DEM_TICKS(e->FailTimeMs) > DEM_TIMER_MAX) || (DEM_TICKS(e->PassTimeMs) > DEM_TIMER_MAX)) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void Dem_Init(const Dem_ConfigType* ConfigPtr)
+{
+	if(ConfigPtr == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_INIT, DEM_E_PARAM_POINTER);
+		return;
+	}
+	if(prv_ConfigValid(ConfigPtr) == FALSE)
+	{
+		DEM_DET_REPORT(DEM_API_ID_INIT, DEM_E_WRONG_CONFIGURATION);
+		return;
+	}
+
+	s_cfg = ConfigPtr;
+	Dem_ClearDTC();
+	prv_Restore();
+}
+
+Std_ReturnType Dem_SetEventStatus(Dem_EventIdType EventId, Dem_EventStatusType EventStatus)
+{
+	const Dem_EventCfgType* cfg;
+
+	if(s_cfg == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_SETEVENTSTATUS, DEM_E_UNINIT);
+		return E_NOT_OK;
+	}
+	if((EventId >= DEM_CFG_EVENT_COUNT) || (EventStatus > DEM_EVENT_STATUS_PREFAILED))
+	{
+		DEM_DET_REPORT(DEM_API_ID_SETEVENTSTATUS, DEM_E_PARAM_DATA);
+		return E_NOT_OK;
+	}
+
+	cfg = &s_cfg->Events[EventId];
+	if(cfg->Debounce == DEM_DEBOUNCE_COUNTER)	prv_Counter(cfg, EventId, &s_events[EventId], EventStatus);
+	else										prv_Time(cfg, EventId, &s_events[EventId], EventStatus);
+	return E_OK;
+}
+
+Std_ReturnType Dem_GetEventStatus(Dem_EventIdType EventId, uint8* UdsStatusPtr)
+{
+	if(UdsStatusPtr == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_GETEVENTSTATUS, DEM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+	if((s_cfg == NULL_PTR) || (EventId >= DEM_CFG_EVENT_COUNT)) return E_NOT_OK;
+
+	*UdsStatusPtr = s_events[EventId].Status;
+	return E_OK;
+}
+
+Std_ReturnType Dem_GetMemoryEntry(uint8 Index, Dem_MemoryEntryType* EntryPtr)
+{
+	if(EntryPtr == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_GETMEMORYENTRY, DEM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+	if((s_cfg == NULL_PTR) || (Index >= DEM_CFG_MEMORY_SIZE) || (s_memory[Index].Used == 0u)) return E_NOT_OK;
+
+	*EntryPtr = s_memory[Index];
+	return E_OK;
+}
+
+Std_ReturnType Dem_GetEventMemoryEntry(Dem_EventIdType EventId, Dem_MemoryEntryType* EntryPtr)
+{
+	if((s_cfg == NULL_PTR) || (EventId >= DEM_CFG_EVENT_COUNT) || (s_events[EventId].Slot == 0u)) return E_NOT_OK;
+
+	return Dem_GetMemoryEntry((uint8)(s_events[EventId].Slot - 1u), EntryPtr);
+}
+
+uint16 Dem_GetOverflowCount(void)
+{
+	return s_overflow;
+}
+
+void Dem_ClearDTC(void)
+{
+	uint8 i;
+
+	if(s_cfg == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_CLEARDTC, DEM_E_UNINIT);
+		return;
+	}
+
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++)
+	{
+		s_events[i].Status	= DEM_STATUS_INIT;
+		s_events[i].Slot	= 0u;
+		prv_ResetDebounce(&s_events[i]);
+	}
+	memset(s_memory, 0, sizeof(s_memory));
+	s_overflow = 0u;
+}
+
+void Dem_RestartOperationCycle(void)
+{
+	uint8 i;
+
+	if(s_cfg == NULL_PTR)
+	{
+		DEM_DET_REPORT(DEM_API_ID_RESTARTOPERATIONCYCLE, DEM_E_UNINIT);
+		return;
+	}
+
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++)
+	{
+		Dem_EventStateType* ev = &s_events[i];
+
+		// tested through the whole cycle without failing: no longer pending
+		if((ev->Status & (DEM_UDS_STATUS_TNCTOC | DEM_UDS_STATUS_TFTOC)) == 0u) ev->Status &= (uint8)~DEM_UDS_STATUS_PDTC;
+
+		ev->Status &= (uint8)~DEM_UDS_STATUS_TFTOC;
+		ev->Status |= DEM_UDS_STATUS_TNCTOC;
+		prv_ResetDebounce(ev);
+	}
+}
+
+void Dem_MainFunction(void)
+{
+	uint8 i;
+
+	if(s_cfg == NULL_PTR) return;
+
+	for(i = 0u; i < DEM_CFG_EVENT_COUNT; i++)
+	{
+		Dem_EventStateType* ev = &s_events[i];
+
+		if((ev->Timer == 0u) || (--ev->Timer != 0u)) continue;
+
+		if(ev->Counter == DEM_DIR_FAILING)	prv_Failed(i, ev);
+		else								prv_Passed(ev);
+	}
+
+	prv_Persist();
+}
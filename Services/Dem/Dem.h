@@ -0,0 +1,184 @@
+/* =====================================================================================================================
+ *  File        : Dem.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Diagnostic event manager: debounced monitor results, UDS status bits, event memory with freeze frame
+ * 					- Dem_SetEventStatus: pre-failed / pre-passed results are debounced per event, counter based
+ * 					  (steps towards a threshold, in the call) or time based (Dem_MainFunction)
+ * 					- qualified failed: TF, TFTOC, PDTC, CDTC, TFSLC set; occurrence counted, first failure stored with
+ * 					  a freeze frame (timestamp, distance, SensorSupervisor status)
+ * 					- Dem_RestartOperationCycle: TFTOC / TNCTOC restart, PDTC cleared after a cycle tested without failure
+ * 					- PDTC, CDTC, TNCSLC, TFSLC and the event memory are kept in the NvM block NVM_BLOCK_DEM, written
+ * 					  behind by Dem_MainFunction when they change
+ * 					- no confirmation threshold (1 failed cycle), no aging
+ *  Depends     : Std_Types.h, Dem_Cfg.h, Det.h
+ * ===================================================================================================================*/
+
+#ifndef DEM_DEM_H_
+#define DEM_DEM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Dem_Cfg.h"
+#include "Det.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define DEM_VENDOR_ID						(0x00u)
+#define DEM_MODULE_ID						(0x36u)
+#define DEM_INSTANCE_ID						(0x00u)
+
+#define DEM_SW_MAJOR_VERSION				(1u)
+#define DEM_SW_MINOR_VERSION				(0u)
+#define DEM_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       BUILD-TIME SWITCHES
+ * ============================== */
+#ifndef DEM_DEV_ERROR_DETECT
+#define DEM_DEV_ERROR_DETECT				STD_ON
+#endif
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define DEM_API_ID_INIT						(0x02u)
+#define DEM_API_ID_SETEVENTSTATUS			(0x04u)
+#define DEM_API_ID_RESTARTOPERATIONCYCLE	(0x08u)
+#define DEM_API_ID_GETEVENTSTATUS			(0x0Au)
+#define DEM_API_ID_CLEARDTC					(0x23u)
+#define DEM_API_ID_MAINFUNCTION				(0x55u)
+#define DEM_API_ID_GETMEMORYENTRY			(0x60u)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define DEM_E_WRONG_CONFIGURATION			(0x10u)
+#define DEM_E_PARAM_POINTER					(0x11u)
+#define DEM_E_PARAM_DATA					(0x12u)
+#define DEM_E_UNINIT						(0x20u)
+
+#if (DEM_DEV_ERROR_DETECT == STD_ON)
+#define DEM_DET_REPORT(_api, _err)\
+	Det_ReportError(DEM_MODULE_ID, DEM_INSTANCE_ID, (_api), (_err))
+#else
+#define DEM_DET_REPORT(_api, _err) ((void)0)
+#endif
+
+/* ==============================
+ *       UDS STATUS BITS
+ * ============================== */
+#define DEM_UDS_STATUS_TF					(0x01u)		// test failed (last qualified result)
+#define DEM_UDS_STATUS_TFTOC				(0x02u)		// test failed this operation cycle
+#define DEM_UDS_STATUS_PDTC					(0x04u)		// pending: failed this or the last completed cycle
+#define DEM_UDS_STATUS_CDTC					(0x08u)		// confirmed
+#define DEM_UDS_STATUS_TNCSLC				(0x10u)		// test not completed since last clear
+#define DEM_UDS_STATUS_TFSLC				(0x20u)		// test failed since last clear
+#define DEM_UDS_STATUS_TNCTOC				(0x40u)		// test not completed this operation cycle
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+typedef uint8 Dem_EventIdType;
+
+typedef enum
+{
+	DEM_EVENT_STATUS_PASSED			= 0,	// qualified, no debouncing
+	DEM_EVENT_STATUS_FAILED,
+	DEM_EVENT_STATUS_PREPASSED,				// debounced towards passed
+	DEM_EVENT_STATUS_PREFAILED				// debounced towards failed
+} Dem_EventStatusType;
+
+typedef enum
+{
+	DEM_DEBOUNCE_COUNTER			= 0,
+	DEM_DEBOUNCE_TIME
+} Dem_DebounceType;
+
+typedef struct
+{
+	Dem_DebounceType	Debounce;
+	sint8				FailThreshold;		// counter: FAILED at >= (1 .. 127)
+	sint8				PassThreshold;		// counter: PASSED at <= (-128 .. 0)
+	uint8				IncStep;			// counter: per pre-failed
+	uint8				DecStep;			// counter: per pre-passed
+	uint16				FailTimeMs;			// time: pre-failed without a pre-passed for this long, FAILED
+	uint16				PassTimeMs;			// time: the other way round
+} Dem_EventCfgType;
+
+typedef struct
+{
+	const Dem_EventCfgType*	Events;				// DEM_CFG_EVENT_COUNT, index = event id
+	uint8					EventCount;
+	uint32					(*GetTimeMs)(void);	// freeze frame sources, called in the failing report
+	uint16					(*GetDistance)(void);
+	uint8					(*GetSensorStatus)(void);
+} Dem_ConfigType;
+
+// Event memory entry, 8 bytes
+typedef struct
+{
+	uint32	TimestampMs;					// freeze frame, first failure since stored
+	uint16	Distance;						// freeze frame, RTE distance (q4 mm, 0xFFFF none)
+	uint8	EventId			: 4;
+	uint8	SensorStatus	: 3;			// freeze frame, SensorSupervisor status
+	uint8	Used			: 1;
+	uint8	Occurrence;						// failed qualifications since stored, saturates at 255
+} Dem_MemoryEntryType;
+
+// NvM block NVM_BLOCK_DEM
+typedef struct
+{
+	uint8				Status[DEM_CFG_EVENT_COUNT];	// persistent status bits only
+	Dem_MemoryEntryType	Memory[DEM_CFG_MEMORY_SIZE];
+	uint16				Overflow;
+} Dem_NvDataType;
+
+/* ==============================
+ *             API
+ * ============================== */
+// Status and event memory from NvM (initialised before), else every event TNCSLC | TNCTOC and event memory
+// empty. First operation cycle started
+void Dem_Init(const Dem_ConfigType* ConfigPtr);
+
+/**
+ * @brief  Monitor result of EventId, constant time, no allocation (a new event memory entry scans
+ *         DEM_CFG_MEMORY_SIZE entries once per failed qualification)
+ * @return E_NOT_OK: not initialised or unknown event
+ */
+Std_ReturnType Dem_SetEventStatus(Dem_EventIdType EventId, Dem_EventStatusType EventStatus);
+
+Std_ReturnType Dem_GetEventStatus(Dem_EventIdType EventId, uint8* UdsStatusPtr);
+
+// Entry Index of the event memory. E_NOT_OK: not initialised, index out of range or entry unused
+Std_ReturnType Dem_GetMemoryEntry(uint8 Index, Dem_MemoryEntryType* EntryPtr);
+
+// Event memory entry of EventId. E_NOT_OK: not stored
+Std_ReturnType Dem_GetEventMemoryEntry(Dem_EventIdType EventId, Dem_MemoryEntryType* EntryPtr);
+
+// Failed events that found the event memory full
+uint16 Dem_GetOverflowCount(void);
+
+// Clear all: status TNCSLC | TNCTOC, debounce state, event memory
+void Dem_ClearDTC(void);
+
+// Operation cycle ends and the next one starts (ignition / power cycle)
+void Dem_RestartOperationCycle(void);
+
+// Time-based debounce, NvM image update. Period DEM_CFG_MAINFUNCTION_PERIOD_MS, same task as the reporting runnables
+void Dem_MainFunction(void);
+
+/* ==============================
+ *       CONFIG
+ * ============================== */
+extern const Dem_ConfigType Dem_Config;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEM_DEM_H_ */
@@ -0,0 +1,54 @@
+/* =====================================================================================================================
+ *  File        : Dem_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of the diagnostic event manager (event IDs, event memory, main function period)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef DEM_DEM_CFG_H_
+#define DEM_DEM_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Event IDs, index of Dem_Config.Events (Dem_PBcfg.c) */
+#define DEM_EVENT_SENSOR_TIMEOUT			(0u)	// Sensor: no echo read back from SensorIf
+#define DEM_EVENT_DISTANCE_INVALID			(1u)	// ObstacleDetection: distance missing or outside the calibration
+#define DEM_EVENT_DISTANCE_MISSING			(2u)	// SensorSupervisor: no distance in the RTE
+#define DEM_EVENT_DISTANCE_RANGE			(3u)	// SensorSupervisor: distance outside 20 .. 4000 mm
+#define DEM_EVENT_NVM_FAILED				(4u)	// NvM: retry limit of failed flash jobs reached
+
+#define DEM_CFG_EVENT_COUNT					(5u)
+
+/* Event memory: entries with freeze frame, an event holds at most one. A new event displaces the oldest entry whose
+ * event is not failed any more, else it is lost (Dem_GetOverflowCount) */
+#ifndef DEM_CFG_MEMORY_SIZE
+#define DEM_CFG_MEMORY_SIZE					(4u)
+#endif
+
+/* Call period of Dem_MainFunction, time-based debounce times are rounded up to it */
+#ifndef DEM_CFG_MAINFUNCTION_PERIOD_MS
+#define DEM_CFG_MAINFUNCTION_PERIOD_MS		(10u)
+#endif
+
+#if (DEM_CFG_MAINFUNCTION_PERIOD_MS == 0u)
+#error "DEM_CFG_MAINFUNCTION_PERIOD_MS must not be 0"
+#endif
+
+#if (DEM_CFG_EVENT_COUNT > 16u)
+#error "DEM_CFG_EVENT_COUNT must fit the 4 bit event id of an event memory entry"
+#endif
+
+#if (DEM_CFG_MEMORY_SIZE == 0u) || (DEM_CFG_MEMORY_SIZE > 7u)
+#error "DEM_CFG_MEMORY_SIZE must be 1 .. 7 (3 bit slot reference of an event)"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEM_DEM_CFG_H_ */
@@ -0,0 +1,55 @@
+/* =====================================================================================================================
+ *  File        : Dem_PBcfg.c
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Event table (debouncing) and freeze frame sources of the diagnostic event manager
+ *  Depends     : Dem.h, Mcu.h, Rte.h, SensorSupervisor.h
+ * ===================================================================================================================*/
+
+#include "Dem.h"
+#include "Dem_Cfg.h"
+#include "Mcu.h"
+#include "Rte.h"
+#include "SensorSupervisor.h"
+
+/* ==============================
+ *       FREEZE FRAME SOURCES
+ * ============================== */
+static uint32 Dem_GetMs(void)
+{
+	return s_systickTicks;
+}
+
+// 0xFFFF while the RTE has no distance
+static uint16 Dem_GetDistance(void)
+{
+	Rte_DistanceType d;
+	return (Rte_Read_Distance(&d) == RTE_E_OK) ? (uint16)d : 0xFFFFu;
+}
+
+static uint8 Dem_GetSensorStatus(void)
+{
+	return (uint8)SensorSupervisor_GetSensorStatus();
+}
+
+/* ==============================
+ *       CONFIG
+ * ============================== */
+// Counter based: per measurement (10 ms runnables), 5 bad ones in a row fail, 2 good ones pass again.
+// Time based: per supervisor call, the state has to last FailTimeMs / PassTimeMs
+// NvM reports qualified results only (FAILED / PASSED), its counter is never used
+static const Dem_EventCfgType Dem_Events[DEM_CFG_EVENT_COUNT] = {
+	[DEM_EVENT_SENSOR_TIMEOUT]		= { .Debounce = DEM_DEBOUNCE_COUNTER,	.FailThreshold = 5,	.PassThreshold = -3,	.IncStep = 1u,	.DecStep = 4u },
+	[DEM_EVENT_DISTANCE_INVALID]	= { .Debounce = DEM_DEBOUNCE_COUNTER,	.FailThreshold = 5,	.PassThreshold = -3,	.IncStep = 1u,	.DecStep = 4u },
+	[DEM_EVENT_DISTANCE_MISSING]	= { .Debounce = DEM_DEBOUNCE_TIME,		.FailTimeMs = 200u,	.PassTimeMs = 50u },
+	[DEM_EVENT_DISTANCE_RANGE]		= { .Debounce = DEM_DEBOUNCE_TIME,		.FailTimeMs = 300u,	.PassTimeMs = 100u },
+	[DEM_EVENT_NVM_FAILED]			= { .Debounce = DEM_DEBOUNCE_COUNTER,	.FailThreshold = 1,	.PassThreshold = -1,	.IncStep = 1u,	.DecStep = 1u },
+};
+
+const Dem_ConfigType Dem_Config = {
+		.Events				= Dem_Events,
+		.EventCount			= DEM_CFG_EVENT_COUNT,
+		.GetTimeMs			= Dem_GetMs,
+		.GetDistance		= Dem_GetDistance,
+		.GetSensorStatus	= Dem_GetSensorStatus
+};
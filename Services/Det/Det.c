@@ -7,13 +7,12 @@
  * ===================================================================================================================*/
 
 #include "Det.h"
-#include <string.h>
-#include <stdio.h>
+#include "Irq.h"
 
 /* ==============================
  *     WEAK HOOK: Timestamp (ms)
  * ============================== */
-#if defined(__GNUC__) || defined(__clag__)
+#if defined(__GNUC__) || defined(__clang__)
 __attribute__((weak))
 #endif
 uint32 Det_GetMs(void)
@@ -21,47 +20,156 @@ uint32 Det_GetMs(void)
 	return 0u;
 }
 
+/* ==============================
+ *     CRITICAL SECTION
+ * ==============================
+ * Det_ReportError may be called from thread and ISR context at the same time.
+ * The ring update is a handful of loads/stores, so it runs with every line masked
+ * (IRQ_ENTER_CRITICAL_ALL) and restores the caller's mask afterwards.
+ */
+
 /* ==============================
  *            STATE
  * ============================== */
 static boolean detInited = FALSE;
 #if (DET_CFG_ENABLE_HISTORY == 1)
+#define DET_HIST_MASK				(DET_CFG_HISTORY_SIZE - 1u)
+#define DET_COUNT_MAX				(0xFFFFu)
+
 static Det_ErrorEntryType 	s_hist[DET_CFG_HISTORY_SIZE];
-static uint16				s_histCount = 0u;
+static uint32				s_head		= 0u;	// sequence of next new entry (free running)
+static uint32				s_flushSeq	= 0u;	// sequence of next entry for Det_FlushNext
+static uint32				s_lastSeq	= 0u;	// sequence of entry touched last
+static uint32				s_dropped	= 0u;
 #endif
 
 /* ==============================
  *       LOCAL HELPERS
  * ============================== */
+#if (DET_CFG_ENABLE_HISTORY == 1)
+static inline uint32 prv_Used(void)
+{
+	return (s_head < DET_CFG_HISTORY_SIZE) ? s_head : DET_CFG_HISTORY_SIZE;
+}
+
+static inline uint32 prv_OldestSeq(void)
+{
+	return s_head - prv_Used();
+}
+#endif
+
 static void prv_Store(uint16 mid, uint8 iid, uint8 api, uint8 err)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	Det_ErrorEntryType e;
-	e.moduleId		= mid;
-	e.instanceId	= iid;
-	e.apiId			= api;
-	e.errorId		= err;
-	e.timestampMs	= Det_GetMs();
-
-	if(s_histCount < DET_CFG_HISTORY_SIZE){
-		s_hist[s_histCount++] = e;
-	} else {
-		//full -> shift to left
-		(void)memmove(&s_hist[0], &s_hist[1], (DET_CFG_HISTORY_SIZE - 1u) * sizeof(Det_ErrorEntryType));
-		s_hist[DET_CFG_HISTORY_SIZE - 1u] = e;
+	uint32 now = Det_GetMs();
+	uint32 sv;
+
+	IRQ_ENTER_CRITICAL_ALL(sv);
+
+	// newest first: a storm of the same error hits on the first compare
+	uint32 used = prv_Used();
+	for(uint32 i = 0u; i < used; i++)
+	{
+		uint32 seq = s_head - 1u - i;
+		Det_ErrorEntryType* e = &s_hist[seq & DET_HIST_MASK];
+
+		if((e->moduleId == mid) && (e->apiId == api) && (e->errorId == err) && (e->instanceId == iid))
+		{
+			if(e->count != DET_COUNT_MAX) e->count++;
+			e->lastMs	= now;
+			s_lastSeq	= seq;
+			IRQ_EXIT_CRITICAL_ALL(sv);
+			return;
+		}
 	}
+
+	// new tuple -> take next slot, oldest one is overwritten when full
+	if(used == DET_CFG_HISTORY_SIZE) s_dropped++;
+
+	Det_ErrorEntryType* e = &s_hist[s_head & DET_HIST_MASK];
+	e->moduleId		= mid;
+	e->instanceId	= iid;
+	e->apiId		= api;
+	e->errorId		= err;
+	e->count		= 1u;
+	e->firstMs		= now;
+	e->lastMs		= now;
+	s_lastSeq		= s_head;
+	s_head++;
+
+	IRQ_EXIT_CRITICAL_ALL(sv);
 #else
-	(void)mid; (void)iid; (void)api; (void)er;
+	(void)mid; (void)iid; (void)api; (void)err;
 #endif
 }
 
+#if (DET_CFG_ENABLE_HISTORY == 1)
+static boolean prv_CopyAt(uint32 seq, Det_ErrorEntryType* out)
+{
+	boolean ok = FALSE;
+	uint32 sv;
+
+	IRQ_ENTER_CRITICAL_ALL(sv);
+	if((s_head - seq - 1u) < prv_Used())
+	{
+		*out = s_hist[seq & DET_HIST_MASK];
+		ok = TRUE;
+	}
+	IRQ_EXIT_CRITICAL_ALL(sv);
+
+	return ok;
+}
+
+/* append decimal value, returns new position */
+static uint32 prv_PutU32(char* buf, uint32 pos, uint32 v)
+{
+	char tmp[10];
+	uint32 n = 0u;
+
+	do {
+		tmp[n++] = (char)('0' + (v % 10u));
+		v /= 10u;
+	} while(v != 0u);
+
+	while(n != 0u) buf[pos++] = tmp[--n];
+	return pos;
+}
+
+static uint32 prv_PutStr(char* buf, uint32 pos, const char* s)
+{
+	while(*s != '\0') buf[pos++] = *s++;
+	return pos;
+}
+
+static void prv_EmitEntry(const Det_ErrorEntryType* e, Det_LineFnType LoggerLineFn)
+{
+	char line[DET_CFG_FLUSH_LINE_SIZE];
+	uint32 p = 0u;
+
+	p = prv_PutStr(line, p, "[DET] MID:");	p = prv_PutU32(line, p, e->moduleId);
+	p = prv_PutStr(line, p, " IID:");		p = prv_PutU32(line, p, e->instanceId);
+	p = prv_PutStr(line, p, " API:");		p = prv_PutU32(line, p, e->apiId);
+	p = prv_PutStr(line, p, " ERR:");		p = prv_PutU32(line, p, e->errorId);
+	p = prv_PutStr(line, p, " CNT:");		p = prv_PutU32(line, p, e->count);
+	p = prv_PutStr(line, p, " TS:");		p = prv_PutU32(line, p, e->firstMs);
+	if(e->count > 1u)
+	{
+		line[p++] = '-';
+		p = prv_PutU32(line, p, e->lastMs);
+	}
+	line[p] = '\0';
+
+	LoggerLineFn(line);
+}
+#endif
+
 /* ==============================
  *       APIs
  * ============================== */
 void Det_Init(void)
 {
 #if(DET_CFG_ENABLE_HISTORY == 1)
-	s_histCount = 0u;
+	Det_ClearHistory();
 #endif
 	detInited = TRUE;
 }
@@ -80,8 +188,8 @@ void Det_ReportError(uint16 ModuleId, uint8 InstanceId, uint8 ApiId, uint8 Error
 boolean Det_GetLastError(Det_ErrorEntryType* out)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	if((out == NULL)|| (s_histCount == 0u))return FALSE;
-	return TRUE;
+	if(out == NULL_PTR) return FALSE;
+	return prv_CopyAt(s_lastSeq, out);
 #else
 	(void)out;
 	return FALSE;
@@ -91,7 +199,7 @@ boolean Det_GetLastError(Det_ErrorEntryType* out)
 uint16 Det_GetHistoryCount(void)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	return s_histCount;
+	return (uint16)prv_Used();
 #else
 	return 0u;
 #endif
@@ -100,47 +208,74 @@ uint16 Det_GetHistoryCount(void)
 boolean Det_GetHistoryAt(uint16 index, Det_ErrorEntryType* out)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	if((out == NULL) | (index >= s_histCount)) return FALSE;
-	*out = s_hist[index];
-	return TRUE;
+	if(out == NULL_PTR) return FALSE;
+	return prv_CopyAt(prv_OldestSeq() + index, out);
 #else
 	(void)index; (void)out;
 	return FALSE;
 #endif
 }
 
+uint32 Det_GetDroppedCount(void)
+{
+#if (DET_CFG_ENABLE_HISTORY == 1)
+	return s_dropped;
+#else
+	return 0u;
+#endif
+}
+
 void Det_ClearHistory(void)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	s_histCount = 0u;
+	uint32 sv;
+
+	IRQ_ENTER_CRITICAL_ALL(sv);
+	s_head		= 0u;
+	s_flushSeq	= 0u;
+	s_lastSeq	= 0u;
+	s_dropped	= 0u;
+	IRQ_EXIT_CRITICAL_ALL(sv);
 #endif
 }
 
-void Det_FlushToLogger(void (*LoggerLineFn)(const char* line))
+void Det_FlushRewind(void)
 {
 #if (DET_CFG_ENABLE_HISTORY == 1)
-	if((LoggerLineFn == NULL) || (s_histCount == 0u)) return;
-	char line[96];
-	for(uint16 i =0; i < s_histCount; i++)
-	{
-		const Det_ErrorEntryType* e = &s_hist[i];
-
-		int n = snprintf(line, sizeof(line),
-						 "[DET] MID:%u IID:%u API:%u ERR:%u TS:%lu",
-						 (unsigned)e->moduleId,
-						 (unsigned)e->instanceId,
-						 (unsigned)e->apiId,
-						 (unsigned)e->errorId,
-						 (unsigned long)e->timestampMs);
-		if(n<0){
-			(void)snprintf(line,sizeof(line), "[DET] MID:%u ERR:%u",
-							(unsigned)e->moduleId,(unsigned)e->errorId);
-		}
-		LoggerLineFn(line);
-	}
+	s_flushSeq = prv_OldestSeq();
+#endif
+}
+
+boolean Det_FlushNext(Det_LineFnType LoggerLineFn)
+{
+#if (DET_CFG_ENABLE_HISTORY == 1)
+	Det_ErrorEntryType e;
+
+	if(LoggerLineFn == NULL_PTR) return FALSE;
+
+	// entries overwritten since last call are skipped
+	if((s_head - s_flushSeq) > prv_Used()) s_flushSeq = prv_OldestSeq();
+
+	if(prv_CopyAt(s_flushSeq, &e) == FALSE) return FALSE;
+	s_flushSeq++;
+
+	prv_EmitEntry(&e, LoggerLineFn);
+
+	return (s_flushSeq != s_head) ? TRUE : FALSE;
 #else
 	(void)LoggerLineFn;
+	return FALSE;
 #endif
 }
 
+void Det_FlushToLogger(Det_LineFnType LoggerLineFn)
+{
+#if (DET_CFG_ENABLE_HISTORY == 1)
+	if(LoggerLineFn == NULL_PTR) return;
 
+	Det_FlushRewind();
+	while(Det_FlushNext(LoggerLineFn) == TRUE) {}
+#else
+	(void)LoggerLineFn;
+#endif
+}
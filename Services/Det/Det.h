@@ -38,25 +38,42 @@ extern "C" {
 #define DET_CFG_ENABLE_HISTORY				(1u)
 #endif
 
+// Ring depth, must be a power of two
 #ifndef DET_CFG_HISTORY_SIZE
-#define DET_CFG_HISTORY_SIZE				(1u)
+#define DET_CFG_HISTORY_SIZE				(8u)
 #endif
 
 #ifndef DET_CFG_HALT_ON_ERROR
 #define DET_CFG_HALT_ON_ERROR				(0u)
 #endif
 
+// Line buffer used by the flush path (worst case line is 74 chars + NUL)
+#ifndef DET_CFG_FLUSH_LINE_SIZE
+#define DET_CFG_FLUSH_LINE_SIZE				(80u)
+#endif
+
+#if (DET_CFG_ENABLE_HISTORY == 1)
+#if ((DET_CFG_HISTORY_SIZE == 0u) || ((DET_CFG_HISTORY_SIZE & (DET_CFG_HISTORY_SIZE - 1u)) != 0u))
+#error "DET_CFG_HISTORY_SIZE must be a power of two"
+#endif
+#endif
+
 /* ==============================
  *      TYPES
  * ============================== */
+// One entry per distinct (module, instance, api, error) tuple, repeats are counted
 typedef struct {
 	uint16 moduleId;
 	uint8 instanceId;
 	uint8 apiId;
 	uint8 errorId;
-	uint32 timestampMs;
+	uint16 count;		// occurrences, saturates at 0xFFFF
+	uint32 firstMs;		// timestamp of first occurrence
+	uint32 lastMs;		// timestamp of latest occurrence
 } Det_ErrorEntryType;
 
+typedef void (*Det_LineFnType)(const char* line);
+
 /* ==============================
  *              API
  * ============================== */
@@ -66,19 +83,29 @@ void Det_Init(void);
 // API for module notify Error
 void Det_ReportError(uint16 ModuleId, uint8 InstanceId, uint8 ApiId, uint8 ErrorId);
 
-// get last log error
+// get last reported error (entry touched most recently)
 boolean Det_GetLastError(Det_ErrorEntryType* out);
 
 // get count number of history error
 uint16 Det_GetHistoryCount(void);
 
-// Get version
+// get entry by index, 0 = oldest
 boolean Det_GetHistoryAt(uint16 index, Det_ErrorEntryType* out);
+
+// number of entries overwritten because the ring was full
+uint32 Det_GetDroppedCount(void);
+
 // delete history Error
 void Det_ClearHistory(void);
 
 // Push all history to backend logging
-void Det_FlushToLogger(void (*LoggerLineFn)(const char* line));
+void Det_FlushToLogger(Det_LineFnType LoggerLineFn);
+
+// Push one entry not yet flushed, returns TRUE while more entries are pending
+boolean Det_FlushNext(Det_LineFnType LoggerLineFn);
+
+// Restart Det_FlushNext from the oldest entry
+void Det_FlushRewind(void);
 
 #ifdef __cplusplus
 }
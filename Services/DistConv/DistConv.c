@@ -0,0 +1,197 @@
+/* =====================================================================================================================
+ *  File        : DistConv.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Echo time -> distance conversion (reciprocal multiply, no division on the hot path)
+ *  Depends     : DistConv.h, Rte.h (ambient inputs)
+ * ===================================================================================================================*/
+
+#include "DistConv.h"
+#include "Rte.h"
+
+/* ==============================
+ *       DRY AIR TABLE (compile time)
+ * ==============================
+ * c(T) = 331.3 m/s * sqrt(1 + T / 273.15)
+ * sqrt(1+x) by its Taylor series up to x^5 (Horner, Q30), |x| <= 0.32 -> rel. error < 2e-5.
+ * The preprocessor expands one entry per whole degC, nothing is computed at run time.
+ */
+#define DISTCONV_LUT_T0						(-40)		// degC of first entry
+#define DISTCONV_LUT_TN						(87)		// degC of last entry
+#define DISTCONV_LUT_SIZE					(DISTCONV_LUT_TN - DISTCONV_LUT_T0 + 1)
+
+#define DISTCONV_Q30						(1073741824LL)
+#define DISTCONV_X(_t)						(((sint64)(_t) * DISTCONV_Q30 * 20) / 5463)	// T / 273.15
+#define DISTCONV_H5(_x)						((-(5 * DISTCONV_Q30) / 128) + ((7 * (_x)) / 256))
+#define DISTCONV_H4(_x)						((DISTCONV_Q30 / 16) + (((_x) * DISTCONV_H5(_x)) / DISTCONV_Q30))
+#define DISTCONV_H3(_x)						((-DISTCONV_Q30 / 8) + (((_x) * DISTCONV_H4(_x)) / DISTCONV_Q30))
+#define DISTCONV_H2(_x)						((DISTCONV_Q30 / 2) + (((_x) * DISTCONV_H3(_x)) / DISTCONV_Q30))
+#define DISTCONV_SQRT1P(_x)					(DISTCONV_Q30 + (((_x) * DISTCONV_H2(_x)) / DISTCONV_Q30))
+#define DISTCONV_SOS_DRY_MMS(_t)			((331300LL * DISTCONV_SQRT1P(DISTCONV_X(_t))) / DISTCONV_Q30)
+#define DISTCONV_KDRY(_t)					DISTCONV_K_FROM_SOS_MMS(DISTCONV_SOS_DRY_MMS(_t))
+
+#define DISTCONV_ROW8(_t)					DISTCONV_KDRY((_t)),     DISTCONV_KDRY((_t) + 1), \
+											DISTCONV_KDRY((_t) + 2), DISTCONV_KDRY((_t) + 3), \
+											DISTCONV_KDRY((_t) + 4), DISTCONV_KDRY((_t) + 5), \
+											DISTCONV_KDRY((_t) + 6), DISTCONV_KDRY((_t) + 7)
+
+static const uint32 DistConv_KDryLut[DISTCONV_LUT_SIZE] =
+{
+	DISTCONV_ROW8(-40), DISTCONV_ROW8(-32), DISTCONV_ROW8(-24), DISTCONV_ROW8(-16),
+	DISTCONV_ROW8( -8), DISTCONV_ROW8(  0), DISTCONV_ROW8(  8), DISTCONV_ROW8( 16),
+	DISTCONV_ROW8( 24), DISTCONV_ROW8( 32), DISTCONV_ROW8( 40), DISTCONV_ROW8( 48),
+	DISTCONV_ROW8( 56), DISTCONV_ROW8( 64), DISTCONV_ROW8( 72), DISTCONV_ROW8( 80)
+};
+
+/* ==============================
+ *       HUMIDITY TABLE
+ * ==============================
+ * K increase at 100 %RH every 5 degC from -40 degC (water vapour pressure is exponential in T,
+ * no closed form for the preprocessor). Generated by Tools/DistConv/gen_hum_lut.py
+ * Scaled linearly in %RH: within 0.04 % of the moist air speed of sound up to 55 degC, 0.6 % up to 85 degC
+ * (make -C Sim sos)
+ */
+#define DISTCONV_HUM_STEP_C					(5)
+#define DISTCONV_HUM_SIZE					(27u)		// -40 .. +90 degC
+
+static const uint16 DistConv_KHum100Lut[DISTCONV_HUM_SIZE] =
+{
+	    3u,     6u,    10u,    16u,    27u,    44u,    69u,   108u,
+	  166u,   239u,   339u,   476u,   659u,   903u,  1225u,  1645u,
+	 2190u,  2892u,  3792u,  4942u,  6405u,  8267u, 10635u, 13657u,
+	17529u, 22529u, 29060u
+};
+
+#if (DISTCONV_CFG_TEMP_MIN_DC < (DISTCONV_LUT_T0 * 10)) || \
+	(DISTCONV_CFG_TEMP_MAX_DC >= (DISTCONV_LUT_TN * 10))
+#error "DistConv: temperature range exceeds lookup table"
+#endif
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static DistConv_TempDeciCType	s_tempDc	= DISTCONV_CFG_DEFAULT_TEMP_DC;
+static DistConv_HumidityType	s_rh		= 0u;
+static uint32					s_kQ16		= DISTCONV_KDRY(DISTCONV_CFG_DEFAULT_TEMP_DC / 10);
+
+#if (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_ADC)
+static boolean					s_adcStarted	= FALSE;
+static boolean					s_adcSeeded		= FALSE;
+static sint32					s_adcFiltDc		= 0;
+#endif
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+// Reload reciprocal from both tables (linear interpolation, cold path)
+static void prv_Reload(void)
+{
+	uint32 t	= (uint32)((sint32)s_tempDc - (DISTCONV_LUT_T0 * 10));
+	uint32 i	= t / 10u;
+	uint32 f	= t % 10u;
+	uint32 k	= DistConv_KDryLut[i] + (((DistConv_KDryLut[i + 1u] - DistConv_KDryLut[i]) * f + 5u) / 10u);
+
+	uint32 hi	= t / (DISTCONV_HUM_STEP_C * 10u);
+	uint32 hf	= t % (DISTCONV_HUM_STEP_C * 10u);
+	uint32 h100	= DistConv_KHum100Lut[hi] + (((uint32)(DistConv_KHum100Lut[hi + 1u] - DistConv_KHum100Lut[hi]) * hf + 25u) / 50u);
+
+	k += (h100 * s_rh + 50u) / 100u;
+
+	s_kQ16 = k;
+}
+
+#if (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_ADC)
+// 12 bit raw -> die temperature (0.1 degC)
+static sint32 prv_AdcToDeciC(uint16 Raw)
+{
+	sint32 vs = ((sint32)Raw * (DISTCONV_CFG_ADC_VDDA_MV * 10)) / 4096;		// 0.1 mV
+
+	return (((DISTCONV_CFG_ADC_V25_01MV - vs) * 1000) / DISTCONV_CFG_ADC_SLOPE_001MV) + 250 + DISTCONV_CFG_ADC_OFFSET_DC;
+}
+
+static void prv_PollAdc(void)
+{
+	uint16 raw;
+
+	if((s_adcStarted == TRUE) && (DISTCONV_CFG_ADC_READ(&raw) == E_OK))
+	{
+		sint32 t = prv_AdcToDeciC(raw);
+
+		if(s_adcSeeded == FALSE)
+		{
+			s_adcFiltDc	= t;
+			s_adcSeeded	= TRUE;
+		} else {
+			s_adcFiltDc += (t - s_adcFiltDc) / (1 << DISTCONV_CFG_ADC_FILTER_SHIFT);
+		}
+		s_adcStarted = FALSE;
+
+		DistConv_SetTemperature((DistConv_TempDeciCType)s_adcFiltDc);
+	}
+
+	if(s_adcStarted == FALSE)
+	{
+		s_adcStarted = (DISTCONV_CFG_ADC_START() == E_OK) ? TRUE : FALSE;
+	}
+}
+#endif
+
+/* ==============================
+ *       APIs
+ * ============================== */
+void DistConv_Init(void)
+{
+	s_tempDc	= DISTCONV_CFG_DEFAULT_TEMP_DC;
+	s_rh		= DISTCONV_CFG_DEFAULT_RH;
+#if (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_ADC)
+	s_adcStarted	= FALSE;
+	s_adcSeeded		= FALSE;
+#endif
+	prv_Reload();
+}
+
+void DistConv_MainFunction(void)
+{
+	Rte_HumidityType	h;
+#if (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_RTE)
+	Rte_TemperatureType	t;
+
+	if(DISTCONV_CFG_READ_TEMP(&t) == RTE_E_OK) DistConv_SetTemperature(t);
+#elif (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_ADC)
+	prv_PollAdc();
+#endif
+
+	if(DISTCONV_CFG_READ_RH(&h) == RTE_E_OK) DistConv_SetHumidity(h);
+}
+
+void DistConv_SetTemperature(DistConv_TempDeciCType TempDeciC)
+{
+	if(TempDeciC < DISTCONV_CFG_TEMP_MIN_DC) TempDeciC = DISTCONV_CFG_TEMP_MIN_DC;
+	if(TempDeciC > DISTCONV_CFG_TEMP_MAX_DC) TempDeciC = DISTCONV_CFG_TEMP_MAX_DC;
+
+	s_tempDc = TempDeciC;
+	prv_Reload();
+}
+
+void DistConv_SetHumidity(DistConv_HumidityType RhPercent)
+{
+	s_rh = (RhPercent > 100u) ? 100u : RhPercent;
+	prv_Reload();
+}
+
+DistConv_TempDeciCType DistConv_GetTemperature(void)
+{
+	return s_tempDc;
+}
+
+DistConv_HumidityType DistConv_GetHumidity(void)
+{
+	return s_rh;
+}
+
+DistConv_Q4MmType DistConv_EchoUsToQ4Mm(uint32 EchoUs)
+{
+	uint64 q4 = (((uint64)EchoUs * s_kQ16) + 0x8000u) >> 16;
+
+	return (q4 > DISTCONV_Q4_MAX) ? DISTCONV_Q4_MAX : (DistConv_Q4MmType)q4;
+}
@@ -0,0 +1,91 @@
+/* =====================================================================================================================
+ *  File        : DistConv.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Echo time -> distance conversion, single place for distance units
+ * 					- distance unit on RTE/Com: Q4 mm (1/16 mm, uint16, max 4095.9 mm)
+ * 					- speed of sound compensated by ambient temperature and humidity
+ * 					- hot path is one 32x32->64 multiply + shift (reciprocal kept per ambient update)
+ *  Depends     : Std_Types.h, DistConv_Cfg.h
+ * ===================================================================================================================*/
+
+#ifndef DISTCONV_DISTCONV_H_
+#define DISTCONV_DISTCONV_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define DISTCONV_VENDOR_ID					(0x00u)
+#define DISTCONV_MODULE_ID					(0xC6u)
+
+#define DISTCONV_SW_MAJOR_VERSION			(1u)
+#define DISTCONV_SW_MINOR_VERSION			(1u)
+#define DISTCONV_SW_PATCH_VERSION			(0u)
+
+/* ==============================
+ *       UNITS
+ * ============================== */
+// Distance in 1/16 mm
+typedef uint16 DistConv_Q4MmType;
+
+// Temperature in 0.1 degC
+typedef sint16 DistConv_TempDeciCType;
+
+// Relative humidity in %RH (0..100)
+typedef uint8 DistConv_HumidityType;
+
+#define DISTCONV_Q4_SHIFT					(4u)
+#define DISTCONV_Q4_MAX						((DistConv_Q4MmType)0xFFFEu)	// conversion saturates here
+#define DISTCONV_Q4_INVALID					((DistConv_Q4MmType)0xFFFFu)
+
+// Unit helpers, integer constants fold at compile time
+#define DISTCONV_MM_TO_Q4(_mm)				((uint32)(_mm) << DISTCONV_Q4_SHIFT)
+#define DISTCONV_CM_TO_Q4(_cm)				((uint32)(_cm) * 160u)
+#define DISTCONV_Q4_TO_MM(_q4)				((uint32)(_q4) >> DISTCONV_Q4_SHIFT)
+#define DISTCONV_Q4_TO_CM(_q4)				((uint32)(_q4) / 160u)
+
+// Round trip Q4 mm per us: d = t * c / 2 * 16 / 1e6  ->  K(Q16) = c[mm/s] * 2^19 / 1e6
+#define DISTCONV_K_FROM_SOS_MMS(_c)			((uint32)((((uint64)(_c) << 19) + 500000u) / 1000000u))
+
+// Ambient temperature sources (DISTCONV_CFG_TEMP_SOURCE)
+#define DISTCONV_TEMP_SRC_FIXED				(0u)	// DISTCONV_CFG_DEFAULT_TEMP_DC or DistConv_SetTemperature
+#define DISTCONV_TEMP_SRC_RTE				(1u)	// Rte_Read_AmbientTemperature
+#define DISTCONV_TEMP_SRC_ADC				(2u)	// ADC1 internal temperature sensor
+
+#include "DistConv_Cfg.h"
+
+/* ==============================
+ *       API
+ * ============================== */
+// Back to configured default temperature / humidity
+void DistConv_Init(void);
+
+// Poll configured ambient source, call slowly (100 ms .. 1 s)
+void DistConv_MainFunction(void);
+
+// Set ambient temperature (clamped to DISTCONV_CFG_TEMP_MIN/MAX_DC), reloads the reciprocal from the LUT
+void DistConv_SetTemperature(DistConv_TempDeciCType TempDeciC);
+
+// Set ambient humidity (clamped to 100 %RH)
+void DistConv_SetHumidity(DistConv_HumidityType RhPercent);
+
+// Temperature currently used for conversion
+DistConv_TempDeciCType DistConv_GetTemperature(void);
+
+// Humidity currently used for conversion
+DistConv_HumidityType DistConv_GetHumidity(void);
+
+// Round trip echo time (us) -> one way distance (Q4 mm), saturates at DISTCONV_Q4_MAX
+DistConv_Q4MmType DistConv_EchoUsToQ4Mm(uint32 EchoUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISTCONV_DISTCONV_H_ */
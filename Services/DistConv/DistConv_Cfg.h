@@ -0,0 +1,84 @@
+/* =====================================================================================================================
+ *  File        : DistConv_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of distance conversion
+ *  Depends     : DistConv.h
+ * ===================================================================================================================*/
+
+#ifndef DISTCONV_DISTCONV_CFG_H_
+#define DISTCONV_DISTCONV_CFG_H_
+
+/* Temperature used until the source delivers a value (0.1 degC) */
+#ifndef DISTCONV_CFG_DEFAULT_TEMP_DC
+#define DISTCONV_CFG_DEFAULT_TEMP_DC		(200)
+#endif
+
+/* Humidity used until the source delivers a value (%RH) */
+#ifndef DISTCONV_CFG_DEFAULT_RH
+#define DISTCONV_CFG_DEFAULT_RH				(50u)
+#endif
+
+/* Accepted temperature range (0.1 degC), inputs outside are clamped.
+ * LUT covers -40.0 .. +87.0 degC */
+#ifndef DISTCONV_CFG_TEMP_MIN_DC
+#define DISTCONV_CFG_TEMP_MIN_DC			(-400)
+#endif
+
+#ifndef DISTCONV_CFG_TEMP_MAX_DC
+#define DISTCONV_CFG_TEMP_MAX_DC			(850)
+#endif
+
+/* Ambient temperature source */
+#ifndef DISTCONV_CFG_TEMP_SOURCE
+#define DISTCONV_CFG_TEMP_SOURCE			DISTCONV_TEMP_SRC_RTE
+#endif
+
+/* RTE inputs (E_OK when a value is available) */
+#ifndef DISTCONV_CFG_READ_TEMP
+#define DISTCONV_CFG_READ_TEMP(_pDc)		Rte_Read_AmbientTemperature((_pDc))
+#endif
+
+#ifndef DISTCONV_CFG_READ_RH
+#define DISTCONV_CFG_READ_RH(_pRh)			Rte_Read_AmbientHumidity((_pRh))
+#endif
+
+/* ADC1 internal sensor (datasheet typ.): V25 = 1.43 V, slope = 4.3 mV/degC, VDDA = 3.3 V.
+ * It measures die temperature: OFFSET covers self heating and part spread (+-45 degC max per datasheet),
+ * trim it per board or use the RTE source for a real ambient sensor */
+#ifndef DISTCONV_CFG_ADC_V25_01MV
+#define DISTCONV_CFG_ADC_V25_01MV			(14300)
+#endif
+
+#ifndef DISTCONV_CFG_ADC_SLOPE_001MV
+#define DISTCONV_CFG_ADC_SLOPE_001MV		(430)
+#endif
+
+#ifndef DISTCONV_CFG_ADC_VDDA_MV
+#define DISTCONV_CFG_ADC_VDDA_MV			(3300)
+#endif
+
+#ifndef DISTCONV_CFG_ADC_OFFSET_DC
+#define DISTCONV_CFG_ADC_OFFSET_DC			(0)
+#endif
+
+/* IIR filter on ADC temperature: y += (x - y) >> SHIFT */
+#ifndef DISTCONV_CFG_ADC_FILTER_SHIFT
+#define DISTCONV_CFG_ADC_FILTER_SHIFT		(3u)
+#endif
+
+#if (DISTCONV_CFG_TEMP_SOURCE == DISTCONV_TEMP_SRC_ADC)
+#include "Adc.h"
+#include "Adc_Cfg.h"
+
+#ifndef DISTCONV_CFG_ADC_START
+#define DISTCONV_CFG_ADC_START()			Adc_StartGroupConversion(ADC_GROUP_TEMPSENSOR)
+#endif
+
+#ifndef DISTCONV_CFG_ADC_READ
+#define DISTCONV_CFG_ADC_READ(_pRaw)		((Adc_GetGroupStatus(ADC_GROUP_TEMPSENSOR) == ADC_STREAM_COMPLETED) ? \
+												Adc_ReadGroup(ADC_GROUP_TEMPSENSOR, (_pRaw)) : E_NOT_OK)
+#endif
+#endif
+
+#endif /* DISTCONV_DISTCONV_CFG_H_ */
@@ -0,0 +1,152 @@
+/* =====================================================================================================================
+ *  File        : E2E.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : End-to-end protection of PDUs (see E2E.h)
+ *  Depends     : E2E.h, Crc.h
+ * ===================================================================================================================*/
+
+#include "E2E.h"
+#include "Crc.h"
+
+#define E2E_FRAME_BYTES					(8u)
+
+static uint8 prv_CrcBytes(const E2E_ConfigType* Config)
+{
+	return (Config->Profile == E2E_PROFILE_CRC16) ? 2u : 1u;
+}
+
+// Counter values: 16 in a nibble, 256 in a byte
+static uint8 prv_CounterMask(const E2E_ConfigType* Config)
+{
+	return (Config->Profile == E2E_PROFILE_CRC16) ? 0xFFu : 0x0Fu;
+}
+
+static uint8 prv_ReadCounter(const E2E_ConfigType* Config, const uint8* Data)
+{
+	uint8 b = Data[Config->CounterOffset >> 3];
+
+	if(Config->Profile == E2E_PROFILE_CRC16) return b;
+	return (uint8)((b >> (Config->CounterOffset & 4u)) & 0x0Fu);
+}
+
+static void prv_WriteCounter(const E2E_ConfigType* Config, uint8* Data, uint8 Counter)
+{
+	uint8* b = &Data[Config->CounterOffset >> 3];
+	uint8 shift;
+
+	if(Config->Profile == E2E_PROFILE_CRC16)
+	{
+		*b = Counter;
+		return;
+	}
+	shift	= (uint8)(Config->CounterOffset & 4u);
+	*b		= (uint8)((*b & ~(0x0Fu << shift)) | ((Counter & 0x0Fu) << shift));
+}
+
+// CRC of Length bytes of Data, the CRC field itself left out
+static uint16 prv_Crc(const E2E_ConfigType* Config, const uint8* Data, PduLengthType Length)
+{
+	const uint8	id[2]	= { (uint8)(Config->DataId & 0xFFu), (uint8)(Config->DataId >> 8) };
+	uint8		off		= Config->CrcOffset;
+	uint8		after	= (uint8)(off + prv_CrcBytes(Config));
+	uint16		crc;
+
+	if(Config->Profile == E2E_PROFILE_CRC16)
+	{
+		crc = Crc_CalculateCRC16(Data, off, 0u, TRUE);
+		crc = Crc_CalculateCRC16(&Data[after], (uint32)Length - after, crc, FALSE);
+		return Crc_CalculateCRC16(id, 2u, crc, FALSE);
+	}
+
+	crc = Crc_CalculateCRC8(id, 2u, 0u, TRUE);
+	crc = Crc_CalculateCRC8(Data, off, (uint8)crc, FALSE);
+	return Crc_CalculateCRC8(&Data[after], (uint32)Length - after, (uint8)crc, FALSE);
+}
+
+uint8 E2E_HeaderLength(const E2E_ConfigType* Config)
+{
+	uint8 crcEnd;
+	uint8 cntByte;
+
+	if((Config == NULL_PTR) || (Config->MaxDeltaCounter == 0u)) return 0u;
+
+	crcEnd	= (uint8)(Config->CrcOffset + prv_CrcBytes(Config));
+	cntByte	= (uint8)(Config->CounterOffset >> 3);
+
+	if((Config->CounterOffset & ((Config->Profile == E2E_PROFILE_CRC16) ? 7u : 3u)) != 0u) return 0u;
+	if((cntByte >= Config->CrcOffset) && (cntByte < crcEnd)) return 0u;
+	if((crcEnd > E2E_FRAME_BYTES) || (cntByte >= E2E_FRAME_BYTES)) return 0u;
+
+	return (crcEnd > cntByte) ? crcEnd : (uint8)(cntByte + 1u);
+}
+
+void E2E_ProtectInit(E2E_ProtectStateType* State)
+{
+	State->Counter = 0u;
+}
+
+Std_ReturnType E2E_Protect(const E2E_ConfigType* Config, E2E_ProtectStateType* State, uint8* Data, PduLengthType Length)
+{
+	uint8 hdr = E2E_HeaderLength(Config);
+	uint16 crc;
+
+	if((Data == NULL_PTR) || (hdr == 0u) || (Length < hdr)) return E_NOT_OK;
+
+	// the counter is covered by the CRC, so it goes in first
+	prv_WriteCounter(Config, Data, State->Counter);
+	crc = prv_Crc(Config, Data, Length);
+
+	Data[Config->CrcOffset] = (uint8)(crc & 0xFFu);
+	if(Config->Profile == E2E_PROFILE_CRC16) Data[Config->CrcOffset + 1u] = (uint8)(crc >> 8);
+
+	State->Counter = (uint8)((State->Counter + 1u) & prv_CounterMask(Config));
+	return E_OK;
+}
+
+void E2E_CheckInit(E2E_CheckStateType* State)
+{
+	State->LastCounter	= 0u;
+	State->Synced		= FALSE;
+	State->Status		= E2E_P_NONEWDATA;
+}
+
+E2E_PCheckStatusType E2E_Check(const E2E_ConfigType* Config, E2E_CheckStateType* State, const uint8* Data, PduLengthType Length)
+{
+	uint8 hdr = E2E_HeaderLength(Config);
+	uint16 rxCrc;
+	uint8 counter;
+	uint8 delta;
+
+	if((Data == NULL_PTR) || (hdr == 0u) || (Length < hdr))
+	{
+		State->Status = E2E_P_ERROR;
+		return State->Status;
+	}
+
+	rxCrc = Data[Config->CrcOffset];
+	if(Config->Profile == E2E_PROFILE_CRC16) rxCrc |= (uint16)((uint16)Data[Config->CrcOffset + 1u] << 8);
+
+	// a corrupted frame does not touch the sequence
+	if(rxCrc != prv_Crc(Config, Data, Length))
+	{
+		State->Status = E2E_P_ERROR;
+		return State->Status;
+	}
+
+	counter	= prv_ReadCounter(Config, Data);
+	delta	= (uint8)((counter - State->LastCounter) & prv_CounterMask(Config));
+
+	if(State->Synced == FALSE)					State->Status = E2E_P_OK;
+	else if(delta == 0u)						State->Status = E2E_P_REPEATED;
+	else if(delta == 1u)						State->Status = E2E_P_OK;
+	else if(delta <= Config->MaxDeltaCounter)	State->Status = E2E_P_OKSOMELOST;
+	else										State->Status = E2E_P_WRONGSEQUENCE;
+
+	if(State->Status != E2E_P_REPEATED)
+	{
+		State->LastCounter	= counter;
+		State->Synced		= TRUE;
+	}
+	return State->Status;
+}
@@ -0,0 +1,112 @@
+/* =====================================================================================================================
+ *  File        : E2E.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : End-to-end protection of PDUs: sequence counter + CRC, written by the sender, checked by the receiver
+ * 					- E2E_PROFILE_CRC8 : CRC8 SAE J1850 over DataId (low, high byte) and the PDU without the CRC
+ * 					  byte, 4-bit counter (0 .. 15) in a nibble
+ * 					- E2E_PROFILE_CRC16: CRC16 CCITT-FALSE over the PDU without the CRC bytes and DataId (low,
+ * 					  high byte), CRC stored little endian, 8-bit counter in a byte
+ * 					- DataId is never sent, a frame of another PDU with the same layout fails the CRC
+ * 					- the CRC covers the length that is sent / received, so dynamic length PDUs work as they are
+ * 					- table driven CRCs (Crc.c), one lookup per byte
+ *  Depends     : Std_Types.h, ComStack_Types.h, Crc.h
+ * ===================================================================================================================*/
+
+#ifndef E2E_E2E_H_
+#define E2E_E2E_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "ComStack_Types.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define E2E_VENDOR_ID						(0x00u)
+#define E2E_MODULE_ID						(0xCFu)
+
+#define E2E_SW_MAJOR_VERSION				(1u)
+#define E2E_SW_MINOR_VERSION				(0u)
+#define E2E_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       TYPES
+ * ============================== */
+typedef enum
+{
+	E2E_PROFILE_CRC8	= 0,
+	E2E_PROFILE_CRC16
+} E2E_ProfileType;
+
+/*
+ * Placement of the protection in the PDU.
+ * CounterOffset is a bit position (byte * 8 + bit): nibble aligned for E2E_PROFILE_CRC8, byte aligned for
+ * E2E_PROFILE_CRC16. Counter and CRC must not overlap, the signals of the PDU must leave both free
+ */
+typedef struct
+{
+	E2E_ProfileType		Profile;
+	uint16				DataId;				// unique per PDU on the network
+	uint8				CrcOffset;			// byte
+	uint8				CounterOffset;		// bit
+	uint8				MaxDeltaCounter;	// counter jump still accepted (frames lost in between + 1), >= 1
+} E2E_ConfigType;
+
+// Sender: counter of the next frame
+typedef struct
+{
+	uint8				Counter;
+} E2E_ProtectStateType;
+
+/*
+ * Result of checking one received frame
+ */
+typedef enum
+{
+	E2E_P_NONEWDATA		= 0,		// nothing received since E2E_CheckInit
+	E2E_P_OK			,			// CRC fine, counter one ahead (or the first frame)
+	E2E_P_OKSOMELOST	,			// CRC fine, counter 2 .. MaxDeltaCounter ahead
+	E2E_P_REPEATED		,			// CRC fine, same counter as the last frame: a stuck or replayed sender
+	E2E_P_WRONGSEQUENCE	,			// CRC fine, counter jumped too far (or back). The receiver resyncs to it
+	E2E_P_ERROR						// CRC wrong or frame too short for the protection, the frame is not used
+} E2E_PCheckStatusType;
+
+// Receiver: last accepted counter
+typedef struct
+{
+	uint8					LastCounter;
+	boolean					Synced;			// LastCounter is valid
+	E2E_PCheckStatusType	Status;			// of the last frame
+} E2E_CheckStateType;
+
+/* ==============================
+ *       API
+ * ============================== */
+/**
+ * @brief  Bytes a PDU needs to carry the counter and CRC of Config
+ * @return 0: invalid placement (unaligned counter, overlapping fields, beyond an 8 byte frame, MaxDeltaCounter 0)
+ */
+uint8 E2E_HeaderLength(const E2E_ConfigType* Config);
+
+void E2E_ProtectInit(E2E_ProtectStateType* State);
+
+/**
+ * @brief  Write the counter and the CRC over Length bytes of Data, then advance the counter
+ * @return E_NOT_OK: Length too short for the protection, Data unchanged
+ */
+Std_ReturnType E2E_Protect(const E2E_ConfigType* Config, E2E_ProtectStateType* State, uint8* Data, PduLengthType Length);
+
+void E2E_CheckInit(E2E_CheckStateType* State);
+
+// Check Length received bytes of Data. The status is also kept in State
+E2E_PCheckStatusType E2E_Check(const E2E_ConfigType* Config, E2E_CheckStateType* State, const uint8* Data, PduLengthType Length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* E2E_E2E_H_ */
@@ -7,13 +7,20 @@
  * ===================================================================================================================*/
 
 #include "EcuM.h"
+#include "Irq_Atomic.h"
 #include <string.h>
 
+#define ECUM_TICKS(_ms)		((uint16)(((_ms) + ECUM_CFG_MAINFUNCTION_PERIOD_MS - 1u) / ECUM_CFG_MAINFUNCTION_PERIOD_MS))
+
 /* ==============================
  *          LOCAL STATE
  * ============================== */
 static volatile EcuM_StateType	s_state = ECUM_STATE_UNINIT;
 static const EcuM_ConfigType*	s_cfg = NULL_PTR;
+static volatile uint32			s_wakeupPending = ECU_WAKEUP_NONE;	// EcuM_SetWakeupEvent, ISRs included
+static EcuM_WakeupSourceType	s_wakeupChecked = ECU_WAKEUP_NONE;	// sources of the wake-up under validation
+static uint16					s_validationTimer = 0u;				// EcuM_MainFunction calls left
+static EcuM_WakeupStatusType	s_wakeup;
 
 /* ==============================
  *      INTERNAL UTILITIES
@@ -43,6 +50,16 @@ static inline void call_void_hook(EcuM_VoidHookType hook)
 	if(hook != NULL_PTR){ hook();}
 }
 
+// Events from before PreSleepHook belong to the time awake, only the ones after it wake the ECU
+static void prv_EnterSleep(void)
+{
+	(void)Irq_AtomicExchange32(&s_wakeupPending, ECU_WAKEUP_NONE);
+	if(s_cfg != NULL_PTR && s_cfg->Hooks != NULL_PTR){
+		call_void_hook(s_cfg->Hooks->PreSleepHook);
+	}
+	s_state = ECUM_STATE_SLEEP;
+}
+
 /* ==============================
  *            APIS
  * ============================== */
@@ -75,10 +92,16 @@ void EcuM_Init(const EcuM_ConfigType* CfgPtr)
 	// Logger & Det
 	if(call_init_hook(s_cfg->Hooks->Logger_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 	if(call_init_hook(s_cfg->Hooks->Det_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->NvM_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->Dem_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->StackMon_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->Telemetry_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->Shell_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 
 	// Optional drivers
 	if(call_init_hook(s_cfg->Hooks->Gpt_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 	if(call_init_hook(s_cfg->Hooks->Icu_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
+	if(call_init_hook(s_cfg->Hooks->Adc_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 	if(call_init_hook(s_cfg->Hooks->Can_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 	if(call_init_hook(s_cfg->Hooks->Com_InitHook) != E_OK){ s_state = ECUM_STATE_SHUTDOWN;return;}
 
@@ -105,11 +128,14 @@ void EcuM_DeInit(void)
 		call_void_hook(s_cfg->Hooks->Com_DeInitHook);
 		call_void_hook(s_cfg->Hooks->Can_DeInitHook);
 
-		// Timmer/Input capture
+		// Timmer/Input capture/Adc
+		call_void_hook(s_cfg->Hooks->Adc_DeInitHook);
 		call_void_hook(s_cfg->Hooks->Icu_DeInitHook);
 		call_void_hook(s_cfg->Hooks->Gpt_DeInitHook);
 
 		// Services
+		call_void_hook(s_cfg->Hooks->Shell_DeInitHook);
+		call_void_hook(s_cfg->Hooks->Telemetry_DeInitHook);
 		call_void_hook(s_cfg->Hooks->Det_DeInitHook);
 		call_void_hook(s_cfg->Hooks->Logger_DeInitHook);
 
@@ -136,10 +162,7 @@ Std_ReturnType EcuM_GoToSleep(void)
 		return ECUM_DET_FAIL(ECUM_API_ID_GOTOSLEEP, ECUM_E_INVALID_STATE);
 	}
 
-	if(s_cfg != NULL_PTR && s_cfg->Hooks != NULL_PTR){
-		call_void_hook(s_cfg->Hooks->PreSleepHook);
-	}
-	s_state = ECUM_STATE_SLEEP;
+	prv_EnterSleep();
 	return E_OK;
 }
 
@@ -155,3 +178,62 @@ Std_ReturnType EcuM_Wakeup(void){
 	s_state = ECUM_STATE_RUN;
 	return E_OK;
 }
+
+void EcuM_SetWakeupEvent(EcuM_WakeupSourceType Sources)
+{
+	uint32 old;
+
+	do
+	{
+		old = Irq_AtomicLoad32(&s_wakeupPending);
+	} while(Irq_AtomicCas32(&s_wakeupPending, old, old | Sources) == FALSE);
+}
+
+void EcuM_ValidateWakeupEvent(EcuM_WakeupSourceType Sources)
+{
+	if((s_state != ECUM_STATE_WAKEUP_VALIDATION) || ((Sources & s_wakeupChecked) == ECU_WAKEUP_NONE)) return;
+
+	s_wakeup.Validated	= Sources & s_wakeupChecked;
+	s_validationTimer	= 0u;
+	s_state				= ECUM_STATE_RUN;
+}
+
+Std_ReturnType EcuM_GetWakeupStatus(EcuM_WakeupStatusType* StatusPtr)
+{
+	if(StatusPtr == NULL_PTR){
+		return ECUM_DET_FAIL(ECUM_API_ID_GETWAKEUPSTATUS, ECUM_E_PARAM_POINTER);
+	}
+
+	*StatusPtr = s_wakeup;
+	return E_OK;
+}
+
+#if (ECUM_ENABLE_MAINFUNCTION == 1u)
+void EcuM_MainFunction(void)
+{
+	EcuM_WakeupSourceType ev;
+
+	if(s_state == ECUM_STATE_SLEEP)
+	{
+		ev = Irq_AtomicExchange32(&s_wakeupPending, ECU_WAKEUP_NONE);
+		if(ev == ECU_WAKEUP_NONE) return;
+
+		// stack back on the bus (receive only), the users decide whether the wake-up was for this ECU
+		if(s_wakeup.Wakeups < 0xFFFFu) s_wakeup.Wakeups++;
+		s_wakeupChecked		= ev;
+		s_validationTimer	= ECUM_TICKS(ECUM_CFG_WAKEUP_VALIDATION_MS);
+		s_state				= ECUM_STATE_WAKEUP_VALIDATION;
+		if(s_cfg != NULL_PTR && s_cfg->Hooks != NULL_PTR){
+			call_void_hook(s_cfg->Hooks->PostWakeupHook);
+		}
+		return;
+	}
+
+	if((s_state != ECUM_STATE_WAKEUP_VALIDATION) || (s_validationTimer == 0u) || (--s_validationTimer != 0u)) return;
+
+	// nobody asked for this ECU: frames of another partial network, a glitch
+	s_wakeup.Expired = s_wakeupChecked;
+	if(s_wakeup.Expirations < 0xFFFFu) s_wakeup.Expirations++;
+	prv_EnterSleep();
+}
+#endif
@@ -4,7 +4,9 @@
  *  ECU         : Sensor_ECU (STM32F103C6T6)
  *  Purpose     : Coordinate the system initialization / shutdown sequence according to module order
  * 					- Provide ECU status (STARTUP/RUN/SLEEP/SHUTDOWN)
- * 					- Call hooks/init functions of each layer: Mcu -> Port -> Uart -> UartIf -> Logger -> Det -> (other drivers)
+ * 					- Sleep / wake-up: EcuM_GoToSleep (PreSleepHook), a wake-up event (PostWakeupHook) is validated
+ * 					  within ECUM_CFG_WAKEUP_VALIDATION_MS or the ECU sleeps again
+ * 					- Call hooks/init functions of each layer: Mcu -> Port -> Uart -> UartIf -> Logger -> Det -> NvM -> (other drivers)
  *  Depends     :
  * ===================================================================================================================*/
 
@@ -19,6 +21,8 @@ extern "C" {
 #include "Std_Types.h"
 #include "ComStack_Types.h"
 #include "Det.h"
+#include "Uart_Cfg.h"		// UART_CFG_LOG_PORT, checked by EcuM_Cfg.h
+#include "EcuM_Cfg.h"
 
 /* ==============================
  *       VERSION & IDENTITIES
@@ -56,6 +60,9 @@ extern "C" {
 #define ECUM_API_ID_MAINFUNCTION			(0x04u)
 #define ECUM_API_ID_GOTOSLEEP				(0x05u)
 #define ECUM_API_ID_WAKEUP					(0x06u)
+#define ECUM_API_ID_SETWAKEUPEVENT			(0x0Cu)
+#define ECUM_API_ID_VALIDATEWAKEUPEVENT		(0x14u)
+#define ECUM_API_ID_GETWAKEUPSTATUS			(0x15u)
 
 /* ==============================
  *         DET ERROR CODES
@@ -85,7 +92,8 @@ typedef enum
 	ECUM_STATE_STARTUP_TWO,
 	ECUM_STATE_RUN,
 	ECUM_STATE_SLEEP,
-	ECUM_STATE_SHUTDOWN
+	ECUM_STATE_SHUTDOWN,
+	ECUM_STATE_WAKEUP_VALIDATION		// woken, stack receive only until a user validates the wake-up
 } EcuM_StateType;
 
 typedef Std_ReturnType (*EcuM_InitHookType)(void);
@@ -101,9 +109,15 @@ typedef struct
 	EcuM_InitHookType		UartIf_InitHook;
 	EcuM_InitHookType		Logger_InitHook;
 	EcuM_InitHookType		Det_InitHook;
+	EcuM_InitHookType		NvM_InitHook;			// Fls + NvM: RAM copies loaded before their owners init
+	EcuM_InitHookType		Dem_InitHook;			// before the first runnable reports an event
+	EcuM_InitHookType		StackMon_InitHook;		// paints the stack, after Det so a config error is kept
+	EcuM_InitHookType		Telemetry_InitHook;
+	EcuM_InitHookType		Shell_InitHook;
 
 	EcuM_InitHookType		Gpt_InitHook;
 	EcuM_InitHookType		Icu_InitHook;
+	EcuM_InitHookType		Adc_InitHook;
 	EcuM_InitHookType		Can_InitHook;
 	EcuM_InitHookType		Com_InitHook;
 
@@ -112,8 +126,11 @@ typedef struct
 	EcuM_VoidHookType		App_DeInitHook;
 	EcuM_VoidHookType		Com_DeInitHook;
 	EcuM_VoidHookType		Can_DeInitHook;
+	EcuM_VoidHookType		Adc_DeInitHook;
 	EcuM_VoidHookType		Icu_DeInitHook;
 	EcuM_VoidHookType		Gpt_DeInitHook;
+	EcuM_VoidHookType		Shell_DeInitHook;
+	EcuM_VoidHookType		Telemetry_DeInitHook;
 	EcuM_VoidHookType		Det_DeInitHook;
 	EcuM_VoidHookType		Logger_DeInitHook;
 	EcuM_VoidHookType		UartIf_DeInitHook;
@@ -125,6 +142,15 @@ typedef struct
 	EcuM_VoidHookType		PostWakeupHook;
 } EcuM_HooksType;
 
+// Wake-up bookkeeping
+typedef struct
+{
+	EcuM_WakeupSourceType	Validated;		// sources of the last validated wake-up (ECU_WAKEUP_NONE: never slept)
+	EcuM_WakeupSourceType	Expired;		// sources of the last wake-up that found nobody (PN other cluster, noise)
+	uint16					Wakeups;		// wake-up events handled
+	uint16					Expirations;	// of those, back to sleep without validation
+} EcuM_WakeupStatusType;
+
 /*
  *  EcuM master configuration: hook groups and optional flags
  */
@@ -140,8 +166,8 @@ typedef struct
 /*
  * EcuM_init
  *	Port_InitHook, UartInitHook, UartIf_InitHook
- *	Services:	Logger_InitHook, Det_InitHook
- *	Other:		GPT/Icu/Can/Com
+ *	Services:	Logger_InitHook, Det_InitHook, StackMon_InitHook, Telemetry_InitHook, Shell_InitHook
+ *	Other:		GPT/Icu/Adc/Can/Com
  *	App:		App_InitHook
  *	if hook == NULL => Skip
  */
@@ -150,10 +176,23 @@ void EcuM_DeInit(void);
 
 EcuM_StateType EcuM_GetState(void); // Get ECU State
 
-Std_ReturnType EcuM_GoToSleep(void); // Get system to Sleep
+Std_ReturnType EcuM_GoToSleep(void); // Get system to Sleep, PreSleepHook, pending wake-up events dropped
 
 Std_ReturnType EcuM_Wakeup(void); // Wake up System
 
+// Wake-up source fired (any context, interrupts included), handled by EcuM_MainFunction while asleep
+void EcuM_SetWakeupEvent(EcuM_WakeupSourceType Sources);
+
+// A user confirms the wake-up under validation (e.g. CanNm: NM PDU for this ECU), ignored in other states
+void EcuM_ValidateWakeupEvent(EcuM_WakeupSourceType Sources);
+
+Std_ReturnType EcuM_GetWakeupStatus(EcuM_WakeupStatusType* StatusPtr);
+
+#if (ECUM_ENABLE_MAINFUNCTION == 1u)
+// Asleep: wake-up events -> PostWakeupHook, validation. Validation time out. Period ECUM_CFG_MAINFUNCTION_PERIOD_MS
+void EcuM_MainFunction(void);
+#endif
+
 /* =========================================================
  * 	 Global configuration
  * =======================================================*/
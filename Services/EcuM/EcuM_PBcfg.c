@@ -10,23 +10,47 @@
 #include "EcuM.h"
 
 #include "Mcu.h"
+#include "Irq.h"
 #include "Uart.h"
 #include "Port.h"
 #include "../../ECU_Abstraction/UartIf/UartIf.h"
 #include "../Logger/Logger.h"
 #include "Det.h"
+#include "Gpt.h"
+#include "Icu.h"
+#include "SensorIf.h"
+#include "Adc.h"
+#include "Telemetry.h"
+#include "Shell.h"
+#include "StackMon.h"
+#include "Fls.h"
+#include "NvM.h"
+#include "Dem.h"
+#include "Can.h"
+#include "CanIf.h"
+#include "CanSM.h"
+#include "CanNm.h"
+#include "PduR.h"
+#include "Com.h"
+#include "SystemApp.h"
 
 extern const Mcu_ConfigType Mcu_Config;
 extern const Port_ConfigType Port_Config;
 extern const Uart_ConfigType Uart_Config;
 extern const UartIf_ConfigType UartIf_Config;
 extern const Logger_ConfigType Logger_Config;
+extern const Gpt_ConFigType Gpt_Config;
+extern const Icu_ConfigType Icu_Config;
+extern const Adc_ConfigType Adc_Config;
+extern const Can_ConfigType Can_Config;
 
 // Config module init
+// Clock, then the interrupt plan before any driver enables its line, then SysTick: the time base of the main loop
 static Std_ReturnType Mcu_Init_Hook(void)
 {
 	Mcu_Init(&Mcu_Config);
-	return E_OK;
+	if(Irq_Init(&Irq_Config) != E_OK) return E_NOT_OK;
+	return Mcu_Set_SysTickHZ(Mcu_Config.systickHz);
 }
 
 static Std_ReturnType Port_Init_Hook(void)
@@ -59,11 +83,108 @@ static Std_ReturnType Det_Init_Hook(void)
 	return E_OK;
 }
 
+// Gpt and Icu share TIM2 (1 MHz): Gpt timebase first, Icu adds trigger/capture channels
+static Std_ReturnType Gpt_Init_Hook(void)
+{
+	Gpt_Init(&Gpt_Config);
+	return E_OK;
+}
+
+// SensorIf ranges through Icu (trigger pulse, echo capture, timeout), the Sensor SWC measures from the first cycle
+static Std_ReturnType Icu_Init_Hook(void)
+{
+	if(Icu_Init(&Icu_Config) != E_OK) return E_NOT_OK;
+	SensorIf_Init();
+	return E_OK;
+}
+
+static Std_ReturnType Adc_Init_Hook(void)
+{
+	return Adc_Init(&Adc_Config);
+}
+
+// Synchronous page scan, reads only
+static Std_ReturnType NvM_Init_Hook(void)
+{
+	Fls_Init();
+	NvM_Init(&NvM_Config);
+	return E_OK;
+}
+
+static Std_ReturnType Dem_Init_Hook(void)
+{
+	Dem_Init(&Dem_Config);
+	return E_OK;
+}
+
+// Paint the unused stack; the frames of Mcu..Det init are shallower than the cyclic paths
+static Std_ReturnType StackMon_Init_Hook(void)
+{
+	StackMon_Init();
+	return E_OK;
+}
+
+static Std_ReturnType Telemetry_Init_Hook(void)
+{
+	Telemetry_Init(&Telemetry_Config);
+	return E_OK;
+}
+
+static Std_ReturnType Shell_Init_Hook(void)
+{
+	Shell_Init();
+	return E_OK;
+}
+
+// Driver, then the stack above it, CanSM starts the controller. A controller that never leaves init is left
+// uninitialised (no traffic), the ECU runs on without CAN. On the bus CanNm starts in ready sleep: without a network
+// request or NM PDUs of other nodes the NM timeout takes it to bus sleep
+static Std_ReturnType Can_Init_Hook(void)
+{
+	Can_Init(&Can_Config);
+	CanIf_Init(&CanIf_Config);
+	CanSM_Init();
+	CanNm_Init();
+	if(CanSM_RequestComMode(CANSM_FULL_COMMUNICATION) == E_OK) (void)CanNm_StartUp();
+	return E_OK;
+}
+
+// Routing before the first send. Rx deadlines run from here, sends are refused until CanSM starts the controller
+static Std_ReturnType Com_Init_Hook(void)
+{
+	PduR_Init((PduR_ConfigTypes*)&PduR_Config);
+	Com_Init(&Com_Config);
+	return E_OK;
+}
+
+// RTE and SWCs last: ObstacleDetection reads its calibration from NvM
+static Std_ReturnType App_Init_Hook(void)
+{
+	SystemApp_Init();
+	return E_OK;
+}
+
 // Config deinit
+static void Adc_DeInit_Hook(void)		{ Adc_DeInit(); }
+static void Shell_DeInit_Hook(void)		{ Shell_DeInit(); }
+static void Telemetry_DeInit_Hook(void)	{ Telemetry_DeInit(); }
 static void Logger_DeInit_Hook(void)	{ Logger_Deinit(); }
 static void UartIf_DeInit_Hook(void)	{ UartIf_DeInit(); }
 static void Uart_DeInit_Hook(void)		{ Uart_Deinit(); }
 
+// Sleep: controller stopped, then bxCAN sleep with automatic wake-up on bus activity (SCE -> EcuM_SetWakeupEvent)
+static void PreSleep_Hook(void)
+{
+	(void)CanSM_RequestComMode(CANSM_NO_COMMUNICATION);
+	(void)Can_SetControllerMode(0u, CAN_CS_SLEEP);
+}
+
+// Woken: back on the bus to receive the frames that validate the wake-up (CanIf stays TX offline until then)
+static void PostWakeup_Hook(void)
+{
+	(void)CanSM_RequestComMode(CANSM_FULL_COMMUNICATION);
+}
+
 static const EcuM_HooksType EcuM_Hooks = {
 	// Startup One
 	.Mcu_InitHook 		= Mcu_Init_Hook,
@@ -76,22 +197,31 @@ static const EcuM_HooksType EcuM_Hooks = {
 	// Services
 	.Logger_InitHook 	= Logger_Init_Hook,
 	.Det_InitHook 		= Det_Init_Hook,
+	.NvM_InitHook		= NvM_Init_Hook,
+	.Dem_InitHook		= Dem_Init_Hook,
+	.StackMon_InitHook	= StackMon_Init_Hook,
+	.Telemetry_InitHook	= Telemetry_Init_Hook,
+	.Shell_InitHook		= Shell_Init_Hook,
 
 	// Optional driver
-	.Gpt_InitHook		= NULL,
-	.Icu_InitHook		= NULL,
-	.Can_InitHook		= NULL,
-	.Com_InitHook		= NULL,
+	.Gpt_InitHook		= Gpt_Init_Hook,
+	.Icu_InitHook		= Icu_Init_Hook,
+	.Adc_InitHook		= Adc_Init_Hook,
+	.Can_InitHook		= Can_Init_Hook,
+	.Com_InitHook		= Com_Init_Hook,
 
 	//App
-	.App_InitHook		= NULL,
+	.App_InitHook		= App_Init_Hook,
 
 	//Deinit
 	.App_DeInitHook		= NULL,
 	.Com_DeInitHook		= NULL,
 	.Can_DeInitHook		= NULL,
+	.Adc_DeInitHook		= Adc_DeInit_Hook,
 	.Icu_DeInitHook		= NULL,
 	.Gpt_DeInitHook		= NULL,
+	.Shell_DeInitHook	= Shell_DeInit_Hook,
+	.Telemetry_DeInitHook	= Telemetry_DeInit_Hook,
 	.Det_DeInitHook		= NULL,
 	.Logger_DeInitHook	= Logger_DeInit_Hook,
 	.UartIf_DeInitHook	= UartIf_DeInit_Hook,
@@ -100,8 +230,8 @@ static const EcuM_HooksType EcuM_Hooks = {
 	.Mcu_DeInitHook		= NULL,
 
 	// Sleep/Wakeup hooks
-	.PreSleepHook		= NULL,
-	.PostWakeupHook		= NULL,
+	.PreSleepHook		= PreSleep_Hook,
+	.PostWakeupHook		= PostWakeup_Hook,
 };
 
 const EcuM_ConfigType EcuM_Config = {
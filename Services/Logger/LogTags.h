@@ -12,12 +12,17 @@
 
 #include "Std_Types.h"
 
+/* Tags are bit masks: one bit per source, matched against Logger tag mask */
 #ifndef LOG_TAG_SYSTEM
-#define LOG_TAG_SYSTEM "SYSTEM_LOG"
+#define LOG_TAG_SYSTEM			(0x00000001u)
 #endif
 
 #ifndef LOG_TAG_SWC_OBTACLE
-#define LOG_TAG_SWC_OBTACLE "SWC_OBS"
+#define LOG_TAG_SWC_OBTACLE		(0x00000002u)
+#endif
+
+#ifndef LOG_TAG_ALL
+#define LOG_TAG_ALL				(0xFFFFFFFFu)
 #endif
 
 #endif /* LOGGER_LOGTAGS_H_ */
@@ -8,7 +8,6 @@
 
 #include "Logger.h"
 #include "Logger_Cfg.h"
-#include "Mcu.h"
 
 #if (LOGGER_CFG_ENABLE == 1)
 
@@ -27,11 +26,29 @@ static Logger_TagMaskType	s_tagMask	= 0xFFFFFFFFu;
 
 static Logger_OutputFnType		s_outWrite	= NULL_PTR;
 static Logger_OutputLineFnType	s_outWriteLine = NULL_PTR;
+static Logger_OutputPartialFnType s_outWritePartial = NULL_PTR;
+
+static uint32					s_dropped	= 0u;
+
+#if (LOGGER_CFG_BACKEND_NONBLOCKING == 1)
+#if ((LOGGER_CFG_QUEUE_SIZE & (LOGGER_CFG_QUEUE_SIZE - 1u)) != 0u) || (LOGGER_CFG_QUEUE_SIZE > 32768u)
+#error "LOGGER_CFG_QUEUE_SIZE must be a power of two <= 32768"
+#endif
+#define LOGGER_Q_MASK				(LOGGER_CFG_QUEUE_SIZE - 1u)
+
+// Byte queue, indexes are free running (used = head - tail)
+static uint8					s_q[LOGGER_CFG_QUEUE_SIZE];
+static uint16					s_qHead		= 0u;
+static uint16					s_qTail		= 0u;
+#endif
 
 #if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 static uint32 (*s_getTimeMs)(void) = NULL_PTR;
 #endif
 
+// Per-level tag gate read inline by the LOG_* macros
+Logger_TagMaskType Logger_GateMask[LOG_LEVEL_DEBUG + 1u];
+
 /* ==============================
  *       INTERNAL HELPERS
  * ============================== */
@@ -102,27 +119,113 @@ static uint16 prv_BuidPrefix(char* buf, uint16 bufsize, Logger_LevelType lv, uin
 #endif
 }
 
-//Push a raw buffer to backend; choose Write/WriteLine appropriately */
-static Std_ReturnType prv_WriteLineRaw(const char* cstr)
+// Rebuild the gate after any change of init state, level or tag mask
+static void prv_UpdateGate(void)
 {
-	if(s_outWriteLine != NULL_PTR)
+#if (LOGGER_CFG_ENABLE_TAG_FILTER == 1)
+	Logger_TagMaskType mask = s_tagMask;
+#else
+	Logger_TagMaskType mask = 0xFFFFFFFFu;
+#endif
+	for(uint8 lv = 0u; lv <= LOG_LEVEL_DEBUG; lv++)
 	{
-		return s_outWriteLine(cstr);
+		boolean on = (s_inited == TRUE) && (lv != LOG_LEVEL_OFF) && (lv <= s_level);
+		Logger_GateMask[lv] = on ? mask : 0u;
 	}
+}
 
-	if(s_outWrite != NULL_PTR)
-	{
-		uint16 len = (uint16) strlen(cstr);
-		if(s_outWrite((const uint8*)cstr,len) != E_OK) return E_NOT_OK;
-#if(LOGGER_CFG_CRLF_STYLE == 1)
-		const uint8 crlf[2] = {'\r','\n'};
-		return s_outWrite(crlf,2u);
+#if (LOGGER_CFG_CRLF_STYLE == 1)
+static const uint8 s_eol[2] = {'\r','\n'};
 #else
-	const uint8 lf[1] = {'\n'};
-	return s_outWrite(lf,1u);
+static const uint8 s_eol[1] = {'\n'};
+#endif
+
+static inline boolean prv_HasBackend(void)
+{
+	return ((s_outWrite != NULL_PTR) || (s_outWriteLine != NULL_PTR) || (s_outWritePartial != NULL_PTR)) ? TRUE : FALSE;
+}
+
+#if (LOGGER_CFG_BACKEND_NONBLOCKING == 1)
+static inline uint16 prv_QFree(void)
+{
+	return (uint16)(LOGGER_CFG_QUEUE_SIZE - (uint16)(s_qHead - s_qTail));
+}
+
+static void prv_QPut(const uint8* d, uint16 n)
+{
+	for(uint16 i = 0u; i < n; i++)
+	{
+		s_q[s_qHead & LOGGER_Q_MASK] = d[i];
+		s_qHead++;
+	}
+}
+
+// Hand queued bytes to the backend until it stops accepting
+static void prv_Drain(void)
+{
+	while(s_qHead != s_qTail)
+	{
+		uint16 idx	= (uint16)(s_qTail & LOGGER_Q_MASK);
+		uint16 used	= (uint16)(s_qHead - s_qTail);
+		uint16 run	= (uint16)(LOGGER_CFG_QUEUE_SIZE - idx);
+		uint16 acc	= 0u;
+		if(run > used) run = used;
+
+		if(s_outWritePartial != NULL_PTR)
+		{
+			(void)s_outWritePartial(&s_q[idx], run, &acc);
+		}
+		else if((s_outWrite != NULL_PTR) && (s_outWrite(&s_q[idx], run) == E_OK))
+		{
+			acc = run;
+		}
+
+		s_qTail = (uint16)(s_qTail + acc);
+		if(acc < run) break;
+	}
+}
 #endif
+
+/*
+ * Push prefix + message (+ EOL) to backend.
+ * Non-blocking build: whole line is queued or dropped, never waits for the UART.
+ */
+static Std_ReturnType prv_Emit(const uint8* pre, uint16 preLen, const uint8* msg, uint16 msgLen, boolean eol)
+{
+	const uint16 eolLen = (eol == TRUE) ? (uint16)sizeof(s_eol) : 0u;
+
+#if (LOGGER_CFG_BACKEND_NONBLOCKING == 1)
+	const uint32 need = (uint32)preLen + msgLen + eolLen;
+
+	if(prv_QFree() < need) prv_Drain();
+	if(prv_QFree() < need)
+	{
+		s_dropped++;
+		return E_NOT_OK;
+	}
+
+	prv_QPut(pre, preLen);
+	prv_QPut(msg, msgLen);
+	prv_QPut(s_eol, eolLen);
+	prv_Drain();
+	return E_OK;
+#else
+	if(s_outWrite != NULL_PTR)
+	{
+		if((preLen > 0u) && (s_outWrite(pre, preLen) != E_OK)) { s_dropped++; return E_NOT_OK; }
+		if((msgLen > 0u) && (s_outWrite(msg, msgLen) != E_OK)) { s_dropped++; return E_NOT_OK; }
+		if((eolLen > 0u) && (s_outWrite(s_eol, eolLen) != E_OK)) { s_dropped++; return E_NOT_OK; }
+		return E_OK;
 	}
+
+	// line backend only: message must be NUL terminated, prefix is not supported
+	if((s_outWriteLine != NULL_PTR) && (preLen == 0u) && (eol == TRUE))
+	{
+		if(s_outWriteLine((const char*)msg) == E_OK) return E_OK;
+	}
+	s_dropped++;
 	return E_NOT_OK;
+#endif
 }
 
 /* ==============================
@@ -144,10 +247,17 @@ void Logger_Init(const Logger_ConfigType* Cfg)
 #endif
 	s_outWrite	= Cfg->outWrite;
 	s_outWriteLine = Cfg->outWriteLine;
+	s_outWritePartial = Cfg->outWritePartial;
+	s_dropped	= 0u;
+#if (LOGGER_CFG_BACKEND_NONBLOCKING == 1)
+	s_qHead		= 0u;
+	s_qTail		= 0u;
+#endif
 #if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 	s_getTimeMs	= Cfg->getTimeMs;
 #endif
 	s_inited	= TRUE;
+	prv_UpdateGate();
 }
 
 void Logger_Deinit(void)
@@ -155,9 +265,11 @@ void Logger_Deinit(void)
 	s_inited = FALSE;
 	s_outWrite = NULL_PTR;
 	s_outWriteLine = NULL_PTR;
+	s_outWritePartial = NULL_PTR;
 #if(LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 	s_getTimeMs = NULL_PTR;
 #endif
+	prv_UpdateGate();
 }
 
 boolean Logger_IsInitialized(void){
@@ -174,6 +286,7 @@ Std_ReturnType Logger_SetLevel(Logger_LevelType level)
 		return E_NOT_OK;
 	}
 	s_level = level;
+	prv_UpdateGate();
 	return E_OK;
 }
 
@@ -186,6 +299,7 @@ Logger_LevelType Logger_GetLevel(void)
 void Logger_SetEnableTags(Logger_TagMaskType mask)
 {
 	s_tagMask = mask;
+	prv_UpdateGate();
 }
 Logger_TagMaskType Logger_GetEnableTags(void)
 {
@@ -204,9 +318,9 @@ Std_ReturnType Logger_Write(const uint8* data, uint16 len)
 #endif
 		return E_NOT_OK;
 	}
-	if(s_outWrite == NULL_PTR) return E_NOT_OK;
+	if(prv_HasBackend() == FALSE) return E_NOT_OK;
 
-	return s_outWrite(data,len);
+	return prv_Emit(NULL_PTR, 0u, data, len, FALSE);
 }
 
 Std_ReturnType Logger_WriteLine(const char* cstr)
@@ -219,7 +333,7 @@ Std_ReturnType Logger_WriteLine(const char* cstr)
 #endif
 		return E_NOT_OK;
 	}
-	return prv_WriteLineRaw(cstr);
+	return prv_Emit(NULL_PTR, 0u, (const uint8*)cstr, (uint16)strlen(cstr), TRUE);
 }
 
 Std_ReturnType Logger_Logf(Logger_LevelType level, uint32 tagMask, const char* fmt,...)
@@ -233,7 +347,7 @@ Std_ReturnType Logger_Logf(Logger_LevelType level, uint32 tagMask, const char* f
 #else
 	(void)tagMask;
 #endif
-	if((fmt == NULL_PTR) || (s_outWrite == NULL_PTR && s_outWriteLine == NULL_PTR))
+	if((fmt == NULL_PTR) || (prv_HasBackend() == FALSE))
 	{
 #if (LOGGER_CFG_DEV_ERROR_DETECT == STD_ON)
 		LOGGER_DET_REPORT(LOGGER_API_ID_LOGF, LOGGER_E_PARAM_POINTER);
@@ -252,32 +366,13 @@ Std_ReturnType Logger_Logf(Logger_LevelType level, uint32 tagMask, const char* f
 	uint16 mLen = (uint16)((m >= (int)sizeof(msg)) ? (sizeof(msg)-1u) : (uint16)m);
 
 	// Send: prefix + message + newline
-	if(pLen > 0u && s_outWrite != NULL_PTR)
-	{
-		if(s_outWrite((const uint8*)prefix,pLen) != E_OK) return E_NOT_OK;
-	}
-	DelayMs(TIME_DELAY_FOR_IQR_HANDER);
-	if(s_outWriteLine != NULL_PTR)
-	{
-		return s_outWriteLine(msg);
-	} else if(s_outWrite != NULL_PTR){
-		if(s_outWrite((const uint8*)msg,mLen) != E_OK)  return E_NOT_OK;
-		DelayMs(TIME_DELAY_FOR_IQR_HANDER);
-#if (LOGGER_CFG_CRLF_STYLE == 1)
-		const uint8 crlf[2] = {'\r','\n'};
-		return s_outWrite(crlf,2u);
-#else
-		const uint8 lf[1] = {'\n'};
-		return s_outWrite(lf,1u);
-#endif
-	}
-	return E_NOT_OK;
+	return prv_Emit((const uint8*)prefix, pLen, (const uint8*)msg, mLen, TRUE);
 }
 
 Std_ReturnType Logger_Printf(const char* fmt, ...)
 {
 	LOGGER_DET_CHK_INIT(LOGGER_API_ID_PRINTF);
-	if((fmt == NULL_PTR) || (s_outWrite == NULL_PTR && s_outWriteLine == NULL_PTR)){
+	if((fmt == NULL_PTR) || (prv_HasBackend() == FALSE)){
 #if(LOGGER_CFG_DEV_ERROR_DETECT == STD_ON)
 		LOGGER_DET_REPORT(LOGGER_API_ID_PRINTF, LOGGER_E_PARAM_POINTER);
 #endif
@@ -293,20 +388,7 @@ Std_ReturnType Logger_Printf(const char* fmt, ...)
 	if( n<0 ) return E_NOT_OK;
 	uint16 len = (uint16)((n >= (int)sizeof(buf)) ? (sizeof(buf)-1) : (uint16)n);
 
-	if(s_outWriteLine != NULL_PTR)
-	{
-		return s_outWriteLine(buf);
-	} else if (s_outWrite != NULL_PTR){
-		if(s_outWrite((const uint8*)buf, len) != E_OK) return E_NOT_OK;
-#if(LOGGER_CFG_CRLF_STYLE == 1)
-		const uint8 crlf[2] = {'\r','\n'};
-		return s_outWrite(crlf,2u);
-#else
-		const uint8 lf[1] = {'\n'};
-		return s_outWrite(lf,1u);
-#endif
-	}
-	return E_NOT_OK;
+	return prv_Emit(NULL_PTR, 0u, (const uint8*)buf, len, TRUE);
 }
 
 Std_ReturnType Logger_HexDump(Logger_LevelType level, uint32 tagMask, const uint8* data, uint16 len)
@@ -362,4 +444,21 @@ Std_ReturnType Logger_HexDump(Logger_LevelType level, uint32 tagMask, const uint
 
 }
 
+void Logger_MainFunction(void)
+{
+	if(s_inited == FALSE)
+	{
+		LOGGER_DET_REPORT(LOGGER_API_ID_MAINFUNCTION, LOGGER_E_UNINIT);
+		return;
+	}
+#if (LOGGER_CFG_BACKEND_NONBLOCKING == 1)
+	prv_Drain();
+#endif
+}
+
+uint32 Logger_GetDroppedCount(void)
+{
+	return s_dropped;
+}
+
 #endif
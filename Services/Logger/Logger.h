@@ -67,6 +67,16 @@ extern "C" {
 #define LOGGER_CFG_ENABLE_TAG_FILTER	(1u)
 #endif
 
+// Highest level compiled into LOG_* sites, see LOG_LOCAL_LEVEL
+#ifndef LOGGER_CFG_COMPILE_LEVEL
+#define LOGGER_CFG_COMPILE_LEVEL		(LOG_LEVEL_INFO)
+#endif
+
+// Tags compiled into LOG_* sites, see LOG_LOCAL_TAG_MASK
+#ifndef LOGGER_CFG_COMPILE_TAG_MASK
+#define LOGGER_CFG_COMPILE_TAG_MASK		(0xFFFFFFFFu)
+#endif
+
 /* ==============================
  *       API IDs (for DET)
  * ============================== */
@@ -81,6 +91,7 @@ extern "C" {
 #define LOGGER_API_ID_PRINTF			(0x09u)
 #define LOGGER_API_ID_LOGF				(0x0Au)
 #define LOGGER_API_ID_HEXDUMP			(0x0Bu)
+#define LOGGER_API_ID_MAINFUNCTION		(0x0Cu)
 
 /* ==============================
  *       DET ERROR CODES
@@ -107,6 +118,7 @@ typedef uint8 	Logger_LevelType; // Log_LEVEL_OFF/ERROR/WARN/INFO/DEBUG
 typedef uint32 	Logger_TagMaskType; //Bitmask
 typedef Std_ReturnType (*Logger_OutputFnType)(const uint8* data, uint16 len); // Backend function
 typedef Std_ReturnType (*Logger_OutputLineFnType)(const char* sctr);
+typedef Std_ReturnType (*Logger_OutputPartialFnType)(const uint8* data, uint16 len, uint16* accepted); // take what fits
 //config runtime for Logger
 typedef struct
 {
@@ -114,6 +126,7 @@ typedef struct
 	Logger_TagMaskType 		enableTagsMask;		//Bitmask tag.
 	Logger_OutputFnType		outWrite;			// out raw bytes
 	Logger_OutputLineFnType outWriteLine; 		// out a line (CR/LF)
+	Logger_OutputPartialFnType outWritePartial;	// drain for the non-blocking queue (optional)
 #if(LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 	uint32					(*getTimeMs)(void);
 #endif
@@ -158,6 +171,15 @@ Std_ReturnType Logger_Printf(const char* fmt, ...);
  */
 Std_ReturnType Logger_HexDump(Logger_LevelType level, uint32 tagMask, const uint8* data, uint16 len);
 
+/*
+ * Drain queued lines to the backend as far as it accepts, never waits.
+ * Call from the background loop.
+ */
+void Logger_MainFunction(void);
+
+/* Lines lost because the queue was full */
+uint32 Logger_GetDroppedCount(void);
+
 #else // LOGGER_CFG_ENABLE == 0
 static inline void Logger_Init(const Logger_ConfigType* cfg) {(void)Cfg;}
 static inline void Logger_Deinit(void) {}
@@ -169,6 +191,8 @@ static inline Std_ReturnType Logger_WriteLine(const char* s) {(void)s; return E_
 static inline Std_ReturnType Logger_Logf(Logger_LevelType lv, uint32 tg, const char* f, ...) {(void) lv;(void)tg;(void)f;return E_OK;}
 static inline Std_ReturnType Logger_Printf(const char* f, ...) {(void)f; return E_OK;}
 static inline Std_ReturnType Logger_HexDump(Logger_LevelType lv, uint32 tg, const uint8* d, uint16 l) {(void)lv;(void) tg; (void)d, (void)l; return E_OK;}
+static inline void Logger_MainFunction(void) {}
+static inline uint32 Logger_GetDroppedCount(void) {return 0u;}
 #endif //LOGGER_CFG_ENABLE
 
 /* ==============================
@@ -194,11 +218,62 @@ static inline Std_ReturnType Logger_HexDump(Logger_LevelType lv, uint32 tg, cons
 #define LOG_LEVEL_DEBUG		4u
 #endif
 
+/*
+ * Compile-time filter. A translation unit may define LOG_LOCAL_LEVEL and/or
+ * LOG_LOCAL_TAG_MASK before its first include of Logger.h to narrow it further.
+ * Sites above the level are removed by the preprocessor (arguments and format
+ * string included), sites whose tag is outside the mask fold to a constant
+ * false branch.
+ */
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL			LOGGER_CFG_COMPILE_LEVEL
+#endif
+
+#ifndef LOG_LOCAL_TAG_MASK
+#define LOG_LOCAL_TAG_MASK		LOGGER_CFG_COMPILE_TAG_MASK
+#endif
+
+#if (LOGGER_CFG_ENABLE == 1)
+/*
+ * Run-time gate: Logger_GateMask[lv] holds the tags enabled at level lv
+ * (0 when lv is above the current level or the logger is down), so an
+ * enabled site costs one load + test before any argument is evaluated.
+ */
+extern Logger_TagMaskType Logger_GateMask[LOG_LEVEL_DEBUG + 1u];
+
+#define LOGGER_GATE(LV, TAG) \
+	(((((uint32)(TAG)) & (uint32)(LOG_LOCAL_TAG_MASK)) != 0u) && ((Logger_GateMask[(LV)] & (uint32)(TAG)) != 0u))
+
+#define LOGGER_LOG_SITE(LV, TAG, FMT, ...) \
+	do { if(LOGGER_GATE((LV), (TAG))) { (void)Logger_Logf((LV), (uint32)(TAG), FMT, ##__VA_ARGS__); } } while(0)
+#else
+#define LOGGER_LOG_SITE(LV, TAG, FMT, ...)	do { } while(0)
+#endif
+
 /* Macro follow level tag */
-#define LOG_ERROR(TAG, FMT, ...) (void)Logger_Logf(LOG_LEVEL_ERROR, (uint32)(TAG), FMT, ##__VA_ARGS__)
-#define LOG_WARN(TAG, FMT, ...) (void)Logger_Logf(LOG_LEVEL_WARN, (uint32)(TAG), FMT, ##__VA_ARGS__)
-#define LOG_INFO(TAG, FMT, ...) (void)Logger_Logf(LOG_LEVEL_INFO, (uint32)(TAG), FMT, ##__VA_ARGS__)
-#define LOG_DEBUG(TAG, FMT, ...) (void)Logger_Logf(LOG_LEVEL_DEBUG, (uint32)(TAG), FMT, ##__VA_ARGS__)
+#if (LOG_LOCAL_LEVEL >= LOG_LEVEL_ERROR)
+#define LOG_ERROR(TAG, FMT, ...)	LOGGER_LOG_SITE(LOG_LEVEL_ERROR, TAG, FMT, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(TAG, FMT, ...)	do { } while(0)
+#endif
+
+#if (LOG_LOCAL_LEVEL >= LOG_LEVEL_WARN)
+#define LOG_WARN(TAG, FMT, ...)		LOGGER_LOG_SITE(LOG_LEVEL_WARN, TAG, FMT, ##__VA_ARGS__)
+#else
+#define LOG_WARN(TAG, FMT, ...)		do { } while(0)
+#endif
+
+#if (LOG_LOCAL_LEVEL >= LOG_LEVEL_INFO)
+#define LOG_INFO(TAG, FMT, ...)		LOGGER_LOG_SITE(LOG_LEVEL_INFO, TAG, FMT, ##__VA_ARGS__)
+#else
+#define LOG_INFO(TAG, FMT, ...)		do { } while(0)
+#endif
+
+#if (LOG_LOCAL_LEVEL >= LOG_LEVEL_DEBUG)
+#define LOG_DEBUG(TAG, FMT, ...)	LOGGER_LOG_SITE(LOG_LEVEL_DEBUG, TAG, FMT, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(TAG, FMT, ...)	do { } while(0)
+#endif
 
 /* =========================================================
  * 	 Global configuration
@@ -11,6 +11,7 @@
 
 extern Std_ReturnType UartIf_Write(const uint8* DataPtr, uint16 Length);
 extern Std_ReturnType UartIf_WriteLine(const char* CStr);
+extern Std_ReturnType UartIf_WritePartial(const uint8* DataPtr, uint16 Length, uint16* AcceptedPtr);
 
 #if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 static uint32 My_GetMs(void){return 0u;}
@@ -21,6 +22,7 @@ const Logger_ConfigType Logger_Config = {
 		.enableTagsMask		= 0xFFFFFFFFu,
 		.outWrite			= UartIf_Write,
 		.outWriteLine		= UartIf_WriteLine,
+		.outWritePartial	= UartIf_WritePartial,
 #if (LOGGER_CFG_ENABLE_TIMESTAMP_MS == 1)
 		.getTimeMs			= My_GetMs
 #endif
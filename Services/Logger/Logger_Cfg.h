@@ -55,10 +55,16 @@ extern "C" {
 #define LOGGER_CFG_CRLF_STYLE	(1u)
 #endif
 
+/* 1: lines go to an internal queue drained by Logger_MainFunction, 0: written straight to the backend */
 #ifndef LOGGER_CFG_BACKEND_NONBLOCKING
 #define LOGGER_CFG_BACKEND_NONBLOCKING	(1u)
 #endif
 
+/* Size of the non-blocking queue in bytes, power of two */
+#ifndef LOGGER_CFG_QUEUE_SIZE
+#define LOGGER_CFG_QUEUE_SIZE	(512u)
+#endif
+
 #ifndef LOGGER_CFG_MAX_LINE_LEN
 #define LOGGER_CFG_MAX_LINE_LEN	(1u)
 #endif
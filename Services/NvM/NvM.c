@@ -0,0 +1,432 @@
+/* =====================================================================================================================
+ *  File        : NvM.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : NV memory manager: log-structured records in a flash page pair, RAM copies, background writes
+ *  Notes       : Page: header { magic, generation, state, reserved } then records { id, length, CRC16, data } up to
+ * 				  the first erased half-word. The state half-word is programmed to 0x0000 once a swap has copied
+ * 				  every block, the page with the newer generation of the valid ones is active.
+ * 				  The CRC (CCITT-FALSE) covers id, length and data. An unknown header or a non-erased tail marks the
+ * 				  page dirty: the next write swaps first.
+ * 				  A failed job is retried after NVM_CFG_RETRY_DELAY_MS, NVM_CFG_RETRY_MAX failures before a write or
+ * 				  swap completes leave the flash alone (NVM_STATE_FAILED, Det and Dem report).
+ * 				  NvM_WriteBlock callers and NvM_MainFunction share the main loop, no locking.
+ *  Depends     : NvM.h, NvM_Cfg.h, Fls.h, Fls_Cfg.h, Crc.h, Det.h, Dem.h, Mcu.h (SysTick)
+ * ===================================================================================================================*/
+
+#include "NvM.h"
+#include "NvM_Cfg.h"
+#include "Fls.h"
+#include "Fls_Cfg.h"
+#include "Crc.h"
+#include "Dem.h"
+#include "Mcu.h"
+#include <string.h>
+
+#define NVM_PAGE_MAGIC						(0x4E56u)	// "VN"
+#define NVM_PAGE_VALID						(0x0000u)
+#define NVM_HEADER_SIZE						(8u)
+#define NVM_STATE_OFFSET					(4u)
+#define NVM_RECORD_HEADER					(4u)		// id, length, CRC16
+#define NVM_RECORD_SIZE(_len)				((uint16)(NVM_RECORD_HEADER + (((uint16)(_len) + 1u) & ~1u)))
+#define NVM_NO_PAGE							(0xFFu)
+
+#if (NVM_CFG_PAGE0_ADDRESS < FLS_CFG_WRITABLE_START) || ((NVM_CFG_PAGE0_ADDRESS % FLS_CFG_PAGE_SIZE) != 0u)
+#error "NVM_CFG_PAGE0_ADDRESS must be a writable flash page"
+#endif
+
+#if (NVM_CFG_PAGE_SIZE != FLS_CFG_PAGE_SIZE) || ((NVM_CFG_PAGE1_ADDRESS + NVM_CFG_PAGE_SIZE) > (FLS_CFG_BASE_ADDRESS + FLS_CFG_TOTAL_SIZE))
+#error "NvM page pair must be two flash pages inside the device"
+#endif
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static const NvM_ConfigType*	s_cfg		= NULL_PTR;
+static NvM_StatusType			s_status;
+static uint8					s_ram[NVM_CFG_BLOCK_COUNT][NVM_CFG_BLOCK_MAX_LENGTH];
+static uint16					s_end;					// log end in the active page
+static boolean					s_pageDirty;			// active page cannot take another record
+static uint8					s_target;				// page of the running swap
+static uint16					s_next;					// write offset in the target page
+static uint8					s_copyId;				// next block the swap copies
+static uint16					s_jobLen;				// record of the running Fls job
+static uint16					s_jobMask;				// blocks the running write / swap took from DirtyMask
+static uint8					s_failStreak;			// failures since the last completed write / swap
+static uint32					s_retryMs;				// SysTick before which no job starts after a failure
+
+// Record or header being programmed, unchanged until its Fls job ends
+static uint8					s_buf[NVM_RECORD_HEADER + NVM_CFG_BLOCK_MAX_LENGTH];
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static Fls_AddressType prv_PageAddr(uint8 Page)
+{
+	return (Page == 0u) ? NVM_CFG_PAGE0_ADDRESS : NVM_CFG_PAGE1_ADDRESS;
+}
+
+static uint16 prv_Get16(const uint8* p)
+{
+	return (uint16)((uint16)p[0] | ((uint16)p[1] << 8));
+}
+
+static void prv_Put16(uint8* p, uint16 v)
+{
+	p[0] = (uint8)v;
+	p[1] = (uint8)(v >> 8);
+}
+
+// CRC of the record in s_buf: id, length, data
+static uint16 prv_RecordCrc(uint8 Len)
+{
+	uint16 crc = Crc_CalculateCRC16(s_buf, 2u, 0u, TRUE);
+	return Crc_CalculateCRC16(&s_buf[NVM_RECORD_HEADER], Len, crc, FALSE);
+}
+
+// Record of the RAM copy into s_buf, the block is clean from here on. Returns the size
+static uint16 prv_BuildRecord(NvM_BlockIdType Id)
+{
+	uint8 len = s_cfg->Blocks[Id].Length;
+
+	s_buf[0] = Id;
+	s_buf[1] = len;
+	memcpy(&s_buf[NVM_RECORD_HEADER], s_ram[Id], len);
+	if((len & 1u) != 0u) s_buf[NVM_RECORD_HEADER + len] = 0xFFu;
+	prv_Put16(&s_buf[2], prv_RecordCrc(len));
+
+	s_status.DirtyMask	&= (uint16)~(1u << Id);
+	s_jobMask			|= (uint16)(1u << Id);
+	s_jobLen			= NVM_RECORD_SIZE(len);
+	return s_jobLen;
+}
+
+// Job refused or failed: the blocks it took are written again after the retry delay, a swap restarts with the
+// erase. A streak that reaches the limit gives the flash up
+static void prv_Fail(void)
+{
+	if(s_status.Failures < 0xFFFFu) s_status.Failures++;
+	s_status.DirtyMask	|= s_jobMask;
+	s_jobMask			= 0u;
+	s_retryMs			= s_systickTicks + NVM_CFG_RETRY_DELAY_MS;
+
+	if(++s_failStreak < NVM_CFG_RETRY_MAX)
+	{
+		s_status.State = NVM_STATE_IDLE;
+		return;
+	}
+
+	s_status.State = NVM_STATE_FAILED;
+	NVM_DET_REPORT(NVM_API_ID_MAINFUNCTION, NVM_E_REQ_FAILED);
+	(void)Dem_SetEventStatus(DEM_EVENT_NVM_FAILED, DEM_EVENT_STATUS_FAILED);
+}
+
+// Write or swap through: the flash works, a streak of failures is over
+static void prv_Done(void)
+{
+	s_jobMask		= 0u;
+	s_status.State	= NVM_STATE_IDLE;
+	if(s_failStreak == 0u) return;
+
+	s_failStreak = 0u;
+	(void)Dem_SetEventStatus(DEM_EVENT_NVM_FAILED, DEM_EVENT_STATUS_PASSED);
+}
+
+static void prv_Job(Std_ReturnType Started, NvM_StateType Next)
+{
+	if(Started == E_OK)	s_status.State = Next;
+	else				prv_Fail();
+}
+
+static void prv_StartSwap(void)
+{
+	s_target	= (s_status.ActivePage == 0u) ? 1u : 0u;
+	s_jobMask	= 0u;
+	prv_Job(Fls_Erase(prv_PageAddr(s_target), NVM_CFG_PAGE_SIZE), NVM_STATE_ERASE);
+}
+
+// Next block with data into the target page, then the commit
+static void prv_CopyNext(void)
+{
+	while((s_copyId < NVM_CFG_BLOCK_COUNT) && ((s_status.ValidMask & (1u << s_copyId)) == 0u)) s_copyId++;
+
+	if(s_copyId < NVM_CFG_BLOCK_COUNT)
+	{
+		uint16 size = prv_BuildRecord(s_copyId++);
+		prv_Job(Fls_Write(prv_PageAddr(s_target) + s_next, s_buf, size), NVM_STATE_COPY);
+		return;
+	}
+
+	prv_Put16(s_buf, NVM_PAGE_VALID);
+	prv_Job(Fls_Write(prv_PageAddr(s_target) + NVM_STATE_OFFSET, s_buf, 2u), NVM_STATE_COMMIT);
+}
+
+static void prv_Idle(void)
+{
+	NvM_BlockIdType id = 0u;
+	uint16 size;
+
+	if(s_status.DirtyMask == 0u) return;
+	if((s_failStreak != 0u) && ((sint32)(s_systickTicks - s_retryMs) < 0)) return;
+
+	if((s_status.ActivePage == NVM_NO_PAGE) || (s_pageDirty == TRUE))
+	{
+		prv_StartSwap();
+		return;
+	}
+
+	while((s_status.DirtyMask & (1u << id)) == 0u) id++;
+	if((s_end + NVM_RECORD_SIZE(s_cfg->Blocks[id].Length)) > NVM_CFG_PAGE_SIZE)
+	{
+		prv_StartSwap();
+		return;
+	}
+
+	s_jobMask	= 0u;
+	size		= prv_BuildRecord(id);
+	prv_Job(Fls_Write(prv_PageAddr(s_status.ActivePage) + s_end, s_buf, size), NVM_STATE_WRITE);
+}
+
+static void prv_JobDone(void)
+{
+	switch(s_status.State)
+	{
+	case NVM_STATE_WRITE:
+		s_end += s_jobLen;
+		if(s_status.Writes < 0xFFFFu) s_status.Writes++;
+		prv_Done();
+		break;
+
+	case NVM_STATE_ERASE:
+		prv_Put16(&s_buf[0], NVM_PAGE_MAGIC);
+		prv_Put16(&s_buf[2], (uint16)(s_status.Generation + 1u));
+		prv_Job(Fls_Write(prv_PageAddr(s_target), s_buf, 4u), NVM_STATE_HEADER);
+		break;
+
+	case NVM_STATE_HEADER:
+		s_next		= NVM_HEADER_SIZE;
+		s_copyId	= 0u;
+		prv_CopyNext();
+		break;
+
+	case NVM_STATE_COPY:
+		s_next += s_jobLen;
+		prv_CopyNext();
+		break;
+
+	default:	// COMMIT: the old page is history
+		s_status.ActivePage	= s_target;
+		s_status.Generation	= (uint16)(s_status.Generation + 1u);
+		s_end				= s_next;
+		s_pageDirty			= FALSE;
+		if(s_status.Swaps < 0xFFFFu) s_status.Swaps++;
+		prv_Done();
+		break;
+	}
+}
+
+static boolean prv_PageValid(uint8 Page, uint16* Generation)
+{
+	uint8 h[NVM_HEADER_SIZE];
+
+	if(Fls_Read(prv_PageAddr(Page), h, NVM_HEADER_SIZE) != E_OK) return FALSE;
+
+	*Generation = prv_Get16(&h[2]);
+	return ((prv_Get16(&h[0]) == NVM_PAGE_MAGIC) && (prv_Get16(&h[NVM_STATE_OFFSET]) == NVM_PAGE_VALID)) ? TRUE : FALSE;
+}
+
+// Records of the active page into the RAM copies, the later record of a block wins
+static void prv_Scan(void)
+{
+	Fls_AddressType page = prv_PageAddr(s_status.ActivePage);
+	uint16 off = NVM_HEADER_SIZE;
+
+	while((off + NVM_RECORD_HEADER) <= NVM_CFG_PAGE_SIZE)
+	{
+		uint8 id;
+		uint8 len;
+		uint16 size;
+
+		(void)Fls_Read(page + off, s_buf, NVM_RECORD_HEADER);
+		if((s_buf[0] == 0xFFu) && (s_buf[1] == 0xFFu)) break;
+
+		// a header the block table does not know was torn: nothing behind it can be parsed
+		id		= s_buf[0];
+		len		= s_buf[1];
+		size	= NVM_RECORD_SIZE(len);
+		if((id >= NVM_CFG_BLOCK_COUNT) || (len != s_cfg->Blocks[id].Length) || ((off + size) > NVM_CFG_PAGE_SIZE))
+		{
+			s_pageDirty = TRUE;
+			break;
+		}
+
+		(void)Fls_Read(page + off + NVM_RECORD_HEADER, &s_buf[NVM_RECORD_HEADER], (Fls_LengthType)(size - NVM_RECORD_HEADER));
+		if(prv_RecordCrc(len) == prv_Get16(&s_buf[2]))
+		{
+			memcpy(s_ram[id], &s_buf[NVM_RECORD_HEADER], len);
+			s_status.ValidMask |= (uint16)(1u << id);
+		} else if(s_status.CrcErrors < 0xFFFFu) {
+			s_status.CrcErrors++;
+		}
+		off += size;
+	}
+
+	s_end = off;
+	if((s_pageDirty == FALSE) && (off < NVM_CFG_PAGE_SIZE) && (Fls_BlankCheck(page + off, NVM_CFG_PAGE_SIZE - off) != E_OK))
+	{
+		s_pageDirty = TRUE;
+	}
+}
+
+// Every block fits, and a swap leaves room for one more record
+static boolean prv_ConfigValid(const NvM_ConfigType* ConfigPtr)
+{
+	uint32 total = NVM_HEADER_SIZE + NVM_RECORD_SIZE(NVM_CFG_BLOCK_MAX_LENGTH);
+	uint8 i;
+
+	if((ConfigPtr->Blocks == NULL_PTR) || (ConfigPtr->BlockCount != NVM_CFG_BLOCK_COUNT)) return FALSE;
+
+	for(i = 0u; i < NVM_CFG_BLOCK_COUNT; i++)
+	{
+		uint8 len = ConfigPtr->Blocks[i].Length;
+
+		if((len == 0u) || (len > NVM_CFG_BLOCK_MAX_LENGTH)) return FALSE;
+		total += NVM_RECORD_SIZE(len);
+	}
+	return (total <= NVM_CFG_PAGE_SIZE) ? TRUE : FALSE;
+}
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void NvM_Init(const NvM_ConfigType* ConfigPtr)
+{
+	uint16 gen0 = 0u;
+	uint16 gen1 = 0u;
+	boolean ok0;
+	boolean ok1;
+
+	if(ConfigPtr == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_INIT, NVM_E_PARAM_POINTER);
+		return;
+	}
+	if(prv_ConfigValid(ConfigPtr) == FALSE)
+	{
+		NVM_DET_REPORT(NVM_API_ID_INIT, NVM_E_WRONG_CONFIGURATION);
+		return;
+	}
+
+	s_cfg = ConfigPtr;
+	memset(&s_status, 0, sizeof(s_status));
+	memset(s_ram, 0, sizeof(s_ram));
+	s_status.ActivePage	= NVM_NO_PAGE;
+	s_end				= NVM_HEADER_SIZE;
+	s_pageDirty			= FALSE;
+	s_jobMask			= 0u;
+	s_failStreak		= 0u;
+
+	// both valid: the older one is the page the last swap left behind
+	ok0 = prv_PageValid(0u, &gen0);
+	ok1 = prv_PageValid(1u, &gen1);
+	if((ok0 == TRUE) && ((ok1 == FALSE) || ((sint16)(gen0 - gen1) > 0)))
+	{
+		s_status.ActivePage	= 0u;
+		s_status.Generation	= gen0;
+	} else if(ok1 == TRUE) {
+		s_status.ActivePage	= 1u;
+		s_status.Generation	= gen1;
+	}
+
+	if(s_status.ActivePage != NVM_NO_PAGE) prv_Scan();
+	s_status.State = NVM_STATE_IDLE;
+}
+
+Std_ReturnType NvM_ReadBlock(NvM_BlockIdType BlockId, void* DstPtr)
+{
+	if(s_cfg == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_READBLOCK, NVM_E_UNINIT);
+		return E_NOT_OK;
+	}
+	if(BlockId >= NVM_CFG_BLOCK_COUNT)
+	{
+		NVM_DET_REPORT(NVM_API_ID_READBLOCK, NVM_E_PARAM_BLOCK_ID);
+		return E_NOT_OK;
+	}
+	if(DstPtr == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_READBLOCK, NVM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+	if((s_status.ValidMask & (1u << BlockId)) == 0u) return E_NOT_OK;
+
+	memcpy(DstPtr, s_ram[BlockId], s_cfg->Blocks[BlockId].Length);
+	return E_OK;
+}
+
+Std_ReturnType NvM_WriteBlock(NvM_BlockIdType BlockId, const void* SrcPtr)
+{
+	uint16 bit;
+	uint8 len;
+
+	if(s_cfg == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_WRITEBLOCK, NVM_E_UNINIT);
+		return E_NOT_OK;
+	}
+	if(BlockId >= NVM_CFG_BLOCK_COUNT)
+	{
+		NVM_DET_REPORT(NVM_API_ID_WRITEBLOCK, NVM_E_PARAM_BLOCK_ID);
+		return E_NOT_OK;
+	}
+	if(SrcPtr == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_WRITEBLOCK, NVM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+
+	bit = (uint16)(1u << BlockId);
+	len = s_cfg->Blocks[BlockId].Length;
+	if(((s_status.ValidMask & bit) != 0u) && (memcmp(s_ram[BlockId], SrcPtr, len) == 0)) return E_OK;
+
+	memcpy(s_ram[BlockId], SrcPtr, len);
+	s_status.ValidMask |= bit;
+	s_status.DirtyMask |= bit;
+	return E_OK;
+}
+
+Std_ReturnType NvM_GetStatus(NvM_StatusType* StatusPtr)
+{
+	if(StatusPtr == NULL_PTR)
+	{
+		NVM_DET_REPORT(NVM_API_ID_GETSTATUS, NVM_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+
+	*StatusPtr				= s_status;
+	StatusPtr->FreeBytes	= (s_status.ActivePage == NVM_NO_PAGE) ? 0u : (uint16)(NVM_CFG_PAGE_SIZE - s_end);
+	return E_OK;
+}
+
+void NvM_MainFunction(void)
+{
+	if((s_cfg == NULL_PTR) || (s_status.State == NVM_STATE_FAILED)) return;
+
+	if(s_status.State == NVM_STATE_IDLE)
+	{
+		prv_Idle();
+		return;
+	}
+
+	if(Fls_GetStatus() == FLS_BUSY) return;
+
+	if(Fls_GetJobResult() != FLS_JOB_OK)
+	{
+		// the append may have left programmed bytes past the log end
+		if(s_status.State == NVM_STATE_WRITE) s_pageDirty = TRUE;
+		prv_Fail();
+		return;
+	}
+	prv_JobDone();
+}
@@ -0,0 +1,141 @@
+/* =====================================================================================================================
+ *  File        : NvM.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : NV memory manager: fixed-length blocks in the internal flash with RAM copies
+ * 					- NvM_Init loads the latest valid record of every block into its RAM copy
+ * 					- NvM_WriteBlock updates the RAM copy only (write-behind), NvM_MainFunction appends a record
+ * 					  { id, length, CRC16, data } to the active page in the background; unchanged data is not written
+ * 					- full page: the other page of the pair is erased and gets the latest record of each block, the
+ * 					  page header is committed last, so both pages wear evenly and a torn swap keeps the old page
+ * 					- a torn record fails its CRC and the block keeps its previous value
+ *  Depends     : Std_Types.h, NvM_Cfg.h, Det.h
+ * ===================================================================================================================*/
+
+#ifndef NVM_NVM_H_
+#define NVM_NVM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "NvM_Cfg.h"
+#include "Det.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define NVM_VENDOR_ID						(0x00u)
+#define NVM_MODULE_ID						(0x14u)
+#define NVM_INSTANCE_ID						(0x00u)
+
+#define NVM_SW_MAJOR_VERSION				(1u)
+#define NVM_SW_MINOR_VERSION				(0u)
+#define NVM_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *       BUILD-TIME SWITCHES
+ * ============================== */
+#ifndef NVM_DEV_ERROR_DETECT
+#define NVM_DEV_ERROR_DETECT				STD_ON
+#endif
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define NVM_API_ID_INIT						(0x00u)
+#define NVM_API_ID_GETSTATUS				(0x04u)
+#define NVM_API_ID_READBLOCK				(0x06u)
+#define NVM_API_ID_WRITEBLOCK				(0x07u)
+#define NVM_API_ID_MAINFUNCTION				(0x0Eu)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define NVM_E_PARAM_BLOCK_ID				(0x0Au)
+#define NVM_E_PARAM_POINTER					(0x0Eu)
+#define NVM_E_WRONG_CONFIGURATION			(0x10u)
+#define NVM_E_UNINIT						(0x14u)
+#define NVM_E_REQ_FAILED					(0x1Cu)	// NVM_CFG_RETRY_MAX jobs failed in a row, flash no longer used
+
+#if (NVM_DEV_ERROR_DETECT == STD_ON)
+#define NVM_DET_REPORT(_api, _err)\
+	Det_ReportError(NVM_MODULE_ID, NVM_INSTANCE_ID, (_api), (_err))
+#else
+#define NVM_DET_REPORT(_api, _err) ((void)0)
+#endif
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+typedef uint8 NvM_BlockIdType;
+
+typedef struct
+{
+	uint8	Length;							// bytes, 1 .. NVM_CFG_BLOCK_MAX_LENGTH
+} NvM_BlockCfgType;
+
+typedef struct
+{
+	const NvM_BlockCfgType*	Blocks;			// NVM_CFG_BLOCK_COUNT, index = block id
+	uint8					BlockCount;
+} NvM_ConfigType;
+
+typedef enum
+{
+	NVM_STATE_UNINIT			= 0,
+	NVM_STATE_IDLE,
+	NVM_STATE_WRITE,						// record appended to the active page
+	NVM_STATE_ERASE,						// swap: other page erased
+	NVM_STATE_HEADER,						// swap: page header (magic, generation)
+	NVM_STATE_COPY,							// swap: latest record of each block
+	NVM_STATE_COMMIT,						// swap: header marked valid, the new page becomes active
+	NVM_STATE_FAILED						// retry limit reached: RAM copies only until the next NvM_Init
+} NvM_StateType;
+
+typedef struct
+{
+	NvM_StateType	State;
+	uint8			ActivePage;				// 0 / 1, 0xFF: none formatted yet
+	uint16			Generation;				// of the active page, + 1 per swap
+	uint16			FreeBytes;				// left in the active page
+	uint16			ValidMask;				// blocks with data (read at init or written since)
+	uint16			DirtyMask;				// RAM copies not in flash yet
+	uint16			Writes;					// records appended
+	uint16			Swaps;
+	uint16			CrcErrors;				// records skipped at init (torn / corrupt)
+	uint16			Failures;				// Fls jobs that failed (or were refused)
+} NvM_StatusType;
+
+/* ==============================
+ *             API
+ * ============================== */
+// Scan both pages (synchronous, reads only), load the RAM copies. Fls must be initialised
+void NvM_Init(const NvM_ConfigType* ConfigPtr);
+
+// Copy the RAM copy of BlockId to DstPtr. E_NOT_OK: not initialised, unknown block or never written
+Std_ReturnType NvM_ReadBlock(NvM_BlockIdType BlockId, void* DstPtr);
+
+/**
+ * @brief  Update the RAM copy of BlockId from SrcPtr (configured length), flushed by NvM_MainFunction.
+ *         Data equal to the RAM copy is not written again
+ * @return E_NOT_OK: not initialised or unknown block
+ */
+Std_ReturnType NvM_WriteBlock(NvM_BlockIdType BlockId, const void* SrcPtr);
+
+Std_ReturnType NvM_GetStatus(NvM_StatusType* StatusPtr);
+
+// Write-behind: starts at most one Fls job per call and never waits for one, call every main loop pass
+void NvM_MainFunction(void);
+
+/* ==============================
+ *       CONFIG
+ * ============================== */
+extern const NvM_ConfigType NvM_Config;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_NVM_H_ */
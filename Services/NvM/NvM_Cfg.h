@@ -0,0 +1,65 @@
+/* =====================================================================================================================
+ *  File        : NvM_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of the NV memory manager (block IDs, flash page pair, RAM copy size)
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef NVM_NVM_CFG_H_
+#define NVM_NVM_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* Block IDs, index of NvM_Config.Blocks (NvM_PBcfg.c) */
+#define NVM_BLOCK_OBSTACLE_CAL				(0u)	// ObstacleDetection calibration
+#define NVM_BLOCK_DEM						(1u)	// Dem event memory and persistent status bits
+
+#define NVM_CFG_BLOCK_COUNT					(2u)
+
+/* Largest block, size of each RAM copy */
+#ifndef NVM_CFG_BLOCK_MAX_LENGTH
+#define NVM_CFG_BLOCK_MAX_LENGTH			(44u)
+#endif
+
+/* Page pair: the last two 1 KB pages of the C6T6, above FLS_CFG_WRITABLE_START. One page holds the log, the other
+ * one is erased and rewritten with the latest record of each block when the log is full */
+#ifndef NVM_CFG_PAGE0_ADDRESS
+#define NVM_CFG_PAGE0_ADDRESS				(0x08007800UL)
+#endif
+
+#define NVM_CFG_PAGE_SIZE					(0x400UL)
+#define NVM_CFG_PAGE1_ADDRESS				(NVM_CFG_PAGE0_ADDRESS + NVM_CFG_PAGE_SIZE)
+
+/* Failed Fls job (erase / program error): the blocks stay dirty and the next job waits this long. After
+ * NVM_CFG_RETRY_MAX failures without a completed write or swap NvM stops using the flash until the next NvM_Init
+ * and reports DEM_EVENT_NVM_FAILED: a page that keeps failing is not erased in a loop */
+#ifndef NVM_CFG_RETRY_DELAY_MS
+#define NVM_CFG_RETRY_DELAY_MS				(500u)
+#endif
+
+#ifndef NVM_CFG_RETRY_MAX
+#define NVM_CFG_RETRY_MAX					(3u)
+#endif
+
+#if (NVM_CFG_BLOCK_COUNT > 16u)
+#error "NVM_CFG_BLOCK_COUNT must fit the 16 bit block masks"
+#endif
+
+#if (NVM_CFG_BLOCK_MAX_LENGTH > 254u) || ((NVM_CFG_BLOCK_MAX_LENGTH & 1u) != 0u)
+#error "NVM_CFG_BLOCK_MAX_LENGTH must be even and fit the 8 bit record length"
+#endif
+
+#if (NVM_CFG_RETRY_MAX == 0u) || (NVM_CFG_RETRY_MAX > 255u)
+#error "NVM_CFG_RETRY_MAX must be 1 .. 255"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_NVM_CFG_H_ */
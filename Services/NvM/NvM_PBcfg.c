@@ -0,0 +1,23 @@
+/* =====================================================================================================================
+ *  File        : NvM_PBcfg.c
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Block table of the NV memory manager, lengths from the RAM images of the owners
+ *  Depends     : NvM.h, Dem.h, ObstacleDetection_Types.h
+ * ===================================================================================================================*/
+
+#include "NvM.h"
+#include "Dem.h"
+#include "ObstacleDetection_Types.h"
+
+static const NvM_BlockCfgType NvM_Blocks[NVM_CFG_BLOCK_COUNT] =
+{
+	[NVM_BLOCK_OBSTACLE_CAL]	= { .Length = (uint8)sizeof(ObstacleDetection_CalibrationType) },
+	[NVM_BLOCK_DEM]				= { .Length = (uint8)sizeof(Dem_NvDataType) }
+};
+
+const NvM_ConfigType NvM_Config =
+{
+	.Blocks		= NvM_Blocks,
+	.BlockCount	= NVM_CFG_BLOCK_COUNT
+};
@@ -8,6 +8,7 @@
 
 #include "PduR.h"
 #include "CanIf.h"
+#include "Com.h"
 
 static PduR_ConfigTypes* PduR_ConfigPtr = NULL_PTR;
 
@@ -39,7 +40,7 @@ void PduR_CanIfRxIndication(
 			// Route to COM
 			if(route->DstModule == PDUR_MODULE_APP)
 			{
-//				App_RxIndication(route->DstPduId,PduInfoPtr);
+				Com_RxIndication(route->DstPduId, PduInfoPtr);
 			}
 			break;
 		}
@@ -62,7 +63,7 @@ void PduR_CanIfTxConfirmation( PduIdType	TxPduId )
 		{
 			if(route->SrcModule == PDUR_MODULE_APP)
 			{
-//				App_TxConfirmation(route->SrcPduId);
+				Com_TxConfirmation(route->SrcPduId);
 			}
 			break;
 		}
@@ -82,7 +83,7 @@ Std_ReturnType PduR_ComTransmit(
 	for( i = 0; i < PduR_ConfigPtr->NumTxRoutes; i++)
 	{
 		route = &PduR_ConfigPtr->TxRoutes[i];
-		if((route->SrcModule == PDUR_MODULE_APP) || (route->SrcPduId == TxPduId))
+		if((route->SrcModule == PDUR_MODULE_APP) && (route->SrcPduId == TxPduId))
 		{
 			if(route->DstModule == PDUR_MODULE_CANIF)
 			{
@@ -66,11 +66,15 @@ Std_ReturnType PduR_ComTransmit(
 
 // Tx Pdu ids from app
 #define PDUR_APP_TX_PDU_STOP_MOTOR				((PduIdType)0)
+#define PDUR_APP_TX_PDU_SENSOR_STATUS			((PduIdType)1)
 
 // Tx Pdu ids to CanIf
 #define PDUR_CANIF_TX_PDU_STOP_MOTOR			((PduIdType)0)
+#define PDUR_CANIF_TX_PDU_SENSOR_STATUS			((PduIdType)1)
 
 // Number of Tx routes
-#define PDUR_NUM_TX_ROUTES						(1u)
+#define PDUR_NUM_TX_ROUTES						(2u)
+
+extern const PduR_ConfigTypes				PduR_Config;
 
 #endif /* PDUR_PDUR_H_ */
@@ -26,6 +26,12 @@ static const PduR_TxRouteType PduR_TxRoutes[] = {
 				.SrcPduId	= 0,
 				.DstModule	= PDUR_MODULE_CANIF,
 				.DstPduId	= 0
+		},
+		{
+				.SrcModule	= PDUR_MODULE_APP,
+				.SrcPduId	= PDUR_APP_TX_PDU_SENSOR_STATUS,
+				.DstModule	= PDUR_MODULE_CANIF,
+				.DstPduId	= PDUR_CANIF_TX_PDU_SENSOR_STATUS
 		}
 };
 
@@ -0,0 +1,323 @@
+/* =====================================================================================================================
+ *  File        : Shell.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Line editor, incremental tokenizer and step scheduler of command shell
+ *  Depends     : Shell.h, Shell_Cfg.h, UartIf.h
+ * ===================================================================================================================*/
+
+#include "Shell.h"
+#include "Shell_Cfg.h"
+#include "UartIf.h"
+#include <string.h>
+
+#define SHELL_CHAR_BS						(0x08u)
+#define SHELL_CHAR_DEL						(0x7Fu)
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static boolean		s_inited	= FALSE;
+
+// input line, tokens are stored back to back with a '\0' after each one
+static char			s_line[SHELL_CFG_LINE_SIZE];
+static uint8		s_len		= 0u;
+static uint8		s_argOff[SHELL_CFG_MAX_ARGS];
+static uint8		s_argc		= 0u;
+static boolean		s_inTok		= FALSE;
+static boolean		s_overflow	= FALSE;
+static uint32		s_rxDropped	= 0u;
+
+// active command
+static const char*			s_argv[SHELL_CFG_MAX_ARGS];
+static const Shell_CmdType*	s_active	= NULL_PTR;
+static uint8				s_step		= 0u;
+
+// output line of current step, kept until UartIf accepts it
+static char			s_out[SHELL_CFG_OUT_SIZE];
+static uint8		s_outLen	= 0u;
+static boolean		s_outPending = FALSE;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static void prv_Echo(const char* s, uint16 len)
+{
+#if (SHELL_CFG_ECHO == 1u)
+	(void)SHELL_CFG_WRITE((const uint8*)s, len);	// best effort, dropped when Tx ring is full
+#else
+	(void)s; (void)len;
+#endif
+}
+
+static void prv_ResetLine(void)
+{
+	s_len		= 0u;
+	s_argc		= 0u;
+	s_inTok		= FALSE;
+	s_overflow	= FALSE;
+}
+
+static void prv_SendOut(void)
+{
+	if(s_outLen == 0u) return;
+	s_outPending = (SHELL_CFG_WRITE_LINE(s_out) == E_OK) ? FALSE : TRUE;
+	if(s_outPending == FALSE) s_outLen = 0u;
+}
+
+static void prv_Dispatch(void)
+{
+	s_out[0] = '\0';
+	s_outLen = 0u;
+
+	if(s_overflow == TRUE)
+	{
+		Shell_OutStr("ERR line too long");
+		prv_ResetLine();
+		prv_SendOut();
+		return;
+	}
+	if(s_argc == 0u)
+	{
+		prv_ResetLine();
+		return;
+	}
+
+	for(uint8 i = 0u; i < s_argc; i++) s_argv[i] = &s_line[s_argOff[i]];
+
+	for(uint8 i = 0u; i < Shell_CmdCount; i++)
+	{
+		if(strcmp(Shell_Cmds[i].Name, s_argv[0]) == 0)
+		{
+			s_active	= &Shell_Cmds[i];
+			s_step		= 0u;
+			return;
+		}
+	}
+
+	Shell_OutStr("ERR unknown: ");
+	Shell_OutStr(s_argv[0]);
+	prv_ResetLine();
+	prv_SendOut();
+}
+
+// O(1) per byte
+static void prv_PutByte(uint8 b)
+{
+	if((b == '\r') || (b == '\n'))
+	{
+		if(s_inTok == TRUE)
+		{
+			s_line[s_len++] = '\0';
+			s_inTok = FALSE;
+		}
+		if((s_argc != 0u) || (s_overflow == TRUE)) prv_Echo("\r\n", 2u);
+		prv_Dispatch();
+		return;
+	}
+
+	if((b == SHELL_CHAR_BS) || (b == SHELL_CHAR_DEL))
+	{
+		if(s_len == 0u) return;
+		s_len--;
+		if(s_line[s_len] == '\0')
+		{
+			s_inTok = TRUE;			// removed separator, back in previous token
+		} else if(s_len == s_argOff[s_argc - 1u]) {
+			s_argc--;				// removed first char of token
+			s_inTok = FALSE;
+		}
+		prv_Echo("\b \b", 3u);
+		return;
+	}
+
+	if((b == ' ') || (b == '\t'))
+	{
+		if(s_inTok == TRUE)
+		{
+			s_line[s_len++] = '\0';
+			s_inTok = FALSE;
+		}
+		prv_Echo(" ", 1u);
+		return;
+	}
+
+	if((b < 0x21u) || (b > 0x7Eu)) return;
+
+	// keep room for the terminator of this token
+	if((s_len + 2u) > SHELL_CFG_LINE_SIZE)
+	{
+		s_overflow = TRUE;
+		return;
+	}
+	if(s_inTok == FALSE)
+	{
+		if(s_argc == SHELL_CFG_MAX_ARGS)
+		{
+			s_overflow = TRUE;
+			return;
+		}
+		s_argOff[s_argc++] = s_len;
+		s_inTok = TRUE;
+	}
+	s_line[s_len++] = (char)b;
+	prv_Echo((const char*)&b, 1u);
+}
+
+/* ==============================
+ *       APIs
+ * ============================== */
+void Shell_Init(void)
+{
+	prv_ResetLine();
+	s_active		= NULL_PTR;
+	s_outLen		= 0u;
+	s_outPending	= FALSE;
+	s_rxDropped		= 0u;
+
+	s_inited = (UartIf_RegisterRxIndication(Shell_RxIndication) == E_OK) ? TRUE : FALSE;
+}
+
+void Shell_DeInit(void)
+{
+	s_inited = FALSE;
+	s_active = NULL_PTR;
+}
+
+void Shell_RxIndication(const uint8* DataPtr, uint16 Length)
+{
+	if((s_inited == FALSE) || (DataPtr == NULL_PTR)) return;
+
+	for(uint16 i = 0u; i < Length; i++)
+	{
+		// one command at a time, type-ahead is dropped
+		if((s_active != NULL_PTR) || (s_outPending == TRUE))
+		{
+			s_rxDropped += (uint32)(Length - i);
+			return;
+		}
+		prv_PutByte(DataPtr[i]);
+	}
+}
+
+void Shell_MainFunction(void)
+{
+	if(s_inited == FALSE) return;
+
+	if(s_outPending == TRUE)
+	{
+		prv_SendOut();
+		if(s_outPending == TRUE) return;
+	}
+
+	if(s_active == NULL_PTR) return;
+
+	s_out[0] = '\0';
+	s_outLen = 0u;
+
+	Shell_ResultType res = s_active->Fn(s_argc, s_argv, s_step);
+
+	if(res == SHELL_MORE)
+	{
+		if(s_step != 0xFFu) s_step++;
+	} else {
+		if((res == SHELL_ERR) && (s_outLen == 0u)) Shell_OutStr("ERR");
+		s_active = NULL_PTR;
+		prv_ResetLine();
+	}
+
+	prv_SendOut();
+}
+
+uint32 Shell_GetRxDroppedCount(void)
+{
+	return s_rxDropped;
+}
+
+/* ==============================
+ *       HELPERS FOR COMMANDS
+ * ============================== */
+void Shell_OutStr(const char* Str)
+{
+	if(Str == NULL_PTR) return;
+	while((*Str != '\0') && ((s_outLen + 1u) < SHELL_CFG_OUT_SIZE))
+	{
+		s_out[s_outLen++] = *Str++;
+	}
+	s_out[s_outLen] = '\0';
+}
+
+void Shell_OutU32(uint32 Value)
+{
+	char tmp[11];
+	uint8 n = (uint8)(sizeof(tmp) - 1u);
+
+	tmp[n] = '\0';
+	do {
+		tmp[--n] = (char)('0' + (Value % 10u));
+		Value /= 10u;
+	} while(Value != 0u);
+
+	Shell_OutStr(&tmp[n]);
+}
+
+void Shell_OutS32(sint32 Value)
+{
+	if(Value < 0)
+	{
+		Shell_OutStr("-");
+		Shell_OutU32(0u - (uint32)Value);
+	} else {
+		Shell_OutU32((uint32)Value);
+	}
+}
+
+void Shell_OutHex(uint32 Value)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char tmp[11];
+	uint8 n = (uint8)(sizeof(tmp) - 1u);
+
+	tmp[n] = '\0';
+	do {
+		tmp[--n] = hex[Value & 0xFu];
+		Value >>= 4;
+	} while(Value != 0u);
+	tmp[--n] = 'x';
+	tmp[--n] = '0';
+
+	Shell_OutStr(&tmp[n]);
+}
+
+boolean Shell_ParseU32(const char* Str, uint32* Value)
+{
+	uint32 v = 0u;
+	uint32 base = 10u;
+
+	if((Str == NULL_PTR) || (Value == NULL_PTR) || (*Str == '\0')) return FALSE;
+
+	if((Str[0] == '0') && ((Str[1] == 'x') || (Str[1] == 'X')))
+	{
+		base = 16u;
+		Str += 2;
+		if(*Str == '\0') return FALSE;
+	}
+
+	for(; *Str != '\0'; Str++)
+	{
+		uint32 d;
+		char c = *Str;
+
+		if((c >= '0') && (c <= '9'))			d = (uint32)(c - '0');
+		else if((c >= 'a') && (c <= 'f'))		d = (uint32)(c - 'a' + 10);
+		else if((c >= 'A') && (c <= 'F'))		d = (uint32)(c - 'A' + 10);
+		else									return FALSE;
+
+		if(d >= base) return FALSE;
+		if(v > ((0xFFFFFFFFu - d) / base)) return FALSE;
+		v = (v * base) + d;
+	}
+
+	*Value = v;
+	return TRUE;
+}
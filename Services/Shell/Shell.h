@@ -0,0 +1,90 @@
+/* =====================================================================================================================
+ *  File        : Shell.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Command/diagnostic shell on UartIf
+ * 					- Bytes arrive through UartIf_RxIndication (called from UartIf_MainFunction)
+ * 					- Incremental tokenizer: line is split into argv while it is typed, no heap, no strtok
+ * 					- Commands run one step per Shell_MainFunction and emit at most one line per step
+ *  Depends     : Std_Types.h, UartIf.h
+ * ===================================================================================================================*/
+
+#ifndef SHELL_SHELL_H_
+#define SHELL_SHELL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define SHELL_VENDOR_ID						(0x00u)
+#define SHELL_MODULE_ID						(0xC7u)
+#define SHELL_INSTANCE_ID					(0x00u)
+
+#define SHELL_SW_MAJOR_VERSION				(1u)
+#define SHELL_SW_MINOR_VERSION				(0u)
+#define SHELL_SW_PATCH_VERSION				(0u)
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+typedef enum
+{
+	SHELL_DONE	= 0u,	// command finished
+	SHELL_MORE,			// call again with Step + 1 (saturates at 0xFF) on next Shell_MainFunction
+	SHELL_ERR			// finished with error, shell prints "ERR"
+} Shell_ResultType;
+
+// Command step: Argv[0] is the command name. Must do bounded work and emit at most one line (Shell_Out*).
+// A command that waits for something bounds the wait itself (in ms, the step rate follows the main loop)
+typedef Shell_ResultType (*Shell_CmdFnType)(uint8 Argc, const char* const* Argv, uint8 Step);
+
+typedef struct
+{
+	const char*		Name;
+	Shell_CmdFnType	Fn;
+	const char*		Help;
+} Shell_CmdType;
+
+/* ==============================
+ *             API
+ * ============================== */
+void Shell_Init(void);
+void Shell_DeInit(void);
+
+// Run one step of the active command / flush pending output line, call every main loop after UartIf_MainFunction
+void Shell_MainFunction(void);
+
+// Rx path, registered with UartIf_RegisterRxIndication
+void Shell_RxIndication(const uint8* DataPtr, uint16 Length);
+
+// Bytes discarded because a command was still running
+uint32 Shell_GetRxDroppedCount(void);
+
+/* ==============================
+ *       HELPERS FOR COMMANDS
+ * ============================== */
+// Append to current output line (truncated at SHELL_CFG_OUT_SIZE)
+void Shell_OutStr(const char* Str);
+void Shell_OutU32(uint32 Value);
+void Shell_OutS32(sint32 Value);
+void Shell_OutHex(uint32 Value);
+
+// Decimal or 0x-prefixed hex, FALSE on syntax error/overflow
+boolean Shell_ParseU32(const char* Str, uint32* Value);
+
+/* =========================================================
+ * 	 Command table (Shell_Cmd.c)
+ * =======================================================*/
+extern const Shell_CmdType	Shell_Cmds[];
+extern const uint8			Shell_CmdCount;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHELL_SHELL_H_ */
@@ -0,0 +1,56 @@
+/* =====================================================================================================================
+ *  File        : Shell_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of command shell
+ *  Depends     : Shell.h
+ * ===================================================================================================================*/
+
+#ifndef SHELL_SHELL_CFG_H_
+#define SHELL_SHELL_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Shell.h"
+
+/* Input line incl. terminators */
+#ifndef SHELL_CFG_LINE_SIZE
+#define SHELL_CFG_LINE_SIZE					(48u)
+#endif
+
+/* Max tokens per line, command name included */
+#ifndef SHELL_CFG_MAX_ARGS
+#define SHELL_CFG_MAX_ARGS					(4u)
+#endif
+
+/* One output line (DET lines are up to DET_CFG_FLUSH_LINE_SIZE) */
+#ifndef SHELL_CFG_OUT_SIZE
+#define SHELL_CFG_OUT_SIZE					(88u)
+#endif
+
+/* Echo typed characters back */
+#ifndef SHELL_CFG_ECHO
+#define SHELL_CFG_ECHO						(1u)
+#endif
+
+/* One-shot measurement gives up after this many ms (SysTick): a Sensor SWC period, the echo timeout and margin */
+#ifndef SHELL_CFG_MEAS_TIMEOUT_MS
+#define SHELL_CFG_MEAS_TIMEOUT_MS			(150u)
+#endif
+
+/* Output backend, both must be non-blocking */
+#ifndef SHELL_CFG_WRITE_LINE
+#define SHELL_CFG_WRITE_LINE(_str)			UartIf_WriteLine((_str))
+#endif
+
+#ifndef SHELL_CFG_WRITE
+#define SHELL_CFG_WRITE(_buf, _len)			UartIf_Write((_buf), (_len))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHELL_SHELL_CFG_H_ */
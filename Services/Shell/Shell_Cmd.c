@@ -0,0 +1,498 @@
+/* =====================================================================================================================
+ *  File        : Shell_Cmd.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Command table of shell
+ * 					help                      list commands
+ * 					cal [name value]          show / set ObstacleDetection calibration (stored by NvM)
+ * 					det [clear]               dump / clear Det history
+ * 					uart                      Uart_GetStats of log channel
+ * 					log [level n | tags mask] show / set Logger filter
+ * 					meas                      one-shot HC-SR04 measurement, requested from the Sensor SWC (RTE)
+ * 					sig id                    Com Rx signal: shadow value and state (0 not received, 1 valid, 2 timeout)
+ * 					e2e id                    Com Rx I-PDU: E2E check of the last frame (0 no data, 1 ok, 2 ok some lost,
+ * 					                          3 repeated, 4 wrong sequence, 5 error)
+ * 					can                       CanSM state (0 no com, 1 full com, 2 bus-off wait, 3 bus-off check),
+ * 					                          error state (0 active, 1 passive, 2 bus-off), TEC, REC, last error code,
+ * 					                          warning / passive / bus-off counts, bus-off streak, restarts
+ * 					nm [req|rel]              request / release the network; CanNm state (0 bus sleep, 1 prepare bus sleep,
+ * 					                          2 repeat message, 3 normal, 4 ready sleep), requested, start reason
+ * 					                          (0 none, 1 local, 2 remote, 3 power-on), start node, PN filtered PDUs,
+ * 					                          EcuM state, validated wake-up sources, expired wake-ups
+ * 					dem [clear|cycle]         one line per event: UDS status byte, occurrences; stored events add the
+ * 					                          freeze frame (ms, distance mm, SensorSupervisor status). clear: clear all,
+ * 					                          cycle: start the next operation cycle
+ * 					nvm                       NvM state (1 idle, 2 write, 3 erase, 4 header, 5 copy, 6 commit), active page,
+ * 					                          generation, free bytes, valid / dirty block masks, records written, page
+ * 					                          swaps, CRC errors at init, failed flash jobs
+ * 					bench                     run benchmark suite, JSON lines follow (BENCH_CFG_ENABLE builds)
+ *  Depends     : Shell.h, Det.h, Logger.h, Uart.h, Rte.h, Mcu.h, ObstacleDetection.h, Com.h, Can.h, CanSM.h, CanNm.h,
+ * 				  EcuM.h, Dem.h, NvM.h, Bench.h
+ * ===================================================================================================================*/
+
+#include "Shell.h"
+#include "Shell_Cfg.h"
+#include "Det.h"
+#include "Logger.h"
+#include "Uart.h"
+#include "Rte.h"
+#include "Mcu.h"
+#include "DistConv.h"
+#include "ObstacleDetection.h"
+#include "Com.h"
+#include "Can.h"
+#include "CanSM.h"
+#include "CanNm.h"
+#include "EcuM.h"
+#include "Dem.h"
+#include "NvM.h"
+#include "Bench.h"
+#include <string.h>
+
+#ifndef SHELL_CFG_UART_CH
+#define SHELL_CFG_UART_CH					(UART_CH1)
+#endif
+
+/* ==============================
+ *       help
+ * ============================== */
+static Shell_ResultType Cmd_Help(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	(void)Argc; (void)Argv;
+
+	Shell_OutStr(Shell_Cmds[Step].Name);
+	Shell_OutStr(" - ");
+	Shell_OutStr(Shell_Cmds[Step].Help);
+
+	return ((uint8)(Step + 1u) < Shell_CmdCount) ? SHELL_MORE : SHELL_DONE;
+}
+
+/* ==============================
+ *       cal
+ * ============================== */
+static const char* const Cal_Names[] = { "thr", "hys", "min", "max", "inv" };
+#define CAL_NAME_COUNT		((uint8)(sizeof(Cal_Names) / sizeof(Cal_Names[0])))
+
+static uint32 prv_CalGet(const ObstacleDetection_CalibrationType* c, uint8 idx)
+{
+	switch(idx)
+	{
+	case 0u: return c->ThresholdCm;
+	case 1u: return c->HysteresisCm;
+	case 2u: return c->MinValidCm;
+	case 3u: return c->MaxValidCm;
+	default: return c->MaxInvalidCount;
+	}
+}
+
+static boolean prv_CalSet(ObstacleDetection_CalibrationType* c, uint8 idx, uint32 v)
+{
+	if(v > ((idx == 4u) ? 0xFFu : 0xFFFFu)) return FALSE;
+
+	switch(idx)
+	{
+	case 0u: c->ThresholdCm		= (ObstacleDistance_cmType)v; break;
+	case 1u: c->HysteresisCm	= (ObstacleDistance_cmType)v; break;
+	case 2u: c->MinValidCm		= (ObstacleDistance_cmType)v; break;
+	case 3u: c->MaxValidCm		= (ObstacleDistance_cmType)v; break;
+	default: c->MaxInvalidCount	= (uint8)v; break;
+	}
+	return TRUE;
+}
+
+static Shell_ResultType Cmd_Cal(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	ObstacleDetection_CalibrationType cal;
+	ObstacleDetection_GetCalibration(&cal);
+
+	if(Argc == 1u)
+	{
+		Shell_OutStr(Cal_Names[Step]);
+		Shell_OutStr("=");
+		Shell_OutU32(prv_CalGet(&cal, Step));
+		return ((uint8)(Step + 1u) < CAL_NAME_COUNT) ? SHELL_MORE : SHELL_DONE;
+	}
+
+	if(Argc != 3u) return SHELL_ERR;
+
+	uint32 v;
+	if(Shell_ParseU32(Argv[2], &v) == FALSE) return SHELL_ERR;
+
+	for(uint8 i = 0u; i < CAL_NAME_COUNT; i++)
+	{
+		if(strcmp(Cal_Names[i], Argv[1]) == 0)
+		{
+			if(prv_CalSet(&cal, i, v) == FALSE) return SHELL_ERR;
+			if(ObstacleDetection_SetCalibration(&cal) != E_OK) return SHELL_ERR;
+			Shell_OutStr("OK");
+			return SHELL_DONE;
+		}
+	}
+	return SHELL_ERR;
+}
+
+/* ==============================
+ *       det
+ * ============================== */
+static void prv_DetLine(const char* line)
+{
+	Shell_OutStr(line);
+}
+
+static Shell_ResultType Cmd_Det(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	if(Argc == 2u)
+	{
+		if(strcmp(Argv[1], "clear") != 0) return SHELL_ERR;
+		Det_ClearHistory();
+		Shell_OutStr("OK");
+		return SHELL_DONE;
+	}
+
+	if(Step == 0u)
+	{
+		if(Det_GetHistoryCount() == 0u)
+		{
+			Shell_OutStr("DET empty, dropped:");
+			Shell_OutU32(Det_GetDroppedCount());
+			return SHELL_DONE;
+		}
+		Det_FlushRewind();
+	}
+
+	// one entry per step
+	return (Det_FlushNext(prv_DetLine) == TRUE) ? SHELL_MORE : SHELL_DONE;
+}
+
+/* ==============================
+ *       uart
+ * ============================== */
+static Shell_ResultType Cmd_Uart(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	Uart_StatsType st;
+	(void)Argc; (void)Argv;
+
+	if(Uart_GetStats(SHELL_CFG_UART_CH, &st) != E_OK) return SHELL_ERR;
+
+	if(Step == 0u)
+	{
+		Shell_OutStr("tx:");		Shell_OutU32(st.txBytes);
+		Shell_OutStr(" rx:");		Shell_OutU32(st.rxBytes);
+		Shell_OutStr(" txIrq:");	Shell_OutU32(st.txIrqCount);
+		Shell_OutStr(" rxIrq:");	Shell_OutU32(st.rxIrqCount);
+		return SHELL_MORE;
+	}
+
+	Shell_OutStr("ore:");			Shell_OutU32(st.rxOverrunCount);
+	Shell_OutStr(" fe:");			Shell_OutU32(st.framingErrCount);
+	Shell_OutStr(" pe:");			Shell_OutU32(st.parityErrCount);
+	Shell_OutStr(" logDrop:");		Shell_OutU32(Logger_GetDroppedCount());
+	Shell_OutStr(" shDrop:");		Shell_OutU32(Shell_GetRxDroppedCount());
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       log
+ * ============================== */
+static Shell_ResultType Cmd_Log(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	uint32 v;
+	(void)Step;
+
+	if(Argc == 1u)
+	{
+		Shell_OutStr("level=");		Shell_OutU32(Logger_GetLevel());
+		Shell_OutStr(" tags=");		Shell_OutHex(Logger_GetEnableTags());
+		return SHELL_DONE;
+	}
+
+	if((Argc != 3u) || (Shell_ParseU32(Argv[2], &v) == FALSE)) return SHELL_ERR;
+
+	if(strcmp(Argv[1], "level") == 0)
+	{
+		// levels above LOGGER_CFG_COMPILE_LEVEL are accepted but compiled out
+		if((v > LOG_LEVEL_DEBUG) || (Logger_SetLevel((Logger_LevelType)v) != E_OK)) return SHELL_ERR;
+	} else if(strcmp(Argv[1], "tags") == 0) {
+		Logger_SetEnableTags((Logger_TagMaskType)v);
+	} else {
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("OK");
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       meas
+ * ============================== */
+// SysTick of the request, the timeout runs in ms whatever the main loop rate
+static uint32 s_measStartMs = 0u;
+
+static Shell_ResultType Cmd_Meas(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	Rte_MeasurementType meas;
+	(void)Argc; (void)Argv;
+
+	// the Sensor SWC owns the sensor: it serves the request with its next trigger
+	if(Step == 0u)
+	{
+		if(Rte_Call_RequestMeasurement() != RTE_E_OK)
+		{
+			Shell_OutStr("ERR no sensor");
+			return SHELL_ERR;
+		}
+		s_measStartMs = s_systickTicks;
+		return SHELL_MORE;
+	}
+
+	if(Rte_Read_Measurement(&meas) == RTE_E_OK)
+	{
+		if(meas.Status == RTE_MEAS_TIMEOUT)
+		{
+			Shell_OutStr("ERR no echo");
+			return SHELL_ERR;
+		}
+		Shell_OutStr("mm:");		Shell_OutU32(DISTCONV_Q4_TO_MM(meas.Distance));
+		Shell_OutStr(" us:");		Shell_OutU32(meas.EchoUs);
+		Shell_OutStr(" st:");		Shell_OutU32(meas.Status);
+		return SHELL_DONE;
+	}
+
+	// the Sensor SWC reports an echo timeout itself, this covers a sensor that stopped measuring
+	if((uint32)(s_systickTicks - s_measStartMs) >= SHELL_CFG_MEAS_TIMEOUT_MS)
+	{
+		Shell_OutStr("ERR no echo");
+		return SHELL_ERR;
+	}
+	return SHELL_MORE;
+}
+
+/* ==============================
+ *       sig
+ * ============================== */
+static Shell_ResultType Cmd_Sig(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	const Com_SignalConfigType* sig = NULL_PTR;
+	Std_ReturnType ret;
+	uint32 id;
+	uint32 u = 0u;
+	sint32 v = 0;
+	boolean sgn = FALSE;
+	uint16 i;
+	(void)Step;
+
+	if((Argc != 2u) || (Shell_ParseU32(Argv[1], &id) == FALSE)) return SHELL_ERR;
+
+	for(i = 0u; (i < Com_Config.NumSignals) && (sig == NULL_PTR); i++)
+	{
+		if(Com_Config.SignalConfig[i].SignalId == id) sig = &Com_Config.SignalConfig[i];
+	}
+	if(sig == NULL_PTR) return SHELL_ERR;
+
+	// Com writes the signal type, signed ones come back sign extended from their width
+	switch(sig->SignalType)
+	{
+	case COM_SIGNAL_UINT8:	{ uint8 x;	ret = Com_ReceiveSignal((Com_SignalIdType)id, &x);	u = x;				break; }
+	case COM_SIGNAL_UINT16:	{ uint16 x;	ret = Com_ReceiveSignal((Com_SignalIdType)id, &x);	u = x;				break; }
+	case COM_SIGNAL_SINT8:	{ sint8 x;	ret = Com_ReceiveSignal((Com_SignalIdType)id, &x);	v = x;	sgn = TRUE;	break; }
+	case COM_SIGNAL_SINT16:	{ sint16 x;	ret = Com_ReceiveSignal((Com_SignalIdType)id, &x);	v = x;	sgn = TRUE;	break; }
+	case COM_SIGNAL_SINT32:	{			ret = Com_ReceiveSignal((Com_SignalIdType)id, &v);			sgn = TRUE;	break; }
+	default:				{			ret = Com_ReceiveSignal((Com_SignalIdType)id, &u);						break; }
+	}
+	if(ret != E_OK) return SHELL_ERR;
+
+	Shell_OutStr("sig:");		Shell_OutU32(id);
+	Shell_OutStr(" val:");
+	if(sgn == TRUE)	Shell_OutS32(v);
+	else			Shell_OutU32(u);
+	Shell_OutStr(" st:");		Shell_OutU32((uint32)Com_GetRxSignalStatus((Com_SignalIdType)id));
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       e2e
+ * ============================== */
+static Shell_ResultType Cmd_E2E(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	uint32 id;
+	(void)Step;
+
+	if((Argc != 2u) || (Shell_ParseU32(Argv[1], &id) == FALSE) || (id >= Com_Config.NumRxIpdu)) return SHELL_ERR;
+
+	Shell_OutStr("e2e:");		Shell_OutU32(id);
+	Shell_OutStr(" st:");		Shell_OutU32((uint32)Com_GetRxE2EStatus((Com_IpduIdType)id));
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       can
+ * ============================== */
+static Shell_ResultType Cmd_Can(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	Can_StatisticsType st;
+	CanSM_StatusType sm;
+	(void)Argc; (void)Argv; (void)Step;
+
+	if((Can_GetStatistics(0u, &st) != E_OK) || (CanSM_GetStatus(&sm) != E_OK))
+	{
+		Shell_OutStr("ERR can uninit");
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("sm:");		Shell_OutU32((uint32)sm.State);
+	Shell_OutStr(" err:");		Shell_OutU32((uint32)st.ErrorState);
+	Shell_OutStr(" tec:");		Shell_OutU32(st.Tec);
+	Shell_OutStr(" rec:");		Shell_OutU32(st.Rec);
+	Shell_OutStr(" lec:");		Shell_OutU32(st.LastErrorCode);
+	Shell_OutStr(" wrn:");		Shell_OutU32(st.WarningCount);
+	Shell_OutStr(" pas:");		Shell_OutU32(st.PassiveCount);
+	Shell_OutStr(" boff:");		Shell_OutU32(st.BusOffCount);
+	Shell_OutStr(" streak:");	Shell_OutU32(sm.BusOffStreak);
+	Shell_OutStr(" restart:");	Shell_OutU32(sm.Restarts);
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       nm
+ * ============================== */
+static Shell_ResultType Cmd_Nm(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	CanNm_StatusType nm;
+	EcuM_WakeupStatusType wk;
+	Std_ReturnType ret = E_OK;
+	(void)Step;
+
+	if(Argc > 2u) return SHELL_ERR;
+	if(Argc == 2u)
+	{
+		if(strcmp(Argv[1], "req") == 0)			ret = CanNm_NetworkRequest();
+		else if(strcmp(Argv[1], "rel") == 0)	ret = CanNm_NetworkRelease();
+		else									return SHELL_ERR;
+	}
+
+	if((ret != E_OK) || (CanNm_GetStatus(&nm) != E_OK) || (EcuM_GetWakeupStatus(&wk) != E_OK))
+	{
+		Shell_OutStr("ERR nm uninit");
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("nm:");		Shell_OutU32((uint32)nm.State);
+	Shell_OutStr(" req:");		Shell_OutU32((uint32)nm.Requested);
+	Shell_OutStr(" why:");		Shell_OutU32((uint32)nm.StartReason);
+	Shell_OutStr(" node:");		Shell_OutHex(nm.StartNode);
+	Shell_OutStr(" pnf:");		Shell_OutU32(nm.PnFiltered);
+	Shell_OutStr(" ecum:");		Shell_OutU32((uint32)EcuM_GetState());
+	Shell_OutStr(" wake:");		Shell_OutHex(wk.Validated);
+	Shell_OutStr(" exp:");		Shell_OutU32(wk.Expirations);
+	return SHELL_DONE;
+}
+
+/* ==============================
+ *       dem
+ * ============================== */
+static Shell_ResultType Cmd_Dem(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	Dem_MemoryEntryType m;
+	uint8 st;
+
+	if(Argc == 2u)
+	{
+		if(strcmp(Argv[1], "clear") == 0)			Dem_ClearDTC();
+		else if(strcmp(Argv[1], "cycle") == 0)		Dem_RestartOperationCycle();
+		else										return SHELL_ERR;
+		Shell_OutStr("OK");
+		return SHELL_DONE;
+	}
+	if(Argc != 1u) return SHELL_ERR;
+
+	// one event per step
+	if(Dem_GetEventStatus((Dem_EventIdType)Step, &st) != E_OK)
+	{
+		Shell_OutStr("ERR dem uninit");
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("ev:");		Shell_OutU32(Step);
+	Shell_OutStr(" st:");		Shell_OutHex(st);
+	if(Dem_GetEventMemoryEntry((Dem_EventIdType)Step, &m) == E_OK)
+	{
+		Shell_OutStr(" occ:");	Shell_OutU32(m.Occurrence);
+		Shell_OutStr(" ms:");	Shell_OutU32(m.TimestampMs);
+		Shell_OutStr(" mm:");
+		if(m.Distance == 0xFFFFu)	Shell_OutStr("-");
+		else						Shell_OutU32(DISTCONV_Q4_TO_MM(m.Distance));
+		Shell_OutStr(" sup:");	Shell_OutU32(m.SensorStatus);
+	}
+	return ((uint8)(Step + 1u) < DEM_CFG_EVENT_COUNT) ? SHELL_MORE : SHELL_DONE;
+}
+
+/* ==============================
+ *       nvm
+ * ============================== */
+static Shell_ResultType Cmd_Nvm(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	NvM_StatusType nv;
+	(void)Argc; (void)Argv; (void)Step;
+
+	if((NvM_GetStatus(&nv) != E_OK) || (nv.State == NVM_STATE_UNINIT))
+	{
+		Shell_OutStr("ERR nvm uninit");
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("st:");		Shell_OutU32((uint32)nv.State);
+	Shell_OutStr(" pg:");
+	if(nv.ActivePage == 0xFFu)	Shell_OutStr("-");
+	else						Shell_OutU32(nv.ActivePage);
+	Shell_OutStr(" gen:");		Shell_OutU32(nv.Generation);
+	Shell_OutStr(" free:");		Shell_OutU32(nv.FreeBytes);
+	Shell_OutStr(" valid:");	Shell_OutHex(nv.ValidMask);
+	Shell_OutStr(" dirty:");	Shell_OutHex(nv.DirtyMask);
+	Shell_OutStr(" wr:");		Shell_OutU32(nv.Writes);
+	Shell_OutStr(" swap:");		Shell_OutU32(nv.Swaps);
+	Shell_OutStr(" crc:");		Shell_OutU32(nv.CrcErrors);
+	Shell_OutStr(" fail:");		Shell_OutU32(nv.Failures);
+	return SHELL_DONE;
+}
+
+#if (BENCH_CFG_ENABLE == 1u)
+/* ==============================
+ *       bench
+ * ============================== */
+static Shell_ResultType Cmd_Bench(uint8 Argc, const char* const* Argv, uint8 Step)
+{
+	(void)Argc; (void)Argv; (void)Step;
+
+	if(Bench_Start() != E_OK)
+	{
+		Shell_OutStr("ERR bench busy");
+		return SHELL_ERR;
+	}
+
+	Shell_OutStr("OK");
+	return SHELL_DONE;
+}
+#endif
+
+/* ==============================
+ *       TABLE
+ * ============================== */
+const Shell_CmdType Shell_Cmds[] = {
+	{ .Name = "help",	.Fn = Cmd_Help,	.Help = "list commands" },
+	{ .Name = "cal",	.Fn = Cmd_Cal,	.Help = "[thr|hys|min|max|inv value] obstacle calibration" },
+	{ .Name = "det",	.Fn = Cmd_Det,	.Help = "[clear] Det history" },
+	{ .Name = "uart",	.Fn = Cmd_Uart,	.Help = "uart statistics" },
+	{ .Name = "log",	.Fn = Cmd_Log,	.Help = "[level n | tags mask] logger filter" },
+	{ .Name = "meas",	.Fn = Cmd_Meas,	.Help = "one-shot distance measurement" },
+	{ .Name = "sig",	.Fn = Cmd_Sig,	.Help = "id: Com Rx signal value / state" },
+	{ .Name = "e2e",	.Fn = Cmd_E2E,	.Help = "id: Com Rx I-PDU E2E check state" },
+	{ .Name = "can",	.Fn = Cmd_Can,	.Help = "CAN error counters / bus-off recovery" },
+	{ .Name = "nm",		.Fn = Cmd_Nm,	.Help = "[req|rel] network management / sleep state" },
+	{ .Name = "dem",	.Fn = Cmd_Dem,	.Help = "[clear|cycle] diagnostic events, freeze frames" },
+	{ .Name = "nvm",	.Fn = Cmd_Nvm,	.Help = "NV storage state / counters" },
+#if (BENCH_CFG_ENABLE == 1u)
+	{ .Name = "bench",	.Fn = Cmd_Bench,	.Help = "run benchmark suite (JSON lines)" },
+#endif
+};
+
+const uint8 Shell_CmdCount = (uint8)(sizeof(Shell_Cmds) / sizeof(Shell_CmdType));
@@ -0,0 +1,118 @@
+/* =====================================================================================================================
+ *  File        : StackMon.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Paint the unused stack once, track its high-water mark with a bounded incremental scan
+ *  Notes       : The mark only moves down. A pass walks from the bottom to the current mark; the first word that
+ * 				  lost the pattern becomes the new mark and the pass restarts, so a pass costs at most
+ * 				  (mark - bottom) / 4 compares spread over calls of STACKMON_CFG_WORDS_PER_CALL each.
+ * 				  Reads only, ISRs pushing frames during a scan need no locking.
+ *  Depends     : StackMon.h, StackMon_Cfg.h, Det.h
+ * ===================================================================================================================*/
+
+#include "StackMon.h"
+#include "StackMon_Cfg.h"
+#include "Det.h"
+
+#if defined(__GNUC__) && defined(__arm__)
+#define STACKMON_GET_SP(_sp)			__asm volatile ("mov %0, sp" : "=r"(_sp))
+#endif
+
+/* ==============================
+ *            STATE
+ * ============================== */
+#if defined(SIM_HOST)
+uint32 StackMon_HostRegion[STACKMON_CFG_HOST_WORDS];
+#endif
+
+static boolean					s_init		= FALSE;
+static boolean					s_tripped	= FALSE;	// guard reported, fault action taken
+static const volatile uint32*	s_bottom	= NULL_PTR;
+static const volatile uint32*	s_mark		= NULL_PTR;	// lowest overwritten word (paint end until found)
+static const volatile uint32*	s_cursor	= NULL_PTR;
+static uint32					s_passes	= 0u;
+
+/* ==============================
+ *            APIS
+ * ============================== */
+void StackMon_Init(void)
+{
+#if (STACKMON_CFG_ENABLE == 1u)
+	volatile uint32*	p		= (volatile uint32*)STACKMON_CFG_BOTTOM;
+	volatile uint32*	end		= (volatile uint32*)STACKMON_CFG_TOP;
+#if defined(STACKMON_GET_SP)
+	uint32				sp;
+
+	// everything from the SP up is live, keep a gap for the frame of this loop
+	STACKMON_GET_SP(sp);
+	sp = (sp - STACKMON_CFG_PAINT_GAP_BYTES) & ~3UL;
+	if((volatile uint32*)sp < end) end = (volatile uint32*)sp;
+#endif
+
+	if(p >= end)
+	{
+		Det_ReportError(STACKMON_MODULE_ID, STACKMON_INSTANCE_ID, STACKMON_API_ID_INIT, STACKMON_E_PARAM_CONFIG);
+		return;
+	}
+
+	s_bottom	= p;
+	s_cursor	= p;
+	s_mark		= end;
+	s_passes	= 0u;
+	s_tripped	= FALSE;
+
+	// volatile stores: no memset call with a frame inside the painted area
+	while(p < end) *p++ = STACKMON_CFG_PATTERN;
+
+	s_init		= TRUE;
+#endif
+}
+
+void StackMon_MainFunction(void)
+{
+	uint16 n;
+
+	if(s_init == FALSE) return;
+
+	for(n = 0u; n < STACKMON_CFG_WORDS_PER_CALL; n++)
+	{
+		if(s_cursor >= s_mark)
+		{
+			s_cursor = s_bottom;
+			s_passes++;
+			break;
+		}
+		if(*s_cursor != STACKMON_CFG_PATTERN)
+		{
+			// new high-water mark, words below it may still be touched later: rescan from the bottom
+			s_mark		= s_cursor;
+			s_cursor	= s_bottom;
+			break;
+		}
+		s_cursor++;
+	}
+
+	if((s_tripped == FALSE) && (StackMon_GetFreeBytes() < STACKMON_CFG_GUARD_BYTES))
+	{
+		s_tripped = TRUE;
+		Det_ReportError(STACKMON_MODULE_ID, STACKMON_INSTANCE_ID, STACKMON_API_ID_MAINFUNCTION, STACKMON_E_GUARD_CROSSED);
+		STACKMON_CFG_GUARD_FAULT();
+	}
+}
+
+uint32 StackMon_GetUsedBytes(void)
+{
+	if(s_init == FALSE) return 0u;
+	return (uint32)((const volatile uint32*)STACKMON_CFG_TOP - s_mark) * 4u;
+}
+
+uint32 StackMon_GetFreeBytes(void)
+{
+	if(s_init == FALSE) return 0u;
+	return (uint32)(s_mark - s_bottom) * 4u;
+}
+
+uint32 StackMon_GetPassCount(void)
+{
+	return s_passes;
+}
@@ -0,0 +1,69 @@
+/* =====================================================================================================================
+ *  File        : StackMon.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Stack painting and runtime high-water-mark monitor
+ * 					- StackMon_Init (EcuM startup, right after Det) fills the unused stack with STACKMON_CFG_PATTERN
+ * 					- StackMon_MainFunction compares STACKMON_CFG_WORDS_PER_CALL words from the bottom up,
+ * 					  the lowest overwritten word is the high-water mark (a full pass restarts at the bottom,
+ * 					  so words skipped by uninitialised locals are still found)
+ * 					- free bytes below the mark < STACKMON_CFG_GUARD_BYTES: Det report, then STACKMON_CFG_GUARD_FAULT
+ *  Depends     : Std_Types.h, StackMon_Cfg.h
+ * ===================================================================================================================*/
+
+#ifndef STACKMON_STACKMON_H_
+#define STACKMON_STACKMON_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "StackMon_Cfg.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define STACKMON_VENDOR_ID					(0x00u)
+#define STACKMON_MODULE_ID					(0xCBu)
+#define STACKMON_INSTANCE_ID				(0x00u)
+
+#define STACKMON_SW_MAJOR_VERSION			(1u)
+#define STACKMON_SW_MINOR_VERSION			(0u)
+#define STACKMON_SW_PATCH_VERSION			(0u)
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define STACKMON_API_ID_INIT				(0x01u)
+#define STACKMON_API_ID_MAINFUNCTION		(0x02u)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define STACKMON_E_PARAM_CONFIG				(0x01u)		// nothing to paint: SP at or below the bottom
+#define STACKMON_E_GUARD_CROSSED			(0x02u)		// runtime: free stack below the guard margin
+
+/* ==============================
+ *             API
+ * ============================== */
+// Paint [BOTTOM, SP - gap), call before any deep call chain has run
+void StackMon_Init(void);
+
+// Background scan, bounded to STACKMON_CFG_WORDS_PER_CALL compares
+void StackMon_MainFunction(void);
+
+// Bytes between the top of the stack and the high-water mark (painted area only, 0 before Init)
+uint32 StackMon_GetUsedBytes(void);
+
+// Bytes between the high-water mark and the bottom
+uint32 StackMon_GetFreeBytes(void);
+
+// Completed bottom-to-mark passes, the marks above are exact as of the last pass
+uint32 StackMon_GetPassCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACKMON_STACKMON_H_ */
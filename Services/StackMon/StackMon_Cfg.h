@@ -0,0 +1,79 @@
+/* =====================================================================================================================
+ *  File        : StackMon_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of stack painting / high-water-mark monitor
+ *  Depends     : Std_Types.h, Mcu.h
+ * ===================================================================================================================*/
+
+#ifndef STACKMON_STACKMON_CFG_H_
+#define STACKMON_STACKMON_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Mcu.h"
+
+/* Paint at startup and scan in the background loop */
+#ifndef STACKMON_CFG_ENABLE
+#define STACKMON_CFG_ENABLE					(1u)
+#endif
+
+/* Fill word of the unused stack */
+#ifndef STACKMON_CFG_PATTERN
+#define STACKMON_CFG_PATTERN				(0xDEADBEEFUL)
+#endif
+
+/* Words compared per StackMon_MainFunction call, bounds its run time (~4 cycles per word on the M3) */
+#ifndef STACKMON_CFG_WORDS_PER_CALL
+#define STACKMON_CFG_WORDS_PER_CALL			(8u)
+#endif
+
+/* Free bytes left below the high-water mark before the controlled fault is raised */
+#ifndef STACKMON_CFG_GUARD_BYTES
+#define STACKMON_CFG_GUARD_BYTES			(256u)
+#endif
+
+/* Bytes below the SP of StackMon_Init left unpainted (frames of the paint loop itself) */
+#ifndef STACKMON_CFG_PAINT_GAP_BYTES
+#define STACKMON_CFG_PAINT_GAP_BYTES		(32u)
+#endif
+
+/* Action after the guard was crossed and reported to Det, must not return on target */
+#ifndef STACKMON_CFG_GUARD_FAULT
+#define STACKMON_CFG_GUARD_FAULT()			MCu_PerformReset()
+#endif
+
+/* Stack region [BOTTOM, TOP) as word pointers.
+ * Target: linker symbols of the CubeIDE script, the stack may grow down to the end of .bss (no heap is used;
+ * raise BOTTOM by _Min_Heap_Size once malloc is linked).
+ * Host: the Sim runs on the process stack, a stand-in region keeps the scan logic in the build */
+#if defined(SIM_HOST)
+#ifndef STACKMON_CFG_HOST_WORDS
+#define STACKMON_CFG_HOST_WORDS				(64u)
+#endif
+extern uint32 StackMon_HostRegion[STACKMON_CFG_HOST_WORDS];
+#ifndef STACKMON_CFG_BOTTOM
+#define STACKMON_CFG_BOTTOM					(&StackMon_HostRegion[0])
+#endif
+#ifndef STACKMON_CFG_TOP
+#define STACKMON_CFG_TOP					(&StackMon_HostRegion[STACKMON_CFG_HOST_WORDS])
+#endif
+#else
+extern uint32 _ebss;
+extern uint32 _estack;
+#ifndef STACKMON_CFG_BOTTOM
+#define STACKMON_CFG_BOTTOM					(&_ebss)
+#endif
+#ifndef STACKMON_CFG_TOP
+#define STACKMON_CFG_TOP					(&_estack)
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACKMON_STACKMON_CFG_H_ */
@@ -0,0 +1,238 @@
+/* =====================================================================================================================
+ *  File        : Telemetry.c
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Sample channels, build CRC protected records and COBS encode them straight into UART Tx ring
+ *  Depends     : Telemetry.h, Telemetry_Cfg.h, Crc.h, UartIf.h
+ * ===================================================================================================================*/
+
+#include "Telemetry.h"
+#include "Telemetry_Cfg.h"
+#include "Crc.h"
+#include "UartIf.h"
+
+// leading + trailing delimiter + one COBS code byte
+#define TELEMETRY_FRAME_OVERHEAD			(3u)
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static const Telemetry_ConfigType*	s_cfg		= NULL_PTR;
+static boolean						s_inited	= FALSE;
+static uint8						s_decim		= 0u;
+static uint8						s_divCnt	= 0u;
+static uint8						s_seq		= 0u;
+static uint16						s_sinceDesc	= 0u;
+static boolean						s_descPending = FALSE;
+static Telemetry_StatsType			s_stats;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static inline uint8* prv_SpanAt(const Uart_TxSpanType* span, uint16 idx)
+{
+	return (idx < span->len[0]) ? &span->ptr[0][idx] : &span->ptr[1][idx - span->len[0]];
+}
+
+static uint16 prv_PutLe(uint8* buf, uint16 pos, uint32 v, uint8 size)
+{
+	for(uint8 i = 0u; i < size; i++)
+	{
+		buf[pos++] = (uint8)(v & 0xFFu);
+		v >>= 8;
+	}
+	return pos;
+}
+
+static uint16 prv_PutHeader(uint8* rec, uint8 type)
+{
+	uint32 ts = (s_cfg->GetTimeMs != NULL_PTR) ? s_cfg->GetTimeMs() : 0u;
+
+	rec[0] = type;
+	rec[1] = s_seq++;
+	return prv_PutLe(rec, 2u, ts, 4u);
+}
+
+static uint16 prv_SampleSize(const Telemetry_ConfigType* cfg)
+{
+	uint16 n = TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE;
+	for(uint8 i = 0u; i < cfg->ChannelCount; i++) n = (uint16)(n + cfg->Channels[i].Size);
+	return n;
+}
+
+static uint16 prv_DescriptorSize(const Telemetry_ConfigType* cfg)
+{
+	return (uint16)(TELEMETRY_HEADER_SIZE + 3u + (2u * cfg->ChannelCount) + TELEMETRY_CRC_SIZE);
+}
+
+/*
+ * Append CRC, reserve ring space and COBS encode in place:
+ *   0x00 | code | data (zeros removed) | 0x00
+ * Leading delimiter resyncs the host if text from Logger sits between two frames.
+ */
+static boolean prv_Send(uint8* rec, uint16 len)
+{
+	Uart_TxSpanType span;
+	uint16 crc = Crc_CalculateCRC16(rec, len, 0u, TRUE);
+
+	len = prv_PutLe(rec, len, crc, TELEMETRY_CRC_SIZE);
+
+	uint16 total = (uint16)(len + TELEMETRY_FRAME_OVERHEAD);
+	if(TELEMETRY_CFG_TX_RESERVE(total, &span) != E_OK)
+	{
+		s_stats.Dropped++;
+		return FALSE;
+	}
+
+	uint16 codeIdx	= 1u;
+	uint16 o		= 2u;
+	uint8  code		= 1u;
+
+	*prv_SpanAt(&span, 0u) = TELEMETRY_FRAME_DELIMITER;
+	for(uint16 i = 0u; i < len; i++)
+	{
+		if(rec[i] == 0u)
+		{
+			*prv_SpanAt(&span, codeIdx) = code;
+			codeIdx	= o++;
+			code	= 1u;
+		} else {
+			*prv_SpanAt(&span, o++) = rec[i];
+			code++;
+		}
+	}
+	*prv_SpanAt(&span, codeIdx) = code;
+	*prv_SpanAt(&span, o++) = TELEMETRY_FRAME_DELIMITER;
+
+	(void)TELEMETRY_CFG_TX_COMMIT(o);
+	return TRUE;
+}
+
+static boolean prv_SendDescriptor(void)
+{
+	uint8 rec[TELEMETRY_CFG_MAX_RECORD_SIZE];
+	uint16 p = prv_PutHeader(rec, TELEMETRY_REC_DESCRIPTOR);
+
+	p = prv_PutLe(rec, p, (uint32)s_cfg->MainPeriodMs * s_decim, 2u);
+	rec[p++] = s_cfg->ChannelCount;
+	for(uint8 i = 0u; i < s_cfg->ChannelCount; i++)
+	{
+		rec[p++] = s_cfg->Channels[i].Id;
+		rec[p++] = s_cfg->Channels[i].Size;
+	}
+
+	if(prv_Send(rec, p) == FALSE) return FALSE;
+	s_stats.Descriptors++;
+	return TRUE;
+}
+
+static void prv_SendSample(void)
+{
+	uint8 rec[TELEMETRY_CFG_MAX_RECORD_SIZE];
+	uint16 p = prv_PutHeader(rec, TELEMETRY_REC_SAMPLE);
+
+	for(uint8 i = 0u; i < s_cfg->ChannelCount; i++)
+	{
+		const Telemetry_ChannelCfgType* ch = &s_cfg->Channels[i];
+		uint32 v = (ch->Sample != NULL_PTR) ? ch->Sample() : 0u;
+		p = prv_PutLe(rec, p, v, ch->Size);
+	}
+
+	if(prv_Send(rec, p) == TRUE) s_stats.Records++;
+}
+
+/* ==============================
+ *       APIs
+ * ============================== */
+void Telemetry_Init(const Telemetry_ConfigType* CfgPtr)
+{
+	s_inited = FALSE;
+
+	if(CfgPtr == NULL_PTR || CfgPtr->Channels == NULL_PTR)
+	{
+		TELEMETRY_DET_REPORT(TELEMETRY_API_ID_INIT, TELEMETRY_E_PARAM_POINTER);
+		return;
+	}
+
+	// every record has to fit the local buffer, channel sizes must be 1/2/4
+	for(uint8 i = 0u; i < CfgPtr->ChannelCount; i++)
+	{
+		uint8 sz = CfgPtr->Channels[i].Size;
+		if((sz != 1u) && (sz != 2u) && (sz != 4u))
+		{
+			TELEMETRY_DET_REPORT(TELEMETRY_API_ID_INIT, TELEMETRY_E_PARAM_CONFIG);
+			return;
+		}
+	}
+	if((prv_SampleSize(CfgPtr) > TELEMETRY_CFG_MAX_RECORD_SIZE) ||
+	   (prv_DescriptorSize(CfgPtr) > TELEMETRY_CFG_MAX_RECORD_SIZE))
+	{
+		TELEMETRY_DET_REPORT(TELEMETRY_API_ID_INIT, TELEMETRY_E_PARAM_CONFIG);
+		return;
+	}
+
+	s_cfg			= CfgPtr;
+	s_decim			= CfgPtr->Decimation;
+	s_divCnt		= 0u;
+	s_seq			= 0u;
+	s_sinceDesc		= 0u;
+	s_descPending	= TRUE;
+	s_stats			= (Telemetry_StatsType){0};
+	s_inited		= (TELEMETRY_CFG_ENABLE == 1u) ? TRUE : FALSE;
+}
+
+void Telemetry_DeInit(void)
+{
+	s_inited	= FALSE;
+	s_cfg		= NULL_PTR;
+}
+
+void Telemetry_MainFunction(void)
+{
+	if(s_inited == FALSE) return;
+	if(s_decim == 0u) return;
+
+	if(++s_divCnt < s_decim) return;
+	s_divCnt = 0u;
+
+	// descriptor goes first so the host can decode what follows; retried next cycle if ring is full
+	if(s_descPending == TRUE)
+	{
+		if(prv_SendDescriptor() == FALSE) return;
+		s_descPending	= FALSE;
+		s_sinceDesc		= 0u;
+	}
+
+	prv_SendSample();
+
+	if(s_cfg->DescriptorPeriod != 0u)
+	{
+		if(++s_sinceDesc >= s_cfg->DescriptorPeriod) s_descPending = TRUE;
+	}
+}
+
+Std_ReturnType Telemetry_SetDecimation(uint8 Decimation)
+{
+	if(s_inited == FALSE)
+	{
+		TELEMETRY_DET_REPORT(TELEMETRY_API_ID_SETDECIMATION, TELEMETRY_E_UNINIT);
+		return E_NOT_OK;
+	}
+
+	s_decim			= Decimation;
+	s_divCnt		= 0u;
+	s_descPending	= TRUE;		// record period changed
+	return E_OK;
+}
+
+Std_ReturnType Telemetry_GetStats(Telemetry_StatsType* StatsPtr)
+{
+	if(StatsPtr == NULL_PTR)
+	{
+		TELEMETRY_DET_REPORT(TELEMETRY_API_ID_GETSTATS, TELEMETRY_E_PARAM_POINTER);
+		return E_NOT_OK;
+	}
+
+	*StatsPtr = s_stats;
+	return E_OK;
+}
@@ -0,0 +1,126 @@
+/* =====================================================================================================================
+ *  File        : Telemetry.h
+ *  Layer       : Services
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Binary telemetry stream over UartIf
+ * 					- Sample configured channels every N main cycles (decimation)
+ * 					- Record = type | seq | ts | values | CRC16, little endian
+ * 					- Each record is COBS encoded in place into the UART Tx ring and delimited by 0x00
+ *  Depends     : Std_Types.h, Crc.h, UartIf.h
+ * ===================================================================================================================*/
+
+#ifndef TELEMETRY_TELEMETRY_H_
+#define TELEMETRY_TELEMETRY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+#include "Det.h"
+
+/* ==============================
+ *       VERSION & IDENTITIES
+ * ============================== */
+#define TELEMETRY_VENDOR_ID					(0x00u)
+#define TELEMETRY_MODULE_ID					(0xC8u)
+#define TELEMETRY_INSTANCE_ID				(0x00u)
+
+#define TELEMETRY_SW_MAJOR_VERSION			(1u)
+#define TELEMETRY_SW_MINOR_VERSION			(0u)
+#define TELEMETRY_SW_PATCH_VERSION			(0u)
+
+/* ==============================
+ *       BUILD-TIME SWITCHES
+ * ============================== */
+#ifndef TELEMETRY_DEV_ERROR_DETECT
+#define TELEMETRY_DEV_ERROR_DETECT			STD_ON
+#endif
+
+/* ==============================
+ *       API IDs
+ * ============================== */
+#define TELEMETRY_API_ID_INIT				(0x01u)
+#define TELEMETRY_API_ID_DEINIT				(0x02u)
+#define TELEMETRY_API_ID_MAINFUNCTION		(0x03u)
+#define TELEMETRY_API_ID_SETDECIMATION		(0x04u)
+#define TELEMETRY_API_ID_GETSTATS			(0x05u)
+
+/* ==============================
+ *         DET ERROR CODES
+ * ============================== */
+#define TELEMETRY_E_UNINIT					(0x01u)
+#define TELEMETRY_E_PARAM_POINTER			(0x02u)
+#define TELEMETRY_E_PARAM_CONFIG			(0x03u)
+
+#if (TELEMETRY_DEV_ERROR_DETECT == STD_ON)
+#define TELEMETRY_DET_REPORT(_api, _err)\
+	Det_ReportError(TELEMETRY_MODULE_ID, TELEMETRY_INSTANCE_ID, (_api), (_err))
+#else
+#define TELEMETRY_DET_REPORT(_api, _err) ((void)0)
+#endif
+
+/* ==============================
+ *         WIRE FORMAT
+ * ============================== */
+#define TELEMETRY_REC_SAMPLE				(0x01u)		// type|seq|ts32|values...|crc16
+#define TELEMETRY_REC_DESCRIPTOR			(0x02u)		// type|seq|ts32|periodMs16|count|{id,size}*count|crc16
+
+#define TELEMETRY_HEADER_SIZE				(6u)		// type + seq + ts32
+#define TELEMETRY_CRC_SIZE					(2u)
+#define TELEMETRY_FRAME_DELIMITER			(0x00u)
+
+/* ==============================
+ *            TYPES
+ * ============================== */
+// Returns current value of one channel, only the low Size bytes are sent
+typedef uint32 (*Telemetry_SampleFnType)(void);
+
+typedef struct
+{
+	uint8					Id;			// channel id seen by the host decoder
+	uint8					Size;		// 1, 2 or 4 bytes on the wire
+	Telemetry_SampleFnType	Sample;
+} Telemetry_ChannelCfgType;
+
+typedef struct
+{
+	const Telemetry_ChannelCfgType*	Channels;
+	uint8							ChannelCount;
+	uint8							Decimation;			// 1 record every N calls of Telemetry_MainFunction
+	uint16							DescriptorPeriod;	// resend descriptor every N sample records, 0: only at init
+	uint16							MainPeriodMs;		// call period of Telemetry_MainFunction
+	uint32							(*GetTimeMs)(void);
+} Telemetry_ConfigType;
+
+typedef struct
+{
+	uint32	Records;		// sample records queued
+	uint32	Descriptors;	// descriptor records queued
+	uint32	Dropped;		// records skipped because the Tx ring was full
+} Telemetry_StatsType;
+
+/* ==============================
+ *             API
+ * ============================== */
+void Telemetry_Init(const Telemetry_ConfigType* CfgPtr);
+void Telemetry_DeInit(void);
+
+// Call cyclically with MainPeriodMs, never waits on the UART
+void Telemetry_MainFunction(void);
+
+// Change decimation at runtime, 0 pauses the stream
+Std_ReturnType Telemetry_SetDecimation(uint8 Decimation);
+
+Std_ReturnType Telemetry_GetStats(Telemetry_StatsType* StatsPtr);
+
+/* =========================================================
+ * 	 Global configuration
+ * =======================================================*/
+extern const Telemetry_ConfigType Telemetry_Config;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_TELEMETRY_H_ */
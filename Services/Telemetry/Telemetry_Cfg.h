@@ -0,0 +1,49 @@
+/* =====================================================================================================================
+ *  File        : Telemetry_Cfg.h
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Compile-time settings of telemetry service
+ *  Depends     : Telemetry.h
+ * ===================================================================================================================*/
+
+#ifndef TELEMETRY_TELEMETRY_CFG_H_
+#define TELEMETRY_TELEMETRY_CFG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Telemetry.h"
+
+/* Enable/Disable telemetry stream */
+#ifndef TELEMETRY_CFG_ENABLE
+#define TELEMETRY_CFG_ENABLE				(1u)
+#endif
+
+/* Max raw record (header + values + crc) in bytes.
+ * Must stay <= 253 so one COBS block covers the record (encoded = raw + 1) */
+#ifndef TELEMETRY_CFG_MAX_RECORD_SIZE
+#define TELEMETRY_CFG_MAX_RECORD_SIZE		(48u)
+#endif
+
+/* Budget @115200 8N1 = 11520 B/s. Default record (15 value bytes) = 23 raw + 3 framing = 26 B,
+ * so 100 Hz uses ~2.6 kB/s and leaves the rest of the link for Logger text */
+
+/* Tx backend (zero copy ring reservation) */
+#ifndef TELEMETRY_CFG_TX_RESERVE
+#define TELEMETRY_CFG_TX_RESERVE(_len, _span)	UartIf_TxReserve((_len), (_span))
+#endif
+
+#ifndef TELEMETRY_CFG_TX_COMMIT
+#define TELEMETRY_CFG_TX_COMMIT(_len)			UartIf_TxCommit((_len))
+#endif
+
+#if (TELEMETRY_CFG_MAX_RECORD_SIZE > 253u)
+#error "TELEMETRY_CFG_MAX_RECORD_SIZE must be <= 253"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_TELEMETRY_CFG_H_ */
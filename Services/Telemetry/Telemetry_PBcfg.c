@@ -0,0 +1,109 @@
+/* =====================================================================================================================
+ *  File        : Telemetry_PBcfg.c
+ *  Layer       : Services (Config)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Channel table of telemetry stream (ids must match Tools/TelemetryDecoder)
+ *  Depends     : Telemetry.h, Rte.h, SWC headers, StackMon.h, Can.h, CanSM.h
+ * ===================================================================================================================*/
+
+#include "Telemetry.h"
+#include "Telemetry_Cfg.h"
+#include "Mcu.h"
+#include "Rte.h"
+#include "Sensor.h"
+#include "SensorSupervisor.h"
+#include "ObstacleDetection.h"
+#include "StackMon.h"
+#include "Can.h"
+#include "CanSM.h"
+
+/* ==============================
+ *       CHANNEL IDs
+ * ============================== */
+#define TELEMETRY_CH_DISTANCE				(0x01u)
+#define TELEMETRY_CH_OBSTACLE_STATE			(0x02u)
+#define TELEMETRY_CH_SUPERVISOR_STATUS		(0x03u)
+#define TELEMETRY_CH_SENSOR_STATUS			(0x04u)
+#define TELEMETRY_CH_SENSOR_TIMEOUTS		(0x05u)
+#define TELEMETRY_CH_INVALID_MEAS			(0x06u)
+#define TELEMETRY_CH_STACK_USED				(0x07u)
+#define TELEMETRY_CH_CAN_TEC				(0x08u)
+#define TELEMETRY_CH_CAN_REC				(0x09u)
+#define TELEMETRY_CH_CAN_LEC				(0x0Au)
+#define TELEMETRY_CH_CAN_BUSOFF_COUNT		(0x0Bu)
+#define TELEMETRY_CH_CANSM_STATE			(0x0Cu)
+
+/* ==============================
+ *       SAMPLERS
+ * ============================== */
+// distance, 0xFFFF when RTE signal is not valid
+static uint32 Sample_Distance(void)
+{
+	Rte_DistanceType d;
+	return (Rte_Read_Distance(&d) == RTE_E_OK) ? (uint32)d : 0xFFFFu;
+}
+
+// obstacle state, 0xFF when RTE signal is not valid
+static uint32 Sample_ObstacleState(void)
+{
+	Rte_ObstacleStateType s;
+	return (Rte_Read_ObstacleState(&s) == RTE_E_OK) ? (uint32)s : 0xFFu;
+}
+
+static uint32 Sample_SupervisorStatus(void)	{ return (uint32)SensorSupervisor_GetSensorStatus(); }
+static uint32 Sample_SensorStatus(void)		{ return (uint32)Sensor_GetStatus(); }
+static uint32 Sample_SensorTimeouts(void)		{ return (uint32)Sensor_GetTimeoutCounter(); }
+static uint32 Sample_InvalidMeas(void)			{ return (uint32)ObstacleDetection_GetInvalidMeasurementCounter(); }
+static uint32 Sample_StackUsed(void)			{ return StackMon_GetUsedBytes(); }
+
+// CAN controller statistics, all 0 before Can_Init
+static Can_StatisticsType prv_CanStats(void)
+{
+	Can_StatisticsType s = { CAN_ERRORSTATE_ACTIVE, 0u, 0u, CAN_LEC_NONE, 0u, 0u, 0u };
+
+	(void)Can_GetStatistics(0u, &s);
+	return s;
+}
+
+static uint32 Sample_CanTec(void)				{ return (uint32)prv_CanStats().Tec; }
+static uint32 Sample_CanRec(void)				{ return (uint32)prv_CanStats().Rec; }
+static uint32 Sample_CanLec(void)				{ return (uint32)prv_CanStats().LastErrorCode; }
+static uint32 Sample_CanBusOffCount(void)		{ return (uint32)prv_CanStats().BusOffCount; }
+
+static uint32 Sample_CanSMState(void)
+{
+	CanSM_StatusType s;
+	return (CanSM_GetStatus(&s) == E_OK) ? (uint32)s.State : 0u;
+}
+
+static uint32 Telemetry_GetMs(void)
+{
+	return s_systickTicks;
+}
+
+/* ==============================
+ *       CONFIG
+ * ============================== */
+static const Telemetry_ChannelCfgType Telemetry_Channels[] = {
+	{ .Id = TELEMETRY_CH_DISTANCE,			.Size = 2u,	.Sample = Sample_Distance },
+	{ .Id = TELEMETRY_CH_OBSTACLE_STATE,	.Size = 1u,	.Sample = Sample_ObstacleState },
+	{ .Id = TELEMETRY_CH_SUPERVISOR_STATUS,	.Size = 1u,	.Sample = Sample_SupervisorStatus },
+	{ .Id = TELEMETRY_CH_SENSOR_STATUS,		.Size = 1u,	.Sample = Sample_SensorStatus },
+	{ .Id = TELEMETRY_CH_SENSOR_TIMEOUTS,	.Size = 1u,	.Sample = Sample_SensorTimeouts },
+	{ .Id = TELEMETRY_CH_INVALID_MEAS,		.Size = 1u,	.Sample = Sample_InvalidMeas },
+	{ .Id = TELEMETRY_CH_STACK_USED,		.Size = 2u,	.Sample = Sample_StackUsed },
+	{ .Id = TELEMETRY_CH_CAN_TEC,			.Size = 1u,	.Sample = Sample_CanTec },
+	{ .Id = TELEMETRY_CH_CAN_REC,			.Size = 1u,	.Sample = Sample_CanRec },
+	{ .Id = TELEMETRY_CH_CAN_LEC,			.Size = 1u,	.Sample = Sample_CanLec },
+	{ .Id = TELEMETRY_CH_CAN_BUSOFF_COUNT,	.Size = 2u,	.Sample = Sample_CanBusOffCount },
+	{ .Id = TELEMETRY_CH_CANSM_STATE,		.Size = 1u,	.Sample = Sample_CanSMState },
+};
+
+const Telemetry_ConfigType Telemetry_Config = {
+		.Channels			= Telemetry_Channels,
+		.ChannelCount		= (uint8)(sizeof(Telemetry_Channels) / sizeof(Telemetry_ChannelCfgType)),
+		.Decimation			= 1u,		// 10 ms main period -> 100 Hz
+		.DescriptorPeriod	= 500u,		// every 5 s at 100 Hz
+		.MainPeriodMs		= 10u,
+		.GetTimeMs			= Telemetry_GetMs
+};
@@ -0,0 +1,151 @@
+/* =====================================================================================================================
+ *  File        : Bench_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host entry point of the benchmark suite (Services/Bench) against the register models
+ *  Usage       : sim_bench [-c insn|ns] [-o <file>]
+ * 					-c insn		retired user space instructions of this thread (perf_event_open, default)
+ * 					-c ns		thread CPU time, used when perf events are not available (containers, paranoid level)
+ * 					-o <file>	JSON lines to file (default stdout)
+ *  Notes       : Instruction counts are repeatable across runs and hosts with the same compiler, they track the
+ * 				  target cycle counts in trend only (x86 vs Thumb-2, models instead of peripherals).
+ *  Exit        : 0 ok, 2 setup error, 3 firmware stopped
+ *  Depends     : Sim.h, EcuM.h, Bench.h
+ * ===================================================================================================================*/
+
+#define _GNU_SOURCE						// syscall
+
+#include <linux/perf_event.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Sim.h"
+#include "EcuM.h"
+#include "Bench.h"
+
+#define BENCH_MAIN_SETTLE_US			(50000u)	// boot logs drained before the first case
+
+static int		s_perfFd	= -1;
+static jmp_buf	s_stopJmp;
+
+/* ==============================
+ *       COUNTERS
+ * ============================== */
+static uint32 prv_InsnRead(void)
+{
+	uint64 v = 0u;
+
+	if(read(s_perfFd, &v, sizeof(v)) != (ssize_t)sizeof(v)) return 0u;
+	return (uint32)v;
+}
+
+static uint32 prv_NsRead(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint32)((uint64)ts.tv_sec * 1000000000u + (uint64)ts.tv_nsec);
+}
+
+static boolean prv_InsnOpen(void)
+{
+	struct perf_event_attr pe;
+
+	memset(&pe, 0, sizeof(pe));
+	pe.type				= PERF_TYPE_HARDWARE;
+	pe.size				= sizeof(pe);
+	pe.config			= PERF_COUNT_HW_INSTRUCTIONS;
+	pe.exclude_kernel	= 1;
+	pe.exclude_hv		= 1;
+
+	s_perfFd = (int)syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0);
+	return (s_perfFd >= 0) ? TRUE : FALSE;
+}
+
+/* ==============================
+ *       SIM OBSERVERS
+ * ============================== */
+static void prv_UartSink(uint8 Uart, uint8 Byte)
+{
+	(void)Uart; (void)Byte;
+}
+
+static void prv_StopHandler(Sim_StopType Reason)
+{
+	longjmp(s_stopJmp, (int)Reason);
+}
+
+/* ==============================
+ *       MAIN
+ * ============================== */
+int main(int argc, char** argv)
+{
+	const char* counter	= "insn";
+	const char* outPath	= NULL_PTR;
+	FILE* out;
+	char line[BENCH_CFG_LINE_SIZE];
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))		counter	= argv[++i];
+		else if((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))	outPath	= argv[++i];
+		else
+		{
+			fprintf(stderr, "usage: %s [-c insn|ns] [-o <file>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if((strcmp(counter, "insn") == 0) && (prv_InsnOpen() == FALSE))
+	{
+		fprintf(stderr, "bench: perf events not available, using thread CPU time\n");
+		counter = "ns";
+	}
+
+	if(strcmp(counter, "insn") == 0)		Bench_SetCounter(prv_InsnRead, "insn");
+	else if(strcmp(counter, "ns") == 0)		Bench_SetCounter(prv_NsRead, "ns");
+	else
+	{
+		fprintf(stderr, "bench: unknown counter %s\n", counter);
+		return 2;
+	}
+
+	out = (outPath != NULL_PTR) ? fopen(outPath, "w") : stdout;
+	if(out == NULL_PTR) return 2;
+
+	if(Sim_Init() != E_OK) return 2;
+	Sim_SetUartSink(prv_UartSink);
+	Sim_SetStopHandler(prv_StopHandler);
+
+	if(setjmp(s_stopJmp) != 0)
+	{
+		fprintf(stderr, "bench: firmware stopped at %.3f ms\n", (double)Sim_NowUs() / 1000.0);
+		return 3;
+	}
+
+	EcuM_Init(&EcuM_Config);
+	Sim_Advance(BENCH_MAIN_SETTLE_US);
+
+	Bench_Init(&Bench_Config);
+	if(Bench_Config.Prepare != NULL_PTR) Bench_Config.Prepare();
+
+	(void)Bench_FormatHeader(line, (uint16)sizeof(line));
+	fprintf(out, "%s\n", line);
+
+	for(uint16 c = 0u; c < Bench_GetCaseCount(); c++)
+	{
+		Bench_ResultType res;
+
+		if(Bench_RunCase(c, &res) != E_OK) return 2;
+		(void)Bench_FormatResult(c, &res, line, (uint16)sizeof(line));
+		fprintf(out, "%s\n", line);
+	}
+
+	if(out != stdout) fclose(out);
+	return 0;
+}
@@ -0,0 +1,267 @@
+/* =====================================================================================================================
+ *  File        : Codec_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Exhaustive property test of the signal codec (Com_Codec.c) against a bit-by-bit reference
+ * 					- every type, Intel and Motorola, BitPosition 0 .. 69, BitSize 0 .. 33 (invalid ones included)
+ * 					- Com_CodecInit accepts exactly the signals that fit an 8 byte frame and their type, MinLength
+ * 					  is the number of bytes up to the last one the signal touches
+ * 					- pack writes the signal bits and nothing else, edge and random values over random frames
+ * 					- unpack reads the signal bits with sign extension, at every received length 0 .. 9
+ * 					- unpack(pack(v)) is v cut to BitSize and sign extended
+ * 				  The reference walks the signal one bit at a time: Intel goes to the next bit number, Motorola
+ * 				  from bit 7 of a byte to bit 0 of the byte before (sawtooth).
+ *  Usage       : sim_codec [-s <seed>]		seed of the random values and frames (default 1)
+ *  Exit        : 0 ok, 1 mismatches, 2 usage
+ *  Depends     : Com_Codec.h
+ * ===================================================================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Com_Codec.h"
+
+#define CODEC_POS_MAX					(70u)		// positions 0 .. 69, the frame ends at 63
+#define CODEC_SIZE_MAX					(34u)		// sizes 0 .. 33, no type is wider than 32
+#define CODEC_RANDOM_VALUES				(32u)		// per signal, besides the edge values
+#define CODEC_RANDOM_FRAMES				(8u)		// per signal, each read at every length
+
+static uint64	s_seed		= 1u;
+static uint32	s_checks	= 0u;
+static uint32	s_errors	= 0u;
+
+static const Com_SignalTypeEnum s_types[] =
+{
+	COM_SIGNAL_UINT8, COM_SIGNAL_UINT16, COM_SIGNAL_UINT32, COM_SIGNAL_SINT8, COM_SIGNAL_SINT16, COM_SIGNAL_SINT32
+};
+
+/* ==============================
+ *       HELPERS
+ * ============================== */
+// xorshift64, the same sequence on every host for a seed
+static uint32 prv_Random(void)
+{
+	s_seed ^= s_seed << 13;
+	s_seed ^= s_seed >> 7;
+	s_seed ^= s_seed << 17;
+	return (uint32)(s_seed >> 16);
+}
+
+static void prv_RandomFrame(uint8* Data)
+{
+	uint8 i;
+
+	for(i = 0u; i < COM_CODEC_FRAME_BYTES; i++) Data[i] = (uint8)prv_Random();
+}
+
+static void prv_Check(boolean Ok, const Com_SignalConfigType* Sig, const char* What, uint32 Expected, uint32 Got)
+{
+	s_checks++;
+	if(Ok == TRUE) return;
+
+	// the first few tell the story, the count tells the rest
+	if(s_errors < 10u)
+	{
+		fprintf(stderr, "codec: type %u %s pos %u size %u: %s, expected 0x%08X got 0x%08X\n",
+				(unsigned)Sig->SignalType, (Sig->Endianness == COM_BIG_ENDIAN) ? "motorola" : "intel",
+				(unsigned)Sig->BitPosition, (unsigned)Sig->BitSize, What, (unsigned)Expected, (unsigned)Got);
+	}
+	s_errors++;
+}
+
+/* ==============================
+ *       REFERENCE
+ * ============================== */
+static uint8 prv_TypeBits(Com_SignalTypeEnum Type)
+{
+	if((Type == COM_SIGNAL_UINT8) || (Type == COM_SIGNAL_SINT8))	return 8u;
+	if((Type == COM_SIGNAL_UINT16) || (Type == COM_SIGNAL_SINT16))	return 16u;
+	return 32u;
+}
+
+static boolean prv_IsSigned(Com_SignalTypeEnum Type)
+{
+	return ((Type == COM_SIGNAL_SINT8) || (Type == COM_SIGNAL_SINT16) || (Type == COM_SIGNAL_SINT32)) ? TRUE : FALSE;
+}
+
+// Frame bit numbers (byte * 8 + bit) of the signal, LSB first. FALSE: the signal leaves the frame or its type
+static boolean prv_RefBits(const Com_SignalConfigType* Sig, uint8* Bits)
+{
+	sint16 p = (sint16)Sig->BitPosition;
+	uint8 i;
+
+	if((Sig->BitSize == 0u) || (Sig->BitSize > prv_TypeBits(Sig->SignalType))) return FALSE;
+
+	for(i = 0u; i < Sig->BitSize; i++)
+	{
+		if((p < 0) || (p >= (sint16)(COM_CODEC_FRAME_BYTES * 8u))) return FALSE;
+		Bits[i] = (uint8)p;
+
+		if(Sig->Endianness == COM_LITTLE_ENDIAN)	p++;
+		else if((p % 8) == 7)						p = (sint16)(p - 15);		// bit 0 of the byte before
+		else										p++;
+	}
+	return TRUE;
+}
+
+static uint8 prv_RefMinLength(const uint8* Bits, uint8 Size)
+{
+	uint8 last = 0u;
+	uint8 i;
+
+	for(i = 0u; i < Size; i++)
+	{
+		if((Bits[i] / 8u) > last) last = (uint8)(Bits[i] / 8u);
+	}
+	return (uint8)(last + 1u);
+}
+
+// Cut to BitSize and sign extended: what a receiver of Value sees
+static uint32 prv_RefValue(const Com_SignalConfigType* Sig, uint32 Value)
+{
+	uint32 mask = (Sig->BitSize >= 32u) ? 0xFFFFFFFFu : ((1u << Sig->BitSize) - 1u);
+
+	Value &= mask;
+	if((prv_IsSigned(Sig->SignalType) == TRUE) && ((Value >> (Sig->BitSize - 1u)) != 0u)) Value |= ~mask;
+	return Value;
+}
+
+static uint32 prv_RefRead(const Com_SignalConfigType* Sig, const uint8* Bits, const uint8* Data, uint8 Length)
+{
+	uint32 v = 0u;
+	uint8 i;
+
+	for(i = 0u; i < Sig->BitSize; i++)
+	{
+		uint8 byte = (uint8)(Bits[i] / 8u);
+
+		if((byte < Length) && (((Data[byte] >> (Bits[i] % 8u)) & 1u) != 0u)) v |= (1u << i);
+	}
+	return prv_RefValue(Sig, v);
+}
+
+/* ==============================
+ *       PROPERTIES
+ * ============================== */
+static void prv_PackValue(const Com_SignalConfigType* Sig, const Com_CodecType* Codec, const uint8* Bits, uint32 Value)
+{
+	uint8 before[COM_CODEC_FRAME_BYTES];
+	uint8 data[COM_CODEC_FRAME_BYTES];
+	uint8 expected[COM_CODEC_FRAME_BYTES];
+	Com_CodecFrameType frame;
+	uint8 i;
+
+	prv_RandomFrame(before);
+	memcpy(data, before, sizeof(data));
+	memcpy(expected, before, sizeof(expected));
+	for(i = 0u; i < Sig->BitSize; i++)
+	{
+		uint8 bit = (uint8)(1u << (Bits[i] % 8u));
+
+		if(((Value >> i) & 1u) != 0u)	expected[Bits[i] / 8u] |= bit;
+		else							expected[Bits[i] / 8u] &= (uint8)~bit;
+	}
+
+	Com_CodecPack(Codec, data, Value);
+	for(i = 0u; i < COM_CODEC_FRAME_BYTES; i++)
+	{
+		prv_Check((data[i] == expected[i]) ? TRUE : FALSE, Sig, "pack byte", expected[i], data[i]);
+	}
+
+	Com_CodecLoad(&frame, data, COM_CODEC_FRAME_BYTES);
+	prv_Check((Com_CodecUnpack(Codec, &frame) == prv_RefValue(Sig, Value)) ? TRUE : FALSE, Sig, "round trip",
+			prv_RefValue(Sig, Value), Com_CodecUnpack(Codec, &frame));
+}
+
+static void prv_Signal(const Com_SignalConfigType* Sig)
+{
+	uint8 bits[CODEC_SIZE_MAX];
+	Com_CodecType codec;
+	boolean valid	= prv_RefBits(Sig, bits);
+	boolean ok		= (Com_CodecInit(&codec, Sig) == E_OK) ? TRUE : FALSE;
+	uint32 edges[] = { 0u, 1u, 0xFFFFFFFFu, 0x55555555u, 0xAAAAAAAAu, 0u, 0u, 0u };
+	uint8 data[COM_CODEC_FRAME_BYTES];
+	uint8 i;
+	uint8 len;
+
+	prv_Check((ok == valid) ? TRUE : FALSE, Sig, "init", valid, ok);
+	if((ok == FALSE) || (valid == FALSE)) return;
+
+	prv_Check((codec.MinLength == prv_RefMinLength(bits, Sig->BitSize)) ? TRUE : FALSE, Sig, "min length",
+			prv_RefMinLength(bits, Sig->BitSize), codec.MinLength);
+
+	// sign bit alone, largest positive, mask
+	edges[5] = 1u << (Sig->BitSize - 1u);
+	edges[6] = edges[5] - 1u;
+	edges[7] = edges[5] | edges[6];
+	for(i = 0u; i < (sizeof(edges) / sizeof(edges[0])); i++)	prv_PackValue(Sig, &codec, bits, edges[i]);
+	for(i = 0u; i < CODEC_RANDOM_VALUES; i++)					prv_PackValue(Sig, &codec, bits, prv_Random());
+
+	// a short frame reads 0 beyond its length
+	for(i = 0u; i < CODEC_RANDOM_FRAMES; i++)
+	{
+		prv_RandomFrame(data);
+		for(len = 0u; len <= (COM_CODEC_FRAME_BYTES + 1u); len++)
+		{
+			Com_CodecFrameType frame;
+			uint8 copy[COM_CODEC_FRAME_BYTES + 1u];
+			uint32 expected;
+			uint32 got;
+
+			memcpy(copy, data, COM_CODEC_FRAME_BYTES);
+			copy[COM_CODEC_FRAME_BYTES] = 0xFFu;						// never read
+			Com_CodecLoad(&frame, copy, len);
+			expected	= prv_RefRead(Sig, bits, copy, (len > COM_CODEC_FRAME_BYTES) ? COM_CODEC_FRAME_BYTES : len);
+			got			= Com_CodecUnpack(&codec, &frame);
+			prv_Check((got == expected) ? TRUE : FALSE, Sig, "unpack", expected, got);
+		}
+	}
+}
+
+/* ==============================
+ *       MAIN
+ * ============================== */
+int main(int argc, char** argv)
+{
+	Com_SignalConfigType sig;
+	uint8 t;
+	uint8 order;
+	uint8 pos;
+	uint8 size;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))	s_seed = strtoull(argv[++i], NULL, 0);
+		else
+		{
+			fprintf(stderr, "usage: %s [-s <seed>]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(s_seed == 0u) s_seed = 1u;										// xorshift stays at 0
+
+	memset(&sig, 0, sizeof(sig));
+	sig.UpdateBitPosition = COM_NO_UPDATE_BIT;
+	for(t = 0u; t < (sizeof(s_types) / sizeof(s_types[0])); t++)
+	{
+		for(order = 0u; order < 2u; order++)
+		{
+			for(pos = 0u; pos < CODEC_POS_MAX; pos++)
+			{
+				for(size = 0u; size < CODEC_SIZE_MAX; size++)
+				{
+					sig.SignalType	= s_types[t];
+					sig.Endianness	= (order == 0u) ? COM_LITTLE_ENDIAN : COM_BIG_ENDIAN;
+					sig.BitPosition	= pos;
+					sig.BitSize		= size;
+					prv_Signal(&sig);
+				}
+			}
+		}
+	}
+
+	printf("codec: %u checks, %u errors\n", (unsigned)s_checks, (unsigned)s_errors);
+	return (s_errors == 0u) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+/* =====================================================================================================================
+ *  File        : ComStack_Types.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host stand-in for the AUTOSAR communication stack types
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef COMSTACK_TYPES_H
+#define COMSTACK_TYPES_H
+
+#include "Std_Types.h"
+
+typedef uint16	PduIdType;
+typedef uint16	PduLengthType;
+
+typedef struct
+{
+	uint8*			SduDataPtr;
+	uint8*			MetaDataPtr;
+	PduLengthType	SduLength;
+} PduInfoType;
+
+#endif /* COMSTACK_TYPES_H */
@@ -0,0 +1,12 @@
+/* =====================================================================================================================
+ *  File        : LogLevels.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host stand-in, Logger.h supplies the LOG_LEVEL_* defaults
+ *  Depends     :
+ * ===================================================================================================================*/
+
+#ifndef LOGLEVELS_H
+#define LOGLEVELS_H
+
+#endif /* LOGLEVELS_H */
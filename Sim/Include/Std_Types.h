@@ -0,0 +1,46 @@
+/* =====================================================================================================================
+ *  File        : Std_Types.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host stand-in for the AUTOSAR platform types of the target toolchain package
+ *  Depends     : stdint.h, stddef.h
+ * ===================================================================================================================*/
+
+#ifndef STD_TYPES_H
+#define STD_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t		uint8;
+typedef uint16_t	uint16;
+typedef uint32_t	uint32;
+typedef uint64_t	uint64;
+typedef int8_t		sint8;
+typedef int16_t		sint16;
+typedef int32_t		sint32;
+typedef int64_t		sint64;
+typedef float		float32;
+typedef double		float64;
+
+typedef uint8		boolean;
+typedef uint8		Std_ReturnType;
+
+#ifndef TRUE
+#define TRUE		1u
+#endif
+#ifndef FALSE
+#define FALSE		0u
+#endif
+
+#define E_OK		0u
+#define E_NOT_OK	1u
+
+#define STD_ON		1u
+#define STD_OFF		0u
+#define STD_HIGH	1u
+#define STD_LOW		0u
+
+#define NULL_PTR	((void*)0)
+
+#endif /* STD_TYPES_H */
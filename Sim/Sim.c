@@ -0,0 +1,578 @@
+/* =====================================================================================================================
+ *  File        : Sim.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Register memory, virtual clock, NVIC dispatch and the core models (RCC, SysTick, SCB, IWDG)
+ * 					- an ISR's register effects happen at entry, its cost (Sim_SetIsrCost) is burnt afterwards;
+ * 					  during that time only lines of a higher preemption group (AIRCR.PRIGROUP) nest
+ * 					- latency = first tick a line is seen pending and enabled .. handler entry
+ *  Notes       : Register blocks and the flash array are anonymous mappings at the real addresses (0x08000000 /
+ * 				  0x40000000 / 0xE0000000), so every driver keeps its own pointer arithmetic. Linux x86-64 / AArch64
+ * 				  user space only.
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "Sim_Internal.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE				(0x100000)
+#endif
+
+/* ==============================
+ *       MEMORY MAP
+ * ============================== */
+typedef struct
+{
+	uintptr_t	Base;
+	size_t		Size;
+} Sim_RegionType;
+
+static const Sim_RegionType s_regions[] =
+{
+	{ SIM_FLASH_BASE, SIM_FLASH_SIZE },	// main flash array (contents: Sim_Flash.c)
+	{ 0x40000000u, 0x00024000u },		// APB1, APB2, AHB (RCC, FLASH)
+	{ 0xE0000000u, 0x00010000u },		// DWT, SysTick, NVIC, SCB
+};
+
+#define SIM_REGION_COUNT				(sizeof(s_regions) / sizeof(s_regions[0]))
+
+/* ==============================
+ *       CORE REGISTERS
+ * ============================== */
+#define SIM_SYST_ENABLE					(1UL << 0)
+#define SIM_SYST_TICKINT				(1UL << 1)
+#define SIM_SYST_CLKSOURCE				(1UL << 2)
+#define SIM_SYST_COUNTFLAG				(1UL << 16)
+#define SIM_SHPR3_SYSTICK				(*(__vo uint8*)0xE000ED23UL)
+
+#define SIM_AIRCR_VECTKEY				(0x05FAUL)
+#define SIM_AIRCR_VECTKEYSTAT			(0xFA050000UL)
+#define SIM_AIRCR_SYSRESETREQ			(1UL << 2)
+#define SIM_AIRCR_PRIGROUP				(0x700UL)
+
+#define SIM_LSI_HZ						(40000u)
+#define SIM_IRQ_STORM_LIMIT				(64u)		// back to back ISR calls inside one microsecond
+
+/* ==============================
+ *       VECTORS
+ * ============================== */
+// Handlers of the firmware, NULL when the image does not define one
+extern void SysTick_Handler(void)				__attribute__((weak));
+extern void ADC1_2_IRQHandler(void)				__attribute__((weak));
+extern void USB_HP_CAN1_TX_IRQHandler(void)		__attribute__((weak));
+extern void USB_LP_CAN1_RX0_IRQHandler(void)	__attribute__((weak));
+extern void CAN1_RX1_IRQHandler(void)			__attribute__((weak));
+extern void CAN1_SCE_IRQHandler(void)			__attribute__((weak));
+extern void TIM1_CC_IRQHandler(void)			__attribute__((weak));
+extern void TIM2_IRQHandler(void)				__attribute__((weak));
+extern void TIM3_IRQHandler(void)				__attribute__((weak));
+extern void TIM4_IRQHandler(void)				__attribute__((weak));
+extern void USART1_IRQHandler(void)				__attribute__((weak));
+extern void USART2_IRQHandler(void)				__attribute__((weak));
+extern void USART3_IRQHandler(void)				__attribute__((weak));
+
+typedef struct
+{
+	sint8		Irqn;							// -1: SysTick exception
+	void		(*Handler)(void);
+	boolean		(*Pending)(void);
+	void		(*Entry)(void);
+	void		(*Exit)(void);
+} Sim_VectorType;
+
+static boolean s_sysTickPend;
+
+static boolean prv_SysTickPending(void)		{ return s_sysTickPend; }
+static void prv_SysTickEntry(void)			{ s_sysTickPend = FALSE; Sim_Stats.SysTickCount++; }
+
+#define SIM_TIM_VECTOR(_n, _i) \
+	static boolean prv_Tim##_n##Pending(void)	{ return Sim_Tim_IrqPending((_i)); } \
+	static void prv_Tim##_n##Entry(void)		{ Sim_Tim_IsrEntry((_i)); } \
+	static void prv_Tim##_n##Exit(void)			{ Sim_Tim_IsrExit((_i)); }
+
+#define SIM_USART_VECTOR(_n, _i) \
+	static boolean prv_Usart##_n##Pending(void)	{ return Sim_Usart_IrqPending((_i)); } \
+	static void prv_Usart##_n##Entry(void)		{ Sim_Usart_IsrEntry((_i)); } \
+	static void prv_Usart##_n##Exit(void)		{ Sim_Usart_IsrExit((_i)); }
+
+SIM_TIM_VECTOR(1, 0u)
+SIM_TIM_VECTOR(2, 1u)
+SIM_TIM_VECTOR(3, 2u)
+SIM_TIM_VECTOR(4, 3u)
+SIM_USART_VECTOR(1, 0u)
+SIM_USART_VECTOR(2, 1u)
+SIM_USART_VECTOR(3, 2u)
+
+static boolean prv_CanTxPending(void)		{ return Sim_Can_IrqPending(SIM_CAN_IRQ_TX); }
+static boolean prv_CanRx0Pending(void)		{ return Sim_Can_IrqPending(SIM_CAN_IRQ_RX0); }
+static boolean prv_CanRx1Pending(void)		{ return Sim_Can_IrqPending(SIM_CAN_IRQ_RX1); }
+static boolean prv_CanScePending(void)		{ return Sim_Can_IrqPending(SIM_CAN_IRQ_SCE); }
+
+// TIM1 update / trigger lines are folded into TIM1_CC
+static const Sim_VectorType s_vectors[] =
+{
+	{ -1, SysTick_Handler,				prv_SysTickPending,	prv_SysTickEntry,	NULL_PTR		},
+	{ 18, ADC1_2_IRQHandler,			Sim_Adc_IrqPending,	Sim_Adc_IsrEntry,	Sim_Adc_IsrExit	},
+	{ 19, USB_HP_CAN1_TX_IRQHandler,	prv_CanTxPending,	NULL_PTR,			NULL_PTR		},
+	{ 20, USB_LP_CAN1_RX0_IRQHandler,	prv_CanRx0Pending,	NULL_PTR,			NULL_PTR		},
+	{ 21, CAN1_RX1_IRQHandler,			prv_CanRx1Pending,	NULL_PTR,			NULL_PTR		},
+	{ 22, CAN1_SCE_IRQHandler,			prv_CanScePending,	NULL_PTR,			NULL_PTR		},
+	{ 27, TIM1_CC_IRQHandler,			prv_Tim1Pending,	prv_Tim1Entry,		prv_Tim1Exit	},
+	{ 28, TIM2_IRQHandler,				prv_Tim2Pending,	prv_Tim2Entry,		prv_Tim2Exit	},
+	{ 29, TIM3_IRQHandler,				prv_Tim3Pending,	prv_Tim3Entry,		prv_Tim3Exit	},
+	{ 30, TIM4_IRQHandler,				prv_Tim4Pending,	prv_Tim4Entry,		prv_Tim4Exit	},
+	{ 37, USART1_IRQHandler,			prv_Usart1Pending,	prv_Usart1Entry,	prv_Usart1Exit	},
+	{ 38, USART2_IRQHandler,			prv_Usart2Pending,	prv_Usart2Entry,	prv_Usart2Exit	},
+	{ 39, USART3_IRQHandler,			prv_Usart3Pending,	prv_Usart3Entry,	prv_Usart3Exit	},
+};
+
+#define SIM_VECTOR_COUNT				(sizeof(s_vectors) / sizeof(s_vectors[0]))
+
+/* ==============================
+ *            STATE
+ * ============================== */
+uint64					Sim_Cycles;
+Sim_StatsType			Sim_Stats;
+
+static boolean				s_mapped		= FALSE;
+static boolean				s_inIsr			= FALSE;
+static uint32				s_activeGroup	= 0x100u;	// preemption group of the running ISR, 0x100: thread
+static uint32				s_costUs[SIM_VECTOR_COUNT];
+static boolean				s_pend[SIM_VECTOR_COUNT];
+static uint64				s_pendAt[SIM_VECTOR_COUNT];
+static uint32				s_pollUs		= 1u;
+static Sim_UartSinkType		s_uartSink		= NULL_PTR;
+static Sim_CanSinkType		s_canSink		= NULL_PTR;
+static Sim_StopHandlerType	s_stopHandler	= NULL_PTR;
+
+// NVIC enable state (ISER reads back, ICER reads 0 so every disable write is visible)
+static uint32				s_nvicEn[2];
+static uint32				s_pubIser[2];
+
+// SysTick
+static uint32				s_sysTickCvr;
+static uint32				s_pubCvr;
+
+// IWDG
+static boolean				s_iwdgOn;
+static uint32				s_iwdgCnt;
+static uint32				s_iwdgAcc;
+
+/* ==============================
+ *       CORE MODELS
+ * ============================== */
+static void prv_CoreReset(void)
+{
+	RCC->CR			= 0x00000083u;			// HSION | HSIRDY | trim
+	SYST_CALIB		= 0x40002327u;			// 9000 -> 1 ms at HCLK/8
+	SCB_AIRCR		= SIM_AIRCR_VECTKEYSTAT;
+	IWDG_RLR		= 0x0FFFu;
+
+	s_nvicEn[0]		= 0u;	s_nvicEn[1]		= 0u;
+	s_pubIser[0]	= 0u;	s_pubIser[1]	= 0u;
+	s_sysTickCvr	= 0u;
+	s_pubCvr		= 0u;
+	s_sysTickPend	= FALSE;
+	s_iwdgOn		= FALSE;
+	s_iwdgCnt		= 0u;
+	s_iwdgAcc		= 0u;
+}
+
+static void prv_CoreSync(void)
+{
+	uint32 i;
+	uint32 v;
+
+	// RCC: oscillators and PLL are ready as soon as they are switched on
+	v = RCC->CR;
+	v = (v & ~(RCC_CR_HSIRDY | RCC_CR_HSERDY | RCC_CR_PLLRDY))
+	  | ((v & RCC_CR_HSION) ? RCC_CR_HSIRDY : 0u)
+	  | ((v & RCC_CR_HSEON) ? RCC_CR_HSERDY : 0u)
+	  | ((v & RCC_CR_PLLON) ? RCC_CR_PLLRDY : 0u);
+	if(v != RCC->CR) RCC->CR = v;
+
+	v = RCC->CFGR;
+	v = (v & ~(3UL << 2)) | ((v & 3UL) << 2);	// SWS follows SW
+	if(v != RCC->CFGR) RCC->CFGR = v;
+
+	// NVIC
+	for(i = 0u; i < 2u; i++)
+	{
+		v = NVIC_ISER[i];
+		if(v != s_pubIser[i]) s_nvicEn[i] |= v;
+
+		v = NVIC_ICER[i];
+		if(v != 0u) s_nvicEn[i] &= ~v;
+
+		NVIC_ISER[i]	= s_nvicEn[i];
+		NVIC_ICER[i]	= 0u;
+		NVIC_ICPR[i]	= 0u;
+		s_pubIser[i]	= s_nvicEn[i];
+	}
+
+	// SysTick: any write to CVR clears it
+	if(SYST_CVR != s_pubCvr)
+	{
+		s_sysTickCvr	= 0u;
+		SYST_CVR		= 0u;
+		s_pubCvr		= 0u;
+		SYST_CSR		&= ~SIM_SYST_COUNTFLAG;
+	}
+
+	// SCB: reset request
+	v = SCB_AIRCR;
+	if((v >> 16) == SIM_AIRCR_VECTKEY)
+	{
+		SCB_AIRCR = SIM_AIRCR_VECTKEYSTAT | (v & SIM_AIRCR_PRIGROUP);
+		if(v & SIM_AIRCR_SYSRESETREQ) Sim_Stop(SIM_STOP_RESET);
+	}
+
+	// IWDG: KR is write only, reads 0
+	v = IWDG_KR;
+	if(v != 0u)
+	{
+		if(v == 0xCCCCu)		{ s_iwdgOn = TRUE; s_iwdgCnt = IWDG_RLR & 0x0FFFu; }
+		else if(v == 0xAAAAu)	{ s_iwdgCnt = IWDG_RLR & 0x0FFFu; }
+		IWDG_KR = 0u;
+	}
+}
+
+static void prv_CoreTick(void)
+{
+	uint32 csr = SYST_CSR;
+
+	if(csr & SIM_SYST_ENABLE)
+	{
+		uint32 clk = (csr & SIM_SYST_CLKSOURCE) ? SIM_CYC_PER_US : (SIM_CYC_PER_US / 8u);
+		uint32 rvr = SYST_RVR & 0x00FFFFFFu;
+
+		while(clk > 0u)
+		{
+			if(s_sysTickCvr == 0u)
+			{
+				// reload takes one clock
+				s_sysTickCvr = rvr;
+				clk--;
+				if(rvr == 0u) break;
+				continue;
+			}
+
+			uint32 d = (clk < s_sysTickCvr) ? clk : s_sysTickCvr;
+			s_sysTickCvr	-= d;
+			clk				-= d;
+
+			if(s_sysTickCvr == 0u)
+			{
+				SYST_CSR |= SIM_SYST_COUNTFLAG;
+				if(csr & SIM_SYST_TICKINT) s_sysTickPend = TRUE;
+			}
+		}
+
+		SYST_CVR = s_sysTickCvr;
+		s_pubCvr = s_sysTickCvr;
+	}
+
+	// IWDG: LSI / (4 << PR)
+	if(s_iwdgOn == TRUE)
+	{
+		uint32 div = (SIM_CPU_HZ / SIM_LSI_HZ) * (4u << (IWDG_PR & 7u));
+
+		s_iwdgAcc += SIM_CYC_PER_US;
+		if(s_iwdgAcc >= div)
+		{
+			s_iwdgAcc -= div;
+			if(s_iwdgCnt == 0u) Sim_Stop(SIM_STOP_IWDG);
+			s_iwdgCnt--;
+		}
+	}
+}
+
+/* ==============================
+ *       SCHEDULER
+ * ============================== */
+static void prv_SyncAll(void)
+{
+	prv_CoreSync();
+	Sim_Gpio_Sync();
+	Sim_Tim_Sync();
+	Sim_Usart_Sync();
+	Sim_Can_Sync();
+	Sim_Adc_Sync();
+	Sim_Flash_Sync();
+}
+
+static void prv_StampPending(void);
+
+static void prv_TickAll(void)
+{
+	prv_CoreTick();
+	Sim_Tim_Tick();
+	Sim_Gpio_Tick();
+	Sim_Hcsr04_Tick();
+	Sim_Usart_Tick();
+	Sim_Can_Tick();
+	Sim_Adc_Tick();
+	Sim_Flash_Tick();
+	prv_StampPending();
+}
+
+static uint8 prv_Priority(const Sim_VectorType* v)
+{
+	return (v->Irqn < 0) ? SIM_SHPR3_SYSTICK : NVIC_IPR_BASE[(uint8)v->Irqn];
+}
+
+static boolean prv_Enabled(const Sim_VectorType* v)
+{
+	if(v->Irqn < 0) return TRUE;
+	return ((s_nvicEn[(uint8)v->Irqn >> 5] >> ((uint8)v->Irqn & 0x1Fu)) & 1u) ? TRUE : FALSE;
+}
+
+// Preemption group of a priority byte: bits above PRIGROUP
+static uint32 prv_Group(uint8 Prio)
+{
+	return (uint32)Prio >> (((SCB_AIRCR & SIM_AIRCR_PRIGROUP) >> 8) + 1u);
+}
+
+// Time stamp of the first tick each line is pending and enabled
+static void prv_StampPending(void)
+{
+	uint32 i;
+
+	for(i = 0u; i < SIM_VECTOR_COUNT; i++)
+	{
+		const Sim_VectorType* v = &s_vectors[i];
+
+		if((prv_Enabled(v) == TRUE) && (v->Pending() == TRUE))
+		{
+			if(s_pend[i] == FALSE) { s_pend[i] = TRUE; s_pendAt[i] = Sim_Cycles; }
+		} else {
+			s_pend[i] = FALSE;
+		}
+	}
+}
+
+// Highest priority pending line that may preempt the running one (lowest value, then lowest number)
+static const Sim_VectorType* prv_NextPending(void)
+{
+	const Sim_VectorType* best = NULL_PTR;
+	uint32 i;
+
+	for(i = 0u; i < SIM_VECTOR_COUNT; i++)
+	{
+		const Sim_VectorType* v = &s_vectors[i];
+
+		if((prv_Enabled(v) == TRUE) && (v->Pending() == TRUE) && (prv_Group(prv_Priority(v)) < s_activeGroup))
+		{
+			if((best == NULL_PTR) || (prv_Priority(v) < prv_Priority(best))) best = v;
+		}
+	}
+	return best;
+}
+
+static void prv_Dispatch(void);
+
+// CPU time of an ISR body, higher groups nest
+static void prv_Burn(uint32 Us)
+{
+	while(Us-- > 0u)
+	{
+		Sim_Cycles += SIM_CYC_PER_US;
+		prv_TickAll();
+		prv_Dispatch();
+	}
+}
+
+static void prv_Latency(uint32 Idx)
+{
+	const Sim_VectorType* v = &s_vectors[Idx];
+	uint32 us;
+
+	if(v->Irqn < 0) return;
+	us = (s_pend[Idx] == TRUE) ? (uint32)((Sim_Cycles - s_pendAt[Idx]) / SIM_CYC_PER_US) : 0u;
+	s_pend[Idx] = FALSE;
+
+	if(us > Sim_Stats.IrqLatencyMaxUs[(uint8)v->Irqn]) Sim_Stats.IrqLatencyMaxUs[(uint8)v->Irqn] = us;
+	Sim_Stats.IrqLatencySumUs[(uint8)v->Irqn] += us;
+}
+
+static void prv_Dispatch(void)
+{
+	uint32 n;
+
+	if(s_inIsr == TRUE) return;
+
+	for(n = 0u; ; n++)
+	{
+		const Sim_VectorType* v = prv_NextPending();
+		uint32 idx;
+		uint32 saved;
+
+		if(v == NULL_PTR) return;
+		idx = (uint32)(v - s_vectors);
+
+		if(v->Handler == NULL_PTR)
+		{
+			fprintf(stderr, "sim: IRQ %d enabled without handler\n", v->Irqn);
+			Sim_Stop(SIM_STOP_NO_HANDLER);
+		}
+		if(n >= SIM_IRQ_STORM_LIMIT)
+		{
+			fprintf(stderr, "sim: IRQ %d still pending after %u ISR calls\n", v->Irqn, (unsigned)n);
+			Sim_Stop(SIM_STOP_IRQ_STORM);
+		}
+
+		prv_Latency(idx);
+		saved			= s_activeGroup;
+		s_activeGroup	= prv_Group(prv_Priority(v));
+
+		if(v->Entry != NULL_PTR) v->Entry();
+
+		s_inIsr = TRUE;
+		v->Handler();
+		s_inIsr = FALSE;
+
+		prv_SyncAll();
+		if(v->Exit != NULL_PTR) v->Exit();
+
+		if(v->Irqn >= 0) Sim_Stats.IrqCount[(uint8)v->Irqn]++;
+
+		prv_Burn(s_costUs[idx]);
+		s_activeGroup	= saved;
+	}
+}
+
+/* ==============================
+ *       APIs
+ * ============================== */
+Std_ReturnType Sim_Init(void)
+{
+	uint32 i;
+
+	for(i = 0u; i < SIM_REGION_COUNT; i++)
+	{
+		void* p = (void*)s_regions[i].Base;
+
+		if(s_mapped == FALSE)
+		{
+			p = mmap(p, s_regions[i].Size, PROT_READ | PROT_WRITE,
+					 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+			if((p == MAP_FAILED) || ((uintptr_t)p != s_regions[i].Base))
+			{
+				fprintf(stderr, "sim: cannot map registers at 0x%08lx\n", (unsigned long)s_regions[i].Base);
+				return E_NOT_OK;
+			}
+		}
+		memset(p, 0, s_regions[i].Size);
+	}
+	s_mapped = TRUE;
+
+	Sim_Cycles		= 0u;
+	s_inIsr			= FALSE;
+	s_activeGroup	= 0x100u;
+	memset(&Sim_Stats, 0, sizeof(Sim_Stats));
+	memset(s_pend, 0, sizeof(s_pend));
+
+	prv_CoreReset();
+	Sim_Gpio_Reset();
+	Sim_Tim_Reset();
+	Sim_Hcsr04_Reset();
+	Sim_Usart_Reset();
+	Sim_Can_Reset();
+	Sim_Adc_Reset();
+	Sim_Flash_Reset();
+
+	return E_OK;
+}
+
+void Sim_Advance(uint32 Us)
+{
+	prv_SyncAll();
+	prv_Dispatch();
+
+	while(Us-- > 0u)
+	{
+		Sim_Cycles += SIM_CYC_PER_US;
+		prv_TickAll();
+		prv_Dispatch();
+	}
+}
+
+void Sim_Poll(void)
+{
+	Sim_Stats.Polls++;
+	Sim_Advance(s_pollUs);
+}
+
+void Sim_Sync(void)
+{
+	prv_SyncAll();
+}
+
+uint64 Sim_NowUs(void)
+{
+	return Sim_Cycles / SIM_CYC_PER_US;
+}
+
+void Sim_SetPollCost(uint32 Us)
+{
+	s_pollUs = Us;
+}
+
+Std_ReturnType Sim_SetIsrCost(sint8 Irqn, uint32 Us)
+{
+	uint32 i;
+
+	for(i = 0u; i < SIM_VECTOR_COUNT; i++)
+	{
+		if(s_vectors[i].Irqn == Irqn) { s_costUs[i] = Us; return E_OK; }
+	}
+	return E_NOT_OK;
+}
+
+void Sim_SetUartSink(Sim_UartSinkType Sink)			{ s_uartSink	= Sink;		}
+void Sim_SetCanSink(Sim_CanSinkType Sink)			{ s_canSink		= Sink;		}
+void Sim_SetStopHandler(Sim_StopHandlerType Handler){ s_stopHandler	= Handler;	}
+
+const Sim_StatsType* Sim_GetStats(void)
+{
+	return &Sim_Stats;
+}
+
+void Sim_Stop(Sim_StopType Reason)
+{
+	s_inIsr			= FALSE;
+	s_activeGroup	= 0x100u;
+	if(s_stopHandler != NULL_PTR) s_stopHandler(Reason);
+
+	fprintf(stderr, "sim: stopped (%d)\n", (int)Reason);
+	exit(3);
+}
+
+void Sim_EmitUart(uint8 Uart, uint8 Byte)
+{
+	Sim_Stats.UartTxBytes[Uart]++;
+	if(s_uartSink != NULL_PTR) s_uartSink(Uart, Byte);
+}
+
+void Sim_EmitCan(const Sim_CanFrameType* Frame)
+{
+	Sim_Stats.CanTxFrames++;
+	if(s_canSink != NULL_PTR) s_canSink(Frame);
+}
+
+/* ==============================
+ *       LIBC
+ * ============================== */
+// newlib integer-only printf used by Logger
+int vsniprintf(char* Buf, size_t Size, const char* Fmt, va_list Ap)
+{
+	return vsnprintf(Buf, Size, Fmt, Ap);
+}
@@ -0,0 +1,145 @@
+/* =====================================================================================================================
+ *  File        : Sim.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host simulation of the STM32F103 peripherals used by the ECU
+ * 					- register blocks are mapped at their real addresses, drivers run unmodified
+ * 					- behavioural models: RCC, SysTick/NVIC/SCB, IWDG, GPIO, TIM1..4, USART1..3, bxCAN, ADC1,
+ * 					  main flash with its program / erase controller
+ * 					- HC-SR04 model on TIM2 CH2 (trigger, PA1) / CH1 (echo, PA0)
+ * 					- virtual clock with 1 us resolution, 72 MHz core clock
+ * 					- optional ISR cost, nesting by preemption group, per-line interrupt latency
+ *  Depends     : Std_Types.h
+ * ===================================================================================================================*/
+
+#ifndef SIM_SIM_H_
+#define SIM_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Std_Types.h"
+
+/* ==============================
+ *       CONSTANTS
+ * ============================== */
+#define SIM_CPU_HZ						(72000000u)
+#define SIM_CYC_PER_US					(SIM_CPU_HZ / 1000000u)
+
+#define SIM_UART_COUNT					(3u)		// USART1..3
+#define SIM_ADC_CHANNELS				(18u)		// 0..15 external, 16 temperature, 17 VREFINT
+
+// HC-SR04 answer modes
+#define SIM_ECHO_OFF					(0u)		// sensor unplugged, echo stays low
+#define SIM_ECHO_PULSE					(1u)		// echo high for the configured round trip
+#define SIM_ECHO_NO_OBJECT				(2u)		// nothing in range, echo high for 38 ms
+
+// bxCAN fault kinds
+#define SIM_CAN_FAULT_TX				(0u)		// every transmission ends in a bit error (broken TX line)
+#define SIM_CAN_FAULT_RX				(1u)		// receive errors seen on the bus (REC + n)
+#define SIM_CAN_FAULT_INIT				(2u)		// INAK stops following INRQ (no clock, bus stuck dominant)
+#define SIM_CAN_FAULT_BUS				(3u)		// a higher priority node holds the bus: no arbitration won
+
+/* ==============================
+ *       TYPES
+ * ============================== */
+// Reason the model stopped the firmware
+typedef enum
+{
+	SIM_STOP_RESET = 1,							// SCB_AIRCR SYSRESETREQ
+	SIM_STOP_IWDG,								// watchdog expired
+	SIM_STOP_IRQ_STORM,							// ISR returns with its source still pending
+	SIM_STOP_NO_HANDLER							// enabled IRQ without handler (Default_Handler on target)
+} Sim_StopType;
+
+typedef struct
+{
+	uint32	Id;
+	boolean	Ide;								// TRUE: 29 bit identifier
+	boolean	Rtr;
+	uint8	Dlc;
+	uint8	Data[8];
+} Sim_CanFrameType;
+
+typedef struct
+{
+	uint32	Polls;								// REG_POLL calls
+	uint32	IrqCount[64];						// per NVIC line
+	uint32	IrqLatencyMaxUs[64];				// pending .. handler entry
+	uint64	IrqLatencySumUs[64];
+	uint32	SysTickCount;
+	uint32	UartTxBytes[SIM_UART_COUNT];
+	uint32	UartRxBytes[SIM_UART_COUNT];
+	uint32	UartRxOverrun[SIM_UART_COUNT];
+	uint32	CanTxFrames;
+	uint32	CanRxFrames;
+	uint32	CanRxLost;							// not in normal mode, filtered out or FIFO full
+	uint32	EchoTriggers;
+	uint32	EchoShortTriggers;					// trigger pulse < 10 us, ignored by the sensor
+	uint32	FlashPrograms;						// half-words
+	uint32	FlashErases;						// pages
+	uint32	FlashPowerLoss;						// operations torn by Sim_Flash_PowerLoss
+} Sim_StatsType;
+
+// Observers
+typedef void (*Sim_UartSinkType)(uint8 Uart, uint8 Byte);			// Uart: 0 = USART1
+typedef void (*Sim_CanSinkType)(const Sim_CanFrameType* Frame);
+typedef void (*Sim_StopHandlerType)(Sim_StopType Reason);			// must not return (longjmp/exit)
+
+/* ==============================
+ *       API
+ * ============================== */
+// Map the register blocks and load reset values
+Std_ReturnType Sim_Init(void);
+
+// Run the peripherals for Us microseconds (ISRs are called on the way)
+void Sim_Advance(uint32 Us);
+
+// Virtual time
+uint64 Sim_NowUs(void);
+
+// Virtual time consumed by one REG_POLL (default 1 us)
+void Sim_SetPollCost(uint32 Us);
+
+// CPU time of one ISR call (default 0), Irqn -1: SysTick
+Std_ReturnType Sim_SetIsrCost(sint8 Irqn, uint32 Us);
+
+void Sim_SetUartSink(Sim_UartSinkType Sink);
+void Sim_SetCanSink(Sim_CanSinkType Sink);
+void Sim_SetStopHandler(Sim_StopHandlerType Handler);
+
+const Sim_StatsType* Sim_GetStats(void);
+
+/* ==============================
+ *       STIMULI
+ * ============================== */
+// HC-SR04: answer of the next triggers (EchoUs used by SIM_ECHO_PULSE)
+void Sim_Echo_Set(uint8 Mode, uint32 EchoUs);
+
+// Bytes arriving on the RX line, one character time apart
+void Sim_Uart_Inject(uint8 Uart, const uint8* Data, uint32 Len);
+
+// Frame received from the bus now (acceptance filters apply)
+void Sim_Can_Inject(const Sim_CanFrameType* Frame);
+
+// bxCAN faults: SIM_CAN_FAULT_TX / INIT / BUS on (Arg 1) or off (0), SIM_CAN_FAULT_RX Arg receive errors now
+void Sim_Can_Fault(uint8 Kind, uint32 Arg);
+
+// ADC input (12 bit raw)
+void Sim_Adc_Set(uint8 Channel, uint16 Raw);
+
+// Supply lost: AfterOps 0 now, n halfway through the n-th flash program / erase from now (that one is torn)
+void Sim_Flash_PowerLoss(uint32 AfterOps);
+
+// Supply back: FPEC locked and idle, the flash array keeps what the power loss left
+void Sim_Flash_PowerOn(void);
+
+// Worn page at Address (0: none): its erase leaves the first half-word at 0x0000 (blank check fails)
+void Sim_Flash_Worn(uint32 Address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_SIM_H_ */
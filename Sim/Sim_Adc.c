@@ -0,0 +1,122 @@
+/* =====================================================================================================================
+ *  File        : Sim_Adc.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : ADC1 model: calibration, single regular conversion on SWSTART
+ * 					- conversion time = sample time (SMPRx) + 12.5 ADCCLK at 12 MHz
+ * 					- DR from Sim_Adc_Set, EOC set on completion; a new start drops the old EOC
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include "Sim_Internal.h"
+
+#define SIM_ADC_CYC_PER_CLK				(6u)		// 72 MHz / 12 MHz
+#define SIM_ADC_CAL_CLK					(83u)
+#define SIM_ADC_SR_EOC					(1UL << 1)
+#define SIM_ADC_SR_STRT					(1UL << 4)
+#define SIM_ADC_CR1_EOCIE				(1UL << 5)
+
+// sample time in half ADC clocks: 1.5, 7.5, 13.5, 28.5, 41.5, 55.5, 71.5, 239.5
+static const uint16 s_smpHalf[8] = { 3u, 15u, 27u, 57u, 83u, 111u, 143u, 479u };
+
+static uint16	s_value[SIM_ADC_CHANNELS];
+static uint32	s_pubSr;
+static boolean	s_calBusy;
+static uint64	s_calEnd;
+static boolean	s_convBusy;
+static uint64	s_convEnd;
+static uint8	s_convCh;
+static uint32	s_isrSr;
+
+static uint32 prv_SampleCode(uint8 Ch)
+{
+	if(Ch >= 10u) return (ADC1->SMPR1 >> ((Ch - 10u) * ADC_SMP_BITS)) & 7u;
+	return (ADC1->SMPR2 >> (Ch * ADC_SMP_BITS)) & 7u;
+}
+
+void Sim_Adc_Reset(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_ADC_CHANNELS; i++) s_value[i] = 0u;
+	s_value[16]	= 1775u;		// temperature sensor, 1.43 V -> 25 degC
+	s_value[17]	= 1489u;		// VREFINT 1.20 V
+
+	s_pubSr		= 0u;
+	s_calBusy	= FALSE;
+	s_convBusy	= FALSE;
+}
+
+void Sim_Adc_Sync(void)
+{
+	uint32 cr2	= ADC1->CR2;
+	uint32 sr	= ADC1->SR;
+
+	if(sr != s_pubSr)
+	{
+		s_pubSr		&= sr;				// rc_w0
+		ADC1->SR	= s_pubSr;
+	}
+
+	if((cr2 & ADC_CR2_ADON) == 0u) return;
+
+	if((cr2 & (ADC_CR2_CAL | ADC_CR2_RSTCAL)) && (s_calBusy == FALSE))
+	{
+		s_calBusy	= TRUE;
+		s_calEnd	= Sim_Cycles + ((cr2 & ADC_CR2_CAL) ? (SIM_ADC_CAL_CLK * SIM_ADC_CYC_PER_CLK) : SIM_ADC_CYC_PER_CLK);
+	}
+
+	if((cr2 & ADC_CR2_SWSTART) && ((cr2 & ADC_CR2_EXTSEL) == ADC_CR2_EXTSEL_SWSTART) && (cr2 & ADC_CR2_EXTTRIG))
+	{
+		ADC1->CR2	= cr2 & ~ADC_CR2_SWSTART;
+		s_convCh	= (uint8)(ADC1->SQR3 & 0x1Fu);
+		s_convBusy	= TRUE;
+		s_convEnd	= Sim_Cycles + (((uint32)s_smpHalf[prv_SampleCode(s_convCh)] + 25u) * SIM_ADC_CYC_PER_CLK) / 2u;
+		s_pubSr		= (s_pubSr & ~SIM_ADC_SR_EOC) | SIM_ADC_SR_STRT;
+		ADC1->SR	= s_pubSr;
+	}
+}
+
+void Sim_Adc_Tick(void)
+{
+	if((s_calBusy == TRUE) && (Sim_Cycles >= s_calEnd))
+	{
+		ADC1->CR2	&= ~(ADC_CR2_CAL | ADC_CR2_RSTCAL);
+		s_calBusy	= FALSE;
+	}
+
+	if((s_convBusy == TRUE) && (Sim_Cycles >= s_convEnd))
+	{
+		uint32 v = (s_convCh < SIM_ADC_CHANNELS) ? s_value[s_convCh] : 0u;
+
+		ADC1->DR	= (ADC1->CR2 & ADC_CR2_ALIGN) ? (v << 4) : v;
+		s_pubSr		|= SIM_ADC_SR_EOC;
+		ADC1->SR	= s_pubSr;
+		s_convBusy	= FALSE;
+	}
+}
+
+boolean Sim_Adc_IrqPending(void)
+{
+	return ((ADC1->CR1 & SIM_ADC_CR1_EOCIE) && (s_pubSr & SIM_ADC_SR_EOC)) ? TRUE : FALSE;
+}
+
+void Sim_Adc_IsrEntry(void)
+{
+	s_isrSr = s_pubSr;
+}
+
+// ISR serving EOC reads DR
+void Sim_Adc_IsrExit(void)
+{
+	if(s_isrSr & SIM_ADC_SR_EOC)
+	{
+		s_pubSr		&= ~SIM_ADC_SR_EOC;
+		ADC1->SR	= s_pubSr;
+	}
+}
+
+void Sim_Adc_Set(uint8 Channel, uint16 Raw)
+{
+	if(Channel < SIM_ADC_CHANNELS) s_value[Channel] = Raw & 0x0FFFu;
+}
@@ -0,0 +1,528 @@
+/* =====================================================================================================================
+ *  File        : Sim_Can.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : bxCAN (CAN1) model
+ * 					- sleep / init / normal modes from MCR (INRQ, SLEEP), INAK / SLAK in MSR, wake-up on the first
+ * 					  frame while asleep with AWUM (frame lost, SLEEP cleared, WKUI)
+ * 					- 3 TX mailboxes, lowest identifier first, frame time from BTR, RQCP/TXOK/TME in TSR (rc_w1)
+ * 					- 2 RX FIFOs of 3, acceptance filters (14 banks, 16/32 bit, mask/list), FULL / FOVR
+ * 					- loop back (LBKM) and silent (SILM) test modes
+ * 					- fault confinement: TEC / REC / LEC in ESR, warning / passive / bus-off flags, ERRI and the SCE
+ * 					  line, bus-off recovery after 128 x 11 bit times once init mode was left (or ABOM)
+ * 					- injected faults (Sim_Can_Fault): failing transmissions, receive errors, INAK stuck, bus held
+ *  Notes       : No arbitration against other nodes, stuff bits not counted. A failing transmission is a bit error
+ * 				  after SIM_CAN_ERROR_FRAME_BITS, retried at once (NART off), TEC + 8 each
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include <string.h>
+
+#include "Sim_Internal.h"
+
+#define SIM_CAN_MB						(3u)
+#define SIM_CAN_FIFO_DEPTH				(3u)
+#define SIM_CAN_BANKS					(14u)
+#define SIM_CAN_ERROR_FRAME_BITS		(20u)		// bit error early in the frame, error flag, delimiter, intermission
+#define SIM_CAN_BOR_BITS				(128u * 11u)	// bus-off recovery: 128 x 11 recessive bits
+
+#define SIM_CAN_TSR_MB_FLAGS(_m)		(0xFUL << ((_m) * 8u))	// RQCP, TXOK, ALST, TERR
+#define SIM_CAN_TSR_RQCP(_m)			(1UL << ((_m) * 8u))
+#define SIM_CAN_TSR_TXOK(_m)			(2UL << ((_m) * 8u))
+#define SIM_CAN_TSR_ABRQ(_m)			(0x80UL << ((_m) * 8u))
+#define SIM_CAN_TSR_TME(_m)				(1UL << (26u + (_m)))
+#define SIM_CAN_RFR_FULL				(1UL << 3)
+#define SIM_CAN_RFR_FOVR				(1UL << 4)
+
+#define SIM_CAN_IER_TMEIE				(1UL << 0)
+#define SIM_CAN_IER_FMPIE(_f)			(1UL << (1u + (_f) * 3u))
+#define SIM_CAN_IER_FFIE(_f)			(1UL << (2u + (_f) * 3u))
+#define SIM_CAN_IER_FOVIE(_f)			(1UL << (3u + (_f) * 3u))
+#define SIM_CAN_MSR_RESET				(0x00000C02u)	// SLAK, SAMP, RX
+#define SIM_CAN_LEC_STUFF				(1u)
+#define SIM_CAN_LEC_BIT_DOMINANT		(5u)
+
+typedef struct
+{
+	Sim_CanFrameType	Frame[SIM_CAN_FIFO_DEPTH];
+	uint8				Fmi[SIM_CAN_FIFO_DEPTH];
+	uint8				Count;
+	uint32				Flags;					// FULL / FOVR
+	uint32				PubRfr;
+} Sim_CanFifoType;
+
+static Sim_CanFifoType	s_fifo[2];
+static uint32			s_pubTsr;
+static boolean			s_txBusy;
+static uint8			s_txMb;
+static uint64			s_txEnd;
+static boolean			s_txFail;				// the running attempt ends in a bit error
+
+// fault confinement
+static uint32			s_pubMsr;
+static uint32			s_pubEsr;
+static uint32			s_errFlags;				// EWGF / EPVF / BOFF last published, ERRI on a rising one
+static uint16			s_tec;					// > 255: bus-off
+static uint8			s_rec;
+static uint8			s_lec;
+static boolean			s_busOff;
+static boolean			s_borArmed;				// init mode entered since the bus-off (ABOM off)
+static uint64			s_borEnd;				// 0: recovery not running
+static boolean			s_faultTx;
+static boolean			s_faultInit;
+static boolean			s_faultBus;				// arbitration always lost: no attempt starts, no error counted
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static __vo uint32* prv_Rfr(uint8 f)
+{
+	return (f == 0u) ? &CAN1->RF0R : &CAN1->RF1R;
+}
+
+static boolean prv_Normal(void)
+{
+	return (((CAN1->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) == 0u) && (s_busOff == FALSE)) ? TRUE : FALSE;
+}
+
+static void prv_SetMsr(uint32 Msr)
+{
+	s_pubMsr	= Msr;
+	CAN1->MSR	= Msr;
+}
+
+// Counters -> ESR, ERRI for each flag that rose with its interrupt enabled
+static void prv_PublishEsr(void)
+{
+	uint32 ier		= CAN1->IER;
+	uint32 flags	= 0u;
+	uint32 rise;
+
+	if((s_tec >= 96u) || (s_rec >= 96u))	flags |= CAN_ESR_EWGF;
+	if((s_tec > 127u) || (s_rec > 127u))	flags |= CAN_ESR_EPVF;
+	if(s_busOff == TRUE)					flags |= CAN_ESR_BOFF;
+
+	rise		= flags & ~s_errFlags;
+	s_errFlags	= flags;
+	if(((rise & CAN_ESR_EWGF) && (ier & CAN_IER_EWGIE)) || ((rise & CAN_ESR_EPVF) && (ier & CAN_IER_EPVIE)) ||
+	   ((rise & CAN_ESR_BOFF) && (ier & CAN_IER_BOFIE)))
+	{
+		prv_SetMsr(s_pubMsr | CAN_MSR_ERRI);
+	}
+
+	s_pubEsr	= flags | ((uint32)s_lec << CAN_ESR_LEC_Pos) | ((uint32)((s_tec > 255u) ? 255u : s_tec) << CAN_ESR_TEC_Pos)
+				| ((uint32)s_rec << CAN_ESR_REC_Pos);
+	CAN1->ESR	= s_pubEsr;
+}
+
+static void prv_Error(uint8 Lec)
+{
+	s_lec = Lec;
+	if(CAN1->IER & CAN_IER_LECIE) prv_SetMsr(s_pubMsr | CAN_MSR_ERRI);
+}
+
+static void prv_PublishFifo(uint8 f)
+{
+	Sim_CanFifoType* q = &s_fifo[f];
+
+	if(q->Count > 0u)
+	{
+		const Sim_CanFrameType* fr = &q->Frame[0];
+
+		CAN1->sFIFOMailBox[f].RIR	= (fr->Ide ? ((fr->Id << CAN_TI0R_EXID_Pos) | CAN_RI_IDE) : (fr->Id << CAN_TI0R_STID_Pos))
+									| (fr->Rtr ? CAN_RI_RTR : 0u);
+		CAN1->sFIFOMailBox[f].RDTR	= (fr->Dlc & 0xFu) | ((uint32)q->Fmi[0] << 8);
+		CAN1->sFIFOMailBox[f].RDLR	= (uint32)fr->Data[0] | ((uint32)fr->Data[1] << 8) | ((uint32)fr->Data[2] << 16) | ((uint32)fr->Data[3] << 24);
+		CAN1->sFIFOMailBox[f].RDHR	= (uint32)fr->Data[4] | ((uint32)fr->Data[5] << 8) | ((uint32)fr->Data[6] << 16) | ((uint32)fr->Data[7] << 24);
+	}
+
+	q->PubRfr		= q->Count | q->Flags;
+	*prv_Rfr(f)		= q->PubRfr;
+}
+
+static void prv_Push(uint8 f, const Sim_CanFrameType* Frame, uint8 Fmi)
+{
+	Sim_CanFifoType* q = &s_fifo[f];
+
+	if(q->Count >= SIM_CAN_FIFO_DEPTH)
+	{
+		q->Flags |= SIM_CAN_RFR_FOVR;		// FIFO locked mode off: new frame lost
+		Sim_Stats.CanRxLost++;
+	} else {
+		q->Frame[q->Count]	= *Frame;
+		q->Fmi[q->Count]	= Fmi;
+		q->Count++;
+		if(q->Count == SIM_CAN_FIFO_DEPTH) q->Flags |= SIM_CAN_RFR_FULL;
+		Sim_Stats.CanRxFrames++;
+	}
+	prv_PublishFifo(f);
+}
+
+// 16 bit filter image: STID[15:5] RTR[4] IDE[3] EXID[17:15] in [2:0]
+static uint32 prv_Img16(const Sim_CanFrameType* Fr)
+{
+	uint32 std = Fr->Ide ? (Fr->Id >> 18) : Fr->Id;
+	uint32 ext = Fr->Ide ? ((Fr->Id >> 15) & 7u) : 0u;
+
+	return ((std & 0x7FFu) << 5) | (Fr->Rtr ? 0x10u : 0u) | (Fr->Ide ? 0x08u : 0u) | ext;
+}
+
+// 32 bit filter image: same layout as TIR / RIR
+static uint32 prv_Img32(const Sim_CanFrameType* Fr)
+{
+	return (Fr->Ide ? ((Fr->Id << 3) | CAN_RI_IDE) : (Fr->Id << 21)) | (Fr->Rtr ? CAN_RI_RTR : 0u);
+}
+
+// First matching active bank -> FIFO, -1 when no filter accepts the frame
+static sint8 prv_Filter(const Sim_CanFrameType* Fr, uint8* Fmi)
+{
+	uint32 b;
+	uint8 n = 0u;
+
+	for(b = 0u; b < SIM_CAN_BANKS; b++)
+	{
+		uint32 r1		= CAN1->sFilterRegister[b].FR1;
+		uint32 r2		= CAN1->sFilterRegister[b].FR2;
+		boolean list	= (CAN1->FM1R >> b) & 1u;
+		boolean scale32	= (CAN1->FS1R >> b) & 1u;
+		boolean hit		= FALSE;
+
+		if(((CAN1->FA1R >> b) & 1u) == 0u)
+		{
+			n = (uint8)(n + (scale32 ? (list ? 2u : 1u) : (list ? 4u : 2u)));
+			continue;
+		}
+
+		if(scale32)
+		{
+			uint32 w = prv_Img32(Fr);
+
+			if(list)	{ if(w == (r1 & ~1u)) { hit = TRUE; } else if(w == (r2 & ~1u)) { hit = TRUE; n++; } }
+			else		{ hit = ((w & r2) == (r1 & r2)) ? TRUE : FALSE; }
+		} else {
+			uint32 w = prv_Img16(Fr);
+
+			if(list)
+			{
+				uint32 ids[4] = { r1 & 0xFFFFu, r1 >> 16, r2 & 0xFFFFu, r2 >> 16 };
+				uint8 k;
+
+				for(k = 0u; (k < 4u) && (hit == FALSE); k++)
+				{
+					if((ids[k] & 0xFFF8u) == (w & 0xFFF8u)) { hit = TRUE; n = (uint8)(n + k); }
+				}
+			} else {
+				if((w & (r1 >> 16)) == ((r1 & 0xFFFFu) & (r1 >> 16)))		{ hit = TRUE; }
+				else if((w & (r2 >> 16)) == ((r2 & 0xFFFFu) & (r2 >> 16)))	{ hit = TRUE; n++; }
+			}
+		}
+
+		if(hit == TRUE)
+		{
+			*Fmi = n;
+			return (sint8)((CAN1->FFA1R >> b) & 1u);
+		}
+		n = (uint8)(n + (scale32 ? (list ? 2u : 1u) : (list ? 4u : 2u)));
+	}
+	return -1;
+}
+
+static void prv_ReadMailbox(uint8 m, Sim_CanFrameType* Fr)
+{
+	uint32 tir	= CAN1->sTxMailBox[m].TIR;
+	uint32 lo	= CAN1->sTxMailBox[m].TDLR;
+	uint32 hi	= CAN1->sTxMailBox[m].TDHR;
+	uint8 i;
+
+	Fr->Ide	= (tir & CAN_TI_IDE) ? TRUE : FALSE;
+	Fr->Rtr	= (tir & CAN_TI_RTR) ? TRUE : FALSE;
+	Fr->Id	= Fr->Ide ? (tir >> CAN_TI0R_EXID_Pos) : (tir >> CAN_TI0R_STID_Pos);
+	Fr->Dlc	= (uint8)(CAN1->sTxMailBox[m].TDTR & 0xFu);
+	for(i = 0u; i < 4u; i++)
+	{
+		Fr->Data[i]			= (uint8)(lo >> (i * 8u));
+		Fr->Data[i + 4u]	= (uint8)(hi >> (i * 8u));
+	}
+}
+
+// Bit time in core cycles; tq = (BRP + 1) PCLK1 cycles
+static uint32 prv_BitCycles(void)
+{
+	uint32 btr	= CAN1->BTR;
+	uint32 tq	= ((btr & 0x3FFu) + 1u) * 2u;
+
+	return tq * (3u + ((btr >> CAN_BTR_TS1_Pos) & 0xFu) + ((btr >> CAN_BTR_TS2_Pos) & 0x7u));
+}
+
+// Frame length on the bus (no stuff bits) x bit time
+static uint64 prv_FrameCycles(const Sim_CanFrameType* Fr)
+{
+	uint32 dlc	= (Fr->Dlc > 8u) ? 8u : Fr->Dlc;
+	uint32 bits	= (Fr->Ide ? 67u : 47u) + (Fr->Rtr ? 0u : (8u * dlc));
+
+	return (uint64)bits * prv_BitCycles();
+}
+
+/* ==============================
+ *       MODEL
+ * ============================== */
+void Sim_Can_Reset(void)
+{
+	CAN1->MCR	= 0x00010002u;		// SLEEP
+	CAN1->BTR	= 0x01230000u;
+	CAN1->TSR	= SIM_CAN_TSR_TME(0u) | SIM_CAN_TSR_TME(1u) | SIM_CAN_TSR_TME(2u);
+	CAN1->FMR	= 0x2A1C0E01u;
+	s_pubTsr	= CAN1->TSR;
+	s_txBusy	= FALSE;
+	memset(s_fifo, 0, sizeof(s_fifo));
+
+	prv_SetMsr(SIM_CAN_MSR_RESET);
+	s_tec		= 0u;
+	s_rec		= 0u;
+	s_lec		= 0u;
+	s_errFlags	= 0u;
+	s_busOff	= FALSE;
+	s_borArmed	= FALSE;
+	s_borEnd	= 0u;
+	s_faultTx	= FALSE;
+	s_faultInit	= FALSE;
+	s_faultBus	= FALSE;
+	prv_PublishEsr();
+}
+
+void Sim_Can_Sync(void)
+{
+	uint32 mcr	= CAN1->MCR;
+	uint32 tsr	= CAN1->TSR;
+	uint32 msr	= CAN1->MSR;
+	uint8 m;
+	uint8 f;
+
+	// MSR: ERRI / WKUI rc_w1, the rest read only
+	if(msr != s_pubMsr) s_pubMsr &= ~(msr & (CAN_MSR_ERRI | CAN_MSR_WKUI));
+	msr = s_pubMsr;
+
+	// modes: init request wins, sleep -> init needs SLEEP cleared. A stuck INAK (fault) ignores both
+	if(s_faultInit == TRUE)
+	{
+		// no change
+	} else if(mcr & CAN_MCR_INRQ) {
+		if((mcr & CAN_MCR_SLEEP) == 0u) msr = (msr & ~CAN_MSR_SLAK) | CAN_MSR_INAK;
+	} else if(mcr & CAN_MCR_SLEEP) {
+		msr = (msr & ~CAN_MSR_INAK) | CAN_MSR_SLAK;
+	} else {
+		msr &= ~(CAN_MSR_INAK | CAN_MSR_SLAK);
+	}
+	prv_SetMsr(msr);
+
+	// bus-off: init mode arms the recovery (ABOM off), entering it again restarts the count
+	if((s_busOff == TRUE) && (msr & CAN_MSR_INAK))
+	{
+		s_borArmed	= TRUE;
+		s_borEnd	= 0u;
+	}
+
+	// ESR: only LEC is writable
+	if(CAN1->ESR != s_pubEsr) s_lec = (uint8)((CAN1->ESR & CAN_ESR_LEC_Msk) >> CAN_ESR_LEC_Pos);
+	prv_PublishEsr();
+
+	// TSR: rc_w1 per mailbox, ABRQ aborts a pending request
+	if(tsr != s_pubTsr)
+	{
+		for(m = 0u; m < SIM_CAN_MB; m++)
+		{
+			if(tsr & SIM_CAN_TSR_RQCP(m)) s_pubTsr &= ~SIM_CAN_TSR_MB_FLAGS(m);
+
+			if((tsr & SIM_CAN_TSR_ABRQ(m)) && !(s_txBusy && (s_txMb == m)) && (CAN1->sTxMailBox[m].TIR & CAN_TI_TXRQ))
+			{
+				CAN1->sTxMailBox[m].TIR &= ~CAN_TI_TXRQ;
+				s_pubTsr |= SIM_CAN_TSR_RQCP(m) | SIM_CAN_TSR_TME(m);
+			}
+		}
+	}
+
+	for(m = 0u; m < SIM_CAN_MB; m++)
+	{
+		if(CAN1->sTxMailBox[m].TIR & CAN_TI_TXRQ) s_pubTsr &= ~SIM_CAN_TSR_TME(m);
+	}
+	CAN1->TSR = s_pubTsr;
+
+	// RFxR: RFOM releases the output mailbox, FULL / FOVR rc_w1
+	for(f = 0u; f < 2u; f++)
+	{
+		Sim_CanFifoType* q	= &s_fifo[f];
+		uint32 rfr			= *prv_Rfr(f);
+
+		if(rfr == q->PubRfr) continue;
+
+		q->Flags &= ~(rfr & (SIM_CAN_RFR_FULL | SIM_CAN_RFR_FOVR));
+
+		if((rfr & CAN_RF0R_RFOM0) && (q->Count > 0u))
+		{
+			memmove(&q->Frame[0], &q->Frame[1], sizeof(q->Frame[0]) * (SIM_CAN_FIFO_DEPTH - 1u));
+			memmove(&q->Fmi[0], &q->Fmi[1], sizeof(q->Fmi[0]) * (SIM_CAN_FIFO_DEPTH - 1u));
+			q->Count--;
+			q->Flags &= ~SIM_CAN_RFR_FULL;
+		}
+		prv_PublishFifo(f);
+	}
+}
+
+void Sim_Can_Tick(void)
+{
+	Sim_CanFrameType fr;
+	uint8 m;
+
+	if((s_busOff == TRUE) && ((s_borArmed == TRUE) || (CAN1->MCR & CAN_MCR_ABOM)) && ((CAN1->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) == 0u))
+	{
+		if(s_borEnd == 0u)
+		{
+			s_borEnd = Sim_Cycles + ((uint64)SIM_CAN_BOR_BITS * prv_BitCycles());
+		} else if(Sim_Cycles >= s_borEnd) {
+			// error active again with both counters at 0
+			s_busOff	= FALSE;
+			s_borArmed	= FALSE;
+			s_borEnd	= 0u;
+			s_tec		= 0u;
+			s_rec		= 0u;
+			prv_PublishEsr();
+		}
+	}
+
+	if((s_txBusy == TRUE) && (s_txFail == TRUE))
+	{
+		if(Sim_Cycles < s_txEnd) return;
+
+		// bit error: the request stays in the mailbox and is retried, 32 in a row from 0 take the node off the bus
+		s_txBusy	= FALSE;
+		s_tec		= (uint16)(s_tec + 8u);
+		if(s_tec > 255u) s_busOff = TRUE;
+		prv_Error(SIM_CAN_LEC_BIT_DOMINANT);
+		prv_PublishEsr();
+	}
+
+	if(s_txBusy == TRUE)
+	{
+		if(Sim_Cycles < s_txEnd) return;
+
+		prv_ReadMailbox(s_txMb, &fr);
+		CAN1->sTxMailBox[s_txMb].TIR &= ~CAN_TI_TXRQ;
+		s_pubTsr	|= SIM_CAN_TSR_RQCP(s_txMb) | SIM_CAN_TSR_TXOK(s_txMb) | SIM_CAN_TSR_TME(s_txMb);
+		CAN1->TSR	= s_pubTsr;
+		s_txBusy	= FALSE;
+		if(s_tec > 0u)
+		{
+			s_tec--;
+			prv_PublishEsr();
+		}
+
+		if((CAN1->BTR & CAN_BTR_SILM) == 0u) Sim_EmitCan(&fr);
+
+		if(CAN1->BTR & CAN_BTR_LBKM)
+		{
+			uint8 fmi;
+			sint8 f = prv_Filter(&fr, &fmi);
+
+			if(f >= 0)	prv_Push((uint8)f, &fr, fmi);
+			else		Sim_Stats.CanRxLost++;
+		}
+	}
+
+	if((prv_Normal() == FALSE) || (s_faultBus == TRUE)) return;
+
+	// next request: lowest identifier (TXFP = 0)
+	for(m = 0u; m < SIM_CAN_MB; m++)
+	{
+		uint32 tir = CAN1->sTxMailBox[m].TIR;
+
+		if((tir & CAN_TI_TXRQ) == 0u) continue;
+		if((s_txBusy == FALSE) || ((tir >> 3) < (CAN1->sTxMailBox[s_txMb].TIR >> 3)))
+		{
+			s_txMb		= m;
+			s_txBusy	= TRUE;
+		}
+	}
+
+	if(s_txBusy == TRUE)
+	{
+		prv_ReadMailbox(s_txMb, &fr);
+		s_txFail	= s_faultTx;
+		s_txEnd		= Sim_Cycles + (s_txFail ? ((uint64)SIM_CAN_ERROR_FRAME_BITS * prv_BitCycles()) : prv_FrameCycles(&fr));
+	}
+}
+
+boolean Sim_Can_IrqPending(uint8 Line)
+{
+	uint32 ier = CAN1->IER;
+	uint8 f;
+
+	if(Line == SIM_CAN_IRQ_SCE)
+	{
+		return (((ier & CAN_IER_ERRIE) && (s_pubMsr & CAN_MSR_ERRI)) || ((ier & CAN_IER_WKUIE) && (s_pubMsr & CAN_MSR_WKUI))) ? TRUE : FALSE;
+	}
+
+	if(Line == SIM_CAN_IRQ_TX)
+	{
+		return ((ier & SIM_CAN_IER_TMEIE) && (s_pubTsr & (SIM_CAN_TSR_RQCP(0u) | SIM_CAN_TSR_RQCP(1u) | SIM_CAN_TSR_RQCP(2u)))) ? TRUE : FALSE;
+	}
+
+	f = (uint8)(Line - SIM_CAN_IRQ_RX0);
+	if((ier & SIM_CAN_IER_FMPIE(f)) && (s_fifo[f].Count > 0u))					return TRUE;
+	if((ier & SIM_CAN_IER_FFIE(f)) && (s_fifo[f].Flags & SIM_CAN_RFR_FULL))		return TRUE;
+	if((ier & SIM_CAN_IER_FOVIE(f)) && (s_fifo[f].Flags & SIM_CAN_RFR_FOVR))	return TRUE;
+	return FALSE;
+}
+
+void Sim_Can_Inject(const Sim_CanFrameType* Frame)
+{
+	uint8 fmi;
+	sint8 f;
+
+	// asleep with AWUM: the start of frame wakes the controller, the frame itself is not received
+	if((s_pubMsr & CAN_MSR_SLAK) && (CAN1->MCR & CAN_MCR_AWUM))
+	{
+		CAN1->MCR &= ~CAN_MCR_SLEEP;
+		prv_SetMsr((s_pubMsr & ~CAN_MSR_SLAK) | CAN_MSR_WKUI);
+		Sim_Stats.CanRxLost++;
+		return;
+	}
+
+	// loop back ignores CANRX
+	if((prv_Normal() == FALSE) || (CAN1->BTR & CAN_BTR_LBKM))
+	{
+		Sim_Stats.CanRxLost++;
+		return;
+	}
+
+	// a frame received without error takes REC down (from error passive back to 119 .. 127)
+	if(s_rec > 0u)
+	{
+		s_rec = (s_rec > 127u) ? 120u : (uint8)(s_rec - 1u);
+		prv_PublishEsr();
+	}
+
+	f = prv_Filter(Frame, &fmi);
+	if(f < 0)
+	{
+		Sim_Stats.CanRxLost++;
+		return;
+	}
+	prv_Push((uint8)f, Frame, fmi);
+}
+
+void Sim_Can_Fault(uint8 Kind, uint32 Arg)
+{
+	if(Kind == SIM_CAN_FAULT_TX)
+	{
+		s_faultTx = (Arg != 0u) ? TRUE : FALSE;
+	} else if(Kind == SIM_CAN_FAULT_INIT) {
+		s_faultInit = (Arg != 0u) ? TRUE : FALSE;
+	} else if(Kind == SIM_CAN_FAULT_BUS) {
+		s_faultBus = (Arg != 0u) ? TRUE : FALSE;
+	} else if(prv_Normal() == TRUE) {
+		// receive errors count only while the node takes part in the bus
+		s_rec = (uint8)(((s_rec + Arg) > 255u) ? 255u : (s_rec + Arg));
+		prv_Error(SIM_CAN_LEC_STUFF);
+		prv_PublishEsr();
+	}
+}
@@ -0,0 +1,270 @@
+/* =====================================================================================================================
+ *  File        : Sim_Flash.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Main flash (32 KB at 0x08000000, erased at reset) and its program / erase controller (FPEC)
+ * 					- KEYR sequence clears CR.LOCK, a wrong key keeps the FPEC locked until reset; CR ignores writes
+ * 					  while locked
+ * 					- PG: a half-word written to the flash array is programmed in SIM_FLASH_PROG_US (BSY), the new
+ * 					  value shows at the end; a location that is not erased takes only 0x0000, else PGERR
+ * 					- PER + STRT: page at AR erased in SIM_FLASH_ERASE_US
+ * 					- SR: EOP at the end of an operation, EOP / PGERR / WRPRTERR rc_w1
+ * 					- power loss (Sim_Flash_PowerLoss): the operation in flight is torn, a half-word keeps only its
+ * 					  low byte programmed, an erase leaves the upper half of the page; the FPEC then stays BSY and
+ * 					  the array keeps its contents until Sim_Flash_PowerOn
+ * 					- worn page (Sim_Flash_Worn): each erase leaves its first half-word at 0x0000
+ *  Notes       : The array is scanned for firmware writes only while CR.PG is set. Fetch stalls during BSY are not
+ * 				  modelled, the host image does not execute from this array.
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include <string.h>
+
+#include "Sim_Internal.h"
+
+#define SIM_FLASH_PROG_US				(52u)		// tPROG typical
+#define SIM_FLASH_ERASE_US				(20000u)	// tERASE typical
+#define SIM_FLASH_SR_FLAGS				(FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR)
+#define SIM_FLASH_CR_BITS				(FLASH_CR_PG | FLASH_CR_PER | FLASH_CR_MER | FLASH_CR_STRT | FLASH_CR_LOCK)
+#define SIM_FLASH_ARRAY					((uint8*)SIM_FLASH_BASE)
+
+typedef enum
+{
+	SIM_FLASH_OP_NONE	= 0,
+	SIM_FLASH_OP_PROGRAM,
+	SIM_FLASH_OP_ERASE
+} Sim_FlashOpType;
+
+static uint8			s_shadow[SIM_FLASH_SIZE];	// array as last published
+static uint32			s_pubCr;
+static uint32			s_pubSr;
+static uint8			s_keyStep;					// 1: KEY1 seen
+static boolean			s_keyLocked;				// wrong key
+static boolean			s_powered;
+static Sim_FlashOpType	s_op;
+static uint32			s_opAddr;					// offset in the array
+static uint16			s_opData;
+static uint64			s_opEnd;
+static uint32			s_cutCount;					// operations until the power loss, 0: none armed
+static boolean			s_cutArmed;					// the running operation is torn at s_cutAt
+static uint64			s_cutAt;
+static uint32			s_wornAddr;					// offset in the array, SIM_FLASH_SIZE: none
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static void prv_Publish(void)
+{
+	FLASH_R->CR		= s_pubCr;
+	FLASH_R->SR		= s_pubSr;
+	FLASH_R->KEYR	= 0u;
+}
+
+static uint16 prv_Get16(const uint8* Mem, uint32 Off)
+{
+	return (uint16)((uint16)Mem[Off] | ((uint16)Mem[Off + 1u] << 8));
+}
+
+static void prv_Put16(uint32 Off, uint16 Value)
+{
+	SIM_FLASH_ARRAY[Off]		= (uint8)Value;
+	SIM_FLASH_ARRAY[Off + 1u]	= (uint8)(Value >> 8);
+	s_shadow[Off]				= (uint8)Value;
+	s_shadow[Off + 1u]			= (uint8)(Value >> 8);
+}
+
+static void prv_Start(Sim_FlashOpType Op, uint32 Us)
+{
+	s_op		= Op;
+	s_opEnd		= Sim_Cycles + ((uint64)Us * SIM_CYC_PER_US);
+	s_pubSr		|= FLASH_SR_BSY;
+	s_cutArmed	= FALSE;
+
+	if((s_cutCount != 0u) && (--s_cutCount == 0u))
+	{
+		s_cutArmed	= TRUE;
+		s_cutAt		= Sim_Cycles + (((uint64)Us * SIM_CYC_PER_US) / 2u);
+	}
+}
+
+static void prv_Complete(void)
+{
+	if(s_op == SIM_FLASH_OP_PROGRAM)
+	{
+		prv_Put16(s_opAddr, s_opData);
+		Sim_Stats.FlashPrograms++;
+	} else {
+		memset(SIM_FLASH_ARRAY + s_opAddr, 0xFF, SIM_FLASH_PAGE_SIZE);
+		memset(s_shadow + s_opAddr, 0xFF, SIM_FLASH_PAGE_SIZE);
+		if(s_opAddr == s_wornAddr) prv_Put16(s_opAddr, 0x0000u);
+		Sim_Stats.FlashErases++;
+	}
+
+	s_op	= SIM_FLASH_OP_NONE;
+	s_pubSr	= (s_pubSr & ~FLASH_SR_BSY) | FLASH_SR_EOP;
+	s_pubCr	&= ~FLASH_CR_STRT;
+	prv_Publish();
+}
+
+// Tear the operation in flight, the FPEC stops answering
+static void prv_Cut(void)
+{
+	if(s_op == SIM_FLASH_OP_PROGRAM)
+	{
+		prv_Put16(s_opAddr, (uint16)(prv_Get16(s_shadow, s_opAddr) & (s_opData | 0xFF00u)));
+	} else if(s_op == SIM_FLASH_OP_ERASE) {
+		memset(SIM_FLASH_ARRAY + s_opAddr, 0xFF, SIM_FLASH_PAGE_SIZE / 2u);
+		memset(s_shadow + s_opAddr, 0xFF, SIM_FLASH_PAGE_SIZE / 2u);
+	}
+
+	s_op		= SIM_FLASH_OP_NONE;
+	s_cutArmed	= FALSE;
+	s_cutCount	= 0u;
+	s_powered	= FALSE;
+	s_pubSr		= FLASH_SR_BSY;
+	prv_Publish();
+	Sim_Stats.FlashPowerLoss++;
+}
+
+// Half-words the firmware wrote into the array since the last sync
+static void prv_ScanArray(void)
+{
+	uint32 off;
+
+	if(memcmp(SIM_FLASH_ARRAY, s_shadow, SIM_FLASH_SIZE) == 0) return;
+
+	for(off = 0u; off < SIM_FLASH_SIZE; off += 2u)
+	{
+		uint16 old = prv_Get16(s_shadow, off);
+		uint16 val = prv_Get16(SIM_FLASH_ARRAY, off);
+
+		if(old == val) continue;
+
+		// the cells change at the end of the operation
+		SIM_FLASH_ARRAY[off]		= s_shadow[off];
+		SIM_FLASH_ARRAY[off + 1u]	= s_shadow[off + 1u];
+
+		if(((s_pubCr & FLASH_CR_PG) == 0u) || (s_op != SIM_FLASH_OP_NONE)) continue;
+
+		if((old != 0xFFFFu) && (val != 0x0000u))
+		{
+			s_pubSr |= FLASH_SR_PGERR;
+			continue;
+		}
+
+		s_opAddr	= off;
+		s_opData	= val;
+		prv_Start(SIM_FLASH_OP_PROGRAM, SIM_FLASH_PROG_US);
+	}
+}
+
+/* ==============================
+ *       MODEL
+ * ============================== */
+void Sim_Flash_Reset(void)
+{
+	memset(SIM_FLASH_ARRAY, 0xFF, SIM_FLASH_SIZE);
+	memset(s_shadow, 0xFF, SIM_FLASH_SIZE);
+	s_cutCount	= 0u;
+	s_wornAddr	= SIM_FLASH_SIZE;
+	s_powered	= FALSE;
+	Sim_Flash_PowerOn();
+}
+
+void Sim_Flash_Sync(void)
+{
+	uint32 cr	= FLASH_R->CR;
+	uint32 sr	= FLASH_R->SR;
+	uint32 key	= FLASH_R->KEYR;
+
+	if(s_powered == FALSE)
+	{
+		// no supply: registers read as left, writes to the array are lost
+		if(memcmp(SIM_FLASH_ARRAY, s_shadow, SIM_FLASH_SIZE) != 0) memcpy(SIM_FLASH_ARRAY, s_shadow, SIM_FLASH_SIZE);
+		prv_Publish();
+		return;
+	}
+
+	// SR: rc_w1
+	if(sr != s_pubSr) s_pubSr &= ~(sr & SIM_FLASH_SR_FLAGS);
+
+	// CR: setting LOCK always works, the rest only while unlocked
+	if(cr != s_pubCr)
+	{
+		if((s_pubCr & FLASH_CR_LOCK) == 0u)
+		{
+			boolean strt = ((cr & FLASH_CR_STRT) && !(s_pubCr & FLASH_CR_STRT)) ? TRUE : FALSE;
+
+			s_pubCr = cr & SIM_FLASH_CR_BITS;
+			if((strt == TRUE) && (cr & FLASH_CR_PER) && (s_op == SIM_FLASH_OP_NONE))
+			{
+				uint32 addr = FLASH_R->AR;
+
+				if((addr >= SIM_FLASH_BASE) && (addr < (SIM_FLASH_BASE + SIM_FLASH_SIZE)))
+				{
+					s_opAddr = (addr - SIM_FLASH_BASE) & ~(SIM_FLASH_PAGE_SIZE - 1u);
+					prv_Start(SIM_FLASH_OP_ERASE, SIM_FLASH_ERASE_US);
+				} else {
+					s_pubCr &= ~FLASH_CR_STRT;
+				}
+			}
+		} else if(cr & FLASH_CR_LOCK) {
+			s_pubCr |= FLASH_CR_LOCK;
+		}
+	}
+
+	// KEYR: write only, reads 0
+	if(key != 0u)
+	{
+		if(s_keyLocked == FALSE)
+		{
+			if((s_keyStep == 0u) && (key == FLASH_KEY1))		s_keyStep = 1u;
+			else if((s_keyStep == 1u) && (key == FLASH_KEY2))	{ s_keyStep = 0u; s_pubCr &= ~FLASH_CR_LOCK; }
+			else												s_keyLocked = TRUE;
+		}
+	}
+
+	if(s_pubCr & FLASH_CR_PG) prv_ScanArray();
+	prv_Publish();
+}
+
+void Sim_Flash_Tick(void)
+{
+	if(s_op == SIM_FLASH_OP_NONE) return;
+
+	if((s_cutArmed == TRUE) && (Sim_Cycles >= s_cutAt))	prv_Cut();
+	else if(Sim_Cycles >= s_opEnd)						prv_Complete();
+}
+
+/* ==============================
+ *       STIMULI
+ * ============================== */
+void Sim_Flash_PowerLoss(uint32 AfterOps)
+{
+	if(s_powered == FALSE) return;
+
+	if(AfterOps == 0u)	prv_Cut();
+	else				s_cutCount = AfterOps;
+}
+
+void Sim_Flash_Worn(uint32 Address)
+{
+	s_wornAddr = SIM_FLASH_SIZE;
+	if((Address >= SIM_FLASH_BASE) && (Address < (SIM_FLASH_BASE + SIM_FLASH_SIZE)))
+	{
+		s_wornAddr = (Address - SIM_FLASH_BASE) & ~(SIM_FLASH_PAGE_SIZE - 1u);
+	}
+}
+
+void Sim_Flash_PowerOn(void)
+{
+	FLASH_R->AR		= 0u;
+	s_pubCr			= FLASH_CR_LOCK;
+	s_pubSr			= 0u;
+	s_keyStep		= 0u;
+	s_keyLocked		= FALSE;
+	s_op			= SIM_FLASH_OP_NONE;
+	s_cutArmed		= FALSE;
+	s_powered		= TRUE;
+	prv_Publish();
+}
@@ -0,0 +1,124 @@
+/* =====================================================================================================================
+ *  File        : Sim_Gpio.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : GPIOA..C model: BSRR/BRR applied to ODR, IDR from pin configuration
+ * 					- output push-pull / open-drain: ODR
+ * 					- alternate function output: timer OC level where mapped, idle high otherwise (USART/CAN TX)
+ * 					- input: external driver if set, pull from ODR, floating reads 0
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include "Sim_Internal.h"
+
+#define SIM_GPIO_PORTS					(3u)
+
+static GPIO_TypeDef* const s_ports[SIM_GPIO_PORTS] = { GPIOA, GPIOB, GPIOC };
+
+// External drivers per port (mask of driven pins, their level)
+static uint16 s_extMask[SIM_GPIO_PORTS];
+static uint16 s_extLevel[SIM_GPIO_PORTS];
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static uint32 prv_Cfg4(const GPIO_TypeDef* Regs, uint8 Pin)
+{
+	uint32 cr = (Pin < 8u) ? Regs->CRL : Regs->CRH;
+
+	return (cr >> ((Pin % 8u) * 4u)) & 0xFu;
+}
+
+// Remap-free alternate function outputs driven by a timer channel
+static uint8 prv_AfLevel(uint8 Port, uint8 Pin)
+{
+	if(Port == SIM_PORT_A)
+	{
+		if((Pin >= 1u) && (Pin <= 3u))	return Sim_Tim_OcLevel(1u, (uint8)(Pin + 1u));	// TIM2 CH2..4
+		if(Pin == 8u)					return Sim_Tim_OcLevel(0u, 1u);					// TIM1 CH1 (CH2..4 share USART1/CAN pins)
+		if((Pin == 6u) || (Pin == 7u))	return Sim_Tim_OcLevel(2u, (uint8)(Pin - 5u));	// TIM3 CH1..2
+	}
+	if((Port == SIM_PORT_B) && (Pin >= 6u) && (Pin <= 9u))
+	{
+		return Sim_Tim_OcLevel(3u, (uint8)(Pin - 5u));									// TIM4 CH1..4
+	}
+	return 1u;
+}
+
+/* ==============================
+ *       MODEL
+ * ============================== */
+void Sim_Gpio_Reset(void)
+{
+	uint8 p;
+
+	for(p = 0u; p < SIM_GPIO_PORTS; p++)
+	{
+		s_ports[p]->CRL	= 0x44444444u;		// floating inputs
+		s_ports[p]->CRH	= 0x44444444u;
+		s_extMask[p]	= 0u;
+		s_extLevel[p]	= 0u;
+	}
+
+	// idle lines: USART1 RX, CAN RX recessive
+	Sim_Gpio_SetInput(SIM_PORT_A, 10u, 1u);
+	Sim_Gpio_SetInput(SIM_PORT_A, 11u, 1u);
+}
+
+void Sim_Gpio_Sync(void)
+{
+	uint8 p;
+
+	for(p = 0u; p < SIM_GPIO_PORTS; p++)
+	{
+		GPIO_TypeDef* r = s_ports[p];
+		uint32 bsrr = r->BSRR;
+		uint32 brr	= r->BRR;
+
+		// write only registers, reset wins over nothing, set wins over reset inside BSRR
+		if(brr != 0u)	{ r->ODR &= ~(brr & 0xFFFFu); r->BRR = 0u; }
+		if(bsrr != 0u)	{ r->ODR = (r->ODR & ~(bsrr >> 16)) | (bsrr & 0xFFFFu); r->BSRR = 0u; }
+	}
+}
+
+void Sim_Gpio_Tick(void)
+{
+	uint8 p;
+	uint8 pin;
+
+	for(p = 0u; p < SIM_GPIO_PORTS; p++)
+	{
+		uint32 idr = 0u;
+
+		for(pin = 0u; pin < 16u; pin++)
+		{
+			idr |= (uint32)Sim_Gpio_Pin(p, pin) << pin;
+		}
+		s_ports[p]->IDR = idr;
+	}
+}
+
+uint8 Sim_Gpio_Pin(uint8 Port, uint8 Pin)
+{
+	const GPIO_TypeDef* r = s_ports[Port];
+	uint32 cfg	= prv_Cfg4(r, Pin);
+	uint32 mode	= cfg & 3u;
+	uint32 cnf	= cfg >> 2;
+
+	if(mode != 0u)
+	{
+		return (cnf & 2u) ? prv_AfLevel(Port, Pin) : (uint8)((r->ODR >> Pin) & 1u);
+	}
+
+	if(s_extMask[Port] & (1u << Pin))	return (uint8)((s_extLevel[Port] >> Pin) & 1u);
+	if(cnf == 2u)						return (uint8)((r->ODR >> Pin) & 1u);		// pull-up / pull-down
+	return 0u;
+}
+
+void Sim_Gpio_SetInput(uint8 Port, uint8 Pin, uint8 Level)
+{
+	s_extMask[Port] |= (uint16)(1u << Pin);
+
+	if(Level != 0u)	s_extLevel[Port] |= (uint16)(1u << Pin);
+	else			s_extLevel[Port] &= (uint16)~(1u << Pin);
+}
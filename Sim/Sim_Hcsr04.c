@@ -0,0 +1,82 @@
+/* =====================================================================================================================
+ *  File        : Sim_Hcsr04.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : HC-SR04 model on PA1 (TRIG) / PA0 (ECHO)
+ * 					- falling edge of a trigger pulse >= 10 us starts a burst (re-triggers while busy are ignored)
+ * 					- echo rises SIM_HCSR04_BURST_US later and stays high for the configured round trip
+ * 					- works for the TIM2 CH2 hardware trigger and for the Dio trigger alike (reads the pin)
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include "Sim_Internal.h"
+
+#define SIM_HCSR04_TRIG_PORT			SIM_PORT_A
+#define SIM_HCSR04_TRIG_PIN				(1u)
+#define SIM_HCSR04_ECHO_PORT			SIM_PORT_A
+#define SIM_HCSR04_ECHO_PIN				(0u)
+
+#define SIM_HCSR04_TRIG_MIN_US			(10u)
+#define SIM_HCSR04_BURST_US				(460u)		// 8 x 40 kHz burst + module latency
+#define SIM_HCSR04_NO_OBJECT_US			(38000u)
+
+static uint8	s_mode		= SIM_ECHO_OFF;
+static uint32	s_echoUs	= 0u;
+static uint8	s_trigLast	= 0u;
+static uint64	s_trigRise	= 0u;
+static boolean	s_busy		= FALSE;
+static uint64	s_echoRise	= 0u;
+static uint64	s_echoFall	= 0u;
+
+void Sim_Hcsr04_Reset(void)
+{
+	s_mode		= SIM_ECHO_OFF;
+	s_echoUs	= 0u;
+	s_trigLast	= 0u;
+	s_busy		= FALSE;
+	Sim_Gpio_SetInput(SIM_HCSR04_ECHO_PORT, SIM_HCSR04_ECHO_PIN, 0u);
+}
+
+void Sim_Hcsr04_Tick(void)
+{
+	uint64 now	= Sim_NowUs();
+	uint8 trig	= Sim_Gpio_Pin(SIM_HCSR04_TRIG_PORT, SIM_HCSR04_TRIG_PIN);
+	uint8 echo	= 0u;
+
+	if((trig != 0u) && (s_trigLast == 0u))
+	{
+		s_trigRise = now;
+	}
+
+	if((trig == 0u) && (s_trigLast != 0u))
+	{
+		if((now - s_trigRise) < SIM_HCSR04_TRIG_MIN_US)
+		{
+			Sim_Stats.EchoShortTriggers++;
+		} else if(s_busy == FALSE) {
+			Sim_Stats.EchoTriggers++;
+
+			if(s_mode != SIM_ECHO_OFF)
+			{
+				s_busy		= TRUE;
+				s_echoRise	= now + SIM_HCSR04_BURST_US;
+				s_echoFall	= s_echoRise + ((s_mode == SIM_ECHO_PULSE) ? s_echoUs : SIM_HCSR04_NO_OBJECT_US);
+			}
+		}
+	}
+	s_trigLast = trig;
+
+	if(s_busy == TRUE)
+	{
+		if(now >= s_echoFall)		s_busy	= FALSE;
+		else if(now >= s_echoRise)	echo	= 1u;
+	}
+
+	Sim_Gpio_SetInput(SIM_HCSR04_ECHO_PORT, SIM_HCSR04_ECHO_PIN, echo);
+}
+
+void Sim_Echo_Set(uint8 Mode, uint32 EchoUs)
+{
+	s_mode		= Mode;
+	s_echoUs	= EchoUs;
+}
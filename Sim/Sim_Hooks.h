@@ -0,0 +1,29 @@
+/* =====================================================================================================================
+ *  File        : Sim_Hooks.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Register access seam, pulled in by stm32f103xx_regs.h when SIM_HOST is defined
+ *  Depends     :
+ * ===================================================================================================================*/
+
+#ifndef SIM_SIM_HOOKS_H_
+#define SIM_SIM_HOOKS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Busy wait: advance the virtual clock by one poll step (may run ISRs)
+void Sim_Poll(void);
+
+// Let the models see register writes now (no time passes, no ISR)
+void Sim_Sync(void);
+
+#define REG_POLL()						Sim_Poll()
+#define REG_SYNC()						Sim_Sync()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_SIM_HOOKS_H_ */
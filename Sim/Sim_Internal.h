@@ -0,0 +1,106 @@
+/* =====================================================================================================================
+ *  File        : Sim_Internal.h
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Interface between the core scheduler (Sim.c) and the peripheral models
+ *  Notes       : Every model has Reset / Sync / Tick:
+ * 					- Sync: compare registers with the value last published, a difference is a firmware write
+ * 					        (w1c / w0c / sentinel registers rely on this)
+ * 					- Tick: one microsecond of hardware time
+ * 				  IsrEntry / IsrExit model read side effects an ISR has on its flags (DR / CCRx reads)
+ *  Depends     : Sim.h, stm32f103xx_regs.h
+ * ===================================================================================================================*/
+
+#ifndef SIM_SIM_INTERNAL_H_
+#define SIM_SIM_INTERNAL_H_
+
+#include "Sim.h"
+#include "stm32f103xx_regs.h"
+
+/* ==============================
+ *       CORE (Sim.c)
+ * ============================== */
+extern uint64			Sim_Cycles;				// virtual time in core clock cycles
+extern Sim_StatsType	Sim_Stats;
+
+void Sim_Stop(Sim_StopType Reason);
+void Sim_EmitUart(uint8 Uart, uint8 Byte);
+void Sim_EmitCan(const Sim_CanFrameType* Frame);
+
+/* ==============================
+ *       GPIO (Sim_Gpio.c)
+ * ============================== */
+#define SIM_PORT_A						(0u)
+#define SIM_PORT_B						(1u)
+#define SIM_PORT_C						(2u)
+
+void	Sim_Gpio_Reset(void);
+void	Sim_Gpio_Sync(void);
+void	Sim_Gpio_Tick(void);
+uint8	Sim_Gpio_Pin(uint8 Port, uint8 Pin);							// level on the pin now
+void	Sim_Gpio_SetInput(uint8 Port, uint8 Pin, uint8 Level);		// external driver
+
+/* ==============================
+ *       TIMERS (Sim_Tim.c)
+ * ============================== */
+#define SIM_TIM_COUNT					(4u)		// TIM1..TIM4
+
+void	Sim_Tim_Reset(void);
+void	Sim_Tim_Sync(void);
+void	Sim_Tim_Tick(void);
+uint8	Sim_Tim_OcLevel(uint8 Tim, uint8 Ch);						// Tim 0 = TIM1, Ch 1..4
+boolean	Sim_Tim_IrqPending(uint8 Tim);
+void	Sim_Tim_IsrEntry(uint8 Tim);
+void	Sim_Tim_IsrExit(uint8 Tim);
+
+/* ==============================
+ *       HC-SR04 (Sim_Hcsr04.c)
+ * ============================== */
+void	Sim_Hcsr04_Reset(void);
+void	Sim_Hcsr04_Tick(void);
+
+/* ==============================
+ *       USART (Sim_Usart.c)
+ * ============================== */
+void	Sim_Usart_Reset(void);
+void	Sim_Usart_Sync(void);
+void	Sim_Usart_Tick(void);
+boolean	Sim_Usart_IrqPending(uint8 Uart);
+void	Sim_Usart_IsrEntry(uint8 Uart);
+void	Sim_Usart_IsrExit(uint8 Uart);
+
+/* ==============================
+ *       bxCAN (Sim_Can.c)
+ * ============================== */
+#define SIM_CAN_IRQ_TX					(0u)
+#define SIM_CAN_IRQ_RX0					(1u)
+#define SIM_CAN_IRQ_RX1					(2u)
+#define SIM_CAN_IRQ_SCE					(3u)
+
+void	Sim_Can_Reset(void);
+void	Sim_Can_Sync(void);
+void	Sim_Can_Tick(void);
+boolean	Sim_Can_IrqPending(uint8 Line);
+
+/* ==============================
+ *       ADC (Sim_Adc.c)
+ * ============================== */
+void	Sim_Adc_Reset(void);
+void	Sim_Adc_Sync(void);
+void	Sim_Adc_Tick(void);
+boolean	Sim_Adc_IrqPending(void);
+void	Sim_Adc_IsrEntry(void);
+void	Sim_Adc_IsrExit(void);
+
+/* ==============================
+ *       FLASH (Sim_Flash.c)
+ * ============================== */
+#define SIM_FLASH_BASE					(0x08000000u)
+#define SIM_FLASH_SIZE					(0x8000u)	// C6T6: 32 KB
+#define SIM_FLASH_PAGE_SIZE				(0x400u)
+
+void	Sim_Flash_Reset(void);
+void	Sim_Flash_Sync(void);
+void	Sim_Flash_Tick(void);
+
+#endif /* SIM_SIM_INTERNAL_H_ */
@@ -0,0 +1,744 @@
+/* =====================================================================================================================
+ *  File        : Sim_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Host entry point (replaces main.c): EcuM_Init, then SystemApp_MainFunction on the virtual clock
+ * 				  driven by a scenario file
+ *  Usage       : sim_ecu [-q] [-u <file>] <scenario>
+ * 					-q			no event log on stderr
+ * 					-u <file>	USART1 output to file (default stdout)
+ *  Scenario    : one command per line, '#' starts a comment, times in ms (fractions allowed)
+ * 					duration <ms>					virtual run time (default 1000)
+ * 					loop_us <us>					virtual time of one SystemApp_MainFunction call (default 20)
+ * 					power_on <ms>					EcuM_Init at this time, events before it set up the environment (default 0)
+ * 					poll_us <us>					virtual time of one REG_POLL (default 1)
+ * 					isr_cost <irqn> <us>			CPU time of one ISR call (default 0, -1: SysTick)
+ * 					task <entry> <period_ms>		call a BSW entry point periodically
+ * 					at <ms> echo <mm>				HC-SR04 round trip for <mm> (343.2 m/s)
+ * 					at <ms> echo_us <us>
+ * 					at <ms> echo none|off			no object (38 ms pulse) / sensor unplugged
+ * 					at <ms> uart <n> "<text>"		bytes on USARTn RX (\r \n \t \\ \" \xHH)
+ * 					at <ms> can <id> [b0 .. b7]		frame from the bus (canx: 29 bit id)
+ * 					at <ms> canfault tx on|off		every transmission ends in a bit error (TEC + 8, bus-off above 255)
+ * 					at <ms> canfault rx <n>			n receive errors (REC + n)
+ * 					at <ms> canfault init on|off	INAK stops following INRQ
+ * 					at <ms> canfault bus on|off		requests wait in their mailbox (bus held by a higher priority node)
+ * 					at <ms> flashfault powerloss <n>	supply lost in the middle of the n-th flash operation from now (0: now)
+ * 					at <ms> flashfault worn <addr>|off	erasing the page at addr leaves a programmed half-word
+ * 					at <ms> adc <ch> <raw>
+ * 					at <ms> call <entry>
+ * 					at <ms> expect uart <n> "<text>"	USARTn output since the last match contains text
+ * 					at <ms> expect can <id> [b0 .. b7]	a frame with id (and exactly these data bytes) was sent since the last match
+ * 					at <ms> expect nocan <id>			no frame with id was sent since the last match
+ * 					at <ms> expect period <id> <min> <max>	at least two frames with id since the last match, each
+ * 														<min> .. <max> ms after the one before (a match up to now)
+ * 					at <ms> expect latency <irqn> <us>	worst latency of the line so far <= us
+ * 				  Entry points (not reached from main.c yet): rte_sensor, rte_motor, rte_ambient, nvm_boot,
+ * 				  log_burst, com_reject
+ *  Exit        : 0 ok, 1 expectation failed, 2 scenario error, 3 firmware stopped (reset, watchdog, IRQ fault)
+ *  Depends     : Sim.h, EcuM.h, SystemApp.h, Mcu.h, Rte.h,
+ * 				  Fls.h, NvM.h, Dem.h, ObstacleDetection.h, Logger.h, Com.h
+ * ===================================================================================================================*/
+
+#define _GNU_SOURCE						// memmem
+
+#include <ctype.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Sim.h"
+#include "EcuM.h"
+#include "SystemApp.h"
+#include "Mcu.h"
+#include "Rte.h"
+#include "Fls.h"
+#include "NvM.h"
+#include "Dem.h"
+#include "ObstacleDetection.h"
+#include "Logger.h"
+#include "Com.h"
+
+/* ==============================
+ *       CONSTANTS
+ * ============================== */
+#define SIM_MAIN_MAX_TOKENS				(13u)		// at <ms> expect can <id> + 8 data bytes
+#define SIM_MAIN_MAX_TASKS				(12u)
+#define SIM_MAIN_MAX_TEXT				(256u)
+#define SIM_MAIN_MAX_CAN_LOG			(256u)
+
+#define SIM_MAIN_SOS_MMS				(343200u)	// 20 degC dry air
+#define SIM_MAIN_LOG_BURST				(100u)		// lines of log_burst
+
+typedef enum
+{
+	SIM_EV_ECHO,
+	SIM_EV_UART,
+	SIM_EV_CAN,
+	SIM_EV_CANFAULT,
+	SIM_EV_FLASHFAULT,
+	SIM_EV_ADC,
+	SIM_EV_CALL,
+	SIM_EV_EXPECT_UART,
+	SIM_EV_EXPECT_CAN,
+	SIM_EV_EXPECT_NOCAN,
+	SIM_EV_EXPECT_PERIOD,
+	SIM_EV_EXPECT_LATENCY
+} Sim_EventKindType;
+
+typedef struct
+{
+	const char*	Name;
+	void		(*Fn)(void);
+} Sim_EntryType;
+
+typedef struct
+{
+	uint64					AtUs;
+	uint32					Line;
+	Sim_EventKindType		Kind;
+	uint32					A;
+	uint32					B;
+	uint32					C;
+	Sim_CanFrameType		Can;
+	uint8					Text[SIM_MAIN_MAX_TEXT];
+	uint32					Len;
+	const Sim_EntryType*	Entry;
+} Sim_EventType;
+
+typedef struct
+{
+	const Sim_EntryType*	Entry;
+	uint64					PeriodUs;
+	uint64					NextUs;
+} Sim_TaskType;
+
+typedef struct
+{
+	uint8*	Data;
+	uint32	Len;
+	uint32	Cap;
+	uint32	Cursor;								// expect searches from here
+} Sim_CaptureType;
+
+/* ==============================
+ *       BSW ENTRY POINTS
+ * ============================== */
+// Ambient conditions have no producer yet: 21.5 degC, 40 %RH
+static void prv_RteAmbient(void)
+{
+	(void)Rte_Write_AmbientTemperature((Rte_TemperatureType)215);
+	(void)Rte_Write_AmbientHumidity((Rte_HumidityType)40u);
+}
+
+// Power back after a flash power loss: the storage stack and its users start again on what the array kept
+static void prv_NvmBoot(void)
+{
+	Sim_Flash_PowerOn();
+	Fls_Init();
+	NvM_Init(&NvM_Config);
+	Dem_Init(&Dem_Config);
+	ObstacleDetection_Init();
+}
+
+// A burst of log lines from one call site, more than the Logger queue holds
+static void prv_LogBurst(void)
+{
+	uint32 i;
+
+	for(i = 0u; i < SIM_MAIN_LOG_BURST; i++)
+	{
+		(void)Logger_Logf(LOG_LEVEL_INFO, LOG_TAG_SYSTEM, "burst %u of %u", (unsigned)i, (unsigned)SIM_MAIN_LOG_BURST);
+	}
+}
+
+// Com after a configuration its init rejected: uninitialised, every send is refused
+static void prv_ComReject(void)
+{
+	Com_Init(NULL_PTR);
+}
+
+static const Sim_EntryType s_entries[] =
+{
+	{ "rte_sensor",		Rte_Runnable_Sensor			},
+	{ "rte_motor",		Rte_Runnable_MotorControl	},
+	{ "rte_ambient",	prv_RteAmbient				},
+	{ "nvm_boot",		prv_NvmBoot					},
+	{ "log_burst",		prv_LogBurst				},
+	{ "com_reject",		prv_ComReject				},
+};
+
+#define SIM_MAIN_ENTRY_COUNT			(sizeof(s_entries) / sizeof(s_entries[0]))
+
+/* ==============================
+ *            STATE
+ * ============================== */
+static uint64			s_durationUs	= 1000000u;
+static uint32			s_loopUs		= 20u;
+static uint64			s_powerOnUs		= 0u;
+static Sim_EventType*	s_events		= NULL_PTR;
+static uint32			s_eventCount	= 0u;
+static Sim_TaskType		s_tasks[SIM_MAIN_MAX_TASKS];
+static uint32			s_taskCount		= 0u;
+
+static boolean			s_quiet			= FALSE;
+static FILE*			s_uartOut		= NULL_PTR;
+static Sim_CaptureType	s_uartCap[SIM_UART_COUNT];
+static Sim_CanFrameType	s_canLog[SIM_MAIN_MAX_CAN_LOG];
+static uint64			s_canLogUs[SIM_MAIN_MAX_CAN_LOG];
+static uint32			s_canLogLen		= 0u;
+static uint32			s_canCursor		= 0u;
+
+static uint32			s_expectPass	= 0u;
+static uint32			s_expectFail	= 0u;
+static uint32			s_loops			= 0u;
+
+static jmp_buf			s_stopJmp;
+static Sim_StopType		s_stopReason;
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static void prv_Log(const char* Fmt, const char* Msg)
+{
+	if(s_quiet == TRUE) return;
+	fprintf(stderr, "[%10.3f ms] ", (double)Sim_NowUs() / 1000.0);
+	fprintf(stderr, Fmt, Msg);
+	fputc('\n', stderr);
+}
+
+static const Sim_EntryType* prv_FindEntry(const char* Name)
+{
+	uint32 i;
+
+	for(i = 0u; i < SIM_MAIN_ENTRY_COUNT; i++)
+	{
+		if(strcmp(s_entries[i].Name, Name) == 0) return &s_entries[i];
+	}
+	return NULL_PTR;
+}
+
+// Split a line into tokens, "..." with C escapes becomes one token (Lens keeps embedded NULs)
+static uint32 prv_Tokenize(char* Line, char** Tok, uint32* Lens)
+{
+	uint32 n = 0u;
+	char* p = Line;
+
+	while((*p != '\0') && (n < SIM_MAIN_MAX_TOKENS))
+	{
+		while(isspace((unsigned char)*p)) p++;
+		if((*p == '\0') || (*p == '#')) break;
+
+		if(*p == '"')
+		{
+			char* w = ++p;
+			Tok[n] = w;
+
+			while((*p != '\0') && (*p != '"'))
+			{
+				if((*p == '\\') && (p[1] != '\0'))
+				{
+					p++;
+					switch(*p)
+					{
+					case 'r':	*w++ = '\r';	p++;	break;
+					case 'n':	*w++ = '\n';	p++;	break;
+					case 't':	*w++ = '\t';	p++;	break;
+					case 'x':	*w++ = (char)strtoul(p + 1, &p, 16);	break;
+					default:	*w++ = *p++;	break;
+					}
+				} else {
+					*w++ = *p++;
+				}
+			}
+			Lens[n] = (uint32)(w - Tok[n]);
+			if(*p == '"') p++;
+			*w = '\0';
+		} else {
+			Tok[n] = p;
+			while((*p != '\0') && !isspace((unsigned char)*p)) p++;
+			Lens[n] = (uint32)(p - Tok[n]);
+			if(*p != '\0') *p++ = '\0';
+		}
+		n++;
+	}
+	return n;
+}
+
+static boolean prv_ParseEvent(Sim_EventType* Ev, char** Tok, const uint32* Lens, uint32 N)
+{
+	const char* cmd = Tok[2];
+	uint32 i;
+
+	if(strcmp(cmd, "echo") == 0 && N == 4u)
+	{
+		Ev->Kind = SIM_EV_ECHO;
+		if(strcmp(Tok[3], "none") == 0)		{ Ev->A = SIM_ECHO_NO_OBJECT;	Ev->B = 0u; }
+		else if(strcmp(Tok[3], "off") == 0)	{ Ev->A = SIM_ECHO_OFF;			Ev->B = 0u; }
+		else
+		{
+			uint64 mm	= strtoul(Tok[3], NULL, 0);
+			Ev->A		= SIM_ECHO_PULSE;
+			Ev->B		= (uint32)(((mm * 2000000u) + (SIM_MAIN_SOS_MMS / 2u)) / SIM_MAIN_SOS_MMS);
+		}
+		return TRUE;
+	}
+	if(strcmp(cmd, "echo_us") == 0 && N == 4u)
+	{
+		Ev->Kind	= SIM_EV_ECHO;
+		Ev->A		= SIM_ECHO_PULSE;
+		Ev->B		= (uint32)strtoul(Tok[3], NULL, 0);
+		return TRUE;
+	}
+	if(strcmp(cmd, "uart") == 0 && N == 5u)
+	{
+		Ev->Kind	= SIM_EV_UART;
+		Ev->A		= (uint32)strtoul(Tok[3], NULL, 0) - 1u;
+		Ev->Len		= (Lens[4] < SIM_MAIN_MAX_TEXT) ? Lens[4] : SIM_MAIN_MAX_TEXT;
+		memcpy(Ev->Text, Tok[4], Ev->Len);
+		return (Ev->A < SIM_UART_COUNT) ? TRUE : FALSE;
+	}
+	if(((strcmp(cmd, "can") == 0) || (strcmp(cmd, "canx") == 0)) && (N >= 4u) && (N <= 12u))
+	{
+		Ev->Kind		= SIM_EV_CAN;
+		Ev->Can.Ide		= (cmd[3] == 'x') ? TRUE : FALSE;
+		Ev->Can.Id		= (uint32)strtoul(Tok[3], NULL, 0);
+		Ev->Can.Dlc		= (uint8)(N - 4u);
+		for(i = 4u; i < N; i++) Ev->Can.Data[i - 4u] = (uint8)strtoul(Tok[i], NULL, 16);
+		return TRUE;
+	}
+	if(strcmp(cmd, "canfault") == 0 && N == 5u)
+	{
+		Ev->Kind	= SIM_EV_CANFAULT;
+		Ev->B		= (strcmp(Tok[4], "on") == 0) ? 1u : (uint32)strtoul(Tok[4], NULL, 0);
+		if(strcmp(Tok[3], "tx") == 0)			Ev->A = SIM_CAN_FAULT_TX;
+		else if(strcmp(Tok[3], "rx") == 0)		Ev->A = SIM_CAN_FAULT_RX;
+		else if(strcmp(Tok[3], "init") == 0)	Ev->A = SIM_CAN_FAULT_INIT;
+		else if(strcmp(Tok[3], "bus") == 0)		Ev->A = SIM_CAN_FAULT_BUS;
+		else									return FALSE;
+		return TRUE;
+	}
+	if(strcmp(cmd, "flashfault") == 0 && N == 5u && (strcmp(Tok[3], "powerloss") == 0 || strcmp(Tok[3], "worn") == 0))
+	{
+		// A: 1 worn page ("off" parses as 0: none)
+		Ev->Kind	= SIM_EV_FLASHFAULT;
+		Ev->A		= (strcmp(Tok[3], "worn") == 0) ? 1u : 0u;
+		Ev->B		= (uint32)strtoul(Tok[4], NULL, 0);
+		return TRUE;
+	}
+	if(strcmp(cmd, "adc") == 0 && N == 5u)
+	{
+		Ev->Kind	= SIM_EV_ADC;
+		Ev->A		= (uint32)strtoul(Tok[3], NULL, 0);
+		Ev->B		= (uint32)strtoul(Tok[4], NULL, 0);
+		return (Ev->A < SIM_ADC_CHANNELS) ? TRUE : FALSE;
+	}
+	if(strcmp(cmd, "call") == 0 && N == 4u)
+	{
+		Ev->Kind	= SIM_EV_CALL;
+		Ev->Entry	= prv_FindEntry(Tok[3]);
+		return (Ev->Entry != NULL_PTR) ? TRUE : FALSE;
+	}
+	if(strcmp(cmd, "expect") == 0 && N == 6u && strcmp(Tok[3], "uart") == 0)
+	{
+		Ev->Kind	= SIM_EV_EXPECT_UART;
+		Ev->A		= (uint32)strtoul(Tok[4], NULL, 0) - 1u;
+		Ev->Len		= (Lens[5] < SIM_MAIN_MAX_TEXT) ? Lens[5] : SIM_MAIN_MAX_TEXT;
+		memcpy(Ev->Text, Tok[5], Ev->Len);
+		return (Ev->A < SIM_UART_COUNT) ? TRUE : FALSE;
+	}
+	if(strcmp(cmd, "expect") == 0 && N == 5u && strcmp(Tok[3], "nocan") == 0)
+	{
+		Ev->Kind	= SIM_EV_EXPECT_NOCAN;
+		Ev->A		= (uint32)strtoul(Tok[4], NULL, 0);
+		return TRUE;
+	}
+	if(strcmp(cmd, "expect") == 0 && N == 7u && strcmp(Tok[3], "period") == 0)
+	{
+		Ev->Kind	= SIM_EV_EXPECT_PERIOD;
+		Ev->A		= (uint32)strtoul(Tok[4], NULL, 0);
+		Ev->B		= (uint32)(strtod(Tok[5], NULL) * 1000.0);
+		Ev->C		= (uint32)(strtod(Tok[6], NULL) * 1000.0);
+		return (Ev->B <= Ev->C) ? TRUE : FALSE;
+	}
+	if(strcmp(cmd, "expect") == 0 && (N >= 5u) && (N <= 13u) && strcmp(Tok[3], "can") == 0)
+	{
+		// B: data given, DLC and bytes must match too
+		Ev->Kind	= SIM_EV_EXPECT_CAN;
+		Ev->A		= (uint32)strtoul(Tok[4], NULL, 0);
+		Ev->B		= (N > 5u) ? 1u : 0u;
+		Ev->Can.Dlc	= (uint8)(N - 5u);
+		for(i = 5u; i < N; i++) Ev->Can.Data[i - 5u] = (uint8)strtoul(Tok[i], NULL, 16);
+		return TRUE;
+	}
+	if(strcmp(cmd, "expect") == 0 && N == 6u && strcmp(Tok[3], "latency") == 0)
+	{
+		Ev->Kind	= SIM_EV_EXPECT_LATENCY;
+		Ev->A		= (uint32)strtoul(Tok[4], NULL, 0);
+		Ev->B		= (uint32)strtoul(Tok[5], NULL, 0);
+		return (Ev->A < 64u) ? TRUE : FALSE;
+	}
+	return FALSE;
+}
+
+static int prv_EventCmp(const void* a, const void* b)
+{
+	const Sim_EventType* x = (const Sim_EventType*)a;
+	const Sim_EventType* y = (const Sim_EventType*)b;
+
+	if(x->AtUs != y->AtUs) return (x->AtUs < y->AtUs) ? -1 : 1;
+	return (x->Line < y->Line) ? -1 : 1;
+}
+
+static boolean prv_LoadScenario(const char* Path)
+{
+	char line[512];
+	char* tok[SIM_MAIN_MAX_TOKENS];
+	uint32 lens[SIM_MAIN_MAX_TOKENS];
+	uint32 lineNo = 0u;
+	FILE* f = fopen(Path, "r");
+
+	if(f == NULL_PTR)
+	{
+		fprintf(stderr, "sim: cannot open %s\n", Path);
+		return FALSE;
+	}
+
+	while(fgets(line, sizeof(line), f) != NULL_PTR)
+	{
+		uint32 n;
+		boolean ok = FALSE;
+
+		lineNo++;
+		n = prv_Tokenize(line, tok, lens);
+		if(n == 0u) continue;
+
+		if((strcmp(tok[0], "duration") == 0) && (n == 2u))
+		{
+			s_durationUs	= (uint64)(strtod(tok[1], NULL) * 1000.0);
+			ok				= TRUE;
+		} else if((strcmp(tok[0], "power_on") == 0) && (n == 2u)) {
+			s_powerOnUs		= (uint64)(strtod(tok[1], NULL) * 1000.0);
+			ok				= TRUE;
+		} else if((strcmp(tok[0], "loop_us") == 0) && (n == 2u)) {
+			s_loopUs		= (uint32)strtoul(tok[1], NULL, 0);
+			ok				= (s_loopUs > 0u) ? TRUE : FALSE;
+		} else if((strcmp(tok[0], "poll_us") == 0) && (n == 2u)) {
+			Sim_SetPollCost((uint32)strtoul(tok[1], NULL, 0));
+			ok				= TRUE;
+		} else if((strcmp(tok[0], "isr_cost") == 0) && (n == 3u)) {
+			ok				= (Sim_SetIsrCost((sint8)strtol(tok[1], NULL, 0), (uint32)strtoul(tok[2], NULL, 0)) == E_OK) ? TRUE : FALSE;
+		} else if((strcmp(tok[0], "task") == 0) && (n == 3u) && (s_taskCount < SIM_MAIN_MAX_TASKS)) {
+			Sim_TaskType* t	= &s_tasks[s_taskCount];
+			t->Entry		= prv_FindEntry(tok[1]);
+			t->PeriodUs		= (uint64)(strtod(tok[2], NULL) * 1000.0);
+			t->NextUs		= 0u;
+			ok				= ((t->Entry != NULL_PTR) && (t->PeriodUs > 0u)) ? TRUE : FALSE;
+			if(ok == TRUE) s_taskCount++;
+		} else if((strcmp(tok[0], "at") == 0) && (n >= 3u)) {
+			Sim_EventType* ev = realloc(s_events, (s_eventCount + 1u) * sizeof(Sim_EventType));
+			if(ev == NULL_PTR) break;
+			s_events = ev;
+			ev = &s_events[s_eventCount];
+			memset(ev, 0, sizeof(*ev));
+			ev->AtUs	= (uint64)(strtod(tok[1], NULL) * 1000.0);
+			ev->Line	= lineNo;
+			ok			= prv_ParseEvent(ev, tok, lens, n);
+			if(ok == TRUE) s_eventCount++;
+		}
+
+		if(ok == FALSE)
+		{
+			fprintf(stderr, "sim: %s:%u: cannot parse\n", Path, (unsigned)lineNo);
+			fclose(f);
+			return FALSE;
+		}
+	}
+
+	fclose(f);
+	qsort(s_events, s_eventCount, sizeof(Sim_EventType), prv_EventCmp);
+	return TRUE;
+}
+
+static void prv_Expect(const Sim_EventType* Ev)
+{
+	char msg[SIM_MAIN_MAX_TEXT + 32];
+	boolean hit = FALSE;
+
+	if(Ev->Kind == SIM_EV_EXPECT_UART)
+	{
+		Sim_CaptureType* c = &s_uartCap[Ev->A];
+		uint8* p = (c->Len > c->Cursor) ? memmem(c->Data + c->Cursor, c->Len - c->Cursor, Ev->Text, Ev->Len) : NULL_PTR;
+
+		if(p != NULL_PTR)
+		{
+			hit			= TRUE;
+			c->Cursor	= (uint32)(p - c->Data) + Ev->Len;
+		}
+		snprintf(msg, sizeof(msg), "uart%u \"%.*s\"", (unsigned)(Ev->A + 1u), (int)Ev->Len, (const char*)Ev->Text);
+	} else if(Ev->Kind == SIM_EV_EXPECT_LATENCY) {
+		uint32 worst = Sim_GetStats()->IrqLatencyMaxUs[Ev->A];
+
+		hit = (worst <= Ev->B) ? TRUE : FALSE;
+		snprintf(msg, sizeof(msg), "IRQ %u latency %u us <= %u us", (unsigned)Ev->A, (unsigned)worst, (unsigned)Ev->B);
+	} else if(Ev->Kind == SIM_EV_EXPECT_NOCAN) {
+		uint32 i;
+
+		hit = TRUE;
+		for(i = s_canCursor; i < s_canLogLen; i++)
+		{
+			if(s_canLog[i].Id == Ev->A) hit = FALSE;
+		}
+		snprintf(msg, sizeof(msg), "no can 0x%X", (unsigned)Ev->A);
+	} else if(Ev->Kind == SIM_EV_EXPECT_PERIOD) {
+		uint64 lo		= 0xFFFFFFFFFFFFFFFFull;
+		uint64 hi		= 0u;
+		uint64 last		= 0u;
+		uint32 frames	= 0u;
+		uint32 i;
+
+		for(i = s_canCursor; i < s_canLogLen; i++)
+		{
+			if(s_canLog[i].Id != Ev->A) continue;
+			if(frames != 0u)
+			{
+				uint64 gap = s_canLogUs[i] - last;
+
+				if(gap < lo) lo = gap;
+				if(gap > hi) hi = gap;
+			}
+			last = s_canLogUs[i];
+			frames++;
+		}
+		hit = ((frames >= 2u) && (lo >= Ev->B) && (hi <= Ev->C)) ? TRUE : FALSE;
+		if(hit == TRUE) s_canCursor = s_canLogLen;
+		if(frames >= 2u)
+		{
+			snprintf(msg, sizeof(msg), "can 0x%X period %.3f .. %.3f ms in %.3f .. %.3f ms", (unsigned)Ev->A,
+					(double)lo / 1000.0, (double)hi / 1000.0, (double)Ev->B / 1000.0, (double)Ev->C / 1000.0);
+		} else {
+			snprintf(msg, sizeof(msg), "can 0x%X period: %u frames", (unsigned)Ev->A, (unsigned)frames);
+		}
+	} else {
+		uint32 i;
+
+		int n;
+
+		for(i = s_canCursor; (i < s_canLogLen) && (hit == FALSE); i++)
+		{
+			const Sim_CanFrameType* fr = &s_canLog[i];
+
+			if(fr->Id != Ev->A) continue;
+			if((Ev->B != 0u) && ((fr->Dlc != Ev->Can.Dlc) || (memcmp(fr->Data, Ev->Can.Data, Ev->Can.Dlc) != 0))) continue;
+			hit			= TRUE;
+			s_canCursor	= i + 1u;
+		}
+		n = snprintf(msg, sizeof(msg), "can 0x%X", (unsigned)Ev->A);
+		for(i = 0u; (Ev->B != 0u) && (i < Ev->Can.Dlc); i++)
+		{
+			n += snprintf(msg + n, sizeof(msg) - (size_t)n, " %02X", Ev->Can.Data[i]);
+		}
+	}
+
+	if(hit == TRUE)
+	{
+		s_expectPass++;
+		prv_Log("expect %s: ok", msg);
+	} else {
+		s_expectFail++;
+		fprintf(stderr, "[%10.3f ms] expect %s: FAILED (scenario line %u)\n",
+				(double)Sim_NowUs() / 1000.0, msg, (unsigned)Ev->Line);
+	}
+}
+
+static void prv_RunEvents(uint32* Next)
+{
+	while((*Next < s_eventCount) && (s_events[*Next].AtUs <= Sim_NowUs()))
+	{
+		const Sim_EventType* ev = &s_events[(*Next)++];
+
+		switch(ev->Kind)
+		{
+		case SIM_EV_ECHO:			Sim_Echo_Set((uint8)ev->A, ev->B);				break;
+		case SIM_EV_UART:			Sim_Uart_Inject((uint8)ev->A, ev->Text, ev->Len);	break;
+		case SIM_EV_CAN:			Sim_Can_Inject(&ev->Can);						break;
+		case SIM_EV_CANFAULT:		Sim_Can_Fault((uint8)ev->A, ev->B);				break;
+		case SIM_EV_FLASHFAULT:		if(ev->A != 0u) Sim_Flash_Worn(ev->B); else Sim_Flash_PowerLoss(ev->B);	break;
+		case SIM_EV_ADC:			Sim_Adc_Set((uint8)ev->A, (uint16)ev->B);		break;
+		case SIM_EV_CALL:			ev->Entry->Fn();								break;
+		case SIM_EV_EXPECT_UART:
+		case SIM_EV_EXPECT_CAN:
+		case SIM_EV_EXPECT_NOCAN:
+		case SIM_EV_EXPECT_PERIOD:
+		case SIM_EV_EXPECT_LATENCY:	prv_Expect(ev);									break;
+		default:																	break;
+		}
+	}
+}
+
+static void prv_RunTasks(void)
+{
+	uint32 i;
+
+	for(i = 0u; i < s_taskCount; i++)
+	{
+		Sim_TaskType* t = &s_tasks[i];
+
+		if(Sim_NowUs() >= t->NextUs)
+		{
+			t->NextUs += t->PeriodUs;
+			t->Entry->Fn();
+		}
+	}
+}
+
+/* ==============================
+ *       SINKS
+ * ============================== */
+static void prv_UartSink(uint8 Uart, uint8 Byte)
+{
+	Sim_CaptureType* c = &s_uartCap[Uart];
+
+	if(c->Len == c->Cap)
+	{
+		uint32 cap	= (c->Cap == 0u) ? 4096u : (c->Cap * 2u);
+		uint8* p	= realloc(c->Data, cap);
+		if(p == NULL_PTR) return;
+		c->Data	= p;
+		c->Cap	= cap;
+	}
+	c->Data[c->Len++] = Byte;
+
+	if((Uart == 0u) && (s_uartOut != NULL_PTR)) fputc(Byte, s_uartOut);
+}
+
+static void prv_CanSink(const Sim_CanFrameType* Frame)
+{
+	char msg[64];
+	int n;
+	uint8 i;
+
+	if(s_canLogLen < SIM_MAIN_MAX_CAN_LOG)
+	{
+		s_canLogUs[s_canLogLen]	= Sim_NowUs();
+		s_canLog[s_canLogLen++]	= *Frame;
+	}
+
+	n = snprintf(msg, sizeof(msg), "0x%X [%u]", (unsigned)Frame->Id, (unsigned)Frame->Dlc);
+	for(i = 0u; (i < Frame->Dlc) && (i < 8u) && (n < (int)sizeof(msg) - 4); i++)
+	{
+		n += snprintf(msg + n, sizeof(msg) - (size_t)n, " %02X", Frame->Data[i]);
+	}
+	prv_Log("CAN TX %s", msg);
+}
+
+static void prv_StopHandler(Sim_StopType Reason)
+{
+	s_stopReason = Reason;
+	longjmp(s_stopJmp, 1);
+}
+
+static void prv_Report(void)
+{
+	const Sim_StatsType* st = Sim_GetStats();
+	uint32 i;
+
+	fprintf(stderr, "sim: %.3f ms, %u loops, %u polls, %u SysTick\n",
+			(double)Sim_NowUs() / 1000.0, (unsigned)s_loops, (unsigned)st->Polls, (unsigned)st->SysTickCount);
+
+	for(i = 0u; i < 64u; i++)
+	{
+		if(st->IrqCount[i] != 0u)
+		{
+			fprintf(stderr, "sim: IRQ %u: %u (latency max %u us, avg %.1f us)\n", (unsigned)i, (unsigned)st->IrqCount[i],
+					(unsigned)st->IrqLatencyMaxUs[i], (double)st->IrqLatencySumUs[i] / (double)st->IrqCount[i]);
+		}
+	}
+	for(i = 0u; i < SIM_UART_COUNT; i++)
+	{
+		if((st->UartTxBytes[i] | st->UartRxBytes[i]) != 0u)
+		{
+			fprintf(stderr, "sim: uart%u tx %u rx %u overrun %u\n", (unsigned)(i + 1u),
+					(unsigned)st->UartTxBytes[i], (unsigned)st->UartRxBytes[i], (unsigned)st->UartRxOverrun[i]);
+		}
+	}
+	fprintf(stderr, "sim: can tx %u rx %u lost %u\n",
+			(unsigned)st->CanTxFrames, (unsigned)st->CanRxFrames, (unsigned)st->CanRxLost);
+	fprintf(stderr, "sim: echo triggers %u (short %u)\n",
+			(unsigned)st->EchoTriggers, (unsigned)st->EchoShortTriggers);
+	fprintf(stderr, "sim: flash programs %u erases %u power loss %u\n",
+			(unsigned)st->FlashPrograms, (unsigned)st->FlashErases, (unsigned)st->FlashPowerLoss);
+	if((s_expectPass + s_expectFail) != 0u)
+	{
+		fprintf(stderr, "sim: expect %u passed, %u failed\n", (unsigned)s_expectPass, (unsigned)s_expectFail);
+	}
+}
+
+/* ==============================
+ *       ENTRY
+ * ============================== */
+int main(int argc, char** argv)
+{
+	static const char* const stopName[] = { "", "reset request", "watchdog", "IRQ storm", "IRQ without handler" };
+	const char* scenario	= NULL_PTR;
+	const char* uartPath	= NULL_PTR;
+	uint32 next				= 0u;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-q") == 0)							s_quiet		= TRUE;
+		else if((strcmp(argv[i], "-u") == 0) && (i + 1 < argc))	uartPath	= argv[++i];
+		else													scenario	= argv[i];
+	}
+
+	if(scenario == NULL_PTR)
+	{
+		fprintf(stderr, "usage: %s [-q] [-u <file>] <scenario>\n", argv[0]);
+		return 2;
+	}
+
+	s_uartOut = (uartPath != NULL_PTR) ? fopen(uartPath, "wb") : stdout;
+	if(s_uartOut == NULL_PTR) return 2;
+
+	if(Sim_Init() != E_OK) return 2;
+	if(prv_LoadScenario(scenario) == FALSE) return 2;
+
+	Sim_SetUartSink(prv_UartSink);
+	Sim_SetCanSink(prv_CanSink);
+	Sim_SetStopHandler(prv_StopHandler);
+
+	if(setjmp(s_stopJmp) != 0)
+	{
+		fflush(s_uartOut);
+		fprintf(stderr, "[%10.3f ms] firmware stopped: %s\n", (double)Sim_NowUs() / 1000.0, stopName[s_stopReason]);
+		prv_Report();
+		return 3;
+	}
+
+	// supply off: faults, echo and inputs present at reset, the firmware does not run
+	while(Sim_NowUs() < s_powerOnUs)
+	{
+		prv_RunEvents(&next);
+		Sim_Advance(s_loopUs);
+	}
+
+	EcuM_Init(&EcuM_Config);
+
+	while(Sim_NowUs() < s_durationUs)
+	{
+		prv_RunEvents(&next);
+		prv_RunTasks();
+
+		SystemApp_MainFunction();
+		Sim_Advance(s_loopUs);
+		s_loops++;
+	}
+
+	fflush(s_uartOut);
+	if(next < s_eventCount) fprintf(stderr, "sim: %u events after end of run\n", (unsigned)(s_eventCount - next));
+	prv_Report();
+
+	return (s_expectFail != 0u) ? 1 : 0;
+}
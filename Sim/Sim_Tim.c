@@ -0,0 +1,291 @@
+/* =====================================================================================================================
+ *  File        : Sim_Tim.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : TIM1..TIM4 model, 16 bit up counter
+ * 					- timer clock 72 MHz, PSC shadowed (loaded on update event or EGR.UG like the hardware)
+ * 					- output compare: frozen / active / inactive / toggle / PWM1 / PWM2 / forced, CCxIF on match
+ * 					- input capture CH1/CH2 from TI1/TI2 (direct mapping, no filter / prescaler), CCxOF on overrun
+ * 					- EGR: UG reloads, CCxG raises CCxIF (capture channels latch CNT)
+ * 					- SR is rc_w0, reading CCRx in the ISR clears CCxIF
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include "Sim_Internal.h"
+
+#define SIM_TIM_UIF						(1UL << 0)
+#define SIM_TIM_EGR_UG					(1UL << 0)
+#define SIM_TIM_CC_FLAGS				(0x1EUL)		// CC1IF..CC4IF
+#define SIM_TIM_IRQ_FLAGS				(0x5FUL)		// UIF, CC1IF..CC4IF, TIF
+
+#define SIM_OCM_FROZEN					(0u)
+#define SIM_OCM_ACTIVE					(1u)
+#define SIM_OCM_INACTIVE				(2u)
+#define SIM_OCM_TOGGLE					(3u)
+#define SIM_OCM_FORCE_LO				(4u)
+#define SIM_OCM_FORCE_HI				(5u)
+#define SIM_OCM_PWM1					(6u)
+#define SIM_OCM_PWM2					(7u)
+
+typedef struct
+{
+	TIM_TypeDef*	Regs;
+	uint8			TiPort[2];					// TI1 / TI2 pins
+	uint8			TiPin[2];
+	uint32			PubSr;
+	uint32			PscActive;
+	uint32			Acc;
+	uint8			OcRef[4];
+	uint8			TiLast[2];
+	uint32			IsrSr;						// SR / DIER seen at ISR entry
+	uint32			IsrDier;
+} Sim_TimType;
+
+static Sim_TimType s_tim[SIM_TIM_COUNT] =
+{
+	{ TIM1, { SIM_PORT_A, SIM_PORT_A }, {  8u,  9u } },
+	{ TIM2, { SIM_PORT_A, SIM_PORT_A }, {  0u,  1u } },
+	{ TIM3, { SIM_PORT_A, SIM_PORT_A }, {  6u,  7u } },
+	{ TIM4, { SIM_PORT_B, SIM_PORT_B }, {  6u,  7u } },
+};
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+// CCMR field of channel (1..4): CCxS in bits 1:0, OCxM in bits 6:4
+static uint32 prv_Ccmr(const TIM_TypeDef* r, uint8 Ch)
+{
+	uint32 v = (Ch <= 2u) ? r->CCMR1 : r->CCMR2;
+
+	return (v >> (((Ch - 1u) & 1u) * 8u)) & 0xFFu;
+}
+
+static __vo uint32* prv_Ccr(TIM_TypeDef* r, uint8 Ch)
+{
+	switch(Ch)
+	{
+	case 1u:	return &r->CCR1;
+	case 2u:	return &r->CCR2;
+	case 3u:	return &r->CCR3;
+	default:	return &r->CCR4;
+	}
+}
+
+static void prv_SetSr(Sim_TimType* t, uint32 Bits)
+{
+	t->PubSr		|= Bits;
+	t->Regs->SR		= t->PubSr;
+}
+
+static void prv_Compare(Sim_TimType* t, uint32 Cnt)
+{
+	TIM_TypeDef* r = t->Regs;
+	uint8 ch;
+
+	for(ch = 1u; ch <= 4u; ch++)
+	{
+		uint32 m	= prv_Ccmr(r, ch);
+		uint32 ccr	= *prv_Ccr(r, ch) & 0xFFFFu;
+		uint8* ref	= &t->OcRef[ch - 1u];
+
+		if((m & 3u) != 0u) continue;			// input channel
+
+		switch((m >> 4) & 7u)
+		{
+		case SIM_OCM_PWM1:	*ref = (Cnt < ccr) ? 1u : 0u;	break;
+		case SIM_OCM_PWM2:	*ref = (Cnt < ccr) ? 0u : 1u;	break;
+		default:											break;
+		}
+
+		if(Cnt != ccr) continue;
+
+		prv_SetSr(t, 1UL << ch);
+
+		switch((m >> 4) & 7u)
+		{
+		case SIM_OCM_ACTIVE:	*ref = 1u;			break;
+		case SIM_OCM_INACTIVE:	*ref = 0u;			break;
+		case SIM_OCM_TOGGLE:	*ref ^= 1u;			break;
+		default:									break;
+		}
+	}
+}
+
+static void prv_Capture(Sim_TimType* t)
+{
+	TIM_TypeDef* r = t->Regs;
+	uint8 i;
+
+	for(i = 0u; i < 2u; i++)
+	{
+		uint8 ch	= (uint8)(i + 1u);
+		uint8 lvl	= Sim_Gpio_Pin(t->TiPort[i], t->TiPin[i]);
+		uint8 last	= t->TiLast[i];
+		uint32 ccer	= r->CCER >> (i * 4u);
+
+		t->TiLast[i] = lvl;
+
+		if((prv_Ccmr(r, ch) & 3u) != 1u)	continue;		// not mapped on its own TI
+		if((ccer & 1u) == 0u)				continue;		// CCxE
+		if(lvl == last)						continue;
+
+		// CCxP: 0 rising, 1 falling
+		if(((ccer & 2u) != 0u) == (lvl != 0u)) continue;
+
+		if(t->PubSr & (1UL << ch)) prv_SetSr(t, 1UL << (ch + 8u));	// CCxOF
+		*prv_Ccr(r, ch) = r->CNT & 0xFFFFu;
+		prv_SetSr(t, 1UL << ch);
+	}
+}
+
+static void prv_Count(Sim_TimType* t)
+{
+	TIM_TypeDef* r = t->Regs;
+	uint32 cnt = r->CNT & 0xFFFFu;
+
+	if(cnt >= (r->ARR & 0xFFFFu))
+	{
+		cnt				= 0u;
+		t->PscActive	= r->PSC & 0xFFFFu;
+		prv_SetSr(t, SIM_TIM_UIF);
+	} else {
+		cnt++;
+	}
+	r->CNT = cnt;
+
+	prv_Compare(t, cnt);
+}
+
+/* ==============================
+ *       MODEL
+ * ============================== */
+void Sim_Tim_Reset(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_TIM_COUNT; i++)
+	{
+		Sim_TimType* t = &s_tim[i];
+
+		t->Regs->ARR	= 0xFFFFu;
+		t->PubSr		= 0u;
+		t->PscActive	= 0u;
+		t->Acc			= 0u;
+		t->OcRef[0]		= 0u;	t->OcRef[1]		= 0u;
+		t->OcRef[2]		= 0u;	t->OcRef[3]		= 0u;
+		t->TiLast[0]	= 0u;	t->TiLast[1]	= 0u;
+	}
+}
+
+void Sim_Tim_Sync(void)
+{
+	uint8 i;
+	uint8 ch;
+
+	for(i = 0u; i < SIM_TIM_COUNT; i++)
+	{
+		Sim_TimType* t	= &s_tim[i];
+		TIM_TypeDef* r	= t->Regs;
+		uint32 sr		= r->SR;
+
+		// rc_w0: writing 0 clears, writing 1 keeps
+		if(sr != t->PubSr)
+		{
+			t->PubSr	&= sr;
+			r->SR		= t->PubSr;
+		}
+
+		if(r->EGR & SIM_TIM_EGR_UG)
+		{
+			r->CNT			= 0u;
+			t->Acc			= 0u;
+			t->PscActive	= r->PSC & 0xFFFFu;
+		}
+
+		// CCxG: capture channels latch CNT, compare channels only raise the flag
+		for(ch = 1u; ch <= 4u; ch++)
+		{
+			if((r->EGR & (1UL << ch)) == 0u) continue;
+
+			if((ch <= 2u) && ((prv_Ccmr(r, ch) & 3u) != 0u))
+			{
+				if(t->PubSr & (1UL << ch)) t->PubSr |= (1UL << (ch + 8u));
+				if(ch == 1u) r->CCR1 = r->CNT; else r->CCR2 = r->CNT;
+			}
+			t->PubSr |= (1UL << ch);
+		}
+		if(r->EGR != 0u)
+		{
+			r->EGR	= 0u;
+			r->SR	= t->PubSr;
+		}
+
+		// forced levels act immediately
+		for(ch = 1u; ch <= 4u; ch++)
+		{
+			uint32 m = prv_Ccmr(r, ch);
+
+			if((m & 3u) != 0u) continue;
+			if(((m >> 4) & 7u) == SIM_OCM_FORCE_LO) t->OcRef[ch - 1u] = 0u;
+			if(((m >> 4) & 7u) == SIM_OCM_FORCE_HI) t->OcRef[ch - 1u] = 1u;
+		}
+	}
+}
+
+void Sim_Tim_Tick(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_TIM_COUNT; i++)
+	{
+		Sim_TimType* t = &s_tim[i];
+
+		prv_Capture(t);
+
+		if((t->Regs->CR1 & TIM_CR1_CEN) == 0u) continue;
+
+		t->Acc += SIM_CYC_PER_US;
+		while(t->Acc > t->PscActive)
+		{
+			t->Acc -= t->PscActive + 1u;
+			prv_Count(t);
+		}
+	}
+}
+
+uint8 Sim_Tim_OcLevel(uint8 Tim, uint8 Ch)
+{
+	uint32 ccer = s_tim[Tim].Regs->CCER >> ((Ch - 1u) * 4u);
+
+	if((ccer & 1u) == 0u) return 0u;
+	return (uint8)(s_tim[Tim].OcRef[Ch - 1u] ^ ((ccer >> 1) & 1u));
+}
+
+boolean Sim_Tim_IrqPending(uint8 Tim)
+{
+	return ((s_tim[Tim].PubSr & s_tim[Tim].Regs->DIER & SIM_TIM_IRQ_FLAGS) != 0u) ? TRUE : FALSE;
+}
+
+void Sim_Tim_IsrEntry(uint8 Tim)
+{
+	s_tim[Tim].IsrSr	= s_tim[Tim].PubSr;
+	s_tim[Tim].IsrDier	= s_tim[Tim].Regs->DIER;
+}
+
+// An ISR serving a capture interrupt reads CCRx, which clears CCxIF
+void Sim_Tim_IsrExit(uint8 Tim)
+{
+	Sim_TimType* t = &s_tim[Tim];
+	uint8 ch;
+
+	for(ch = 1u; ch <= 2u; ch++)
+	{
+		uint32 f = 1UL << ch;
+
+		if(((prv_Ccmr(t->Regs, ch) & 3u) != 0u) && (t->IsrSr & t->IsrDier & f))
+		{
+			t->PubSr	&= ~f;
+			t->Regs->SR	= t->PubSr;
+		}
+	}
+}
@@ -0,0 +1,243 @@
+/* =====================================================================================================================
+ *  File        : Sim_Usart.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : USART1..3 model
+ * 					- TDR + shift register, TXE / TC timing from BRR (10 or 11 bit frames)
+ * 					- RX queue fed by Sim_Uart_Inject, one character time apart, ORE when RXNE is still set
+ * 					- writes to DR are seen through a sentinel (bit 31 set while idle, readers mask the data)
+ * 					- SR is rc_w0; an ISR serving RXNE reads DR (clears RXNE / ORE)
+ *  Notes       : Polled readers cannot be observed, a byte left in RDR is overwritten by the next one
+ *  Depends     : Sim_Internal.h
+ * ===================================================================================================================*/
+
+#include "Sim_Internal.h"
+
+#define SIM_USART_DR_IDLE				(0x80000000UL)
+#define SIM_USART_RXQ_SIZE				(1024u)
+
+#define SIM_USART_SR_PE					(1UL << USART_SR_PE)
+#define SIM_USART_SR_FE					(1UL << USART_SR_FE)
+#define SIM_USART_SR_NE					(1UL << USART_SR_NE)
+#define SIM_USART_SR_ORE				(1UL << USART_SR_ORE)
+#define SIM_USART_SR_RXNE				(1UL << USART_SR_RXNE)
+#define SIM_USART_SR_TC					(1UL << USART_SR_TC)
+#define SIM_USART_SR_TXE				(1UL << USART_SR_TXE)
+#define SIM_USART_SR_RC_W0				((1UL << USART_SR_RXNE) | (1UL << USART_SR_TC) | (1UL << USART_SR_LBD) | (1UL << USART_SR_CTS))
+
+typedef struct
+{
+	USART_TypeDef*	Regs;
+	uint32			ClkDiv;						// core cycles per PCLK cycle
+	uint32			PubSr;
+	uint32			PubDr;
+	uint8			RxData;
+	boolean			ShiftBusy;
+	uint8			ShiftData;
+	uint64			ShiftEnd;
+	boolean			TdrFull;
+	uint8			Tdr;
+	uint8			RxQ[SIM_USART_RXQ_SIZE];
+	uint32			RxHead;
+	uint32			RxTail;
+	uint64			RxNext;
+	uint32			IsrSr;
+	uint32			IsrCr1;
+} Sim_UsartType;
+
+static Sim_UsartType s_usart[SIM_UART_COUNT] =
+{
+	{ USART1,								1u },	// PCLK2 72 MHz
+	{ (USART_TypeDef*)(APB1PERIPH_BASE + 0x4400UL),	2u },	// PCLK1 36 MHz
+	{ (USART_TypeDef*)(APB1PERIPH_BASE + 0x4800UL),	2u },
+};
+
+/* ==============================
+ *       LOCAL HELPERS
+ * ============================== */
+static uint64 prv_CharCycles(const Sim_UsartType* u)
+{
+	uint32 brr	= u->Regs->BRR & 0xFFFFu;
+	uint32 bits	= (u->Regs->CR1 & (1UL << USART_CR1_M)) ? 11u : 10u;
+
+	if(brr == 0u) brr = 1u;
+	return (uint64)bits * brr * u->ClkDiv;
+}
+
+static void prv_Publish(Sim_UsartType* u)
+{
+	u->Regs->SR		= u->PubSr;
+	u->PubDr		= SIM_USART_DR_IDLE | u->RxData;
+	u->Regs->DR		= u->PubDr;
+}
+
+static boolean prv_On(const Sim_UsartType* u, uint32 Dir)
+{
+	uint32 cr1 = u->Regs->CR1;
+
+	return ((cr1 & (1UL << USART_CR1_UE)) && (cr1 & (1UL << Dir))) ? TRUE : FALSE;
+}
+
+/* ==============================
+ *       MODEL
+ * ============================== */
+void Sim_Usart_Reset(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_UART_COUNT; i++)
+	{
+		Sim_UsartType* u = &s_usart[i];
+
+		u->PubSr		= SIM_USART_SR_TXE | SIM_USART_SR_TC;
+		u->RxData		= 0u;
+		u->ShiftBusy	= FALSE;
+		u->TdrFull		= FALSE;
+		u->RxHead		= 0u;
+		u->RxTail		= 0u;
+		u->RxNext		= 0u;
+		prv_Publish(u);
+	}
+}
+
+void Sim_Usart_Sync(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_UART_COUNT; i++)
+	{
+		Sim_UsartType* u	= &s_usart[i];
+		uint32 sr			= u->Regs->SR;
+		uint32 dr			= u->Regs->DR;
+
+		if(sr != u->PubSr)
+		{
+			u->PubSr &= (sr | ~SIM_USART_SR_RC_W0);
+		}
+
+		if((dr & SIM_USART_DR_IDLE) == 0u)
+		{
+			// write to DR clears TC (SR was read before by every writer)
+			u->PubSr &= ~SIM_USART_SR_TC;
+
+			if(prv_On(u, USART_CR1_TE) == TRUE)
+			{
+				if(u->ShiftBusy == FALSE)
+				{
+					u->ShiftBusy	= TRUE;
+					u->ShiftData	= (uint8)dr;
+					u->ShiftEnd		= Sim_Cycles + prv_CharCycles(u);
+				} else {
+					// a write while TXE = 0 overwrites TDR
+					u->TdrFull	= TRUE;
+					u->Tdr		= (uint8)dr;
+					u->PubSr	&= ~SIM_USART_SR_TXE;
+				}
+			}
+		}
+
+		prv_Publish(u);
+	}
+}
+
+void Sim_Usart_Tick(void)
+{
+	uint8 i;
+
+	for(i = 0u; i < SIM_UART_COUNT; i++)
+	{
+		Sim_UsartType* u	= &s_usart[i];
+		boolean changed		= FALSE;
+
+		if((u->ShiftBusy == TRUE) && (Sim_Cycles >= u->ShiftEnd))
+		{
+			Sim_EmitUart(i, u->ShiftData);
+
+			if(u->TdrFull == TRUE)
+			{
+				u->ShiftData	= u->Tdr;
+				u->ShiftEnd		+= prv_CharCycles(u);
+				u->TdrFull		= FALSE;
+				u->PubSr		|= SIM_USART_SR_TXE;
+			} else {
+				u->ShiftBusy	= FALSE;
+				u->PubSr		|= SIM_USART_SR_TC;
+			}
+			changed = TRUE;
+		}
+
+		if((u->RxHead != u->RxTail) && (Sim_Cycles >= u->RxNext) && (prv_On(u, USART_CR1_RE) == TRUE))
+		{
+			uint8 b = u->RxQ[u->RxTail];
+
+			u->RxTail = (u->RxTail + 1u) % SIM_USART_RXQ_SIZE;
+			Sim_Stats.UartRxBytes[i]++;
+
+			if((u->PubSr & SIM_USART_SR_RXNE) && (u->Regs->CR1 & (1UL << USART_CR1_RXNEIE)))
+			{
+				u->PubSr |= SIM_USART_SR_ORE;
+				Sim_Stats.UartRxOverrun[i]++;
+			} else {
+				u->RxData	= b;
+				u->PubSr	|= SIM_USART_SR_RXNE;
+			}
+			u->RxNext	= Sim_Cycles + prv_CharCycles(u);
+			changed		= TRUE;
+		}
+
+		if(changed == TRUE) prv_Publish(u);
+	}
+}
+
+boolean Sim_Usart_IrqPending(uint8 Uart)
+{
+	const Sim_UsartType* u	= &s_usart[Uart];
+	uint32 sr				= u->PubSr;
+	uint32 cr1				= u->Regs->CR1;
+
+	if((cr1 & (1UL << USART_CR1_RXNEIE)) && (sr & (SIM_USART_SR_RXNE | SIM_USART_SR_ORE)))	return TRUE;
+	if((cr1 & (1UL << USART_CR1_TXEIE)) && (sr & SIM_USART_SR_TXE))							return TRUE;
+	if((cr1 & (1UL << USART_CR1_TCIE)) && (sr & SIM_USART_SR_TC))							return TRUE;
+	if((cr1 & (1UL << USART_CR1_PEIE)) && (sr & SIM_USART_SR_PE))							return TRUE;
+	if((u->Regs->CR3 & (1UL << USART_CR3_EIE)) && (sr & (SIM_USART_SR_FE | SIM_USART_SR_NE | SIM_USART_SR_ORE))) return TRUE;
+	return FALSE;
+}
+
+void Sim_Usart_IsrEntry(uint8 Uart)
+{
+	s_usart[Uart].IsrSr		= s_usart[Uart].PubSr;
+	s_usart[Uart].IsrCr1	= s_usart[Uart].Regs->CR1;
+}
+
+// SR read + DR read in the ISR: RXNE and the error flags are gone
+void Sim_Usart_IsrExit(uint8 Uart)
+{
+	Sim_UsartType* u = &s_usart[Uart];
+
+	if((u->IsrCr1 & (1UL << USART_CR1_RXNEIE)) && (u->IsrSr & (SIM_USART_SR_RXNE | SIM_USART_SR_ORE)))
+	{
+		u->PubSr &= ~(SIM_USART_SR_RXNE | SIM_USART_SR_ORE | SIM_USART_SR_FE | SIM_USART_SR_NE | SIM_USART_SR_PE);
+		prv_Publish(u);
+	}
+}
+
+void Sim_Uart_Inject(uint8 Uart, const uint8* Data, uint32 Len)
+{
+	Sim_UsartType* u = &s_usart[Uart];
+	uint64 first;
+
+	if(u->RxHead == u->RxTail)
+	{
+		first		= Sim_Cycles + prv_CharCycles(u);
+		u->RxNext	= (u->RxNext > first) ? u->RxNext : first;
+	}
+
+	while(Len-- > 0u)
+	{
+		uint32 next = (u->RxHead + 1u) % SIM_USART_RXQ_SIZE;
+
+		if(next == u->RxTail) break;			// queue full, rest dropped
+		u->RxQ[u->RxHead]	= *Data++;
+		u->RxHead			= next;
+	}
+}
@@ -0,0 +1,126 @@
+/* =====================================================================================================================
+ *  File        : Sos_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Check of the ambient compensated distance conversion (DistConv.c) against the physical speed of
+ * 				  sound in moist air, over the whole temperature range and 0 .. 100 %RH
+ * 					- reference: ideal gas mixture of dry air and water vapour at 101.325 kPa, saturation pressure
+ * 					  by Magnus (WMO), Cp air 29.07 / water 33.58 J/mol/K (the model of Tools/DistConv/gen_hum_lut.py)
+ * 					- the speed of sound DistConv uses is read back from the longest echo it converts without
+ * 					  saturating (resolution about 1e-5)
+ * 					- fails when the worst relative error exceeds SOS_MAX_ERR_PPM up to SOS_HOT_DC, SOS_MAX_ERR_HOT_PPM
+ * 					  above. About 280 ppm everywhere is the dry model (331.3 m/s at 0 degC vs 331.38 m/s of the
+ * 					  ideal gas). Above 55 degC humid air is up to a third water vapour and the humidity term, linear
+ * 					  in %RH between 0 and 100 %RH, is off by up to 0.55 % at 50 %RH
+ *  Usage       : sim_sos [-v]		-v: worst error per 5 degC
+ *  Exit        : 0 within the bound, 1 above, 2 usage
+ *  Depends     : DistConv.h, Rte.h
+ * ===================================================================================================================*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "DistConv.h"
+#include "Rte.h"
+
+#define SOS_HOT_DC						(550)		// 55.0 degC
+#define SOS_MAX_ERR_PPM					(400.0)		// up to SOS_HOT_DC: 0.14 m/s, 0.4 mm at 1 m
+#define SOS_MAX_ERR_HOT_PPM				(6000.0)	// above: 6 mm at 1 m
+#define SOS_GAS_R						(8.314462)
+#define SOS_ECHO_US						(19000u)	// below DISTCONV_Q4_MAX up to 420 m/s (+85 degC, 100 %RH)
+#define SOS_BAND_DC						(50)		// -v: one line per band
+
+/* ==============================
+ *       RTE STAND-IN
+ * ============================== */
+// DistConv_MainFunction is not called, the check sets temperature and humidity directly
+Std_ReturnType Rte_Read_AmbientTemperature(Rte_TemperatureType* Value)	{ (void)Value; return RTE_E_NO_DATA; }
+Std_ReturnType Rte_Read_AmbientHumidity(Rte_HumidityType* Value)			{ (void)Value; return RTE_E_NO_DATA; }
+
+/* ==============================
+ *       REFERENCE
+ * ============================== */
+static double prv_PSat(double T)
+{
+	if(T >= 0.0) return 611.2 * exp((17.62 * T) / (243.12 + T));
+	return 611.2 * exp((22.46 * T) / (272.62 + T));
+}
+
+// m/s at T degC and Rh %RH
+static double prv_SosMixture(double T, double Rh)
+{
+	double x	= (Rh / 100.0) * prv_PSat(T) / 101325.0;
+	double cp	= ((1.0 - x) * 29.07) + (x * 33.58);
+	double m	= (((1.0 - x) * 28.9645) + (x * 18.01528)) / 1000.0;
+
+	return sqrt((cp / (cp - SOS_GAS_R)) * SOS_GAS_R * (T + 273.15) / m);
+}
+
+// m/s DistConv converts with: d[Q4 mm] = t[us] * c[m/s] * 16 / 2000
+static double prv_SosDistConv(void)
+{
+	return ((double)DistConv_EchoUsToQ4Mm(SOS_ECHO_US) * 2000.0) / ((double)SOS_ECHO_US * 16.0);
+}
+
+/* ==============================
+ *       MAIN
+ * ============================== */
+int main(int argc, char** argv)
+{
+	boolean verbose		= FALSE;
+	double worst[2]		= { 0.0, 0.0 };			// up to / above SOS_HOT_DC
+	sint32 worstDc[2]	= { 0, 0 };
+	uint8 worstRh[2]	= { 0u, 0u };
+	double band			= 0.0;
+	boolean ok;
+	sint32 dc;
+	uint8 rh;
+
+	if((argc == 2) && (strcmp(argv[1], "-v") == 0))	verbose = TRUE;
+	else if(argc != 1)
+	{
+		fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+		return 2;
+	}
+
+	DistConv_Init();
+	for(dc = DISTCONV_CFG_TEMP_MIN_DC; dc <= DISTCONV_CFG_TEMP_MAX_DC; dc++)
+	{
+		uint8 hot = (dc > SOS_HOT_DC) ? 1u : 0u;
+
+		DistConv_SetTemperature((DistConv_TempDeciCType)dc);
+		for(rh = 0u; rh <= 100u; rh++)
+		{
+			double ref;
+			double err;
+
+			DistConv_SetHumidity(rh);
+			ref	= prv_SosMixture((double)dc / 10.0, (double)rh);
+			err	= fabs(prv_SosDistConv() - ref) / ref * 1e6;
+			if(err > band) band = err;
+			if(err > worst[hot])
+			{
+				worst[hot]		= err;
+				worstDc[hot]	= dc;
+				worstRh[hot]	= rh;
+			}
+		}
+		if((verbose == TRUE) && (((dc - DISTCONV_CFG_TEMP_MIN_DC) % SOS_BAND_DC) == (SOS_BAND_DC - 1)))
+		{
+			printf("sos: %5.1f .. %5.1f degC  worst %6.1f ppm\n",
+					(double)(dc - SOS_BAND_DC + 1) / 10.0, (double)dc / 10.0, band);
+			band = 0.0;
+		}
+	}
+
+	printf("sos: %.1f .. %.1f degC, 0 .. 100 %%RH: worst %.1f ppm at %.1f degC %u %%RH (bound %.0f ppm)\n",
+			(double)DISTCONV_CFG_TEMP_MIN_DC / 10.0, (double)SOS_HOT_DC / 10.0, worst[0],
+			(double)worstDc[0] / 10.0, (unsigned)worstRh[0], SOS_MAX_ERR_PPM);
+	printf("sos: %.1f .. %.1f degC, 0 .. 100 %%RH: worst %.1f ppm at %.1f degC %u %%RH (bound %.0f ppm)\n",
+			(double)(SOS_HOT_DC + 1) / 10.0, (double)DISTCONV_CFG_TEMP_MAX_DC / 10.0, worst[1],
+			(double)worstDc[1] / 10.0, (unsigned)worstRh[1], SOS_MAX_ERR_HOT_PPM);
+
+	ok = ((worst[0] <= SOS_MAX_ERR_PPM) && (worst[1] <= SOS_MAX_ERR_HOT_PPM)) ? TRUE : FALSE;
+	return (ok == TRUE) ? 0 : 1;
+}
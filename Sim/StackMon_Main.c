@@ -0,0 +1,136 @@
+/* =====================================================================================================================
+ *  File        : StackMon_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Check of the high-water-mark scan (StackMon.c) on the host stand-in region StackMon_HostRegion
+ * 					- a word written below the mark becomes the new mark within the rest of the running pass plus
+ * 					  one pass from the bottom up to it (WORDS_PER_CALL words per call), used / free bytes follow
+ * 					- hole: a deeper word written later under still painted words is found by the rescan from the
+ * 					  bottom
+ * 					- the call that takes the free bytes under STACKMON_CFG_GUARD_BYTES reports to Det and calls
+ * 					  STACKMON_CFG_GUARD_FAULT once, a mark moving further down reports nothing more
+ * 				  Built with the guard at 64 bytes (16 words) and the fault action counted here, see the Makefile.
+ *  Usage       : sim_stackmon
+ *  Exit        : 0 ok, 1 mismatches
+ *  Depends     : StackMon.h, Det.h
+ * ===================================================================================================================*/
+
+#include <stdio.h>
+
+#include "StackMon.h"
+#include "Det.h"
+
+#define STACKMON_CHECK_WORD_BYTES		(4u)
+#define STACKMON_CHECK_REGION_BYTES		(STACKMON_CFG_HOST_WORDS * STACKMON_CHECK_WORD_BYTES)
+
+static uint32	s_checks	= 0u;
+static uint32	s_errors	= 0u;
+static uint32	s_detGuard	= 0u;
+static uint32	s_detOther	= 0u;
+static uint32	s_faults	= 0u;
+
+/* ==============================
+ *       STAND-INS
+ * ============================== */
+void Det_ReportError(uint16 ModuleId, uint8 InstanceId, uint8 ApiId, uint8 ErrorId)
+{
+	(void)InstanceId;
+
+	if((ModuleId == STACKMON_MODULE_ID) && (ApiId == STACKMON_API_ID_MAINFUNCTION) && (ErrorId == STACKMON_E_GUARD_CROSSED))
+	{
+		s_detGuard++;
+	} else {
+		s_detOther++;
+	}
+}
+
+// STACKMON_CFG_GUARD_FAULT on the host, returns so the scan can go on
+void StackMonCheck_Fault(void)
+{
+	s_faults++;
+}
+
+/* ==============================
+ *       HELPERS
+ * ============================== */
+static void prv_Check(boolean Ok, const char* What, uint32 Expected, uint32 Got)
+{
+	s_checks++;
+	if(Ok == TRUE) return;
+
+	s_errors++;
+	printf("stackmon: %s: expected %u, got %u\n", What, (unsigned)Expected, (unsigned)Got);
+}
+
+static void prv_CheckEq(const char* What, uint32 Expected, uint32 Got)
+{
+	prv_Check((Expected == Got) ? TRUE : FALSE, What, Expected, Got);
+}
+
+// Write Word, then run the scan until the mark reaches it. Worst case: the running pass goes on up to the old mark
+// (the restart takes a call of its own), then the next one from the bottom up to the word
+static void prv_TouchAndScan(const char* What, uint32 Word)
+{
+	uint32 mark		= StackMon_GetFreeBytes() / STACKMON_CHECK_WORD_BYTES;
+	uint32 bound	= ((mark + STACKMON_CFG_WORDS_PER_CALL - 1u) / STACKMON_CFG_WORDS_PER_CALL) + 1u +
+					  (Word / STACKMON_CFG_WORDS_PER_CALL) + 1u;
+	uint32 used		= STACKMON_CHECK_REGION_BYTES - (Word * STACKMON_CHECK_WORD_BYTES);
+	uint32 calls	= 0u;
+
+	StackMon_HostRegion[Word] = 0u;
+	while((StackMon_GetUsedBytes() != used) && (calls < (2u * STACKMON_CFG_HOST_WORDS)))
+	{
+		StackMon_MainFunction();
+		calls++;
+	}
+
+	printf("stackmon: %-12s word %2u: mark after %u calls (bound %u), used %u free %u\n", What, (unsigned)Word,
+			(unsigned)calls, (unsigned)bound, (unsigned)StackMon_GetUsedBytes(), (unsigned)StackMon_GetFreeBytes());
+	prv_CheckEq("used bytes", used, StackMon_GetUsedBytes());
+	prv_CheckEq("free bytes", Word * STACKMON_CHECK_WORD_BYTES, StackMon_GetFreeBytes());
+	prv_Check((calls <= bound) ? TRUE : FALSE, "calls to the mark", bound, calls);
+}
+
+/* ==============================
+ *       MAIN
+ * ============================== */
+int main(void)
+{
+	uint32 i;
+	uint32 passes;
+
+	StackMon_Init();
+	prv_CheckEq("used bytes after init", 0u, StackMon_GetUsedBytes());
+	prv_CheckEq("free bytes after init", STACKMON_CHECK_REGION_BYTES, StackMon_GetFreeBytes());
+	for(i = 0u; i < STACKMON_CFG_HOST_WORDS; i++)
+	{
+		if(StackMon_HostRegion[i] != STACKMON_CFG_PATTERN) prv_CheckEq("painted word", STACKMON_CFG_PATTERN, StackMon_HostRegion[i]);
+	}
+
+	// untouched: whole passes, the mark stays at the top
+	for(i = 0u; i < (2u * STACKMON_CFG_HOST_WORDS); i++) StackMon_MainFunction();
+	passes = StackMon_GetPassCount();
+	prv_Check((passes >= 2u) ? TRUE : FALSE, "passes over the painted region", 2u, passes);
+	prv_CheckEq("used bytes untouched", 0u, StackMon_GetUsedBytes());
+
+	// first frame, then a deeper one with painted words between it and the mark (hole)
+	prv_TouchAndScan("first", 40u);
+	prv_TouchAndScan("hole", 24u);
+	prv_CheckEq("guard reports above the margin", 0u, s_detGuard);
+	prv_CheckEq("faults above the margin", 0u, s_faults);
+
+	// free 40 bytes < 64: one report, one fault action, in the call that moved the mark
+	prv_TouchAndScan("guard", 10u);
+	prv_CheckEq("guard reports", 1u, s_detGuard);
+	prv_CheckEq("faults", 1u, s_faults);
+
+	// further down: the mark follows, nothing is reported again
+	prv_TouchAndScan("below guard", 2u);
+	for(i = 0u; i < (2u * STACKMON_CFG_HOST_WORDS); i++) StackMon_MainFunction();
+	prv_CheckEq("guard reports after more calls", 1u, s_detGuard);
+	prv_CheckEq("faults after more calls", 1u, s_faults);
+	prv_CheckEq("other Det reports", 0u, s_detOther);
+
+	printf("stackmon: %u checks, %u errors\n", (unsigned)s_checks, (unsigned)s_errors);
+	return (s_errors == 0u) ? 0 : 1;
+}
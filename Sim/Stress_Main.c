@@ -0,0 +1,311 @@
+/* =====================================================================================================================
+ *  File        : Stress_Main.c
+ *  Layer       : Sim (host only)
+ *  ECU         : Sensor_ECU (STM32F103C6T6)
+ *  Purpose     : Threaded stress test of the word atomics (Irq_Atomic.h) and the SPSC / MPSC queues (Irq_Queue.c)
+ * 					- Add / CAS: every thread adds 1 per call, the counter must end at threads x calls
+ * 					- SPSC: one producer, one consumer, small queue (full and empty all the time), the consumer sees
+ * 					  0, 1, 2 .. in order
+ * 					- MPSC: several producers tag their sequence numbers, the consumer sees each producer's numbers
+ * 					  in order and all of them
+ * 				  Every element carries its value and the complement: a copy torn by a racing index shows as well.
+ *  Usage       : sim_stress [-n <items>]		items per thread (default 1000000)
+ *  Notes       : Real threads on the host cores are harsher than ISR preemption on one core: both sides run at the
+ * 				  same time, not only nested. The host builds of the atomics are the GCC __atomic builtins, the
+ * 				  LDREX/STREX paths are checked on target only. A full / empty queue yields the core: on a single
+ * 				  core host the other side runs instead of the spin.
+ *  Exit        : 0 ok, 1 lost / duplicated / torn items or a stuck queue, 2 setup error
+ *  Depends     : Irq_Atomic.h, Irq_Queue.h
+ * ===================================================================================================================*/
+
+#define _GNU_SOURCE						// pthread_timedjoin_np
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "Irq_Atomic.h"
+#include "Irq_Queue.h"
+
+#define STRESS_THREADS					(4u)		// Add / CAS threads, MPSC producers
+#define STRESS_SPSC_COUNT				(8u)
+#define STRESS_MPSC_COUNT				(16u)
+#define STRESS_TAG_SHIFT				(24u)		// MPSC: producer in the top byte, sequence below
+#define STRESS_PREEMPT_US				(20)		// SIGALRM period
+#define STRESS_TIMEOUT_S				(30)		// per test
+
+typedef struct
+{
+	uint32	Value;
+	uint32	Check;							// ~Value
+} Stress_ItemType;
+
+static uint32				s_items		= 1000000u;
+static uint32				s_errors	= 0u;
+
+static volatile uint32		s_counter;
+static volatile uint32		s_done;						// producers finished: an empty queue then means lost items
+static Irq_SpscType			s_spsc;
+static Stress_ItemType		s_spscBuf[STRESS_SPSC_COUNT];
+static Irq_MpscType			s_mpsc;
+static Stress_ItemType		s_mpscBuf[STRESS_MPSC_COUNT];
+static volatile uint32		s_mpscSeq[STRESS_MPSC_COUNT];
+
+/* ==============================
+ *       HELPERS
+ * ============================== */
+// Preemption at any instruction, like an ISR: the interrupted thread gives the core away from inside a push / pop
+static void prv_Preempt(int Sig)
+{
+	(void)Sig;
+	(void)sched_yield();
+}
+
+static boolean prv_PreemptStart(void)
+{
+	struct sigaction sa;
+	struct itimerval it;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler	= prv_Preempt;
+	sa.sa_flags		= SA_RESTART;
+	if(sigaction(SIGALRM, &sa, NULL) != 0) return FALSE;
+
+	it.it_interval.tv_sec	= 0;
+	it.it_interval.tv_usec	= STRESS_PREEMPT_US;
+	it.it_value				= it.it_interval;
+	return (setitimer(ITIMER_REAL, &it, NULL) == 0) ? TRUE : FALSE;
+}
+
+static void prv_Error(const char* Test, const char* What, uint32 Expected, uint32 Got)
+{
+	// the first few tell the story, the count tells the rest
+	if(s_errors < 10u) fprintf(stderr, "stress: %s: %s, expected %u got %u\n", Test, What, (unsigned)Expected, (unsigned)Got);
+	s_errors++;
+}
+
+// A thread that does not finish in time spins on a queue that lost or corrupted its state
+static boolean prv_Run(const char* Test, void* (*Fn)(void*), uint32 Threads)
+{
+	pthread_t th[STRESS_THREADS + 1u];
+	struct timespec deadline;
+	uintptr_t i;
+
+	for(i = 0u; i < Threads; i++)
+	{
+		if(pthread_create(&th[i], NULL, Fn, (void*)i) != 0) return FALSE;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += STRESS_TIMEOUT_S;
+	for(i = 0u; i < Threads; i++)
+	{
+		if(pthread_timedjoin_np(th[i], NULL, &deadline) != 0)
+		{
+			fprintf(stderr, "stress: %s: stuck after %d s\n", Test, STRESS_TIMEOUT_S);
+			exit(1);
+		}
+	}
+	return TRUE;
+}
+
+static boolean prv_SpscPop(Stress_ItemType* It)	{ return Irq_SpscPop(&s_spsc, It); }
+static boolean prv_MpscPop(Stress_ItemType* It)	{ return Irq_MpscPop(&s_mpsc, It); }
+
+// Next item, FALSE once every producer is done and the queue stays empty
+static boolean prv_Wait(boolean (*Pop)(Stress_ItemType*), Stress_ItemType* It, uint32 Producers)
+{
+	for(;;)
+	{
+		boolean done = (Irq_AtomicLoad32(&s_done) == Producers) ? TRUE : FALSE;
+
+		if(Pop(It) == TRUE)	return TRUE;
+		if(done == TRUE)	return FALSE;
+		(void)sched_yield();
+	}
+}
+
+/* ==============================
+ *       ADD / CAS
+ * ============================== */
+static void* prv_AddThread(void* Arg)
+{
+	uint32 i;
+	(void)Arg;
+
+	for(i = 0u; i < s_items; i++) (void)Irq_AtomicAdd32(&s_counter, 1u);
+	return NULL;
+}
+
+static void* prv_CasThread(void* Arg)
+{
+	uint32 i;
+	(void)Arg;
+
+	for(i = 0u; i < s_items; i++)
+	{
+		uint32 old;
+
+		do
+		{
+			old = Irq_AtomicLoad32(&s_counter);
+		} while(Irq_AtomicCas32(&s_counter, old, old + 1u) == FALSE);
+	}
+	return NULL;
+}
+
+static boolean prv_Counter(const char* Test, void* (*Fn)(void*))
+{
+	s_counter = 0u;
+	if(prv_Run(Test, Fn, STRESS_THREADS) == FALSE) return FALSE;
+	if(s_counter != (STRESS_THREADS * s_items)) prv_Error(Test, "counter", STRESS_THREADS * s_items, s_counter);
+	return TRUE;
+}
+
+static boolean prv_Queue(const char* Test, void* (*Fn)(void*), uint32 Threads)
+{
+	s_done = 0u;
+	return prv_Run(Test, Fn, Threads);
+}
+
+/* ==============================
+ *       SPSC
+ * ============================== */
+static void* prv_SpscThread(void* Arg)
+{
+	Stress_ItemType it;
+	uint32 i;
+
+	if((uintptr_t)Arg == 0u)
+	{
+		for(i = 0u; i < s_items; i++)
+		{
+			it.Value = i;
+			it.Check = ~i;
+			while(Irq_SpscPush(&s_spsc, &it) == FALSE) (void)sched_yield();
+		}
+		(void)Irq_AtomicAdd32(&s_done, 1u);
+		return NULL;
+	}
+
+	for(i = 0u; i < s_items; i++)
+	{
+		if(prv_Wait(prv_SpscPop, &it, 1u) == FALSE)
+		{
+			prv_Error("spsc", "items", s_items, i);
+			break;
+		}
+		if(it.Check != ~it.Value)	prv_Error("spsc", "torn item", ~it.Value, it.Check);
+		if(it.Value != i)			prv_Error("spsc", "sequence", i, it.Value);
+	}
+	if(Irq_SpscPop(&s_spsc, &it) == TRUE) prv_Error("spsc", "extra item", 0u, it.Value);
+	return NULL;
+}
+
+/* ==============================
+ *       MPSC
+ * ============================== */
+static void* prv_MpscProducer(void* Arg)
+{
+	uint32 tag = (uint32)(uintptr_t)Arg << STRESS_TAG_SHIFT;
+	Stress_ItemType it;
+	uint32 i;
+
+	for(i = 0u; i < s_items; i++)
+	{
+		it.Value = tag | i;
+		it.Check = ~it.Value;
+		while(Irq_MpscPush(&s_mpsc, &it) == FALSE) (void)sched_yield();
+	}
+	(void)Irq_AtomicAdd32(&s_done, 1u);
+	return NULL;
+}
+
+static void* prv_MpscConsumer(void* Arg)
+{
+	uint32 next[STRESS_THREADS] = { 0u };
+	Stress_ItemType it;
+	uint32 n;
+	uint32 p;
+	(void)Arg;
+
+	for(n = 0u; n < (STRESS_THREADS * s_items); n++)
+	{
+		if(prv_Wait(prv_MpscPop, &it, STRESS_THREADS) == FALSE) break;
+		if(it.Check != ~it.Value)
+		{
+			prv_Error("mpsc", "torn item", ~it.Value, it.Check);
+			continue;
+		}
+
+		p = it.Value >> STRESS_TAG_SHIFT;
+		if(p >= STRESS_THREADS)
+		{
+			prv_Error("mpsc", "producer", STRESS_THREADS - 1u, p);
+			continue;
+		}
+		if((it.Value & ((1u << STRESS_TAG_SHIFT) - 1u)) != next[p]) prv_Error("mpsc", "sequence", next[p], it.Value & ((1u << STRESS_TAG_SHIFT) - 1u));
+		next[p] = (it.Value & ((1u << STRESS_TAG_SHIFT) - 1u)) + 1u;
+	}
+	for(p = 0u; p < STRESS_THREADS; p++)
+	{
+		if(next[p] != s_items) prv_Error("mpsc", "items of a producer", s_items, next[p]);
+	}
+	if(Irq_MpscPop(&s_mpsc, &it) == TRUE) prv_Error("mpsc", "extra item", 0u, it.Value);
+	return NULL;
+}
+
+static void* prv_MpscThread(void* Arg)
+{
+	uintptr_t i = (uintptr_t)Arg;
+
+	return (i < STRESS_THREADS) ? prv_MpscProducer(Arg) : prv_MpscConsumer(Arg);
+}
+
+/* ==============================
+ *       MAIN
+ * ============================== */
+int main(int argc, char** argv)
+{
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))	s_items = (uint32)strtoul(argv[++i], NULL, 0);
+		else
+		{
+			fprintf(stderr, "usage: %s [-n <items>]\n", argv[0]);
+			return 2;
+		}
+	}
+	if((s_items == 0u) || (s_items >= (1u << STRESS_TAG_SHIFT)))
+	{
+		fprintf(stderr, "stress: items 1 .. %u\n", (unsigned)((1u << STRESS_TAG_SHIFT) - 1u));
+		return 2;
+	}
+
+	if((Irq_SpscInit(&s_spsc, (uint8*)s_spscBuf, (uint16)sizeof(s_spscBuf[0]), STRESS_SPSC_COUNT) != E_OK) ||
+	   (Irq_MpscInit(&s_mpsc, (uint8*)s_mpscBuf, s_mpscSeq, (uint16)sizeof(s_mpscBuf[0]), STRESS_MPSC_COUNT) != E_OK))
+	{
+		return 2;
+	}
+
+	if((prv_PreemptStart() == FALSE) ||
+	   (prv_Counter("add", prv_AddThread) == FALSE) ||
+	   (prv_Counter("cas", prv_CasThread) == FALSE) ||
+	   (prv_Queue("spsc", prv_SpscThread, 2u) == FALSE) ||
+	   (prv_Queue("mpsc", prv_MpscThread, STRESS_THREADS + 1u) == FALSE))
+	{
+		fprintf(stderr, "stress: cannot start threads\n");
+		return 2;
+	}
+
+	printf("stress: %u threads x %u items, add / cas / spsc / mpsc: %u errors\n",
+			(unsigned)STRESS_THREADS, (unsigned)s_items, (unsigned)s_errors);
+	return (s_errors == 0u) ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+# =====================================================================================================================
+#  File        : gen_hum_lut.py
+#  Layer       : Tools (host)
+#  ECU         : Sensor_ECU (STM32F103C6T6)
+#  Purpose     : Generate DistConv_KHum100Lut (Services/DistConv/DistConv.c)
+#                K increase (Q16, Q4 mm per us) at 100 %RH, 101.325 kPa, every 5 degC from -40 degC
+#                Moist air as ideal gas mixture: p_sat Magnus (WMO), Cp air 29.07 / water 33.58 J/mol/K
+#  Usage       : gen_hum_lut.py            (prints C initializer)
+#                gen_hum_lut.py --check    (prints model speed of sound table)
+# =====================================================================================================================
+
+import math
+import sys
+
+R = 8.314462
+T_MIN, T_MAX, T_STEP = -40, 90, 5
+
+
+def p_sat(t):
+    if t >= 0:
+        return 611.2 * math.exp(17.62 * t / (243.12 + t))
+    return 611.2 * math.exp(22.46 * t / (272.62 + t))
+
+
+def sos_mixture(t, rh):
+    x = rh / 100.0 * p_sat(t) / 101325.0
+    cp = (1.0 - x) * 29.07 + x * 33.58
+    m = ((1.0 - x) * 28.9645 + x * 18.01528) / 1000.0
+    return math.sqrt(cp / (cp - R) * R * (t + 273.15) / m)
+
+
+def sos_dry(t):
+    # same model DistConv uses for the dry table
+    return 331.3 * math.sqrt(1.0 + t / 273.15)
+
+
+def k_q16(c_ms):
+    return c_ms * 1000.0 * (1 << 19) / 1e6
+
+
+def main():
+    rows = []
+    for t in range(T_MIN, T_MAX + 1, T_STEP):
+        ratio = sos_mixture(t, 100.0) / sos_mixture(t, 0.0)
+        rows.append(int(round(k_q16(sos_dry(t)) * (ratio - 1.0))))
+        if "--check" in sys.argv:
+            print("%4d degC  dry %.2f m/s  +%.3f m/s @100%%RH" % (t, sos_dry(t), sos_dry(t) * (ratio - 1.0)))
+    if "--check" in sys.argv:
+        return
+    for i in range(0, len(rows), 8):
+        print("\t" + " ".join("%5uu," % v for v in rows[i:i + 8]))
+
+
+if __name__ == "__main__":
+    main()
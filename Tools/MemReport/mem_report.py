@@ -0,0 +1,370 @@
+#!/usr/bin/env python3
+# =====================================================================================================================
+#  File        : mem_report.py
+#  Layer       : Tools (host)
+#  ECU         : Sensor_ECU (STM32F103C6T6)
+#  Purpose     : RAM / flash / stack footprint per module and layer from the GNU ld map file and the
+#                GCC -fstack-usage (.su) / -fcallgraph-info=su (.ci) outputs, checked against mem_budget.ini
+#                - flash: .isr_vector .text .rodata .ARM.* init/fini arrays + .data load image
+#                - ram:   .data .bss COMMON
+#                - stack: worst-case call path of every ISR and runnable (indirect calls resolved from [indirect])
+#                - total: deepest task-context root + every ISR (nesting) + one exception frame per ISR
+#  Usage       : mem_report.py --map build/Sensor_ECU.map --obj-dir build [--profile target] [--budget file]
+#  Exit        : 0 within budget, 1 budget exceeded, 2 bad input
+# =====================================================================================================================
+
+import argparse
+import configparser
+import fnmatch
+import os
+import re
+import sys
+
+LAYERS = ("MCAL", "ECU_Abstraction", "Services", "RTE", "Application", "Config")
+
+FLASH_PREFIXES = (".isr_vector", ".text", ".rodata", ".ARM.", ".init_array", ".fini_array", ".preinit_array")
+RAM_PREFIXES = (".bss", "COMMON", ".noinit")
+DATA_PREFIXES = (".data",)
+
+RE_INPUT = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+RE_INPUT_CONT = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+RE_ASSIGN = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(\w+)\s*=")
+RE_CI_NODE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+RE_CI_EDGE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+RE_CI_FRAME = re.compile(r"(\d+) bytes \(([a-z,]+)\)")
+
+INDIRECT = "__indirect_call"
+
+
+def layer_of(path):
+    parts = re.split(r"[\\/]", path)
+    for p in parts:
+        if p in LAYERS:
+            return p
+    if "(" in path or path.endswith(".a"):
+        return "lib"
+    return "other"
+
+
+def module_of(path):
+    m = re.match(r"(.*\.a)\((.*)\)", path)
+    if m:
+        return os.path.basename(m.group(1))
+    return os.path.splitext(os.path.basename(path))[0]
+
+
+def bare(title):
+    # static functions are "file.c:name" in .ci files
+    return title.rsplit(":", 1)[-1]
+
+
+# ==============================
+#       MAP FILE
+# ==============================
+def section_kind(name):
+    if name.startswith(DATA_PREFIXES):
+        return "data"
+    if name.startswith(FLASH_PREFIXES):
+        return "flash"
+    if name.startswith(RAM_PREFIXES):
+        return "ram"
+    return None
+
+
+def parse_map(path):
+    modules = {}
+    symbols = {}
+    pending = None
+    started = False
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not started:
+                started = line.startswith("Linker script and memory map")
+                continue
+
+            m = RE_ASSIGN.match(line)
+            if m:
+                symbols[m.group(2)] = int(m.group(1), 16)
+                continue
+
+            entry = None
+            m = RE_INPUT.match(line)
+            if m and not m.group(1).startswith("*"):
+                entry = (m.group(1), int(m.group(3), 16), m.group(4).strip())
+            elif pending is not None:
+                m = RE_INPUT_CONT.match(line)
+                if m:
+                    entry = (pending, int(m.group(2), 16), m.group(3).strip())
+            pending = None
+
+            if entry is None:
+                # long input section names wrap onto the next line
+                s = line.strip()
+                if line.startswith(" ") and not line.startswith("  ") and " " not in s and not s.startswith("*"):
+                    pending = s
+                continue
+
+            name, size, obj = entry
+            kind = section_kind(name)
+            if kind is None or size == 0 or not obj.endswith((".o", ")")):
+                continue
+
+            key = (layer_of(obj), module_of(obj))
+            mod = modules.setdefault(key, {"flash": 0, "ram": 0, "frame": 0, "frame_fn": ""})
+            if kind in ("flash", "data"):
+                mod["flash"] += size
+            if kind in ("ram", "data"):
+                mod["ram"] += size
+
+    if not started:
+        raise ValueError("%s: no memory map section" % path)
+    return modules, symbols
+
+
+# ==============================
+#       STACK USAGE / CALL GRAPH
+# ==============================
+class Function:
+    def __init__(self, title, src, size, qual):
+        self.title = title
+        self.src = src
+        self.size = size
+        self.qual = qual      # static / dynamic / dynamic,bounded
+        self.calls = set()
+
+
+def parse_ci(path, funcs):
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = RE_CI_NODE.match(line)
+            if m:
+                title, label = m.group(1), m.group(2).split("\\n")
+                fr = RE_CI_FRAME.search(m.group(2))
+                if fr and len(label) >= 2:
+                    src = label[1].split(":")[0]
+                    old = funcs.get(title)
+                    fn = Function(title, src, int(fr.group(1)), fr.group(2))
+                    if old is not None:
+                        fn.calls = old.calls
+                    funcs[title] = fn
+                elif title not in funcs:
+                    funcs[title] = Function(title, None, None, None)
+                continue
+            m = RE_CI_EDGE.match(line)
+            if m:
+                src = funcs.setdefault(m.group(1), Function(m.group(1), None, None, None))
+                src.calls.add(m.group(2))
+
+
+def parse_su(path, funcs):
+    # no call graph from .su alone, only frames of functions .ci did not describe
+    with open(path, errors="replace") as f:
+        for line in f:
+            cols = line.rstrip("\n").split("\t")
+            if len(cols) < 3:
+                continue
+            loc, size, qual = cols[0], int(cols[1]), cols[2]
+            name = loc.rsplit(":", 1)[-1]
+            src = loc.split(":")[0]
+            for title in (name, "%s:%s" % (os.path.basename(src), name)):
+                if title in funcs and funcs[title].size is not None:
+                    break
+            else:
+                funcs[name] = Function(name, src, size, qual)
+
+
+def load_functions(obj_dir):
+    funcs = {}
+    ci, su = [], []
+    for root, _, files in os.walk(obj_dir):
+        for n in files:
+            if n.endswith(".ci"):
+                ci.append(os.path.join(root, n))
+            elif n.endswith(".su"):
+                su.append(os.path.join(root, n))
+    for p in sorted(ci):
+        parse_ci(p, funcs)
+    for p in sorted(su):
+        parse_su(p, funcs)
+    return funcs
+
+
+class StackAnalyzer:
+    def __init__(self, funcs, indirect, external):
+        self.funcs = funcs
+        self.indirect = indirect
+        self.external = external
+        self.memo = {}
+        self.unknown = set()
+        self.unbounded = set()
+
+    def _indirect_targets(self, title):
+        pats = self.indirect.get(title, self.indirect.get(bare(title)))
+        if pats is None:
+            return None
+        out = []
+        for pat in pats:
+            out += [t for t, fn in self.funcs.items() if fn.size is not None and fnmatch.fnmatchcase(bare(t), pat)]
+        return sorted(set(out))
+
+    def depth(self, title, stack=()):
+        """(bytes, path) of the deepest call chain starting at title."""
+        if title in self.memo:
+            return self.memo[title]
+        if title in stack:
+            self.unbounded.add(title)
+            return (0, [title + " (recursion)"])
+
+        fn = self.funcs.get(title)
+        if fn is None or fn.size is None:
+            size = self.external.get(bare(title))
+            if size is None:
+                self.unknown.add(bare(title))
+                size = 0
+            return (size, [bare(title)])
+
+        if fn.qual.startswith("dynamic") and "bounded" not in fn.qual:
+            self.unbounded.add(bare(title))
+
+        best = (0, [])
+        for callee in fn.calls:
+            if callee == INDIRECT:
+                targets = self._indirect_targets(title)
+                if targets is None:
+                    self.unknown.add("%s -> (indirect)" % bare(title))
+                    targets = []
+            else:
+                targets = [callee]
+            for t in targets:
+                d = self.depth(t, stack + (title,))
+                if d[0] > best[0]:
+                    best = d
+        res = (fn.size + best[0], [bare(title)] + best[1])
+        if not stack or title not in self.unbounded:
+            self.memo[title] = res
+        return res
+
+
+# ==============================
+#       REPORT
+# ==============================
+def words(cfg, section, key, default=""):
+    return cfg.get(section, key, fallback=default).split()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="RAM / flash / stack footprint report with budgets")
+    ap.add_argument("--map", required=True, help="GNU ld map file (-Wl,-Map=...)")
+    ap.add_argument("--obj-dir", required=True, help="tree with the .su / .ci files")
+    ap.add_argument("--budget", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "mem_budget.ini"))
+    ap.add_argument("--profile", default="target", help="budget section (target / host)")
+    ap.add_argument("--no-enforce", action="store_true", help="report only, exit 0")
+    args = ap.parse_args()
+
+    cfg = configparser.ConfigParser(inline_comment_prefixes=("#", ";"))
+    cfg.optionxform = str
+    if not cfg.read(args.budget):
+        print("mem_report: cannot read %s" % args.budget, file=sys.stderr)
+        return 2
+    if not cfg.has_section(args.profile):
+        print("mem_report: no [%s] in %s" % (args.profile, args.budget), file=sys.stderr)
+        return 2
+
+    try:
+        modules, symbols = parse_map(args.map)
+    except (OSError, ValueError) as e:
+        print("mem_report: %s" % e, file=sys.stderr)
+        return 2
+
+    funcs = load_functions(args.obj_dir)
+    for fn in funcs.values():
+        if fn.size is None or fn.src is None:
+            continue
+        key = (layer_of(fn.src), os.path.splitext(os.path.basename(fn.src))[0])
+        if key in modules and fn.size > modules[key]["frame"]:
+            modules[key]["frame"] = fn.size
+            modules[key]["frame_fn"] = bare(fn.title)
+
+    indirect = {k: v.split() for k, v in cfg.items("indirect")} if cfg.has_section("indirect") else {}
+    external = {k: int(v) for k, v in cfg.items("external")} if cfg.has_section("external") else {}
+    an = StackAnalyzer(funcs, indirect, external)
+
+    root_pats = words(cfg, "general", "roots")
+    isr_pats = words(cfg, "general", "isr")
+    exc_frame = cfg.getint("general", "exception_frame", fallback=32)
+    budget = dict(cfg.items(args.profile))
+    fails = []
+
+    def check(key, value, what):
+        if key in budget and value > int(budget[key], 0):
+            fails.append("%s: %d > %s" % (what, value, budget[key]))
+            return " !"
+        return ""
+
+    # ---- modules / layers
+    print("%-16s %-24s %8s %8s %8s  %s" % ("layer", "module", "flash", "ram", "frame", "largest frame"))
+    totals = {}
+    for (layer, mod), v in sorted(modules.items()):
+        print("%-16s %-24s %8d %8d %8d  %s" % (layer, mod, v["flash"], v["ram"], v["frame"], v["frame_fn"]))
+        t = totals.setdefault(layer, {"flash": 0, "ram": 0})
+        t["flash"] += v["flash"]
+        t["ram"] += v["ram"]
+
+    # ---- stack per root
+    roots = sorted(t for t, fn in funcs.items()
+                   if fn.size is not None and any(fnmatch.fnmatchcase(bare(t), p) for p in root_pats))
+    isr_total, task_worst, task_worst_name = 0, 0, ""
+    layer_stack = {}
+    print()
+    print("%-36s %-4s %8s  %s" % ("root", "kind", "stack", "worst path"))
+    for r in roots:
+        size, path = an.depth(r)
+        isr = any(fnmatch.fnmatchcase(bare(r), p) for p in isr_pats)
+        layer = layer_of(funcs[r].src)
+        if isr:
+            isr_total += size + exc_frame
+        elif size > task_worst:
+            task_worst, task_worst_name = size, bare(r)
+        layer_stack[layer] = max(layer_stack.get(layer, 0), size)
+        print("%-36s %-4s %8d  %s" % (bare(r), "isr" if isr else "task", size, " > ".join(path)))
+
+    print()
+    print("%-16s %8s %8s %8s" % ("layer", "flash", "ram", "stack"))
+    for layer in sorted(totals):
+        fl, ra, st = totals[layer]["flash"], totals[layer]["ram"], layer_stack.get(layer, 0)
+        mark = check(layer + ".flash", fl, layer + " flash")
+        mark += check(layer + ".ram", ra, layer + " ram")
+        mark += check(layer + ".stack", st, layer + " stack")
+        print("%-16s %8d %8d %8d%s" % (layer, fl, ra, st, mark))
+
+    total_stack = task_worst + isr_total
+    fw_ram = sum(t["ram"] for l, t in totals.items() if l in LAYERS)
+    fw_flash = sum(t["flash"] for l, t in totals.items() if l in LAYERS)
+    print()
+    print("firmware flash %d, ram %d (layers %s)" % (fw_flash, fw_ram, " ".join(LAYERS)))
+    print("worst-case stack %d = %s %d + ISRs %d (each + %d exception frame, all nesting)"
+          % (total_stack, task_worst_name or "-", task_worst, isr_total, exc_frame))
+    if "_Min_Stack_Size" in symbols:
+        print("linker stack reserve %d" % symbols["_Min_Stack_Size"])
+        check("stack", total_stack, "stack vs budget")
+        if total_stack > symbols["_Min_Stack_Size"]:
+            fails.append("stack: %d > _Min_Stack_Size %d" % (total_stack, symbols["_Min_Stack_Size"]))
+    else:
+        check("stack", total_stack, "stack")
+    check("flash", fw_flash, "firmware flash")
+    check("ram", fw_ram, "firmware ram")
+
+    if an.unknown:
+        print("no frame info (counted as 0, see [external] / [indirect]): %s" % " ".join(sorted(an.unknown)))
+    if an.unbounded:
+        print("unbounded (recursion / dynamic stack): %s" % " ".join(sorted(an.unbounded)))
+
+    for f in fails:
+        print("BUDGET EXCEEDED %s" % f, file=sys.stderr)
+    return 1 if (fails and not args.no_enforce) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# =====================================================================================================================
+#  File        : telemetry_decode.py
+#  Layer       : Tools (host)
+#  ECU         : Sensor_ECU (STM32F103C6T6)
+#  Purpose     : Decode Services/Telemetry binary stream (COBS + CRC16 CCITT-FALSE) into CSV
+#  Usage       : telemetry_decode.py capture.bin [-o out.csv]
+#                telemetry_decode.py /dev/ttyUSB0 --baud 115200    (needs pyserial)
+# =====================================================================================================================
+
+import argparse
+import csv
+import struct
+import sys
+
+REC_SAMPLE = 0x01
+REC_DESCRIPTOR = 0x02
+
+# must match Telemetry_PBcfg.c
+CHANNEL_NAMES = {
+    0x01: "distance_q4mm",     # 1/16 mm, see Services/DistConv
+    0x02: "obstacle_state",
+    0x03: "supervisor_status",
+    0x04: "sensor_status",
+    0x05: "sensor_timeouts",
+    0x06: "invalid_meas",
+    0x07: "stack_used_bytes",  # high-water mark, see Services/StackMon
+    0x08: "can_tec",
+    0x09: "can_rec",
+    0x0A: "can_lec",           # last error code, 0 none .. 6 CRC, see Can_Types.h
+    0x0B: "can_busoff_count",
+    0x0C: "cansm_state",       # 0 no com, 1 full com, 2 bus-off wait, 3 bus-off check
+}
+
+
+def crc16_ccitt_false(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(stream):
+    # split on 0x00, empty chunks come from the leading delimiter of each frame
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+        while True:
+            idx = buf.find(b"\x00")
+            if idx < 0:
+                break
+            if idx > 0:
+                yield bytes(buf[:idx])
+            del buf[:idx + 1]
+
+
+class Decoder:
+    def __init__(self, writer, verbose):
+        self.writer = writer
+        self.verbose = verbose
+        self.layout = None      # list of (id, size)
+        self.period_ms = None
+        self.last_seq = None
+        self.stats = {"records": 0, "crc_err": 0, "text": 0, "lost": 0, "no_desc": 0}
+
+    def feed(self, raw):
+        rec = cobs_decode(raw)
+        if rec is None or len(rec) < 8 or crc16_ccitt_false(rec[:-2]) != struct.unpack_from("<H", rec, len(rec) - 2)[0]:
+            # Logger text shares the port; anything that is not a valid record is skipped
+            if raw.isascii():
+                self.stats["text"] += 1
+                if self.verbose:
+                    sys.stderr.write(raw.decode("ascii", "replace"))
+            else:
+                self.stats["crc_err"] += 1
+            return
+
+        rtype, seq, ts = struct.unpack_from("<BBI", rec, 0)
+        body = rec[6:-2]
+
+        if self.last_seq is not None:
+            self.stats["lost"] += (seq - self.last_seq - 1) & 0xFF
+        self.last_seq = seq
+
+        if rtype == REC_DESCRIPTOR:
+            self.period_ms, count = struct.unpack_from("<HB", body, 0)
+            layout = [(body[3 + 2 * i], body[4 + 2 * i]) for i in range(count)]
+            if layout != self.layout:
+                self.layout = layout
+                self.writer.writerow(["ts_ms", "seq"] + [CHANNEL_NAMES.get(cid, "ch%02x" % cid) for cid, _ in layout])
+        elif rtype == REC_SAMPLE:
+            if self.layout is None:
+                self.stats["no_desc"] += 1
+                return
+            row = [ts, seq]
+            pos = 0
+            for _, size in self.layout:
+                row.append(int.from_bytes(body[pos:pos + size], "little"))
+                pos += size
+            self.writer.writerow(row)
+            self.stats["records"] += 1
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode Sensor_ECU telemetry stream to CSV")
+    ap.add_argument("input", help="capture file or serial port")
+    ap.add_argument("-o", "--output", help="CSV file (default stdout)")
+    ap.add_argument("--baud", type=int, default=115200, help="baudrate when input is a serial port")
+    ap.add_argument("-v", "--verbose", action="store_true", help="echo Logger text lines to stderr")
+    args = ap.parse_args()
+
+    if args.input.startswith("/dev/") or args.input.upper().startswith("COM"):
+        import serial
+        src = serial.Serial(args.input, args.baud, timeout=1)
+    else:
+        src = open(args.input, "rb")
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    dec = Decoder(csv.writer(out), args.verbose)
+    try:
+        for raw in frames(src):
+            dec.feed(raw)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        src.close()
+        if out is not sys.stdout:
+            out.close()
+        sys.stderr.write("records=%(records)d lost=%(lost)d crc_err=%(crc_err)d text=%(text)d no_desc=%(no_desc)d\n" % dec.stats)
+
+
+if __name__ == "__main__":
+    main()
@@ -14,10 +14,6 @@
 
 extern const EcuM_ConfigType EcuM_Config;
 
-#ifndef LOG_TAG_SYSTEM
-#define LOG_TAG_SYSTEM (0x00000001u)
-#endif
-
 int main(void)
 {
 	// Init sequence